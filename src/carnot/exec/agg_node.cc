@@ -125,8 +125,12 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
   group_data_types_.reserve(groups_size);
   for (const auto& group : plan_node_->groups()) {
     DCHECK(group.idx < input_descriptor_->size());
-    group_data_types_.emplace_back(input_descriptor_->type(group.idx));
+    auto dt = input_descriptor_->type(group.idx);
+    group_data_types_.emplace_back(dt);
+    group_key_types_.emplace_back(dt == types::STRING ? types::INT64 : dt);
+    group_input_cols_.emplace_back(group.idx);
   }
+  group_dictionaries_.resize(groups_size);
 
   auto values_size = plan_node_->values().size();
   for (size_t i = 0; i < values_size; ++i) {
@@ -154,6 +158,11 @@ Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_
   if (HasNoGroups()) {
     return AggregateGroupByNone(exec_state, rb);
   }
+  if (rb.HasDictionaryColumns()) {
+    PL_ASSIGN_OR_RETURN(auto decoded_rb,
+                        rb.DecodeDictionaryColumns(exec_state->exec_mem_pool(), group_input_cols_));
+    return AggregateGroupByClause(exec_state, *decoded_rb);
+  }
   return AggregateGroupByClause(exec_state, rb);
 }
 
@@ -176,6 +185,9 @@ Status AggNode::ClearAggState(ExecState* exec_state) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
   }
   agg_hash_map_.clear();
+  for (auto& dictionary : group_dictionaries_) {
+    dictionary.Clear();
+  }
   return Status::OK();
 }
 
@@ -224,6 +236,10 @@ Status AggNode::ExtractRowTupleForBatch(const RowBatch& rb) {
     DCHECK(idx < group_data_types_.size());
     auto dt = group_data_types_[idx];
     auto col = rb.ColumnAt(grp.idx).get();
+    if (dt == types::STRING) {
+      ExtractStringGroupCodes(idx, col, num_rows);
+      continue;
+    }
 
 #define TYPE_CASE(_dt_) ExtractIntoGroupArgs<_dt_>(&group_args_chunk_, col, idx);
     PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
@@ -232,6 +248,29 @@ Status AggNode::ExtractRowTupleForBatch(const RowBatch& rb) {
   return Status::OK();
 }
 
+void AggNode::ExtractStringGroupCodes(size_t group_idx, const arrow::Array* col,
+                                      int64_t num_rows) {
+  auto* dictionary = &group_dictionaries_[group_idx];
+  if (!types::IsDictionaryEncoded(col)) {
+    for (int64_t row_idx = 0; row_idx < num_rows; ++row_idx) {
+      int32_t code = dictionary->Insert(types::GetStringViewFromArrowArray(col, row_idx));
+      group_args_chunk_[row_idx].rt->SetValue(group_idx, types::Int64Value(code));
+    }
+    return;
+  }
+  // Map the batch's dictionary onto the group's once, only for the values that are used.
+  const auto* values = types::DictionaryValues(col);
+  const auto* codes = types::DictionaryCodes(col);
+  std::vector<int32_t> remap(values->length(), -1);
+  for (int64_t row_idx = 0; row_idx < num_rows; ++row_idx) {
+    int32_t& code = remap[codes->Value(row_idx)];
+    if (code == -1) {
+      code = dictionary->Insert(types::GetStringViewFromArrowArray(values, codes->Value(row_idx)));
+    }
+    group_args_chunk_[row_idx].rt->SetValue(group_idx, types::Int64Value(code));
+  }
+}
+
 Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
   PL_UNUSED(exec_state);
   // Loop through all the row and basically store the values into column chunk based on which
@@ -305,7 +344,11 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
   DCHECK(output_rb != nullptr);
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders;
   for (const auto& group_dt : group_data_types_) {
-    group_builders.push_back(types::MakeArrowBuilder(group_dt, exec_state->exec_mem_pool()));
+    if (group_dt == types::STRING) {
+      group_builders.push_back(std::make_unique<arrow::Int32Builder>(exec_state->exec_mem_pool()));
+    } else {
+      group_builders.push_back(types::MakeArrowBuilder(group_dt, exec_state->exec_mem_pool()));
+    }
   }
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> value_builders;
   for (const auto& value_data_type : value_data_types_) {
@@ -319,6 +362,12 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
 
     for (size_t i = 0; i < group_data_types_.size(); ++i) {
       DCHECK(i < group_builders.size());
+      if (group_data_types_[i] == types::STRING) {
+        auto code = static_cast<int32_t>(groups_rt->GetValue<types::Int64Value>(i).val);
+        PL_RETURN_IF_ERROR(
+            static_cast<arrow::Int32Builder*>(group_builders[i].get())->Append(code));
+        continue;
+      }
 
 #define TYPE_CASE(_dt_) AppendToBuilder<_dt_>(group_builders[i].get(), groups_rt, i);
       PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
@@ -333,9 +382,14 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
     }
   }
 
-  for (const auto& group_builder : group_builders) {
+  // STRING groups are emitted dictionary encoded, sharing the group's dictionary.
+  for (const auto& [i, group_builder] : Enumerate(group_builders)) {
     std::shared_ptr<arrow::Array> arr;
     PL_RETURN_IF_ERROR(group_builder->Finish(&arr));
+    if (group_data_types_[i] == types::STRING) {
+      arr = types::MakeStringDictionaryArray(
+          arr, group_dictionaries_[i].ToArrow(exec_state->exec_mem_pool()));
+    }
     PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
   }
 
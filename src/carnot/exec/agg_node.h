@@ -37,6 +37,7 @@
 #include "src/common/memory/memory.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/hash_utils.h"
+#include "src/shared/types/string_dictionary.h"
 #include "src/shared/types/types.h"
 #include "src/table_store/table_store.h"
 
@@ -81,6 +82,9 @@ class AggNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  // STRING groups are hashed by their dictionary code. Other dictionary encoded columns are
+  // decoded before they are stored.
+  bool AcceptsDictionaryColumns() const override { return !HasNoGroups(); }
 
  private:
   AggHashMap agg_hash_map_;
@@ -126,6 +130,12 @@ class AggNode : public ProcessingNode {
 
   std::vector<types::DataType> group_data_types_;
   std::vector<types::DataType> value_data_types_;
+  // The types stored in the group row tuples. STRING groups are stored as INT64 codes into
+  // group_dictionaries_, so hashing and comparing a group never touches the string itself.
+  std::vector<types::DataType> group_key_types_;
+  std::vector<types::StringDictionary> group_dictionaries_;
+  // The input columns of the groups, which are left dictionary encoded.
+  std::vector<int64_t> group_input_cols_;
 
   // We construct row-tuples in a batch, chunked by each column.
   // This vector holds pointers to the row_tuples which are managed by the group_args_pool_.
@@ -137,6 +147,7 @@ class AggNode : public ProcessingNode {
   Status CreateColumnMapping();
 
   Status ExtractRowTupleForBatch(const table_store::schema::RowBatch& rb);
+  void ExtractStringGroupCodes(size_t group_idx, const arrow::Array* col, int64_t num_rows);
   Status HashRowBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status EvaluatePartialAggregates(ExecState* exec_state, size_t num_records);
   Status ResetGroupArgs();
@@ -145,7 +156,7 @@ class AggNode : public ProcessingNode {
 
   AggHashValue* CreateAggHashValue(ExecState* exec_state);
   RowTuple* CreateGroupArgsRowTuple() {
-    return group_args_pool_.Add(new RowTuple(&group_data_types_));
+    return group_args_pool_.Add(new RowTuple(&group_key_types_));
   }
 
   Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
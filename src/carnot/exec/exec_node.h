@@ -220,7 +220,12 @@ class ExecNode {
     }
     stats_->AddInputStats(rb);
     stats_->ResumeTotalTimer();
-    PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, rb, parent_index));
+    if (!AcceptsDictionaryColumns() && rb.HasDictionaryColumns()) {
+      PL_ASSIGN_OR_RETURN(auto decoded_rb, rb.DecodeDictionaryColumns(exec_state->exec_mem_pool()));
+      PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, *decoded_rb, parent_index));
+    } else {
+      PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, rb, parent_index));
+    }
     stats_->StopTotalTimer();
     return Status::OK();
   }
@@ -313,6 +318,13 @@ class ExecNode {
   virtual Status ConsumeNextImpl(ExecState*, const table_store::schema::RowBatch&, size_t) {
     return error::Unimplemented("Implement in derived class (if sink or processing)");
   }
+
+  /**
+   * Whether ConsumeNextImpl reads dictionary encoded STRING columns itself. Nodes that don't
+   * (sinks, joins, unions, ...) get those columns materialized as plain strings before
+   * ConsumeNextImpl is called.
+   */
+  virtual bool AcceptsDictionaryColumns() const { return false; }
   bool is_closed() { return is_closed_; }
 
   std::unique_ptr<table_store::schema::RowDescriptor> output_descriptor_;
@@ -41,6 +41,14 @@ class MockExecNode : public ExecNode {
   MOCK_METHOD1(CloseImpl, Status(ExecState* exec_state));
   MOCK_METHOD1(GenerateNextImpl, Status(ExecState*));
   MOCK_METHOD3(ConsumeNextImpl, Status(ExecState*, const table_store::schema::RowBatch&, size_t));
+
+  void set_accepts_dictionary_columns(bool val) { accepts_dictionary_columns_ = val; }
+
+ protected:
+  bool AcceptsDictionaryColumns() const override { return accepts_dictionary_columns_; }
+
+ private:
+  bool accepts_dictionary_columns_ = false;
 };
 
 class MockSourceNode : public SourceNode {
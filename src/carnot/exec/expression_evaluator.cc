@@ -28,12 +28,14 @@
 #include <ostream>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
 #include <absl/strings/str_join.h>
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/udf/udf_definition.h"
 #include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
 #include "src/shared/types/types.h"
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
 
@@ -42,6 +44,7 @@ namespace carnot {
 namespace exec {
 
 // PL_CARNOT_UPDATE_FOR_NEW_TYPES
+using table_store::schema::CopyValue;
 using table_store::schema::CopyValueRepeated;
 using table_store::schema::RowBatch;
 using types::ArrowToDataType;
@@ -133,6 +136,76 @@ std::shared_ptr<ColumnWrapper> EvalScalarToColumnWrapper(ExecState*, const plan:
   }
 }
 
+namespace {
+
+// Returns the index of the dictionary encoded argument when fn can be evaluated once per
+// dictionary value: the UDF is pure, exactly one argument is dictionary encoded and all the
+// others are constants. Returns -1 when fn has to be evaluated row by row.
+int DictionaryArgument(const udf::ScalarUDFDefinition* def, const std::vector<bool>& encoded,
+                       const std::vector<bool>& constant) {
+  if (!def->is_pure()) {
+    return -1;
+  }
+  int dict_arg = -1;
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    if (encoded[i]) {
+      if (dict_arg != -1) {
+        return -1;
+      }
+      dict_arg = static_cast<int>(i);
+    } else if (!constant[i]) {
+      return -1;
+    }
+  }
+  return dict_arg;
+}
+
+// Expands values computed once per dictionary value back to one value per row.
+template <types::DataType T>
+std::shared_ptr<arrow::Array> GatherByCodes(arrow::MemoryPool* mem_pool, const arrow::Array* values,
+                                            const arrow::Int32Array* codes) {
+  auto builder = GetArrowBuilder<T>(mem_pool);
+  PL_CHECK_OK(builder->Reserve(codes->length()));
+  for (int64_t idx = 0; idx < codes->length(); ++idx) {
+    PL_CHECK_OK(
+        CopyValue<T>(builder.get(), types::GetValueFromArrowArray<T>(values, codes->Value(idx))));
+  }
+  std::shared_ptr<arrow::Array> arr;
+  PL_CHECK_OK(builder->Finish(&arr));
+  return arr;
+}
+
+template <types::DataType T>
+SharedColumnWrapper GatherByCodes(const ColumnWrapper& values, const arrow::Int32Array* codes) {
+  using value_type = typename DataTypeTraits<T>::value_type;
+  const auto& typed_values = static_cast<const types::ColumnWrapperTmpl<value_type>&>(values);
+  auto out = std::make_shared<types::ColumnWrapperTmpl<value_type>>(codes->length());
+  for (int64_t idx = 0; idx < codes->length(); ++idx) {
+    (*out)[idx] = typed_values[codes->Value(idx)];
+  }
+  return out;
+}
+
+// A value computed by the VectorNative evaluator. Dictionary encoded columns are evaluated on
+// their distinct values, in which case codes maps each row to one of them.
+struct VectorValue {
+  SharedColumnWrapper col;
+  std::shared_ptr<arrow::Array> codes;
+  const plan::ScalarValue* constant = nullptr;
+};
+
+SharedColumnWrapper Materialize(const VectorValue& value) {
+  if (value.codes == nullptr) {
+    return value.col;
+  }
+  const auto* codes = static_cast<const arrow::Int32Array*>(value.codes.get());
+#define TYPE_CASE(_dt_) return GatherByCodes<_dt_>(*value.col, codes);
+  PL_SWITCH_FOREACH_DATATYPE(value.col->data_type(), TYPE_CASE);
+#undef TYPE_CASE
+}
+
+}  // namespace
+
 Status ScalarExpressionEvaluator::Evaluate(ExecState* exec_state, const RowBatch& input,
                                            RowBatch* output) {
   CHECK(exec_state != nullptr);
@@ -199,45 +272,66 @@ VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
   // Path for scalar funcs an their dependencies to get evaluated.
   // The Arrow arrays are converted to type erased column wrappers
   // and then evaluated.
-  plan::ExpressionWalker<types::SharedColumnWrapper> walker;
+  plan::ExpressionWalker<VectorValue> walker;
   walker.OnScalarValue(
-      [&](const plan::ScalarValue& val,
-          const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
+      [&](const plan::ScalarValue& val, const std::vector<VectorValue>& children) -> VectorValue {
         DCHECK_EQ(children.size(), 0ULL);
-        return EvalScalarToColumnWrapper(exec_state, val, num_rows);
+        return {EvalScalarToColumnWrapper(exec_state, val, num_rows), nullptr, &val};
       });
 
   walker.OnColumn(
-      [&](const plan::Column& col,
-          const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
+      [&](const plan::Column& col, const std::vector<VectorValue>& children) -> VectorValue {
         DCHECK_EQ(children.size(), 0ULL);
-        return ColumnWrapper::FromArrow(input.ColumnAt(col.Index()));
+        auto arr = input.ColumnAt(col.Index());
+        if (types::IsDictionaryEncoded(arr.get())) {
+          const auto* dict = static_cast<const arrow::DictionaryArray*>(arr.get());
+          return {ColumnWrapper::FromArrow(dict->dictionary()), dict->indices()};
+        }
+        return {ColumnWrapper::FromArrow(arr)};
       });
 
   walker.OnScalarFunc(
-      [&](const plan::ScalarFunc& fn,
-          const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
-        std::vector<types::DataType> arg_types;
-        arg_types.reserve(children.size());
-        for (const auto& child : children) {
-          arg_types.emplace_back(child->data_type());
-        }
-
+      [&](const plan::ScalarFunc& fn, const std::vector<VectorValue>& children) -> VectorValue {
         auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
         auto udf = id_to_udf_map_[fn.udf_id()].get();
 
-        std::vector<const types::ColumnWrapper*> raw_children;
-        raw_children.reserve(children.size());
+        std::vector<bool> encoded;
+        std::vector<bool> constant;
         for (const auto& child : children) {
-          raw_children.emplace_back(child.get());
+          encoded.push_back(child.codes != nullptr);
+          constant.push_back(child.constant != nullptr);
         }
-        auto output = types::ColumnWrapper::Make(def->exec_return_type(), num_rows);
+        // Evaluate on the dictionary values when possible, otherwise expand every argument.
+        int dict_arg = DictionaryArgument(def, encoded, constant);
+        size_t count = dict_arg == -1 ? num_rows : children[dict_arg].col->Size();
+        std::vector<SharedColumnWrapper> args;
+        args.reserve(children.size());
+        for (const auto& [idx, child] : Enumerate(children)) {
+          if (dict_arg == -1) {
+            args.push_back(Materialize(child));
+          } else if (static_cast<int>(idx) == dict_arg) {
+            args.push_back(child.col);
+          } else {
+            args.push_back(EvalScalarToColumnWrapper(exec_state, *child.constant, count));
+          }
+        }
+
+        std::vector<const types::ColumnWrapper*> raw_children;
+        raw_children.reserve(args.size());
+        for (const auto& arg : args) {
+          raw_children.emplace_back(arg.get());
+        }
+        auto output = types::ColumnWrapper::Make(def->exec_return_type(), count);
         // TODO(zasgar): need a better way to handle errors.
-        PL_CHECK_OK(def->ExecBatch(udf, function_ctx_, raw_children, output.get(), num_rows));
-        return output;
+        PL_CHECK_OK(def->ExecBatch(udf, function_ctx_, raw_children, output.get(), count));
+        if (dict_arg == -1) {
+          return {output};
+        }
+        return {output, children[dict_arg].codes};
       });
 
-  return walker.Walk(expr);
+  PL_ASSIGN_OR_RETURN(auto result, walker.Walk(expr));
+  return Materialize(result);
 }
 
 Status VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
@@ -294,11 +388,16 @@ Status exec::ArrowNativeScalarExpressionEvaluator::EvaluateSingleExpression(
     RowBatch* output) {
   size_t num_rows = input.num_rows();
   plan::ExpressionWalker<std::shared_ptr<arrow::Array>> walker;
+  // The plan constants among the evaluated arrays, so they can be re-evaluated at the length of
+  // a dictionary. Holding the arrays keeps their addresses from being reused by other results.
+  absl::flat_hash_map<std::shared_ptr<arrow::Array>, const plan::ScalarValue*> constants;
   walker.OnScalarValue(
       [&](const plan::ScalarValue& val, const std::vector<std::shared_ptr<arrow::Array>>& children)
           -> std::shared_ptr<arrow::Array> {
         DCHECK_EQ(children.size(), 0ULL);
-        return EvalScalarToArrow(exec_state, val, num_rows);
+        auto arr = EvalScalarToArrow(exec_state, val, num_rows);
+        constants[arr] = &val;
+        return arr;
       });
 
   walker.OnColumn(
@@ -311,28 +410,69 @@ Status exec::ArrowNativeScalarExpressionEvaluator::EvaluateSingleExpression(
   walker.OnScalarFunc(
       [&](const plan::ScalarFunc& fn, const std::vector<std::shared_ptr<arrow::Array>>& children)
           -> std::shared_ptr<arrow::Array> {
-        std::vector<types::DataType> arg_types;
-        arg_types.reserve(children.size());
+        auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
+        auto udf = id_to_udf_map_[fn.udf_id()].get();
+
+        std::vector<bool> encoded;
+        std::vector<bool> constant;
         for (const auto& child : children) {
-          arg_types.emplace_back(ArrowToDataType(child->type_id()));
+          encoded.push_back(types::IsDictionaryEncoded(child.get()));
+          constant.push_back(constants.contains(child));
+        }
+        int dict_arg = DictionaryArgument(def, encoded, constant);
+        if (dict_arg == -1 && def->ProducesDictionary()) {
+          auto result_or = def->ExecBatchArrowDictionary(udf, function_ctx_, children[0].get(),
+                                                         num_rows, arrow::default_memory_pool());
+          PL_CHECK_OK(result_or);
+          return result_or.ConsumeValueOrDie();
         }
 
-        auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
-        auto udf = id_to_udf_map_[fn.udf_id()].get();
+        // Evaluate on the dictionary values when possible, otherwise decode every argument.
+        const arrow::DictionaryArray* dict = nullptr;
+        size_t count = num_rows;
+        std::vector<std::shared_ptr<arrow::Array>> args;
+        args.reserve(children.size());
+        if (dict_arg != -1) {
+          dict = static_cast<const arrow::DictionaryArray*>(children[dict_arg].get());
+          count = dict->dictionary()->length();
+        }
+        for (const auto& [idx, child] : Enumerate(children)) {
+          if (dict != nullptr && static_cast<int>(idx) == dict_arg) {
+            args.push_back(dict->dictionary());
+          } else if (dict != nullptr) {
+            args.push_back(EvalScalarToArrow(exec_state, *constants[child], count));
+          } else if (encoded[idx]) {
+            args.push_back(
+                types::DecodeStringDictionaryArray(child.get(), exec_state->exec_mem_pool()));
+          } else {
+            args.push_back(child);
+          }
+        }
 
         auto output = MakeArrowBuilder(def->exec_return_type(), arrow::default_memory_pool());
 
         std::vector<arrow::Array*> raw_children;
-        raw_children.reserve(children.size());
-        for (const auto& child : children) {
-          raw_children.push_back(child.get());
+        raw_children.reserve(args.size());
+        for (const auto& arg : args) {
+          raw_children.push_back(arg.get());
         }
 
-        PL_CHECK_OK(def->ExecBatchArrow(udf, function_ctx_, raw_children, output.get(), num_rows));
+        PL_CHECK_OK(def->ExecBatchArrow(udf, function_ctx_, raw_children, output.get(), count));
 
         std::shared_ptr<arrow::Array> output_array;
         PL_CHECK_OK(output->Finish(&output_array));
-        return output_array;
+        if (dict == nullptr) {
+          return output_array;
+        }
+        // STRING results keep the codes of the argument, everything else is expanded per row.
+        if (def->exec_return_type() == DataType::STRING) {
+          return types::MakeStringDictionaryArray(dict->indices(), output_array);
+        }
+        const auto* codes = types::DictionaryCodes(dict);
+#define TYPE_CASE(_dt_) \
+  return GatherByCodes<_dt_>(arrow::default_memory_pool(), output_array.get(), codes);
+        PL_SWITCH_FOREACH_DATATYPE(def->exec_return_type(), TYPE_CASE);
+#undef TYPE_CASE
       });
 
   PL_ASSIGN_OR_RETURN(auto result, walker.Walk(expr));
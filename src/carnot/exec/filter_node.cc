@@ -129,6 +129,27 @@ Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& p
   return Status::OK();
 }
 
+// Dictionary encoded columns are filtered by copying the selected codes. The output shares the
+// dictionary of the input column.
+Status PredicateCopyDictionary(const types::BoolValueColumnWrapper& pred,
+                               const arrow::Array* input_col, RowBatch* output_rb) {
+  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
+  const auto* dict = static_cast<const arrow::DictionaryArray*>(input_col);
+  const auto* codes = types::DictionaryCodes(input_col);
+  arrow::Int32Builder output_codes_builder(arrow::default_memory_pool());
+  PL_RETURN_IF_ERROR(output_codes_builder.Reserve(output_rb->num_rows()));
+  for (int64_t idx = 0; idx < codes->length(); ++idx) {
+    if (udf::UnWrap(pred[idx])) {
+      output_codes_builder.UnsafeAppend(codes->Value(idx));
+    }
+  }
+  std::shared_ptr<arrow::Array> output_codes;
+  PL_RETURN_IF_ERROR(output_codes_builder.Finish(&output_codes));
+  PL_RETURN_IF_ERROR(
+      output_rb->AddColumn(types::MakeStringDictionaryArray(output_codes, dict->dictionary())));
+  return Status::OK();
+}
+
 Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
   // Current implementation does not merge across row batches, we should
   // consider this for cases where the filter has really low selectivity.
@@ -157,6 +178,10 @@ Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, si
 
   for (const auto& [output_col_idx, input_col_idx] : Enumerate(plan_node_->selected_cols())) {
     auto input_col = rb.ColumnAt(input_col_idx);
+    if (types::IsDictionaryEncoded(input_col.get())) {
+      PL_RETURN_IF_ERROR(PredicateCopyDictionary(pred_col_wrapper, input_col.get(), &output_rb));
+      continue;
+    }
     auto col_type = output_descriptor_->type(output_col_idx);
 #define TYPE_CASE(_dt_) \
   PL_RETURN_IF_ERROR(PredicateCopyValues<_dt_>(pred_col_wrapper, input_col.get(), &output_rb));
@@ -49,6 +49,8 @@ class FilterNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  // The predicate is evaluated once per dictionary value and selected codes are copied as is.
+  bool AcceptsDictionaryColumns() const override { return true; }
 
  private:
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
@@ -47,9 +47,13 @@ class EqUDF : public udf::ScalarUDF {
 
 class StrEqUDF : public udf::ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
   types::BoolValue Exec(FunctionContext*, types::StringValue v1, types::StringValue v2) {
+    ++exec_count;
     return v1 == v2;
   }
+
+  static inline int exec_count = 0;
 };
 
 class FilterNodeTest : public ::testing::Test {
@@ -223,6 +227,36 @@ TEST_F(FilterNodeTest, string_pred) {
       .Close();
 }
 
+TEST_F(FilterNodeTest, dictionary_pred) {
+  auto op_proto = planpb::testutils::CreateTestFilterTwoColsString();
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::STRING, types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd(
+      {types::DataType::STRING, types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  StrEqUDF::exec_count = 0;
+  tester.KeepDictionaryColumns()
+      .ConsumeNext(RowBatchBuilder(input_rd, 6, /*eow*/ true, /*eos*/ true)
+                       .AddDictionaryColumn({0, 1, 0, 2, 0, 1}, {"A", "B", "D"})
+                       .AddColumn<types::Int64Value>({1, 3, 6, 9, 12, 15})
+                       .AddColumn<types::Int64Value>({2, 4, 7, 10, 13, 16})
+                       .get(),
+                   0)
+      // The selected rows keep their codes into the input dictionary.
+      .ExpectDictionaryColumn(0, 3)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<types::StringValue>({"A", "A", "A"})
+                          .AddColumn<types::Int64Value>({1, 6, 12})
+                          .AddColumn<types::Int64Value>({2, 7, 13})
+                          .get())
+      .Close();
+  // The predicate ran once per dictionary value, not once per row.
+  EXPECT_EQ(3, StrEqUDF::exec_count);
+}
+
 TEST_F(FilterNodeTest, child_fail) {
   auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
   plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
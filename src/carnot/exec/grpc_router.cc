@@ -35,6 +35,17 @@ namespace px {
 namespace carnot {
 namespace exec {
 
+namespace {
+
+// Row batches arrive either as RowBatchData or as the ArrowRowBatchData body negotiated in the
+// plan. Decoding is left to the GRPCSourceNode so it happens on the consuming exec thread.
+bool HasRowBatch(const carnotpb::TransferResultChunkRequest& req) {
+  return req.has_query_result() &&
+         (req.query_result().has_row_batch() || req.query_result().has_arrow_row_batch());
+}
+
+}  // namespace
+
 GRPCRouter::SourceNodeTracker* GRPCRouter::GetSourceNodeTracker(QueryTracker* query_tracker,
                                                                 int64_t source_id) {
   absl::base_internal::SpinLockHolder query_lock(&query_tracker->query_lock);
@@ -43,7 +54,7 @@ GRPCRouter::SourceNodeTracker* GRPCRouter::GetSourceNodeTracker(QueryTracker* qu
 
 Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
                                    std::unique_ptr<carnotpb::TransferResultChunkRequest> req) {
-  if (!req->has_query_result() || !req->query_result().has_row_batch() ||
+  if (!HasRowBatch(*req) ||
       req->query_result().destination_case() !=
           carnotpb::TransferResultChunkRequest_SinkResult::DestinationCase::kGrpcSourceId) {
     return error::Internal(
@@ -169,7 +180,7 @@ void GRPCRouter::MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
                            absl::Substitute("Failed to record stats w/ err: $0", s.msg()));
         break;
       }
-    } else if (rb->has_query_result() && rb->query_result().has_row_batch()) {
+    } else if (HasRowBatch(*rb)) {
       auto s = EnqueueRowBatch(query_tracker.get(), std::move(rb));
       if (!s.ok()) {
         result_status = ::grpc::Status(grpc::StatusCode::INTERNAL, "failed to enqueue batch");
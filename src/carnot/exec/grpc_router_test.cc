@@ -56,6 +56,7 @@ using grpc::InsecureChannelCredentials;
 using grpc::InsecureServerCredentials;
 using grpc::Server;
 using grpc::ServerBuilder;
+using table_store::schema::RowBatch;
 using table_store::schema::RowDescriptor;
 
 class GRPCRouterTest : public ::testing::Test {
@@ -225,6 +226,58 @@ TEST_F(GRPCRouterTest, basic_router_test) {
   EXPECT_TRUE(source_node.upstream_closed_connection());
 }
 
+TEST_F(GRPCRouterTest, arrow_row_batch_router_test) {
+  int64_t grpc_source_node_id = 1;
+  uint64_t ab = 0xea8aa095697f49f1, cd = 0xb127d50e5b6e2645;
+
+  RowDescriptor input_rd({types::DataType::INT64});
+  auto query_uuid = sole::rebuild(ab, cd);
+
+  auto op_proto = planpb::testutils::CreateTestGRPCSource1PB();
+  std::unique_ptr<px::carnot::plan::Operator> plan_node =
+      plan::GRPCSourceOperator::FromProto(op_proto, grpc_source_node_id);
+  auto source_node = FakeGRPCSourceNode();
+  ASSERT_OK(source_node.Init(*plan_node, input_rd, {}));
+
+  auto num_continues = 0;
+  ASSERT_OK(service_->AddGRPCSourceNode(query_uuid, grpc_source_node_id, &source_node,
+                                        [&] { num_continues++; }));
+
+  carnotpb::TransferResultChunkRequest initiate_stream_req0;
+  auto query_id = initiate_stream_req0.mutable_query_id();
+  query_id->set_high_bits(ab);
+  query_id->set_low_bits(cd);
+  initiate_stream_req0.mutable_query_result()->set_grpc_source_id(grpc_source_node_id);
+  initiate_stream_req0.mutable_query_result()->set_initiate_result_stream(true);
+
+  auto rb1 = RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                 .AddColumn<types::Int64Value>({1, 2})
+                 .get();
+  carnotpb::TransferResultChunkRequest rb_req1;
+  EXPECT_OK(rb1.ToArrowProto(rb_req1.mutable_query_result()->mutable_arrow_row_batch(),
+                             /* deflate */ true));
+  rb_req1.mutable_query_result()->set_grpc_source_id(grpc_source_node_id);
+  query_id = rb_req1.mutable_query_id();
+  query_id->set_high_bits(ab);
+  query_id->set_low_bits(cd);
+
+  px::carnotpb::TransferResultChunkResponse response;
+  grpc::ClientContext context;
+  auto writer = stub_->TransferResultChunk(&context, &response);
+  writer->Write(initiate_stream_req0);
+  writer->Write(rb_req1);
+  writer->WritesDone();
+  writer->Finish();
+
+  EXPECT_TRUE(response.success());
+  ASSERT_EQ(1, source_node.row_batches.size());
+  auto* result = source_node.row_batches.at(0)->mutable_query_result();
+  ASSERT_TRUE(result->has_arrow_row_batch());
+  ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromArrowProto(result->mutable_arrow_row_batch()));
+  EXPECT_TRUE(rb1.ColumnAt(0)->Equals(rb->ColumnAt(0)));
+  EXPECT_EQ(1, num_continues);
+}
+
 TEST_F(GRPCRouterTest, router_and_stats_test) {
   int64_t grpc_source_node_id = 1;
   uint64_t ab = 0xea8aa095697f49f1, cd = 0xb127d50e5b6e2645;
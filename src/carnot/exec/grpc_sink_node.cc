@@ -318,8 +318,16 @@ Status GRPCSinkNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb,
 
 Status GRPCSinkNode::ConsumeNextImplNoSplit(ExecState* exec_state, const RowBatch& rb, size_t) {
   PL_ASSIGN_OR_RETURN(auto req, RequestWithMetadata(plan_node_.get(), exec_state));
-  // Serialize the RowBatch.
-  PL_RETURN_IF_ERROR(rb.ToProto(req.mutable_query_result()->mutable_row_batch()));
+  // Serialize the RowBatch. Output tables are read outside of Carnot, so they always get
+  // RowBatchData; batches to another Carnot use whatever encoding the planner negotiated.
+  auto encoding = plan_node_->row_batch_encoding();
+  if (plan_node_->has_grpc_source_id() && encoding != planpb::GRPCSinkOperator::ROW_BATCH_DATA) {
+    PL_RETURN_IF_ERROR(
+        rb.ToArrowProto(req.mutable_query_result()->mutable_arrow_row_batch(),
+                        /* deflate */ encoding == planpb::GRPCSinkOperator::ARROW_DEFLATE));
+  } else {
+    PL_RETURN_IF_ERROR(rb.ToProto(req.mutable_query_result()->mutable_row_batch()));
+  }
 
   PL_RETURN_IF_ERROR(TryWriteRequest(exec_state, req));
 
@@ -16,9 +16,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <benchmark/benchmark.h>
 #include <grpcpp/test/mock_stream.h>
 #include <gtest/gtest.h>
@@ -49,6 +52,91 @@ using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Return;
 using ::testing::SetArgPointee;
+
+namespace {
+
+// Builds a row batch with one column of each type that commonly crosses the PEM -> Kelvin hop.
+RowBatch MakeMixedRowBatch(int64_t num_rows) {
+  RowDescriptor rd({DataType::TIME64NS, DataType::INT64, DataType::FLOAT64, DataType::STRING});
+  std::vector<px::types::Time64NSValue> times(num_rows);
+  std::vector<px::types::Int64Value> ints(num_rows);
+  std::vector<px::types::Float64Value> floats(num_rows);
+  std::vector<px::types::StringValue> strings(num_rows);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    times[i] = 1552607213931245000 + i;
+    ints[i] = i;
+    floats[i] = i * 0.5;
+    strings[i] = absl::StrCat("/api/v1/resource/", i);
+  }
+  auto builder = px::carnot::exec::RowBatchBuilder(rd, num_rows, /*eow*/ true, /*eos*/ true);
+  builder.AddColumn<px::types::Time64NSValue>(times);
+  builder.AddColumn<px::types::Int64Value>(ints);
+  builder.AddColumn<px::types::Float64Value>(floats);
+  builder.AddColumn<px::types::StringValue>(strings);
+  return builder.get();
+}
+
+}  // namespace
+
+// Measures the RowBatch -> RowBatchData encode done by GRPCSinkNode for every batch it sends.
+// NOLINTNEXTLINE : runtime/references.
+void BM_RowBatchToProto(benchmark::State& state) {
+  auto rb = MakeMixedRowBatch(state.range(0));
+  for (auto _ : state) {
+    px::table_store::schemapb::RowBatchData proto;
+    PL_CHECK_OK(rb.ToProto(&proto));
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() * rb.NumBytes());
+}
+
+// Measures the RowBatchData -> RowBatch decode done by GRPCSourceNode for every batch it receives.
+// NOLINTNEXTLINE : runtime/references.
+void BM_RowBatchFromProto(benchmark::State& state) {
+  auto rb = MakeMixedRowBatch(state.range(0));
+  px::table_store::schemapb::RowBatchData proto;
+  PL_CHECK_OK(rb.ToProto(&proto));
+  for (auto _ : state) {
+    auto out = RowBatch::FromProto(proto).ConsumeValueOrDie();
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(state.iterations() * rb.NumBytes());
+}
+
+// Measures the RowBatch -> ArrowRowBatchData encode used between Carnot instances. The argument
+// selects the gzip compressed body.
+// NOLINTNEXTLINE : runtime/references.
+void BM_RowBatchToArrowProto(benchmark::State& state) {
+  auto rb = MakeMixedRowBatch(state.range(0));
+  bool deflate = state.range(1);
+  size_t wire_bytes = 0;
+  for (auto _ : state) {
+    px::table_store::schemapb::ArrowRowBatchData proto;
+    PL_CHECK_OK(rb.ToArrowProto(&proto, deflate));
+    wire_bytes = proto.ByteSizeLong();
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() * rb.NumBytes());
+  state.counters["wire_bytes"] = wire_bytes;
+}
+
+// Measures the ArrowRowBatchData -> RowBatch decode. The body is moved out of the message, so
+// every iteration decodes a fresh copy made outside the timed region.
+// NOLINTNEXTLINE : runtime/references.
+void BM_RowBatchFromArrowProto(benchmark::State& state) {
+  auto rb = MakeMixedRowBatch(state.range(0));
+  px::table_store::schemapb::ArrowRowBatchData proto;
+  PL_CHECK_OK(rb.ToArrowProto(&proto, state.range(1)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto copy = proto;
+    state.ResumeTiming();
+    auto out = RowBatch::FromArrowProto(&copy).ConsumeValueOrDie();
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetBytesProcessed(state.iterations() * rb.NumBytes());
+}
+
 // NOLINTNEXTLINE : runtime/references.
 void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
   auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
@@ -74,7 +162,9 @@ void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
       .WillByDefault(DoAll(SetArgPointee<1>(resp), Return(writer)));
 
   px::carnot::exec::GRPCSinkNode node;
-  auto op_proto = px::carnot::planpb::testutils::CreateTestGRPCSink2PB();
+  auto op_proto = px::carnot::planpb::testutils::CreateTestGRPCSink1PB();
+  op_proto.mutable_grpc_sink_op()->set_row_batch_encoding(
+      static_cast<px::carnot::planpb::GRPCSinkOperator::RowBatchEncoding>(state.range(0)));
   auto plan_node = std::make_unique<px::carnot::plan::GRPCSinkOperator>(1);
   auto s = plan_node->Init(op_proto.grpc_sink_op());
 
@@ -103,4 +193,12 @@ void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_GRPCSinkNodeSplitting)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GRPCSinkNodeSplitting)
+    ->Arg(px::carnot::planpb::GRPCSinkOperator::ROW_BATCH_DATA)
+    ->Arg(px::carnot::planpb::GRPCSinkOperator::ARROW)
+    ->Arg(px::carnot::planpb::GRPCSinkOperator::ARROW_DEFLATE)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RowBatchToProto)->RangeMultiplier(8)->Range(1024, 65536);
+BENCHMARK(BM_RowBatchFromProto)->RangeMultiplier(8)->Range(1024, 65536);
+BENCHMARK(BM_RowBatchToArrowProto)->RangeMultiplier(8)->Ranges({{1024, 65536}, {0, 1}});
+BENCHMARK(BM_RowBatchFromArrowProto)->RangeMultiplier(8)->Ranges({{1024, 65536}, {0, 1}});
@@ -231,6 +231,65 @@ TEST_F(GRPCSinkNodeTest, internal_result) {
   EXPECT_FALSE(add_metadata_called_);
 }
 
+TEST_F(GRPCSinkNodeTest, internal_arrow_result) {
+  for (auto encoding : {planpb::GRPCSinkOperator::ARROW, planpb::GRPCSinkOperator::ARROW_DEFLATE}) {
+    auto op_proto = planpb::testutils::CreateTestGRPCSink1PB();
+    op_proto.mutable_grpc_sink_op()->set_row_batch_encoding(encoding);
+    auto plan_node = std::make_unique<plan::GRPCSinkOperator>(1);
+    EXPECT_OK(plan_node->Init(op_proto.grpc_sink_op()));
+    RowDescriptor input_rd({types::DataType::INT64, types::DataType::STRING});
+    RowDescriptor output_rd({types::DataType::INT64, types::DataType::STRING});
+
+    TransferResultChunkResponse resp;
+    resp.set_success(true);
+
+    std::vector<TransferResultChunkRequest> actual_protos(3);
+    auto writer = new grpc::testing::MockClientWriter<TransferResultChunkRequest>();
+    EXPECT_CALL(*writer, Write(_, _))
+        .Times(3)
+        .WillOnce(DoAll(SaveArg<0>(&actual_protos[0]), Return(true)))
+        .WillOnce(DoAll(SaveArg<0>(&actual_protos[1]), Return(true)))
+        .WillOnce(DoAll(SaveArg<0>(&actual_protos[2]), Return(true)));
+    EXPECT_CALL(*writer, WritesDone());
+    EXPECT_CALL(*writer, Finish()).WillOnce(Return(grpc::Status::OK));
+    EXPECT_CALL(*mock_, TransferResultChunkRaw(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(resp), Return(writer)));
+
+    auto tester = exec::ExecNodeTester<GRPCSinkNode, plan::GRPCSinkOperator>(
+        *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+    std::vector<RowBatch> expected_rbs;
+    for (auto i = 1; i < 3; ++i) {
+      std::vector<types::Int64Value> data(i, i);
+      std::vector<types::StringValue> strs(i, absl::StrCat("value", i));
+      auto rb = RowBatchBuilder(output_rd, i, /*eow*/ i == 2, /*eos*/ i == 2)
+                    .AddColumn<types::Int64Value>(data)
+                    .AddColumn<types::StringValue>(strs)
+                    .get();
+      expected_rbs.push_back(rb);
+      tester.ConsumeNext(rb, 5, 0);
+    }
+    tester.Close();
+
+    EXPECT_TRUE(actual_protos[0].query_result().initiate_result_stream());
+    for (size_t i = 0; i < expected_rbs.size(); ++i) {
+      auto* result = actual_protos[i + 1].mutable_query_result();
+      ASSERT_TRUE(result->has_arrow_row_batch());
+      EXPECT_EQ(0, result->grpc_source_id());
+      EXPECT_EQ(encoding == planpb::GRPCSinkOperator::ARROW_DEFLATE,
+                result->arrow_row_batch().deflated());
+      ASSERT_OK_AND_ASSIGN(auto actual_rb,
+                           RowBatch::FromArrowProto(result->mutable_arrow_row_batch()));
+      EXPECT_EQ(expected_rbs[i].num_rows(), actual_rb->num_rows());
+      EXPECT_EQ(expected_rbs[i].eos(), actual_rb->eos());
+      EXPECT_EQ(expected_rbs[i].eow(), actual_rb->eow());
+      for (int64_t col = 0; col < actual_rb->num_columns(); ++col) {
+        EXPECT_TRUE(expected_rbs[i].ColumnAt(col)->Equals(actual_rb->ColumnAt(col)));
+      }
+    }
+  }
+}
+
 constexpr char kExpectedExternalInitialization[] = R"proto(
 address: "localhost:1234"
 query_id {
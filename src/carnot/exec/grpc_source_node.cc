@@ -72,6 +72,12 @@ Status GRPCSourceNode::PopRowBatch() {
         "Called GRPCSourceNode::OptionallyPopRowBatch but there was no available row batch in the "
         "queue.");
   }
+  if (rb_request->has_query_result() && rb_request->query_result().has_arrow_row_batch()) {
+    // The arrow body is moved out of the request and the columns point into it.
+    PL_ASSIGN_OR_RETURN(rb_, RowBatch::FromArrowProto(
+                                 rb_request->mutable_query_result()->mutable_arrow_row_batch()));
+    return Status::OK();
+  }
   if (!rb_request->has_query_result() || !rb_request->query_result().has_row_batch()) {
     return error::Internal(
         "GRPCSourceNode::PopRowBatch expected TransferResultChunkRequest to have RowBatch "
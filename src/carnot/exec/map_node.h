@@ -49,6 +49,8 @@ class MapNode : public ProcessingNode {
   Status CloseImpl(ExecState* exec_state) override;
   Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                          size_t parent_index) override;
+  // Pure UDFs are evaluated once per dictionary value and STRING results stay encoded.
+  bool AcceptsDictionaryColumns() const override { return true; }
 
  private:
   std::unique_ptr<ExpressionEvaluator> evaluator_;
@@ -21,7 +21,10 @@
 #include <memory>
 #include <vector>
 
+#include <absl/strings/ascii.h>
+#include <absl/strings/substitute.h>
 #include <gmock/gmock.h>
+#include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 #include <sole.hpp>
 
@@ -51,6 +54,30 @@ class AddUDF : public udf::ScalarUDF {
   }
 };
 
+class UpperUDF : public udf::ScalarUDF {
+ public:
+  static constexpr bool IsPure() { return true; }
+  types::StringValue Exec(FunctionContext*, types::StringValue v) {
+    ++exec_count;
+    return absl::AsciiStrToUpper(v);
+  }
+
+  static inline int exec_count = 0;
+};
+
+constexpr char kUpperScalarFuncPbtxt[] = R"(
+func {
+  name: "upper"
+  id: 1
+  args {
+    column {
+      node: 0
+      index: 0
+    }
+  }
+  args_data_types: STRING
+})";
+
 class MapNodeTest : public ::testing::Test {
  public:
   MapNodeTest() {
@@ -59,6 +86,7 @@ class MapNodeTest : public ::testing::Test {
 
     func_registry_ = std::make_unique<udf::Registry>("test_registry");
     EXPECT_OK(func_registry_->Register<AddUDF>("add"));
+    EXPECT_OK(func_registry_->Register<UpperUDF>("upper"));
     auto table_store = std::make_shared<table_store::TableStore>();
 
     exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
@@ -66,6 +94,7 @@ class MapNodeTest : public ::testing::Test {
                                               MockTraceStubGenerator, sole::uuid4(), nullptr);
     EXPECT_OK(exec_state_->AddScalarUDF(
         0, "add", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
+    EXPECT_OK(exec_state_->AddScalarUDF(1, "upper", {types::DataType::STRING}));
   }
 
  protected:
@@ -131,6 +160,42 @@ TEST_F(MapNodeTest, zero_row_row_batch) {
       .Close();
 }
 
+TEST_F(MapNodeTest, dictionary_output) {
+  auto map_pbtxt = absl::Substitute(planpb::testutils::kMapOperatorTmpl, kUpperScalarFuncPbtxt);
+  planpb::Operator op_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      absl::Substitute(planpb::testutils::kOperatorProtoTmpl, "MAP_OPERATOR", "map_op", map_pbtxt),
+      &op_proto));
+  auto plan_node = plan::MapOperator::FromProto(op_proto, 1);
+  RowDescriptor input_rd({types::DataType::STRING});
+  RowDescriptor output_rd({types::DataType::STRING});
+
+  auto tester = exec::ExecNodeTester<MapNode, plan::MapOperator>(*plan_node, output_rd, {},
+                                                                 exec_state_.get());
+  UpperUDF::exec_count = 0;
+  tester.KeepDictionaryColumns()
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({"a", "b", "a", "a"})
+                       .get(),
+                   0)
+      // A pure STRING UDF produces a column holding each distinct result once.
+      .ExpectDictionaryColumn(0, 2)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, false, false)
+                          .AddColumn<types::StringValue>({"A", "B", "A", "A"})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, true, true)
+                       .AddDictionaryColumn({1, 0, 1}, {"x", "y"})
+                       .get(),
+                   0)
+      // On a dictionary encoded argument it runs on the dictionary and keeps the codes.
+      .ExpectDictionaryColumn(0, 2)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<types::StringValue>({"Y", "X", "Y"})
+                          .get())
+      .Close();
+  EXPECT_EQ(4, UpperUDF::exec_count);
+}
+
 TEST_F(MapNodeTest, child_fail) {
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
   RowDescriptor output_rd({types::DataType::INT64});
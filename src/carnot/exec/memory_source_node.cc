@@ -19,10 +19,14 @@
 #include "src/carnot/exec/memory_source_node.h"
 #include "src/table_store/table/table.h"
 
+#include <arrow/array/concatenate.h>
+#include <arrow/memory_pool.h>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/planpb/plan.pb.h"
@@ -34,6 +38,7 @@ namespace exec {
 
 using StartSpec = Table::Cursor::StartSpec;
 using StopSpec = Table::Cursor::StopSpec;
+using table_store::schema::RowDescriptor;
 
 std::string MemorySourceNode::DebugStringImpl() {
   return absl::Substitute("Exec::MemorySourceNode: <name: $0, output: $1>", plan_node_->TableName(),
@@ -52,13 +57,27 @@ Status MemorySourceNode::InitImpl(const plan::Operator& plan_node) {
 Status MemorySourceNode::PrepareImpl(ExecState*) { return Status::OK(); }
 
 Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
-  table_ = exec_state->table_store()->GetTable(plan_node_->TableName(), plan_node_->Tablet());
-  DCHECK(table_ != nullptr);
-
   infinite_stream_ = plan_node_->infinite_stream();
-
-  if (table_ == nullptr) {
-    return error::NotFound("Table '$0' not found", plan_node_->TableName());
+  multi_tablet_ = !plan_node_->Tablets().empty();
+
+  std::vector<Table*> tables;
+  if (multi_tablet_) {
+    // The planner prunes the tablet list, so a tablet that has since gone away (or was never
+    // created on this agent) simply contributes no rows.
+    for (const auto& tablet : plan_node_->Tablets()) {
+      Table* table = exec_state->table_store()->GetTable(plan_node_->TableName(), tablet);
+      if (table != nullptr) {
+        tables.push_back(table);
+      }
+    }
+  } else {
+    Table* table =
+        exec_state->table_store()->GetTable(plan_node_->TableName(), plan_node_->Tablet());
+    DCHECK(table != nullptr);
+    if (table == nullptr) {
+      return error::NotFound("Table '$0' not found", plan_node_->TableName());
+    }
+    tables.push_back(table);
   }
 
   StartSpec start_spec;
@@ -79,30 +98,106 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
     // Determine table_end at Open() time because Stirling may be pushing to the table
     stop_spec.type = StopSpec::StopType::CurrentEndOfTable;
   }
-  cursor_ = std::make_unique<Table::Cursor>(table_, start_spec, stop_spec);
+  for (Table* table : tables) {
+    cursors_.push_back(std::make_unique<Table::Cursor>(table, start_spec, stop_spec));
+  }
 
   return Status::OK();
 }
 
 Status MemorySourceNode::CloseImpl(ExecState*) {
   stats()->AddExtraInfo("infinite_stream", infinite_stream_ ? "true" : "false");
+  if (multi_tablet_) {
+    stats()->AddExtraInfo("tablets", absl::StrCat(cursors_.size()));
+  }
   return Status::OK();
 }
 
+bool MemorySourceNode::CursorsDone() {
+  for (const auto& cursor : cursors_) {
+    if (!cursor->Done()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::MergeRowBatches(
+    const std::vector<std::unique_ptr<RowBatch>>& row_batches, bool eos) {
+  int64_t num_rows = 0;
+  for (const auto& rb : row_batches) {
+    num_rows += rb->num_rows();
+  }
+
+  auto output_rb = std::make_unique<RowBatch>(*output_descriptor_, num_rows);
+  arrow::ArrayVector columns(row_batches.size());
+  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
+    for (const auto& [j, rb] : Enumerate(row_batches)) {
+      columns[j] = rb->ColumnAt(static_cast<int64_t>(i));
+    }
+    std::shared_ptr<arrow::Array> merged;
+    PL_RETURN_IF_ERROR(arrow::Concatenate(columns, arrow::default_memory_pool(), &merged));
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(merged));
+  }
+  output_rb->set_eow(eos);
+  output_rb->set_eos(eos);
+  return output_rb;
+}
+
+// Reads from the cursors round-robin until enough rows are gathered for one output batch. Tablets
+// tend to be small, so merging their batches keeps downstream nodes from paying per-batch overhead
+// once per tablet. A single batch is passed through without copying.
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextTabletsRowBatch() {
+  std::vector<std::unique_ptr<RowBatch>> row_batches;
+  size_t num_rows = 0;
+  size_t num_idle = 0;
+  while (num_rows < kTabletScanRowBatchSize && !cursors_.empty() && num_idle < cursors_.size()) {
+    auto& cursor = cursors_[next_cursor_];
+    next_cursor_ = (next_cursor_ + 1) % cursors_.size();
+    if (!cursor->NextBatchReady()) {
+      ++num_idle;
+      continue;
+    }
+    num_idle = 0;
+    PL_ASSIGN_OR_RETURN(auto row_batch, cursor->GetNextRowBatch(plan_node_->Columns()));
+    num_rows += row_batch->num_rows();
+    row_batches.push_back(std::move(row_batch));
+  }
+
+  bool eos = CursorsDone() && !infinite_stream_;
+  if (row_batches.empty()) {
+    return RowBatch::WithZeroRows(*output_descriptor_, /* eow */ eos, /* eos */ eos);
+  }
+  if (row_batches.size() == 1) {
+    auto row_batch = std::move(row_batches[0]);
+    row_batch->set_eow(eos);
+    row_batch->set_eos(eos);
+    return row_batch;
+  }
+  return MergeRowBatches(row_batches, eos);
+}
+
 StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*) {
-  DCHECK(table_ != nullptr);
+  if (multi_tablet_) {
+    PL_ASSIGN_OR_RETURN(auto row_batch, GetNextTabletsRowBatch());
+    rows_processed_ += row_batch->num_rows();
+    bytes_processed_ += row_batch->NumBytes();
+    return row_batch;
+  }
 
-  if (!cursor_->NextBatchReady()) {
+  DCHECK_EQ(cursors_.size(), 1U);
+  auto& cursor = cursors_[0];
+  if (!cursor->NextBatchReady()) {
     // If the NextBatch is not ready, but the cursor is not yet exhausted, then we need to output
     // 0-row row batches, while we wait for more data to be added. This currently only occurs in the
     // case of an infinite stream. In the future, it should also occur when a stop time is set in
     // the future, but this is not yet supported by Table.
     // If the cursor is exhausted, then we return a 0-row row batch with eow=eos=true.
-    return RowBatch::WithZeroRows(*output_descriptor_, /* eow */ cursor_->Done(),
-                                  /* eos */ cursor_->Done());
+    return RowBatch::WithZeroRows(*output_descriptor_, /* eow */ cursor->Done(),
+                                  /* eos */ cursor->Done());
   }
 
-  PL_ASSIGN_OR_RETURN(auto row_batch, cursor_->GetNextRowBatch(plan_node_->Columns()));
+  PL_ASSIGN_OR_RETURN(auto row_batch, cursor->GetNextRowBatch(plan_node_->Columns()));
 
   rows_processed_ += row_batch->num_rows();
   bytes_processed_ += row_batch->NumBytes();
@@ -110,7 +205,7 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
   // If infinite stream is set, we don't send Eow or Eos. Infinite streams therefore never cause
   // HasBatchesRemaining to be false. Instead the outer loop that calls GenerateNext() is
   // responsible for managing whether we continue the stream or end it.
-  if (cursor_->Done() && !infinite_stream_) {
+  if (cursor->Done() && !infinite_stream_) {
     row_batch->set_eow(true);
     row_batch->set_eos(true);
   }
@@ -123,7 +218,14 @@ Status MemorySourceNode::GenerateNextImpl(ExecState* exec_state) {
   return Status::OK();
 }
 
-bool MemorySourceNode::InfiniteStreamNextBatchReady() { return cursor_->NextBatchReady(); }
+bool MemorySourceNode::InfiniteStreamNextBatchReady() {
+  for (const auto& cursor : cursors_) {
+    if (cursor->NextBatchReady()) {
+      return true;
+    }
+  }
+  return false;
+}
 
 bool MemorySourceNode::NextBatchReady() {
   // Next batch is ready if we haven't seen an eow and if it's an infinite_stream that has batches
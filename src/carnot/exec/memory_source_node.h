@@ -39,6 +39,9 @@ namespace exec {
 using table_store::Table;
 using table_store::schema::RowBatch;
 
+// Rows to gather from the tablets of a multi-tablet scan before emitting a row batch.
+constexpr size_t kTabletScanRowBatchSize = 1024;
+
 class MemorySourceNode : public SourceNode {
  public:
   MemorySourceNode() = default;
@@ -56,15 +59,23 @@ class MemorySourceNode : public SourceNode {
 
  private:
   StatusOr<std::unique_ptr<RowBatch>> GetNextRowBatch(ExecState* exec_state);
+  StatusOr<std::unique_ptr<RowBatch>> GetNextTabletsRowBatch();
+  StatusOr<std::unique_ptr<RowBatch>> MergeRowBatches(
+      const std::vector<std::unique_ptr<RowBatch>>& row_batches, bool eos);
   bool InfiniteStreamNextBatchReady();
+  bool CursorsDone();
   // Whether this memory source will stream infinitely. Can be stopped by the
   // exec_state_->keep_running() call in exec_graph.
   bool infinite_stream_ = false;
 
-  std::unique_ptr<Table::Cursor> cursor_;
+  // Whether the plan asked for a set of tablets rather than a single table.
+  bool multi_tablet_ = false;
+  // One cursor per table being read. Tablets that did not exist at Open() have no cursor.
+  std::vector<std::unique_ptr<Table::Cursor>> cursors_;
+  // The cursor to pull from first on the next multi-tablet batch, so tablets are read fairly.
+  size_t next_cursor_ = 0;
 
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
-  table_store::Table* table_ = nullptr;
 };
 
 }  // namespace exec
@@ -325,6 +325,53 @@ TEST_F(MemorySourceNodeTabletTest, multiple_tablet_test) {
   EXPECT_EQ(0, tester.node()->BytesProcessed());
 }
 
+// Test that a scan over several tablets merges them and skips tablets that don't exist.
+TEST_F(MemorySourceNodeTabletTest, scan_tablets_merges_batches) {
+  types::TabletID other_tablet_id = "456";
+  std::shared_ptr<Table> other_tablet = Table::Create(table_name_, rel);
+  auto rb = RowBatch(RowDescriptor(rel.col_types()), 2);
+  std::vector<types::BoolValue> col1 = {true, true};
+  std::vector<types::Time64NSValue> col2 = {10, 11};
+  EXPECT_OK(rb.AddColumn(types::ToArrow(col1, arrow::default_memory_pool())));
+  EXPECT_OK(rb.AddColumn(types::ToArrow(col2, arrow::default_memory_pool())));
+  EXPECT_OK(other_tablet->WriteRowBatch(rb));
+  exec_state_->table_store()->AddTable(other_tablet, table_name_, table_id_, other_tablet_id);
+
+  auto op_proto =
+      planpb::testutils::CreateTestSourceWithTabletsPB({tablet_id_, "789", other_tablet_id});
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  EXPECT_TRUE(tester.node()->HasBatchesRemaining());
+  // The tablets are read round-robin and their batches merged into a single row batch.
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 7, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({1, 2, 3, 10, 11, 5, 6})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+  EXPECT_EQ(7, tester.node()->RowsProcessed());
+  EXPECT_EQ(sizeof(int64_t) * 7, tester.node()->BytesProcessed());
+}
+
+TEST_F(MemorySourceNodeTabletTest, scan_tablets_none_exist) {
+  auto op_proto = planpb::testutils::CreateTestSourceWithTabletsPB({"789"});
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  EXPECT_TRUE(tester.node()->HasBatchesRemaining());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 0, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+}
+
 using MemorySourceNodeTabletDeathTest = MemorySourceNodeTabletTest;
 TEST_F(MemorySourceNodeTabletDeathTest, missing_tablet_fails) {
   types::TabletID non_existant_tablet_value = "223";
@@ -395,7 +442,7 @@ TEST_F(MemorySourceNodeTest, table_compact_between_open_and_exec) {
   EXPECT_TRUE(tester.node()->HasBatchesRemaining());
 
   // Force a table compaction between MemorySource::Open and MemorySource::Exec.
-  EXPECT_OK(cpu_table_->CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(cpu_table_->CompactHotToCold());
 
   tester.GenerateNextResult().ExpectRowBatch(
       RowBatchBuilder(output_rd, 2, /*eow*/ false, /*eos*/ false)
@@ -404,7 +451,7 @@ TEST_F(MemorySourceNodeTest, table_compact_between_open_and_exec) {
   EXPECT_TRUE(tester.node()->HasBatchesRemaining());
 
   // Force a second compaction to check between Exec and a subsequent Exec.
-  EXPECT_OK(cpu_table_->CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(cpu_table_->CompactHotToCold());
 
   tester.GenerateNextResult().ExpectRowBatch(
       RowBatchBuilder(output_rd, 1, /*eow*/ true, /*eos*/ true)
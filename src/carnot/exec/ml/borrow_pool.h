@@ -17,17 +17,24 @@
  */
 
 #pragma once
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
-#include <absl/base/internal/spinlock.h>
-
 namespace px {
 namespace carnot {
 namespace exec {
 namespace ml {
 
+/**
+ * BorrowPool hands out unique ownership of pooled objects, which are returned to the pool when
+ * the borrowed pointer is destroyed. Each object remembers the thread that last returned it, and
+ * a borrowing thread prefers the object it used last so that per-object caches stay warm.
+ */
 template <typename T>
 class BorrowPool {
  public:
@@ -35,40 +42,77 @@ class BorrowPool {
   struct ReclaimDeleter {
     void operator()(T* ptr) {
       if (ptr != nullptr) {
-        absl::base_internal::SpinLockHolder l(pool_lock_);
-        StoredPtrType stored_ptr(ptr);
-        pool_->push_back(std::move(stored_ptr));
+        pool_->Add(StoredPtrType(ptr));
       }
     }
-    std::vector<StoredPtrType>* pool_;
-    absl::base_internal::SpinLock* pool_lock_;
+    BorrowPool<T>* pool_;
   };
   using BorrowedPtrType = std::unique_ptr<T, ReclaimDeleter>;
 
   void Add(StoredPtrType ptr) {
-    absl::base_internal::SpinLockHolder l(&pool_lock_);
-    pool_.push_back(std::move(ptr));
+    {
+      std::lock_guard<std::mutex> l(pool_lock_);
+      pool_.push_back(Entry{std::move(ptr), std::this_thread::get_id()});
+    }
+    pool_cv_.notify_one();
   }
 
+  /**
+   * Borrows an object if one is available, otherwise returns nullptr.
+   */
   BorrowedPtrType Borrow() {
-    absl::base_internal::SpinLockHolder l(&pool_lock_);
-    if (pool_.size() == 0) {
-      return nullptr;
-    }
-    auto raw_ptr = pool_.back().release();
-    pool_.pop_back();
-    BorrowedPtrType ptr(raw_ptr, ReclaimDeleter{&pool_, &pool_lock_});
-    return ptr;
+    std::lock_guard<std::mutex> l(pool_lock_);
+    return TakeLocked();
+  }
+
+  /**
+   * Borrows an object, blocking until one is returned if the pool is empty.
+   * Returns nullptr if none was returned within the timeout.
+   */
+  BorrowedPtrType BorrowWithTimeout(std::chrono::nanoseconds timeout) {
+    std::unique_lock<std::mutex> l(pool_lock_);
+    pool_cv_.wait_for(l, timeout, [this] { return !pool_.empty(); });
+    return TakeLocked();
+  }
+
+  /**
+   * Wraps an object that is not in the pool so that it joins the pool once it is released.
+   */
+  BorrowedPtrType Adopt(StoredPtrType ptr) {
+    return BorrowedPtrType(ptr.release(), ReclaimDeleter{this});
   }
 
   size_t Size() {
-    absl::base_internal::SpinLockHolder l(&pool_lock_);
+    std::lock_guard<std::mutex> l(pool_lock_);
     return pool_.size();
   }
 
  private:
-  std::vector<StoredPtrType> pool_ GUARDED_BY(pool_lock_);
-  absl::base_internal::SpinLock pool_lock_;
+  struct Entry {
+    StoredPtrType ptr;
+    std::thread::id last_thread;
+  };
+
+  BorrowedPtrType TakeLocked() {
+    if (pool_.empty()) {
+      return BorrowedPtrType(nullptr, ReclaimDeleter{this});
+    }
+    auto it = pool_.end() - 1;
+    auto this_thread = std::this_thread::get_id();
+    for (auto entry = pool_.begin(); entry != pool_.end(); ++entry) {
+      if (entry->last_thread == this_thread) {
+        it = entry;
+        break;
+      }
+    }
+    auto raw_ptr = it->ptr.release();
+    pool_.erase(it);
+    return BorrowedPtrType(raw_ptr, ReclaimDeleter{this});
+  }
+
+  std::mutex pool_lock_;
+  std::condition_variable pool_cv_;
+  std::vector<Entry> pool_;
 };
 
 }  // namespace ml
@@ -100,6 +100,38 @@ TEST(BorrowPool, threaded) {
   EXPECT_EQ(2, pool.Size());
 }
 
+TEST(BorrowPool, wait_for_return) {
+  BorrowPool<int> pool;
+  pool.Add(BorrowPool<int>::StoredPtrType(new int(1)));
+  auto ptr1 = pool.Borrow();
+  EXPECT_EQ(nullptr, pool.BorrowWithTimeout(std::chrono::milliseconds(1)));
+
+  std::thread releaser([&ptr1] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ptr1.reset();
+  });
+  auto ptr2 = pool.BorrowWithTimeout(std::chrono::seconds(10));
+  releaser.join();
+  ASSERT_NE(nullptr, ptr2);
+  EXPECT_EQ(1, *ptr2);
+}
+
+TEST(BorrowPool, prefers_last_used_by_thread) {
+  BorrowPool<int> pool;
+  pool.Add(BorrowPool<int>::StoredPtrType(new int(1)));
+  pool.Add(BorrowPool<int>::StoredPtrType(new int(2)));
+
+  // The other thread takes and returns 2, leaving it at the back of the pool. This thread should
+  // still get 1, which it added.
+  std::thread other([&pool] {
+    auto ptr = pool.Borrow();
+    EXPECT_EQ(2, *ptr);
+  });
+  other.join();
+  auto ptr = pool.Borrow();
+  EXPECT_EQ(1, *ptr);
+}
+
 }  // namespace ml
 }  // namespace exec
 }  // namespace carnot
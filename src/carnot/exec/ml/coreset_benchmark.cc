@@ -71,7 +71,7 @@ static void BM_CoresetTreeMerge(benchmark::State& state) {
 
 // NOLINTNEXTLINE : runtime/references.
 static void BM_CoresetFromWeightedPointSet(benchmark::State& state) {
-  int d = 65;
+  int d = state.range(0);
   Eigen::MatrixXf points = Eigen::MatrixXf::Random(4 * 64, d);
   auto set = std::make_shared<WeightedPointSet>(points, Eigen::VectorXf::Ones(4 * 64));
 
@@ -112,7 +112,7 @@ static void BM_CoresetDeserialize(benchmark::State& state) {
 }
 
 BENCHMARK(BM_CoresetTreeUpdate);
-BENCHMARK(BM_CoresetFromWeightedPointSet);
+BENCHMARK(BM_CoresetFromWeightedPointSet)->RangeMultiplier(2)->Range(64, 512);
 BENCHMARK(BM_CoresetTreeQuery);
 BENCHMARK(BM_CoresetTreeMerge);
 BENCHMARK(BM_CoresetSerialize);
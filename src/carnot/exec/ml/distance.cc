@@ -0,0 +1,183 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/ml/distance.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace px {
+namespace carnot {
+namespace exec {
+namespace ml {
+
+namespace {
+
+// Number of points whose distances are computed together. Keeps the distance block for a few
+// hundred centroids in cache.
+constexpr int64_t kBlockRows = 256;
+// Minimum number of multiply-adds to give each thread, below which threads cost more than they
+// save.
+constexpr int64_t kMinWorkPerThread = int64_t{1} << 24;
+
+/**
+ * A fixed set of worker threads shared by all queries, so that concurrent k-means runs don't each
+ * spawn a thread per core, and iterations don't pay for thread creation.
+ */
+class BlockThreadPool {
+ public:
+  static BlockThreadPool* Get() {
+    // Never destroyed, so that workers don't race with static destruction at exit.
+    static BlockThreadPool* pool =
+        new BlockThreadPool(std::max(1U, std::thread::hardware_concurrency()) - 1);
+    return pool;
+  }
+
+  // The number of threads that run tasks, including the caller of ParallelFor().
+  int64_t parallelism() const { return static_cast<int64_t>(workers_.size()) + 1; }
+
+  // Runs fn(i) for every i in [0, n), on the workers and on the calling thread. Returns once all
+  // of them are done.
+  void ParallelFor(int64_t n, std::function<void(int64_t)> fn) {
+    auto job = std::make_shared<Job>();
+    job->n = n;
+    job->fn = std::move(fn);
+    {
+      std::lock_guard<std::mutex> l(lock_);
+      for (int64_t i = 1; i < std::min(n, parallelism()); ++i) {
+        queue_.push_back(job);
+      }
+    }
+    cv_.notify_all();
+    job->Run();
+    std::unique_lock<std::mutex> l(job->lock);
+    job->done_cv.wait(l, [&job]() { return job->num_done == job->n; });
+  }
+
+ private:
+  struct Job {
+    // Claims and runs tasks until there are none left.
+    void Run() {
+      for (int64_t i = next++; i < n; i = next++) {
+        fn(i);
+        std::lock_guard<std::mutex> l(lock);
+        if (++num_done == n) {
+          done_cv.notify_all();
+        }
+      }
+    }
+
+    int64_t n = 0;
+    std::function<void(int64_t)> fn;
+    std::atomic<int64_t> next = 0;
+    std::mutex lock;
+    std::condition_variable done_cv;
+    int64_t num_done = 0;
+  };
+
+  explicit BlockThreadPool(int num_workers) {
+    for (int i = 0; i < num_workers; ++i) {
+      workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+  }
+
+  void WorkerLoop() {
+    while (true) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> l(lock_);
+        cv_.wait(l, [this]() { return !queue_.empty(); });
+        job = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      job->Run();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<Job>> queue_;
+};
+
+void AssignBlocks(const Eigen::MatrixXf& points, const Eigen::MatrixXf& centroids,
+                  const Eigen::VectorXf& centroid_norms, int64_t begin, int64_t end,
+                  Eigen::VectorXi* closest, Eigen::VectorXf* min_sq_dists) {
+  Eigen::MatrixXf dists;
+  for (int64_t start = begin; start < end; start += kBlockRows) {
+    int64_t rows = std::min(kBlockRows, end - start);
+    auto block = points.middleRows(start, rows);
+    // ||x||^2 is the same for every centroid, so it only matters for the reported distance.
+    dists.noalias() = block * centroids.transpose();
+    dists = (-2 * dists).rowwise() + centroid_norms.transpose();
+    for (int64_t i = 0; i < rows; ++i) {
+      Eigen::Index min_idx;
+      float min_dist = dists.row(i).minCoeff(&min_idx);
+      (*closest)(start + i) = static_cast<int>(min_idx);
+      if (min_sq_dists != nullptr) {
+        (*min_sq_dists)(start + i) = std::max(0.0f, min_dist + block.row(i).squaredNorm());
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void AssignToClosest(const Eigen::MatrixXf& points, const Eigen::MatrixXf& centroids,
+                     Eigen::VectorXi* closest, Eigen::VectorXf* min_sq_dists) {
+  DCHECK_EQ(points.cols(), centroids.cols());
+  DCHECK_GT(centroids.rows(), 0);
+  int64_t n = points.rows();
+  closest->resize(n);
+  if (min_sq_dists != nullptr) {
+    min_sq_dists->resize(n);
+  }
+  Eigen::VectorXf centroid_norms = centroids.rowwise().squaredNorm();
+
+  BlockThreadPool* pool = BlockThreadPool::Get();
+  int64_t work = n * centroids.rows() * centroids.cols();
+  int64_t num_blocks = (n + kBlockRows - 1) / kBlockRows;
+  int64_t num_tasks =
+      std::min<int64_t>({pool->parallelism(), num_blocks, work / kMinWorkPerThread});
+  if (num_tasks <= 1) {
+    AssignBlocks(points, centroids, centroid_norms, 0, n, closest, min_sq_dists);
+    return;
+  }
+
+  // Each task takes a contiguous range of whole blocks, so outputs never overlap.
+  int64_t blocks_per_task = (num_blocks + num_tasks - 1) / num_tasks;
+  pool->ParallelFor(num_tasks, [&](int64_t t) {
+    int64_t begin = t * blocks_per_task * kBlockRows;
+    int64_t end = std::min(n, begin + blocks_per_task * kBlockRows);
+    if (begin < end) {
+      AssignBlocks(points, centroids, centroid_norms, begin, end, closest, min_sq_dists);
+    }
+  });
+}
+
+}  // namespace ml
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/common/base/base.h"
+#include "third_party/eigen3/Eigen/Core"
+
+namespace px {
+namespace carnot {
+namespace exec {
+namespace ml {
+
+/**
+ * Finds the index of the closest centroid (row of centroids) for each point (row of points), and
+ * optionally the squared distance to it.
+ *
+ * Distances are computed a block of points at a time as ||x||^2 + ||c||^2 - 2x.c, so most of the
+ * work is one matrix product per block rather than a loop over points. Large inputs are split
+ * across a process-wide worker pool that all queries share.
+ */
+void AssignToClosest(const Eigen::MatrixXf& points, const Eigen::MatrixXf& centroids,
+                     Eigen::VectorXi* closest, Eigen::VectorXf* min_sq_dists = nullptr);
+
+}  // namespace ml
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
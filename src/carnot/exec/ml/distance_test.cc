@@ -0,0 +1,66 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/exec/ml/distance.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+namespace ml {
+
+TEST(AssignToClosest, matches_brute_force) {
+  for (int d : {2, 64, 300}) {
+    // Enough points for several blocks, with a partial last block.
+    Eigen::MatrixXf points = Eigen::MatrixXf::Random(1000, d);
+    Eigen::MatrixXf centroids = Eigen::MatrixXf::Random(7, d);
+
+    Eigen::VectorXi closest;
+    Eigen::VectorXf min_sq_dists;
+    AssignToClosest(points, centroids, &closest, &min_sq_dists);
+    ASSERT_EQ(points.rows(), closest.rows());
+    ASSERT_EQ(points.rows(), min_sq_dists.rows());
+
+    for (int i = 0; i < points.rows(); ++i) {
+      Eigen::Index expected;
+      float expected_dist =
+          (centroids.rowwise() - points.row(i)).rowwise().squaredNorm().minCoeff(&expected);
+      EXPECT_EQ(expected, closest(i)) << "d=" << d << " point=" << i;
+      EXPECT_NEAR(expected_dist, min_sq_dists(i), 1e-3 * expected_dist);
+    }
+  }
+}
+
+TEST(AssignToClosest, point_on_centroid) {
+  Eigen::MatrixXf centroids = Eigen::MatrixXf::Identity(3, 3);
+  Eigen::MatrixXf points = centroids;
+
+  Eigen::VectorXi closest;
+  Eigen::VectorXf min_sq_dists;
+  AssignToClosest(points, centroids, &closest, &min_sq_dists);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, closest(i));
+    EXPECT_FLOAT_EQ(0.0f, min_sq_dists(i));
+  }
+}
+
+}  // namespace ml
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -19,6 +19,7 @@
 #include "src/carnot/exec/ml/kmeans.h"
 #include <random>
 
+#include "src/carnot/exec/ml/distance.h"
 #include "src/carnot/exec/ml/sampling.h"
 
 namespace px {
@@ -52,14 +53,11 @@ bool KMeans::LloydsIteration(const Eigen::MatrixXf& points, const Eigen::VectorX
   Eigen::MatrixXf new_centroids = Eigen::MatrixXf::Zero(centroids_.rows(), centroids_.cols());
   Eigen::ArrayXf centroid_weights = Eigen::ArrayXf::Zero(centroids_.rows());
 
+  Eigen::VectorXi closest;
+  AssignToClosest(points, centroids_, &closest);
   for (int i = 0; i < points.rows(); i++) {
-    Eigen::VectorXf::Index closest_centroid;
-    (centroids_.rowwise() - points(i, Eigen::all))
-        .rowwise()
-        .squaredNorm()
-        .minCoeff(&closest_centroid);
-    new_centroids(closest_centroid, Eigen::all) += weights(i) * points(i, Eigen::all);
-    centroid_weights(closest_centroid) += weights(i);
+    new_centroids.row(closest(i)) += weights(i) * points.row(i);
+    centroid_weights(closest(i)) += weights(i);
   }
 
   for (int i = 0; i < k_; i++) {
@@ -82,20 +80,19 @@ void KMeans::KMeansPlusPlusInit(const Eigen::MatrixXf& points, const Eigen::Vect
   auto firstCentroid = dist(random_gen_);
   centroids_(0, Eigen::all) = points(firstCentroid, Eigen::all);
 
+  // The distance from each point to its closest chosen centroid only changes when the newest
+  // centroid is closer, so each round only needs the distances to that one centroid.
+  Eigen::VectorXf min_dists = (points.rowwise() - centroids_.row(0)).rowwise().squaredNorm();
   Eigen::VectorXf probDist(points.rows());
   for (auto i = 1; i < k_; i++) {
-    for (auto j = 0; j < probDist.rows(); j++) {
-      auto point = points(j, Eigen::all);
-      Eigen::VectorXf::Index closestCentroid;
-      auto dist = (centroids_(Eigen::seq(0, i - 1), Eigen::all).rowwise() - point)
-                      .rowwise()
-                      .squaredNorm()
-                      .minCoeff(&closestCentroid);
-      probDist(j) = weights(j) * dist;
-    }
+    probDist = weights.cwiseProduct(min_dists);
     std::discrete_distribution<> pointDist(probDist.begin(), probDist.end());
     auto ind = pointDist(random_gen_);
     centroids_(i, Eigen::all) = points(ind, Eigen::all);
+    if (i + 1 < k_) {
+      min_dists = min_dists.cwiseMin(
+          (points.rowwise() - centroids_.row(i)).rowwise().squaredNorm());
+    }
   }
 }
 
@@ -19,16 +19,18 @@
 #include <benchmark/benchmark.h>
 
 #include "src/carnot/exec/ml/coreset.h"
+#include "src/carnot/exec/ml/distance.h"
 #include "src/carnot/exec/ml/kmeans.h"
 #include "src/common/perf/perf.h"
 
+using px::carnot::exec::ml::AssignToClosest;
 using px::carnot::exec::ml::KMeans;
 using px::carnot::exec::ml::WeightedPointSet;
 
 // NOLINTNEXTLINE : runtime/references.
 static void BM_KMeansFit(benchmark::State& state) {
   int k = 10;
-  int d = 64;
+  int d = state.range(0);
   KMeans kmeans(k);
 
   Eigen::MatrixXf points = Eigen::MatrixXf::Random(500, d);
@@ -58,5 +60,50 @@ static void BM_KMeansTransform(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_KMeansFit);
+// NOLINTNEXTLINE : runtime/references.
+static void BM_AssignToClosest(benchmark::State& state) {
+  int k = 16;
+  int d = state.range(0);
+  Eigen::MatrixXf points = Eigen::MatrixXf::Random(state.range(1), d);
+  Eigen::MatrixXf centroids = Eigen::MatrixXf::Random(k, d);
+  Eigen::VectorXi closest;
+
+  for (auto _ : state) {
+    AssignToClosest(points, centroids, &closest);
+    benchmark::DoNotOptimize(closest.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.rows());
+}
+
+// The per-point loop that AssignToClosest replaced, kept as a baseline.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_AssignToClosestPerPoint(benchmark::State& state) {
+  int k = 16;
+  int d = state.range(0);
+  Eigen::MatrixXf points = Eigen::MatrixXf::Random(state.range(1), d);
+  Eigen::MatrixXf centroids = Eigen::MatrixXf::Random(k, d);
+  Eigen::VectorXi closest(points.rows());
+
+  for (auto _ : state) {
+    for (int i = 0; i < points.rows(); i++) {
+      Eigen::Index closest_centroid;
+      (centroids.rowwise() - points.row(i)).rowwise().squaredNorm().minCoeff(&closest_centroid);
+      closest(i) = closest_centroid;
+    }
+    benchmark::DoNotOptimize(closest.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.rows());
+}
+
+static void DistanceArgs(benchmark::internal::Benchmark* b) {
+  for (int d = 64; d <= 512; d *= 2) {
+    for (int n : {1000, 100000}) {
+      b->Args({d, n});
+    }
+  }
+}
+
+BENCHMARK(BM_KMeansFit)->RangeMultiplier(2)->Range(64, 512);
 BENCHMARK(BM_KMeansTransform);
+BENCHMARK(BM_AssignToClosest)->Apply(DistanceArgs);
+BENCHMARK(BM_AssignToClosestPerPoint)->Apply(DistanceArgs);
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -36,6 +38,12 @@ enum ModelType {
 class ModelExecutor {
  public:
   virtual ~ModelExecutor() = default;
+
+  /**
+   * The approximate number of bytes this executor may hold while running, including buffers it
+   * only grows into for large batches. Used to size the ModelPool.
+   */
+  virtual int64_t MemoryUsage() const { return 0; }
 };
 
 }  // namespace ml
@@ -18,37 +18,56 @@
 
 #pragma once
 
-#include <absl/base/internal/spinlock.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <utility>
 
+#include <prometheus/counter.h>
+
 #include "src/carnot/exec/ml/borrow_pool.h"
 #include "src/carnot/exec/ml/model_executor.h"
+#include "src/common/base/base.h"
+#include "src/common/metrics/metrics.h"
 
 namespace px {
 namespace carnot {
 namespace exec {
 namespace ml {
 
+/**
+ * ModelPool lends out model executors. Each model type gets its own pool, which grows by one
+ * executor whenever a borrower finds it empty, as long as the executors of all models stay within
+ * the memory budget and the pool stays within the per-model limit. Otherwise borrowers block
+ * until an executor is returned.
+ */
 class ModelPool {
  public:
   using PoolType = BorrowPool<ModelExecutor>;
   using PtrType = PoolType::BorrowedPtrType;
 
-  static std::unique_ptr<ModelPool> Create() { return std::make_unique<ModelPool>(); }
+  static constexpr int64_t kDefaultMemoryBudgetBytes = 1024 * 1024 * 1024;
 
-  template <typename TExecutor, typename... Args>
-  void CreatePool(Args... args) {
-    // TODO(james, PP-2594): currently if you ask for the same type of model with different args the
-    // pool will return the first args asked for.
-    auto pool = std::make_unique<PoolType>();
-    pool->Add(std::make_unique<TExecutor>(args...));
-    pool_map_[TExecutor::Type()] = std::move(pool);
+  static std::unique_ptr<ModelPool> Create() {
+    return Create(kDefaultMemoryBudgetBytes, std::max(1U, std::thread::hardware_concurrency()));
+  }
+  static std::unique_ptr<ModelPool> Create(int64_t memory_budget_bytes,
+                                           size_t max_executors_per_model) {
+    return std::make_unique<ModelPool>(memory_budget_bytes, max_executors_per_model);
   }
 
+  ModelPool(int64_t memory_budget_bytes, size_t max_executors_per_model)
+      : memory_budget_bytes_(memory_budget_bytes),
+        max_executors_per_model_(max_executors_per_model),
+        waits_counter_(BuildCounter("carnot_model_pool_waits",
+                                    "Number of times a query waited for a model executor")),
+        wait_time_counter_(BuildCounter("carnot_model_pool_wait_time_us",
+                                        "Total time queries spent waiting for model executors")) {}
+
   template <typename TExecutor>
   struct DerivedDeleter {
     void operator()(TExecutor* ptr) { deleter_(ptr); }
@@ -57,19 +76,95 @@ class ModelPool {
 
   template <typename TExecutor, typename... Args>
   std::unique_ptr<TExecutor, DerivedDeleter<TExecutor>> GetModelExecutor(Args... args) {
-    if (pool_map_.find(TExecutor::Type()) == pool_map_.end()) {
-      CreatePool<TExecutor>(args...);
+    // TODO(james, PP-2594): currently if you ask for the same type of model with different args the
+    // pool will return the first args asked for.
+    auto ptr = Borrow<TExecutor>(args...);
+    auto deleter = ptr.get_deleter();
+    return std::unique_ptr<TExecutor, DerivedDeleter<TExecutor>>(
+        static_cast<TExecutor*>(ptr.release()), DerivedDeleter<TExecutor>{deleter});
+  }
+
+  // The number of times, and the total time, borrowers waited for an executor to be returned.
+  int64_t num_waits() const { return num_waits_; }
+  std::chrono::microseconds total_wait_time() const {
+    return std::chrono::microseconds(total_wait_us_);
+  }
+  size_t NumExecutors(ModelType type) {
+    std::lock_guard<std::mutex> l(lock_);
+    auto it = models_.find(type);
+    return it == models_.end() ? 0 : it->second.num_executors;
+  }
+
+ private:
+  struct ModelEntry {
+    std::unique_ptr<PoolType> pool;
+    size_t num_executors = 0;
+    int64_t executor_bytes = 0;
+  };
+
+  template <typename TExecutor, typename... Args>
+  PtrType Borrow(Args... args) {
+    ModelEntry* entry;
+    bool grow = false;
+    {
+      std::lock_guard<std::mutex> l(lock_);
+      auto [it, inserted] = models_.try_emplace(TExecutor::Type());
+      entry = &it->second;
+      if (inserted) {
+        // The first executor is always created, and tells us how much each one costs at its
+        // largest batch size.
+        entry->pool = std::make_unique<PoolType>();
+        auto executor = std::make_unique<TExecutor>(args...);
+        entry->executor_bytes = executor->MemoryUsage();
+        entry->num_executors = 1;
+        used_bytes_ += entry->executor_bytes;
+        return entry->pool->Adopt(std::move(executor));
+      }
+      auto ptr = entry->pool->Borrow();
+      if (ptr != nullptr) {
+        return ptr;
+      }
+      if (entry->num_executors < max_executors_per_model_ &&
+          used_bytes_ + entry->executor_bytes <= memory_budget_bytes_) {
+        // Reserve the executor before releasing the lock, so concurrent borrowers can't overshoot
+        // the budget.
+        ++entry->num_executors;
+        used_bytes_ += entry->executor_bytes;
+        grow = true;
+      }
     }
-    auto ptr = pool_map_[TExecutor::Type()]->Borrow();
+    if (grow) {
+      return entry->pool->Adopt(std::make_unique<TExecutor>(args...));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto ptr = entry->pool->BorrowWithTimeout(kWaitLogInterval);
     while (ptr == nullptr) {
-      ptr = pool_map_[TExecutor::Type()]->Borrow();
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      LOG(INFO) << "Still waiting for a model executor, consider increasing the model pool budget";
+      ptr = entry->pool->BorrowWithTimeout(kWaitLogInterval);
     }
-    return std::unique_ptr<TExecutor, DerivedDeleter<TExecutor>>(
-        static_cast<TExecutor*>(ptr.release()), DerivedDeleter<TExecutor>{ptr.get_deleter()});
+    auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    ++num_waits_;
+    total_wait_us_ += waited.count();
+    waits_counter_.Increment();
+    wait_time_counter_.Increment(waited.count());
+    return ptr;
   }
 
-  std::unordered_map<ModelType, std::unique_ptr<PoolType>> pool_map_;
+  static constexpr std::chrono::seconds kWaitLogInterval{10};
+
+  const int64_t memory_budget_bytes_;
+  const size_t max_executors_per_model_;
+
+  std::mutex lock_;
+  std::unordered_map<ModelType, ModelEntry> models_;
+  int64_t used_bytes_ = 0;
+
+  std::atomic<int64_t> num_waits_ = 0;
+  std::atomic<int64_t> total_wait_us_ = 0;
+  prometheus::Counter& waits_counter_;
+  prometheus::Counter& wait_time_counter_;
 };
 
 }  // namespace ml
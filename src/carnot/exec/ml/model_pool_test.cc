@@ -19,6 +19,8 @@
 #include "src/carnot/exec/ml/model_pool.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
 #include "src/carnot/exec/ml/transformer_executor.h"
 
 DEFINE_string(embedding_dir, "", "Path to embedding.proto");
@@ -34,6 +36,46 @@ TEST(ModelPool, basic) {
   EXPECT_EQ(kTransformer, executor->Type());
 }
 
+class FakeExecutor : public ModelExecutor {
+ public:
+  static constexpr ModelType Type() { return kTransformer; }
+  int64_t MemoryUsage() const override { return 100; }
+};
+
+TEST(ModelPool, grows_within_budget) {
+  auto p = ModelPool::Create(/* memory_budget_bytes */ 250, /* max_executors_per_model */ 8);
+  auto executor1 = p->GetModelExecutor<FakeExecutor>();
+  auto executor2 = p->GetModelExecutor<FakeExecutor>();
+  EXPECT_NE(executor1.get(), executor2.get());
+  EXPECT_EQ(2, p->NumExecutors(kTransformer));
+
+  // A third executor would exceed the budget, so the borrower waits for one to be returned.
+  FakeExecutor* returned = executor1.get();
+  std::thread releaser([&executor1] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    executor1.reset();
+  });
+  auto executor3 = p->GetModelExecutor<FakeExecutor>();
+  releaser.join();
+  EXPECT_EQ(returned, executor3.get());
+  EXPECT_EQ(2, p->NumExecutors(kTransformer));
+  EXPECT_EQ(1, p->num_waits());
+  EXPECT_GE(p->total_wait_time(), std::chrono::milliseconds(40));
+}
+
+TEST(ModelPool, reuses_returned_executor) {
+  auto p = ModelPool::Create(/* memory_budget_bytes */ 1000, /* max_executors_per_model */ 1);
+  FakeExecutor* first;
+  {
+    auto executor = p->GetModelExecutor<FakeExecutor>();
+    first = executor.get();
+  }
+  auto executor = p->GetModelExecutor<FakeExecutor>();
+  EXPECT_EQ(first, executor.get());
+  EXPECT_EQ(1, p->NumExecutors(kTransformer));
+  EXPECT_EQ(0, p->num_waits());
+}
+
 }  // namespace ml
 }  // namespace exec
 }  // namespace carnot
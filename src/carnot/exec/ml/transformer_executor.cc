@@ -16,6 +16,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+
 #include "src/carnot/exec/ml/transformer_executor.h"
 
 namespace px {
@@ -23,9 +25,9 @@ namespace carnot {
 namespace exec {
 namespace ml {
 
-static int load_ints_from_json(std::string in, int32_t* arr, int max_num) {
+static int load_ints_from_json(std::string_view in, int32_t* arr, int max_num) {
   rapidjson::Document d;
-  rapidjson::ParseResult ok = d.Parse(in.data());
+  rapidjson::ParseResult ok = d.Parse(in.data(), in.size());
   // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
   if (ok == nullptr) {
     return 0;
@@ -49,54 +51,135 @@ static int load_ints_from_json(std::string in, int32_t* arr, int max_num) {
   return count;
 }
 
-void TransformerExecutor::Execute(std::string doc, std::string* out) {
-  // LOG(INFO) << "inputs: " << tf_interpreter_->inputs().size() << "\n";
-  // LOG(INFO) << "input(0) name: " << tf_interpreter_->GetInputName(0) << "\n";
-
-  // int t_size = tf_interpreter_->tensors_size();
-  // for (int i = 0; i < t_size; i++) {
-  //   if (tf_interpreter_->tensor(i)->name) {
-  //     LOG(INFO) << i << ": " << tf_interpreter_->tensor(i)->name << ", "
-  //               << tf_interpreter_->tensor(i)->bytes << ", "
-  //               << tf_interpreter_->tensor(i)->type;
-  //   }
-  // }
-  auto input = tf_interpreter_->typed_input_tensor<int32_t>(0);
-  if (input == nullptr) {
-    LOG(INFO) << "Error getting typed input tensor, most likely using wrong type for this model";
-    *out = "";
-    return;
+int64_t TransformerExecutor::MemoryUsage() const {
+  int64_t bytes = model_->allocation() == nullptr ? 0 : model_->allocation()->bytes();
+  // Activations are sized for the current batch, and ResizeBatch() grows them up to
+  // max_batch_size_ documents, so count them at that size.
+  const int batch_size = std::max(batch_size_, 1);
+  for (size_t i = 0; i < tf_interpreter_->tensors_size(); ++i) {
+    const TfLiteTensor* tensor = tf_interpreter_->tensor(i);
+    if (tensor->allocation_type == kTfLiteArenaRw) {
+      bytes += static_cast<int64_t>(tensor->bytes) / batch_size * max_batch_size_;
+    } else {
+      bytes += tensor->bytes;
+    }
   }
+  return bytes;
+}
 
-  auto count = load_ints_from_json(doc, input, max_length_);
-  if (count == 0) {
-    // Either input array was empty or there was an error parsing the json, either way don't
-    // continue.
-    *out = "";
-    return;
+StatusOr<int> TransformerExecutor::ResizeBatch(int batch_size) {
+  batch_size = std::min(batch_size, max_batch_size_);
+  // Never shrink the input: short chunks are padded instead, so the interpreter's arena is only
+  // reallocated when the batch grows.
+  if (batch_size <= batch_size_) {
+    return batch_size_;
   }
-
-  // Add 1 to each token to account for pad token.
-  for (int i = 0; i < count; i++) {
-    input[i] = input[i] + 1;
+  tf_interpreter_->ResizeInputTensor(tf_interpreter_->inputs()[0], {batch_size, max_length_});
+  if (tf_interpreter_->AllocateTensors() == kTfLiteOk) {
+    batch_size_ = batch_size;
+    return batch_size_;
+  }
+  LOG(INFO) << "Failed to allocate tensors for batch size " << batch_size
+            << ", falling back to single document batches";
+  max_batch_size_ = 1;
+  tf_interpreter_->ResizeInputTensor(tf_interpreter_->inputs()[0], {1, max_length_});
+  if (tf_interpreter_->AllocateTensors() != kTfLiteOk) {
+    // Leave the batch size unset, so the next call tries to allocate again.
+    batch_size_ = 0;
+    return error::ResourceUnavailable("Failed to allocate tensors for the transformer model");
   }
+  batch_size_ = 1;
+  return batch_size_;
+}
 
-  for (int i = count; i < max_length_; i++) {
-    input[i] = 0;
+Status TransformerExecutor::RunBatch(const std::vector<int32_t>& batch_tokens,
+                                     const std::vector<size_t>& batch_rows,
+                                     std::vector<float>* embeddings, std::vector<bool>* valid) {
+  DCHECK_EQ(batch_tokens.size(), batch_rows.size() * max_length_);
+  size_t done = 0;
+  while (done < batch_rows.size()) {
+    // The interpreter may hold more documents than are left, in which case the rest of its input
+    // is padded and the outputs for the padding are ignored. It may also hold fewer, in which case
+    // the rows are run in chunks of whatever batch size it could allocate.
+    PL_ASSIGN_OR_RETURN(int batch_size,
+                        ResizeBatch(static_cast<int>(batch_rows.size() - done)));
+    int num_docs = std::min(batch_size, static_cast<int>(batch_rows.size() - done));
+    auto input = tf_interpreter_->typed_input_tensor<int32_t>(0);
+    std::copy(batch_tokens.begin() + done * max_length_,
+              batch_tokens.begin() + (done + num_docs) * max_length_, input);
+    std::fill(input + num_docs * max_length_, input + batch_size * max_length_, 0);
+    if (tf_interpreter_->Invoke() != kTfLiteOk) {
+      return error::Internal("Failed to invoke the transformer model");
+    }
+    auto output = tf_interpreter_->typed_output_tensor<float>(0);
+    for (int i = 0; i < num_docs; ++i) {
+      size_t row = batch_rows[done + i];
+      std::copy(output + i * kEmbeddingSize, output + (i + 1) * kEmbeddingSize,
+                embeddings->begin() + row * kEmbeddingSize);
+      (*valid)[row] = true;
+    }
+    done += num_docs;
   }
+  return Status::OK();
+}
 
-  const int embedding_size = 256;
+Status TransformerExecutor::ExecuteBatch(const std::vector<std::string_view>& docs,
+                                         std::vector<float>* embeddings,
+                                         std::vector<bool>* valid) {
+  embeddings->resize(docs.size() * kEmbeddingSize);
+  valid->assign(docs.size(), false);
+  if (tf_interpreter_->typed_input_tensor<int32_t>(0) == nullptr) {
+    LOG(INFO) << "Error getting typed input tensor, most likely using wrong type for this model";
+    return Status::OK();
+  }
 
-  tf_interpreter_->Invoke();
+  // Tokens are parsed into a staging buffer first so that documents which fail to parse don't
+  // take up a slot in the batch.
+  std::vector<int32_t> tokens(max_length_);
+  std::vector<int32_t> batch_tokens;
+  std::vector<size_t> batch_rows;
+  for (size_t row = 0; row < docs.size(); ++row) {
+    auto count = load_ints_from_json(docs[row], tokens.data(), max_length_);
+    if (count == 0) {
+      // Either input array was empty or there was an error parsing the json, either way don't
+      // embed this document.
+      continue;
+    }
+    // Add 1 to each token to account for pad token.
+    for (int i = 0; i < count; i++) {
+      batch_tokens.push_back(tokens[i] + 1);
+    }
+    batch_tokens.resize(batch_tokens.size() + max_length_ - count, 0);
+    batch_rows.push_back(row);
+    if (static_cast<int>(batch_rows.size()) == kMaxBatchSize) {
+      PL_RETURN_IF_ERROR(RunBatch(batch_tokens, batch_rows, embeddings, valid));
+      batch_tokens.clear();
+      batch_rows.clear();
+    }
+  }
+  return RunBatch(batch_tokens, batch_rows, embeddings, valid);
+}
 
-  auto output = tf_interpreter_->typed_output_tensor<float>(0);
+void TransformerExecutor::Execute(std::string doc, std::string* out) {
+  std::vector<float> embedding;
+  std::vector<bool> valid;
+  Status s = ExecuteBatch({doc}, &embedding, &valid);
+  if (!s.ok()) {
+    LOG(ERROR) << s.msg();
+    *out = "";
+    return;
+  }
+  if (!valid[0]) {
+    *out = "";
+    return;
+  }
 
   // Copy output to json array.
   rapidjson::StringBuffer sb;
   rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
   writer.StartArray();
-  for (int i = 0; i < embedding_size; i++) {
-    writer.Double(output[i]);
+  for (int i = 0; i < kEmbeddingSize; i++) {
+    writer.Double(embedding[i]);
   }
   writer.EndArray();
   *out = sb.GetString();
@@ -26,7 +26,11 @@
 #include <tensorflow/lite/model.h>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
+
 #include "src/carnot/exec/ml/model_executor.h"
+#include "src/common/base/base.h"
 #include "src/common/base/utils.h"
 
 namespace px {
@@ -36,6 +40,8 @@ namespace ml {
 
 class TransformerExecutor : public ModelExecutor {
  public:
+  static constexpr int kEmbeddingSize = 256;
+
   TransformerExecutor() : TransformerExecutor("/embedding.proto") {}
   explicit TransformerExecutor(std::string model_proto_path) { Init(model_proto_path); }
 
@@ -48,17 +54,44 @@ class TransformerExecutor : public ModelExecutor {
     tf_interpreter_->ResizeInputTensor(tf_interpreter_->inputs()[0], {1, max_length_});
     if (tf_interpreter_->AllocateTensors() != kTfLiteOk) {
       LOG(INFO) << "Failed to allocate tensors";
+      batch_size_ = 0;
     } else {
       LOG(INFO) << "Init Transformer model";
     }
   }
 
+  int64_t MemoryUsage() const override;
+
   void Execute(std::string doc, std::string* out);
 
+  /**
+   * Embeds a batch of token id JSON arrays, running the interpreter once per chunk of up to
+   * kMaxBatchSize documents. Row i of the embeddings (kEmbeddingSize floats) is only written if
+   * valid[i] is true, i.e. the document parsed into at least one token. Returns an error if the
+   * interpreter could not allocate tensors for even a single document.
+   */
+  Status ExecuteBatch(const std::vector<std::string_view>& docs, std::vector<float>* embeddings,
+                      std::vector<bool>* valid);
+
  private:
+  static constexpr int kMaxBatchSize = 32;
+
+  // Grows the interpreter's input to hold up to batch_size documents, and returns the number of
+  // documents it holds, which may be more than batch_size. Falls back to single document batches
+  // if the model does not support a variable batch dimension, and fails if not even a single
+  // document fits.
+  StatusOr<int> ResizeBatch(int batch_size);
+  // Embeds the documents whose padded tokens are in batch_tokens, max_length_ tokens per row of
+  // batch_rows, in as many interpreter invocations as the allocated batch size requires. A short
+  // final chunk is padded up to the allocated batch size.
+  Status RunBatch(const std::vector<int32_t>& batch_tokens, const std::vector<size_t>& batch_rows,
+                  std::vector<float>* embeddings, std::vector<bool>* valid);
+
   std::unique_ptr<tflite::Interpreter> tf_interpreter_;
   std::unique_ptr<tflite::FlatBufferModel> model_;
   int max_length_ = 64;
+  int batch_size_ = 1;
+  int max_batch_size_ = kMaxBatchSize;
 };
 
 }  // namespace ml
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <arrow/builder.h>
+
 #include <algorithm>
 #include <memory>
 #include <queue>
@@ -283,6 +285,24 @@ class RowBatchBuilder {
     return *this;
   }
 
+  /**
+   * Add a dictionary encoded STRING column to the rowbatch.
+   * @param codes The index into values of each row.
+   * @param values The distinct strings of the column.
+   * @return the RowBatchBuilder, to allow for chaining.
+   */
+  RowBatchBuilder& AddDictionaryColumn(const std::vector<int32_t>& codes,
+                                       std::vector<types::StringValue> values) {
+    arrow::Int32Builder codes_builder;
+    EXPECT_TRUE(codes_builder.AppendValues(codes).ok());
+    std::shared_ptr<arrow::Array> codes_arrow;
+    EXPECT_TRUE(codes_builder.Finish(&codes_arrow).ok());
+    EXPECT_OK(rb_->AddColumn(types::MakeStringDictionaryArray(
+        codes_arrow, types::ToArrow(values, arrow::default_memory_pool()))));
+
+    return *this;
+  }
+
   /**
    * @return The rowbatch.
    */
@@ -438,14 +458,15 @@ class ExecNodeTester {
    */
   ExecNodeTester& ExpectRowBatch(const table_store::schema::RowBatch& expected_rb,
                                  bool ordered = true, int64_t time_column_idx = -1) {
+    DCHECK(current_row_batches_.size());
+    auto actual_rb = Decoded(*current_row_batches_.front());
     if (ordered) {
-      DCHECK(current_row_batches_.size());
-      ValidateRowBatch(expected_rb, *current_row_batches_.front().get());
+      ValidateRowBatch(expected_rb, *actual_rb);
     } else {
-      ValidateUnorderedRowBatch(expected_rb, *current_row_batches_.front().get());
+      ValidateUnorderedRowBatch(expected_rb, *actual_rb);
     }
     if (time_column_idx > -1) {
-      ValidateTimeOrder(*current_row_batches_.front().get(), time_column_idx);
+      ValidateTimeOrder(*actual_rb, time_column_idx);
     }
     current_row_batches_.pop();
 
@@ -462,7 +483,7 @@ class ExecNodeTester {
                                        int64_t num_batches, int64_t time_column_idx = -1) {
     std::vector<table_store::schema::RowBatch> batches;
     for (auto i = 0; i < num_batches; ++i) {
-      batches.push_back(*current_row_batches_.front().get());
+      batches.push_back(*Decoded(*current_row_batches_.front()));
       current_row_batches_.pop();
     }
     auto actual_rb = ConcatRowBatches(batches);
@@ -476,7 +497,38 @@ class ExecNodeTester {
     return *this;
   }
 
+  /**
+   * Makes the mock child receive dictionary encoded columns as the node emits them, instead of
+   * the decoded strings. The Expect functions still compare the decoded strings.
+   * @return the ExecNodeTester, to allow for chaining.
+   */
+  ExecNodeTester& KeepDictionaryColumns() {
+    mock_child_.set_accepts_dictionary_columns(true);
+    return *this;
+  }
+
+  /**
+   * Checks that a column of the next rowbatch to be checked is dictionary encoded.
+   * @param col_idx The column to check.
+   * @param num_values The expected number of values in the column's dictionary.
+   * @return the ExecNodeTester, to allow for chaining.
+   */
+  ExecNodeTester& ExpectDictionaryColumn(int64_t col_idx, int64_t num_values) {
+    DCHECK(current_row_batches_.size());
+    auto col = current_row_batches_.front()->ColumnAt(col_idx);
+    EXPECT_TRUE(types::IsDictionaryEncoded(col.get()));
+    if (types::IsDictionaryEncoded(col.get())) {
+      EXPECT_EQ(num_values, types::DictionaryValues(col.get())->length());
+    }
+    return *this;
+  }
+
  private:
+  static std::unique_ptr<table_store::schema::RowBatch> Decoded(
+      const table_store::schema::RowBatch& rb) {
+    return rb.DecodeDictionaryColumns(arrow::default_memory_pool()).ConsumeValueOrDie();
+  }
+
   void ValidateRowBatch(const table_store::schema::RowBatch& expected_rb,
                         const table_store::schema::RowBatch& actual_rb) {
     EXPECT_EQ(actual_rb.num_rows(), expected_rb.num_rows());
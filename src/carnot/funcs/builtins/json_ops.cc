@@ -26,6 +26,164 @@ namespace builtins {
 
 using types::StringValue;
 
+namespace internal {
+
+JSONPluckHandler::ValueType JSONPluckHandler::Pluck(const char* json) {
+  rapidjson::Reader reader;
+  rapidjson::StringStream stream(json);
+  // The handler stops the parse as soon as it has the value, which the reader reports as a
+  // termination error. So the parse result is not useful, only whether a value was found.
+  reader.Parse(stream, *this);
+  return type_;
+}
+
+bool JSONPluckHandler::Scalar(ValueType type) {
+  if (depth_ == 0) {
+    // There is nothing to pluck from a scalar document.
+    return false;
+  }
+  if (AtTarget()) {
+    type_ = type;
+    return false;
+  }
+  if (depth_ == 1) {
+    key_matched_ = false;
+    ++element_idx_;
+  }
+  return true;
+}
+
+bool JSONPluckHandler::StartContainer(bool is_object) {
+  if (capture_depth_ < 0) {
+    if (depth_ == 0 && is_object != by_key()) {
+      // Keys can only be plucked from objects, and indexes from arrays.
+      return false;
+    }
+    if (!AtTarget()) {
+      ++depth_;
+      return true;
+    }
+    capture_depth_ = depth_;
+  }
+  ++depth_;
+  return is_object ? writer_.StartObject() : writer_.StartArray();
+}
+
+bool JSONPluckHandler::EndContainer() {
+  --depth_;
+  if (capture_depth_ >= 0) {
+    if (depth_ == capture_depth_) {
+      type_ = ValueType::kNested;
+      return false;
+    }
+    return true;
+  }
+  if (depth_ == 0) {
+    // Reached the end of the document without finding the value.
+    return false;
+  }
+  if (depth_ == 1) {
+    key_matched_ = false;
+    ++element_idx_;
+  }
+  return true;
+}
+
+bool JSONPluckHandler::Null() {
+  if (capture_depth_ >= 0) {
+    return writer_.Null();
+  }
+  return Scalar(ValueType::kNull);
+}
+
+bool JSONPluckHandler::Bool(bool b) {
+  if (capture_depth_ >= 0 || AtTarget()) {
+    writer_.Bool(b);
+    bool_value_ = b;
+  }
+  return capture_depth_ >= 0 || Scalar(ValueType::kBool);
+}
+
+bool JSONPluckHandler::Int(int i) {
+  if (capture_depth_ >= 0 || AtTarget()) {
+    writer_.Int(i);
+    int64_value_ = i;
+  }
+  return capture_depth_ >= 0 || Scalar(ValueType::kInt64);
+}
+
+bool JSONPluckHandler::Uint(unsigned u) {
+  if (capture_depth_ >= 0 || AtTarget()) {
+    writer_.Uint(u);
+    int64_value_ = u;
+  }
+  return capture_depth_ >= 0 || Scalar(ValueType::kInt64);
+}
+
+bool JSONPluckHandler::Int64(int64_t i) {
+  if (capture_depth_ >= 0 || AtTarget()) {
+    writer_.Int64(i);
+    int64_value_ = i;
+  }
+  return capture_depth_ >= 0 || Scalar(ValueType::kInt64);
+}
+
+bool JSONPluckHandler::Uint64(uint64_t u) {
+  if (capture_depth_ >= 0 || AtTarget()) {
+    writer_.Uint64(u);
+    uint64_value_ = u;
+  }
+  return capture_depth_ >= 0 || Scalar(ValueType::kUInt64);
+}
+
+bool JSONPluckHandler::Double(double d) {
+  if (capture_depth_ >= 0 || AtTarget()) {
+    writer_.Double(d);
+    double_value_ = d;
+  }
+  return capture_depth_ >= 0 || Scalar(ValueType::kDouble);
+}
+
+bool JSONPluckHandler::String(const char* str, rapidjson::SizeType length, bool copy) {
+  if (capture_depth_ >= 0) {
+    return writer_.String(str, length, copy);
+  }
+  if (AtTarget()) {
+    string_value_.assign(str, length);
+  }
+  return Scalar(ValueType::kString);
+}
+
+bool JSONPluckHandler::StartObject() { return StartContainer(/*is_object*/ true); }
+
+bool JSONPluckHandler::Key(const char* str, rapidjson::SizeType length, bool copy) {
+  if (capture_depth_ >= 0) {
+    return writer_.Key(str, length, copy);
+  }
+  if (depth_ == 1) {
+    key_matched_ = std::string_view(str, length) == key_;
+  }
+  return true;
+}
+
+bool JSONPluckHandler::EndObject(rapidjson::SizeType member_count) {
+  if (capture_depth_ >= 0) {
+    writer_.EndObject(member_count);
+  }
+  return EndContainer();
+}
+
+bool JSONPluckHandler::StartArray() { return StartContainer(/*is_object*/ false); }
+
+bool JSONPluckHandler::EndArray(rapidjson::SizeType element_count) {
+  if (capture_depth_ >= 0) {
+    writer_.EndArray(element_count);
+  }
+  return EndContainer();
+}
+
+}  // namespace internal
+
 void RegisterJSONOpsOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<PluckUDF>("pluck");
   registry->RegisterOrDie<PluckAsInt64UDF>("pluck_int64");
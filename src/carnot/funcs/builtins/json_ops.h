@@ -18,11 +18,14 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
@@ -33,36 +36,104 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+/**
+ * JSONPluckHandler is a rapidjson SAX handler that looks for a single value at the top level of
+ * a document (a member of an object by key, or an element of an array by index). Parsing stops
+ * as soon as the value has been read, so the rest of the document is neither parsed nor stored,
+ * unlike parsing into a rapidjson::Document.
+ */
+class JSONPluckHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONPluckHandler> {
+ public:
+  enum class ValueType { kNotFound, kNull, kBool, kInt64, kUInt64, kDouble, kString, kNested };
+
+  static JSONPluckHandler ForKey(std::string_view key) { return JSONPluckHandler(key, -1); }
+  static JSONPluckHandler ForIndex(int64_t index) { return JSONPluckHandler({}, index); }
+
+  /**
+   * Parses the null terminated JSON string until the value is found.
+   * @return the type of the value that was found, or kNotFound.
+   */
+  ValueType Pluck(const char* json);
+
+  // Accessors for the plucked value. Only the one matching the ValueType is set.
+  bool bool_value() const { return bool_value_; }
+  int64_t int64_value() const { return int64_value_; }
+  uint64_t uint64_value() const { return uint64_value_; }
+  double double_value() const { return double_value_; }
+  const std::string& string_value() const { return string_value_; }
+  // The value as serialized by rapidjson::Writer, valid for everything except kString.
+  std::string SerializedValue() const { return buffer_.GetString(); }
+
+  // rapidjson SAX interface.
+  bool Null();
+  bool Bool(bool b);
+  bool Int(int i);
+  bool Uint(unsigned u);
+  bool Int64(int64_t i);
+  bool Uint64(uint64_t u);
+  bool Double(double d);
+  bool String(const char* str, rapidjson::SizeType length, bool copy);
+  bool StartObject();
+  bool Key(const char* str, rapidjson::SizeType length, bool copy);
+  bool EndObject(rapidjson::SizeType member_count);
+  bool StartArray();
+  bool EndArray(rapidjson::SizeType element_count);
+
+ private:
+  JSONPluckHandler(std::string_view key, int64_t index)
+      : key_(key), index_(index), writer_(buffer_) {}
+
+  bool by_key() const { return index_ < 0; }
+  // Whether the next value at depth 1 is the one being plucked.
+  bool AtTarget() const {
+    return depth_ == 1 && (by_key() ? key_matched_ : element_idx_ == index_);
+  }
+  // Called for each scalar value. Returns false once the target has been read.
+  bool Scalar(ValueType type);
+  bool StartContainer(bool is_object);
+  bool EndContainer();
+
+  std::string_view key_;
+  int64_t index_;
+
+  int depth_ = 0;
+  bool key_matched_ = false;
+  int64_t element_idx_ = 0;
+  // Depth at which the plucked nested value started, or -1 if not inside it.
+  int capture_depth_ = -1;
+
+  ValueType type_ = ValueType::kNotFound;
+  bool bool_value_ = false;
+  int64_t int64_value_ = 0;
+  uint64_t uint64_value_ = 0;
+  double double_value_ = 0;
+  std::string string_value_;
+  rapidjson::StringBuffer buffer_;
+  rapidjson::Writer<rapidjson::StringBuffer> writer_;
+};
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 To have proper support for JSON we need structs and nullable types.
 // Revisit when we have them.
 class PluckUDF : public udf::ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    auto handler = internal::JSONPluckHandler::ForKey(key);
+    using ValueType = internal::JSONPluckHandler::ValueType;
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return "";
-    }
-    if (!d.IsObject()) {
-      return "";
-    }
-    if (!d.HasMember(key.data())) {
-      return "";
+    switch (handler.Pluck(in.data())) {
+      case ValueType::kNotFound:
+      case ValueType::kNull:
+        return "";
+      case ValueType::kString:
+        return handler.string_value();
+      default:
+        // This is robust to nested JSON.
+        return handler.SerializedValue();
     }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return "";
-    }
-    if (plucked_value.IsString()) {
-      return plucked_value.GetString();
-    }
-
-    // This is robust to nested JSON.
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-    plucked_value.Accept(writer);
-    return sb.GetString();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -87,26 +158,20 @@ class PluckUDF : public udf::ScalarUDF {
 class PluckAsInt64UDF : public udf::ScalarUDF {
  public:
   Int64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    auto handler = internal::JSONPluckHandler::ForKey(key);
+    using ValueType = internal::JSONPluckHandler::ValueType;
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return 0;
-    }
-    if (!d.IsObject()) {
-      return 0;
-    }
-    if (!d.HasMember(key.data())) {
-      return 0;
-    }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return 0;
+    switch (handler.Pluck(in.data())) {
+      case ValueType::kInt64:
+        return handler.int64_value();
+      case ValueType::kUInt64:
+        if (handler.uint64_value() <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+          return static_cast<int64_t>(handler.uint64_value());
+        }
+        return 0;
+      default:
+        return 0;
     }
-    if (plucked_value.IsInt64()) {
-      return plucked_value.GetInt64();
-    }
-    return 0;
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -131,24 +196,10 @@ class PluckAsInt64UDF : public udf::ScalarUDF {
 class PluckAsFloat64UDF : public udf::ScalarUDF {
  public:
   Float64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    auto handler = internal::JSONPluckHandler::ForKey(key);
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return 0.0;
-    }
-    if (!d.IsObject()) {
-      return 0.0;
-    }
-    if (!d.HasMember(key.data())) {
-      return 0.0;
-    }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return 0.0;
-    }
-    if (plucked_value.IsDouble()) {
-      return plucked_value.GetDouble();
+    if (handler.Pluck(in.data()) == internal::JSONPluckHandler::ValueType::kDouble) {
+      return handler.double_value();
     }
     return 0.0;
   }
@@ -178,33 +229,21 @@ class PluckAsFloat64UDF : public udf::ScalarUDF {
 class PluckArrayUDF : public udf::ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue in, Int64Value index) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
-    // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return "";
-    }
-    if (!d.IsArray()) {
+    if (index < 0) {
       return "";
     }
-    const auto& plucked_array = d.GetArray();
-    if (index < 0 || index >= plucked_array.Size()) {
-      return "";
-    }
-
-    const auto& plucked_value = plucked_array[index.val];
-    if (plucked_value.IsNull()) {
-      return "";
-    }
-    if (plucked_value.IsString()) {
-      return plucked_value.GetString();
+    auto handler = internal::JSONPluckHandler::ForIndex(index.val);
+    using ValueType = internal::JSONPluckHandler::ValueType;
+    // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
+    switch (handler.Pluck(in.data())) {
+      case ValueType::kNotFound:
+      case ValueType::kNull:
+        return "";
+      case ValueType::kString:
+        return handler.string_value();
+      default:
+        return handler.SerializedValue();
     }
-
-    // This is robust to nested JSON.
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-    plucked_value.Accept(writer);
-    return sb.GetString();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
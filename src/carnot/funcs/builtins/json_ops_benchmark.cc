@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include <absl/strings/str_cat.h>
+#include <absl/strings/substitute.h>
+#include <rapidjson/document.h>
+
+#include "src/carnot/funcs/builtins/json_ops.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+// Similar to the output of px.quantiles, followed by nested members that are not plucked.
+std::string MakeQuantilesJSON(int num_trailing_keys) {
+  std::string json = R"({"p01":1.5,"p10":2.5,"p25":3.5,"p50":4.5,"p75":5.5,"p90":6.5,"p99":7.5)";
+  for (int i = 0; i < num_trailing_keys; ++i) {
+    absl::StrAppend(&json,
+                    absl::Substitute(R"(,"extra_$0":{"values":[1,2,3],"name":"x$0"})", i));
+  }
+  json += "}";
+  return json;
+}
+
+// The previous implementation of pluck_float64, which parses the whole document into a DOM.
+double PluckFloat64WithDocument(const std::string& in, const std::string& key) {
+  rapidjson::Document d;
+  rapidjson::ParseResult ok = d.Parse(in.data());
+  if (ok == nullptr || !d.IsObject() || !d.HasMember(key.data())) {
+    return 0.0;
+  }
+  const auto& plucked_value = d[key.data()];
+  return plucked_value.IsDouble() ? plucked_value.GetDouble() : 0.0;
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_PluckFloat64Document(benchmark::State& state) {
+  std::string json = MakeQuantilesJSON(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PluckFloat64WithDocument(json, "p50"));
+    benchmark::DoNotOptimize(PluckFloat64WithDocument(json, "p90"));
+    benchmark::DoNotOptimize(PluckFloat64WithDocument(json, "p99"));
+  }
+  state.SetBytesProcessed(3 * static_cast<int64_t>(json.size()) * state.iterations());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_PluckFloat64(benchmark::State& state) {
+  PluckAsFloat64UDF udf;
+  StringValue json = MakeQuantilesJSON(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, json, "p50"));
+    benchmark::DoNotOptimize(udf.Exec(nullptr, json, "p90"));
+    benchmark::DoNotOptimize(udf.Exec(nullptr, json, "p99"));
+  }
+  state.SetBytesProcessed(3 * static_cast<int64_t>(json.size()) * state.iterations());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_PluckNested(benchmark::State& state) {
+  PluckUDF udf;
+  StringValue json = MakeQuantilesJSON(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, json, "extra_0"));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(json.size()) * state.iterations());
+}
+
+BENCHMARK(BM_PluckFloat64Document)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK(BM_PluckFloat64)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK(BM_PluckNested)->RangeMultiplier(4)->Range(1, 64);
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
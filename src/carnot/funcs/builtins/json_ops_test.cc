@@ -60,6 +60,18 @@ TEST(JSONOps, PluckUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "str_key").Expect("");
 }
 
+TEST(JSONOps, PluckUDF_only_matches_top_level_keys) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  constexpr char kNested[] =
+      R"({"a": {"b": [1, {"b": 2}], "c": null}, "b": [true, "x", -5, 1.5], "c": null})";
+  udf_tester.ForInput(kNested, "a").Expect(R"({"b":[1,{"b":2}],"c":null})");
+  udf_tester.ForInput(kNested, "b").Expect(R"([true,"x",-5,1.5])");
+  udf_tester.ForInput(kNested, "c").Expect("");
+  udf_tester.ForInput(kNested, "d").Expect("");
+  // The first matching key wins.
+  udf_tester.ForInput(R"({"k": 1, "k": 2})", "k").Expect("1");
+}
+
 TEST(JSONOps, PluckAsInt64UDF) {
   auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
   udf_tester.ForInput(kTestJSONStr, "str_key").Expect(0);
@@ -111,6 +123,17 @@ TEST(JSONOps, PluckArrayUDF_index_out_of_bound) {
   udf_tester.ForInput(kTestJSONArray, 3).Expect("");
 }
 
+TEST(JSONOps, PluckArrayUDF_nested_and_scalar_elements) {
+  auto udf_tester = udf::UDFTester<PluckArrayUDF>();
+  constexpr char kArray[] = R"([[1, 2], {"a": [3]}, "foo", 4, null])";
+  udf_tester.ForInput(kArray, 0).Expect("[1,2]");
+  udf_tester.ForInput(kArray, 1).Expect(R"({"a":[3]})");
+  udf_tester.ForInput(kArray, 2).Expect("foo");
+  udf_tester.ForInput(kArray, 3).Expect("4");
+  udf_tester.ForInput(kArray, 4).Expect("");
+  udf_tester.ForInput(kArray, -1).Expect("");
+}
+
 TEST(JSONOps, ScriptReferenceUDF_no_args) {
   auto udf_tester = udf::UDFTester<ScriptReferenceUDF<>>();
   auto res = udf_tester.ForInput("text", "px/script").Result();
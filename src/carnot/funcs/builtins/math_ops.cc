@@ -222,6 +222,14 @@ void RegisterMathOpsOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<TimeToInt64UDF>("time_to_int64");
   registry->RegisterOrDie<Int64ToTimeUDF>("int64_to_time");
 
+  // Partitioning
+  registry->RegisterOrDie<PartitionIDUDF<types::BoolValue>>("_partition_id");
+  registry->RegisterOrDie<PartitionIDUDF<types::Int64Value>>("_partition_id");
+  registry->RegisterOrDie<PartitionIDUDF<types::UInt128Value>>("_partition_id");
+  registry->RegisterOrDie<PartitionIDUDF<types::Float64Value>>("_partition_id");
+  registry->RegisterOrDie<PartitionIDUDF<types::Time64NSValue>>("_partition_id");
+  registry->RegisterOrDie<PartitionIDUDF<types::StringValue>>("_partition_id");
+
   /*****************************************
    * Aggregate UDFs.
    *****************************************/
@@ -19,7 +19,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <string_view>
 
 #include "src/carnot/udf/registry.h"
 #include "src/carnot/udf/type_inference.h"
@@ -373,6 +375,7 @@ template <typename TArg1, typename TArg2 = TArg1>
 class EqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 == b2; }
+  static constexpr bool IsPure() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns whether the values are equal.")
         .Details(
@@ -393,6 +396,7 @@ template <typename TArg1, typename TArg2 = TArg1>
 class NotEqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 != b2; }
+  static constexpr bool IsPure() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns whether the values are not equal.")
         .Details(
@@ -580,6 +584,60 @@ class Int64ToTimeUDF : public udf::ScalarUDF {
   }
 };
 
+/**
+ * @brief Stable hash used to route rows to partitions. Every Carnot instance that takes part in
+ * a shuffle must assign a key to the same partition, so unlike absl::Hash this is not seeded per
+ * process.
+ */
+inline uint64_t PartitionHash(uint64_t v) {
+  // splitmix64 finalizer.
+  v ^= v >> 30;
+  v *= 0xbf58476d1ce4e5b9ULL;
+  v ^= v >> 27;
+  v *= 0x94d049bb133111ebULL;
+  v ^= v >> 31;
+  return v;
+}
+
+inline uint64_t PartitionHash(const types::BoolValue& v) { return PartitionHash(v.val ? 1 : 0); }
+inline uint64_t PartitionHash(const types::Int64Value& v) {
+  return PartitionHash(static_cast<uint64_t>(v.val));
+}
+inline uint64_t PartitionHash(const types::UInt128Value& v) {
+  return PartitionHash(v.High64() ^ PartitionHash(v.Low64()));
+}
+inline uint64_t PartitionHash(const types::Float64Value& v) {
+  // -0.0 and 0.0 compare equal, so they must land in the same partition.
+  double d = v.val == 0 ? 0.0 : v.val;
+  uint64_t bits;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return PartitionHash(bits);
+}
+inline uint64_t PartitionHash(std::string_view s) {
+  // FNV-1a, finalized to spread the low bits used by the modulo.
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (char c : s) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 0x100000001b3ULL;
+  }
+  return PartitionHash(h);
+}
+
+/**
+ * @brief Returns the partition in [0, num_partitions) that a key belongs to. The distributed
+ * planner uses this to hash-partition the rows sent from each PEM across several Kelvins.
+ */
+template <typename TArg>
+class PartitionIDUDF : public udf::ScalarUDF {
+ public:
+  Int64Value Exec(FunctionContext*, TArg key, Int64Value num_partitions) {
+    if (num_partitions.val <= 1) {
+      return 0;
+    }
+    return static_cast<int64_t>(PartitionHash(key) % static_cast<uint64_t>(num_partitions.val));
+  }
+};
+
 template <typename TArg>
 class MeanUDA : public udf::UDA {
  public:
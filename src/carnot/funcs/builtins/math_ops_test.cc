@@ -467,6 +467,32 @@ TEST(MathOps, int64_to_time_test) {
   udf_tester.ForInput(0).Expect(0);
 }
 
+TEST(MathOps, partition_id_test) {
+  auto udf_tester = udf::UDFTester<PartitionIDUDF<types::StringValue>>();
+  udf_tester.ForInput("abc", 1).Expect(0);
+  udf_tester.ForInput("abc", 0).Expect(0);
+
+  // Partitions must be stable and in range, and spread keys across every partition.
+  PartitionIDUDF<types::Int64Value> udf;
+  std::vector<int64_t> counts(4, 0);
+  for (int64_t i = 0; i < 4000; ++i) {
+    int64_t partition = udf.Exec(nullptr, i, 4).val;
+    ASSERT_GE(partition, 0);
+    ASSERT_LT(partition, 4);
+    EXPECT_EQ(partition, udf.Exec(nullptr, i, 4).val);
+    ++counts[partition];
+  }
+  for (int64_t count : counts) {
+    EXPECT_GT(count, 800);
+  }
+
+  // Time keys hash like their int64 value, and -0.0 lands with 0.0.
+  PartitionIDUDF<types::Time64NSValue> time_udf;
+  EXPECT_EQ(time_udf.Exec(nullptr, 1234, 7).val, udf.Exec(nullptr, 1234, 7).val);
+  PartitionIDUDF<types::Float64Value> float_udf;
+  EXPECT_EQ(float_udf.Exec(nullptr, -0.0, 7).val, float_udf.Exec(nullptr, 0.0, 7).val);
+}
+
 TEST(MathOps, basic_float64_mean_uda_test) {
   auto inputs = std::vector<double>({1.234, 2.442, 1.04, 5.322, 6.333});
   uint64_t size = inputs.size();
@@ -25,6 +25,12 @@ namespace builtins {
 void RegisterMathSketchesOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<QuantilesUDA<types::Int64Value>>("quantiles");
   registry->RegisterOrDie<QuantilesUDA<types::Float64Value>>("quantiles");
+  registry->RegisterOrDie<PercentileUDA<types::Int64Value, 50>>("p50");
+  registry->RegisterOrDie<PercentileUDA<types::Float64Value, 50>>("p50");
+  registry->RegisterOrDie<PercentileUDA<types::Int64Value, 90>>("p90");
+  registry->RegisterOrDie<PercentileUDA<types::Float64Value, 90>>("p90");
+  registry->RegisterOrDie<PercentileUDA<types::Int64Value, 99>>("p99");
+  registry->RegisterOrDie<PercentileUDA<types::Float64Value, 99>>("p99");
 }
 
 }  // namespace builtins
@@ -21,6 +21,12 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+
 #include "src/carnot/udf/registry.h"
 #include "src/shared/types/types.h"
 #include "tdigest/tdigest.h"
@@ -29,11 +35,51 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+// Compression used for all t-digests. Higher values are more accurate, but use more memory.
+constexpr double kTDigestCompression = 1000;
+
+/**
+ * Writes the centroids of the digest as packed (mean, weight) pairs. This is much more compact
+ * than the JSON result, and is what is sent between agents for partial aggregates.
+ */
+inline StringValue SerializeTDigest(tdigest::TDigest* digest) {
+  // Merge the unprocessed points so only the centroids need to be written.
+  digest->compress();
+  const auto& centroids = digest->processed();
+  std::vector<double> packed;
+  packed.reserve(centroids.size() * 2);
+  for (const auto& c : centroids) {
+    packed.push_back(c.mean());
+    packed.push_back(c.weight());
+  }
+  // The string buffer has no alignment guarantee for doubles, so copy the bytes over.
+  std::string out(packed.size() * sizeof(double), '\0');
+  if (!packed.empty()) {
+    std::memcpy(out.data(), packed.data(), out.size());
+  }
+  return out;
+}
+
+inline Status DeserializeTDigest(const StringValue& data, tdigest::TDigest* digest) {
+  constexpr size_t kCentroidSize = 2 * sizeof(double);
+  if (data.size() % kCentroidSize != 0) {
+    return error::InvalidArgument("Serialized t-digest has invalid size $0", data.size());
+  }
+  std::vector<double> packed(data.size() / sizeof(double));
+  if (!packed.empty()) {
+    std::memcpy(packed.data(), data.data(), data.size());
+  }
+  for (size_t i = 0; i < packed.size(); i += 2) {
+    digest->add(packed[i], packed[i + 1]);
+  }
+  return Status::OK();
+}
+
 // TODO(zasgar): PL-419 Replace this when we add support for structs.
 template <typename TArg>
 class QuantilesUDA : public udf::UDA {
  public:
-  QuantilesUDA() : digest_(1000) {}
+  QuantilesUDA() : digest_(kTDigestCompression) {}
   void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
   void Merge(FunctionContext*, const QuantilesUDA& other) { digest_.merge(&other.digest_); }
 
@@ -53,6 +99,12 @@ class QuantilesUDA : public udf::UDA {
     return sb.GetString();
   }
 
+  StringValue Serialize(FunctionContext*) { return SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    return DeserializeTDigest(data, &digest_);
+  }
+
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<QuantilesUDA>(types::ST_QUANTILES, {types::ST_NONE}),
             udf::ExplicitRule::Create<QuantilesUDA>(types::ST_DURATION_NS_QUANTILES,
@@ -66,7 +118,8 @@ class QuantilesUDA : public udf::UDA {
             "[tdigest](https://github.com/tdunning/t-digest). Returns a serialized JSON object "
             "with the "
             "keys for 1%, 10%, 50%, 90%, and 99%. You can use `px.pluck_float64` to grab the "
-            "specific values from the result.")
+            "specific values from the result. If only a few percentiles are needed, prefer "
+            "`px.p50`, `px.p90` and `px.p99` which return them directly as floats.")
         .Example(R"doc(
         | # Calculate the quantiles.
         | df = df.agg(latency_dist=('latency_ms', px.quantiles))
@@ -81,6 +134,46 @@ class QuantilesUDA : public udf::UDA {
   tdigest::TDigest digest_;
 };
 
+/**
+ * Approximates a single percentile of the aggregated data, returned as a float.
+ * @tparam TArg The input type.
+ * @tparam TPercentile The percentile to compute, in [0, 100].
+ */
+template <typename TArg, int TPercentile>
+class PercentileUDA : public udf::UDA {
+ public:
+  PercentileUDA() : digest_(kTDigestCompression) {}
+  void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
+  void Merge(FunctionContext*, const PercentileUDA& other) { digest_.merge(&other.digest_); }
+  Float64Value Finalize(FunctionContext*) { return digest_.quantile(TPercentile / 100.0); }
+
+  StringValue Serialize(FunctionContext*) { return SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    return DeserializeTDigest(data, &digest_);
+  }
+
+  static udf::InfRuleVec SemanticInferenceRules() {
+    return {udf::InheritTypeFromArgs<PercentileUDA>::Create(
+        {types::ST_BYTES, types::ST_DURATION_NS, types::ST_PERCENT})};
+  }
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder(
+               absl::Substitute("Approximates the $0th percentile of the aggregated data.",
+                                TPercentile))
+        .Details(
+            "Uses the same [tdigest](https://github.com/tdunning/t-digest) as `px.quantiles`, "
+            "but returns a single percentile as a float, so it does not need to be plucked.")
+        .Example(absl::Substitute("df = df.agg(latency_p$0=('latency_ms', px.p$0))", TPercentile))
+        .Arg("val", "The data to calculate the percentile of.")
+        .Returns(absl::Substitute("The $0th percentile of the data.", TPercentile));
+  }
+
+ protected:
+  tdigest::TDigest digest_;
+};
+
 void RegisterMathSketchesOrDie(udf::Registry* registry);
 
 }  // namespace builtins
@@ -22,6 +22,7 @@
 #include "src/carnot/funcs/builtins/math_sketches.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/common/testing/testing.h"
 
 namespace px {
 namespace carnot {
@@ -69,6 +70,44 @@ TEST(MathSketches, quantiles_int64) {
   EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6);
 }
 
+TEST(MathSketches, quantiles_serialize) {
+  auto uda_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  uda_tester.ForInput(1.234).ForInput(2.442).ForInput(1.04).ForInput(5.322).ForInput(6.333);
+  auto serialized = uda_tester.Serialize();
+  // Each centroid is written as two doubles.
+  EXPECT_EQ(0, serialized.size() % (2 * sizeof(double)));
+
+  auto other_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  ASSERT_OK(other_tester.Deserialize(serialized));
+  rapidjson::Document d;
+  auto res = other_tester.Result();
+  d.Parse(res.data());
+  EXPECT_DOUBLE_EQ(d["p01"].GetDouble(), 1.04);
+  EXPECT_DOUBLE_EQ(d["p50"].GetDouble(), 2.442);
+  EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6.333);
+
+  EXPECT_NOT_OK(other_tester.Deserialize("bad"));
+}
+
+TEST(MathSketches, percentiles) {
+  udf::UDATester<PercentileUDA<types::Int64Value, 50>>()
+      .ForInput(1)
+      .ForInput(2)
+      .ForInput(2)
+      .ForInput(1)
+      .ForInput(1)
+      .ForInput(5)
+      .ForInput(6)
+      .Expect(2);
+  udf::UDATester<PercentileUDA<types::Float64Value, 99>>()
+      .ForInput(1.234)
+      .ForInput(2.442)
+      .ForInput(1.04)
+      .ForInput(5.322)
+      .ForInput(6.333)
+      .Expect(6.333);
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
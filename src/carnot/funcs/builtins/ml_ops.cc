@@ -16,6 +16,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include "src/carnot/funcs/builtins/ml_ops.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
@@ -30,6 +33,7 @@ void RegisterMLOpsOrDie(udf::Registry* registry) {
    * Scalar UDFs.
    *****************************************/
   registry->RegisterOrDie<TransformerUDF>("_text_embedding");
+  registry->RegisterOrDie<PackedTransformerUDF>("_text_embedding_packed");
   registry->RegisterOrDie<SentencePieceUDF>("_encode_sentence_piece");
   registry->RegisterOrDie<KMeansUDF>("_kmeans_inference");
   /*****************************************
@@ -65,6 +69,32 @@ int load_floats_from_json(std::string in, Eigen::VectorXf* out, int max_num) {
   return count;
 }
 
+int load_embedding(std::string_view in, Eigen::VectorXf* out, int max_num) {
+  if (in.empty() || in[0] != kPackedEmbeddingTag) {
+    return load_floats_from_json(std::string(in), out, max_num);
+  }
+  int count = std::min<int>((in.size() - 1) / sizeof(float), max_num);
+  std::memcpy(out->data(), in.data() + 1, count * sizeof(float));
+  return count;
+}
+
+std::string write_floats_packed(const float* arr, int num) {
+  std::string out(1 + num * sizeof(float), kPackedEmbeddingTag);
+  std::memcpy(out.data() + 1, arr, num * sizeof(float));
+  return out;
+}
+
+std::string write_floats_to_json(const float* arr, int num) {
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  writer.StartArray();
+  for (int i = 0; i < num; i++) {
+    writer.Double(arr[i]);
+  }
+  writer.EndArray();
+  return sb.GetString();
+}
+
 std::string write_ints_to_json(int* arr, int num) {
   // Copy output to json array.
   rapidjson::StringBuffer sb;
@@ -26,6 +26,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "src/carnot/exec/ml/coreset.h"
@@ -48,23 +49,69 @@ using exec::ml::KMeansCoreset;
 
 int load_floats_from_json(std::string in, Eigen::VectorXf* out, int max_num);
 std::string write_ints_to_json(int* arr, int num);
+std::string write_floats_to_json(const float* arr, int num);
+
+// Packed embeddings are a tag byte followed by the raw float values. JSON arrays never start
+// with the tag, so consumers can accept both encodings.
+constexpr char kPackedEmbeddingTag = '\0';
+std::string write_floats_packed(const float* arr, int num);
+// Loads an embedding encoded either as a JSON array or with write_floats_packed.
+int load_embedding(std::string_view in, Eigen::VectorXf* out, int max_num);
+
+enum class EmbeddingFormat {
+  kJSON,
+  kPacked,
+};
 
-class TransformerUDF : public udf::ScalarUDF {
+template <EmbeddingFormat TFormat>
+class TransformerUDFImpl : public udf::ScalarUDF {
  public:
-  TransformerUDF() : TransformerUDF("/embedding.proto") {}
-  explicit TransformerUDF(std::string model_proto_path) : model_proto_path_(model_proto_path) {}
+  TransformerUDFImpl() : TransformerUDFImpl("/embedding.proto") {}
+  explicit TransformerUDFImpl(std::string model_proto_path)
+      : model_proto_path_(model_proto_path) {}
   StringValue Exec(FunctionContext* ctx, StringValue doc) {
+    StringValue out;
+    Status s = ExecBatch(ctx, &doc, &out, 1);
+    if (!s.ok()) {
+      LOG(ERROR) << s.msg();
+      return "";
+    }
+    return out;
+  }
+
+  // Embeds a whole column chunk with as few interpreter invocations as possible.
+  Status ExecBatch(FunctionContext* ctx, const StringValue* docs, StringValue* out,
+                   size_t count) {
     auto executor =
         ctx->model_pool()->GetModelExecutor<exec::ml::TransformerExecutor>(model_proto_path_);
-    std::string output;
-    executor->Execute(doc, &output);
-    return output;
+    std::vector<std::string_view> doc_views(docs, docs + count);
+    std::vector<float> embeddings;
+    std::vector<bool> valid;
+    PL_RETURN_IF_ERROR(executor->ExecuteBatch(doc_views, &embeddings, &valid));
+
+    constexpr int kEmbeddingSize = exec::ml::TransformerExecutor::kEmbeddingSize;
+    for (size_t i = 0; i < count; ++i) {
+      if (!valid[i]) {
+        out[i] = "";
+        continue;
+      }
+      const float* embedding = embeddings.data() + i * kEmbeddingSize;
+      if constexpr (TFormat == EmbeddingFormat::kPacked) {
+        out[i] = write_floats_packed(embedding, kEmbeddingSize);
+      } else {
+        out[i] = write_floats_to_json(embedding, kEmbeddingSize);
+      }
+    }
+    return Status::OK();
   }
 
  private:
   std::string model_proto_path_;
 };
 
+using TransformerUDF = TransformerUDFImpl<EmbeddingFormat::kJSON>;
+using PackedTransformerUDF = TransformerUDFImpl<EmbeddingFormat::kPacked>;
+
 class SentencePieceUDF : public udf::ScalarUDF {
  public:
   SentencePieceUDF() : SentencePieceUDF("/sentencepiece.proto") {}
@@ -95,7 +142,7 @@ class KMeansUDA : public udf::UDA {
       k_ = k.val;
     }
     Eigen::VectorXf point(d_);
-    int d = load_floats_from_json(in, &point, d_);
+    int d = load_embedding(in, &point, d_);
     DCHECK_EQ(d_, d);
     coreset_.Update(point);
   }
@@ -131,7 +178,7 @@ class KMeansUDF : public udf::ScalarUDF {
       kmeans_->FromJSON(kmeans_json);
     }
     Eigen::VectorXf point(d_);
-    int d = load_floats_from_json(embedding, &point, d_);
+    int d = load_embedding(embedding, &point, d_);
     DCHECK_EQ(d_, d);
     return kmeans_->Transform(point);
   }
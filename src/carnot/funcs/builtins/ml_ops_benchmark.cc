@@ -83,5 +83,57 @@ static void BM_SentencePiece(benchmark::State& state) {
   }
 }
 
+// Embeds a chunk of documents and assigns each embedding to a cluster, reporting rows/sec.
+// The row-wise variant calls Exec per row, the batched variants go through ExecBatch.
+template <typename TTransformerUDF, bool TBatched>
+// NOLINTNEXTLINE : runtime/references.
+static void BM_EmbedAndCluster(benchmark::State& state) {
+  using px::carnot::builtins::KMeansUDA;
+  using px::carnot::builtins::KMeansUDF;
+  using px::types::StringValue;
+
+  size_t num_rows = state.range(0);
+  auto model_pool = px::carnot::exec::ml::ModelPool::Create();
+  auto ctx = px::carnot::udf::FunctionContext(nullptr, model_pool.get());
+  TTransformerUDF embed_udf(FLAGS_embedding_dir);
+
+  std::vector<StringValue> docs;
+  for (size_t i = 0; i < num_rows; ++i) {
+    auto ints = random_ints(16);
+    docs.push_back(px::carnot::builtins::write_ints_to_json(ints.data(), ints.size()));
+  }
+  std::vector<StringValue> embeddings(num_rows);
+  PL_CHECK_OK(embed_udf.ExecBatch(&ctx, docs.data(), embeddings.data(), num_rows));
+  KMeansUDA fit;
+  for (const auto& embedding : embeddings) {
+    fit.Update(&ctx, embedding, 4);
+  }
+  StringValue kmeans_json = fit.Finalize(&ctx);
+
+  for (auto _ : state) {
+    if constexpr (TBatched) {
+      PL_CHECK_OK(embed_udf.ExecBatch(&ctx, docs.data(), embeddings.data(), num_rows));
+    } else {
+      for (size_t i = 0; i < num_rows; ++i) {
+        embeddings[i] = embed_udf.Exec(&ctx, docs[i]);
+      }
+    }
+    KMeansUDF cluster;
+    for (const auto& embedding : embeddings) {
+      benchmark::DoNotOptimize(cluster.Exec(&ctx, embedding, kmeans_json));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+
 BENCHMARK(BM_SentencePiece)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EmbedAndCluster, px::carnot::builtins::TransformerUDF, false)
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EmbedAndCluster, px::carnot::builtins::TransformerUDF, true)
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EmbedAndCluster, px::carnot::builtins::PackedTransformerUDF, true)
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_TransformerModel)->Unit(benchmark::kMillisecond);
@@ -71,6 +71,37 @@ TEST(KMeans, basic) {
   EXPECT_THAT(kmeans.centroids(), UnorderedRowsAre(expected_centroids, 0.1));
 }
 
+TEST(KMeans, packed_embeddings) {
+  int k = 3;
+  int d = 2;
+
+  auto kmeans_uda_tester = udf::UDATester<KMeansUDA>(d);
+
+  Eigen::MatrixXf expected_centroids = kmeans_expected_centroids();
+  Eigen::MatrixXf points = kmeans_test_data();
+
+  for (int i = 0; i < points.rows(); i++) {
+    Eigen::VectorXf point = points(i, Eigen::all).transpose();
+    kmeans_uda_tester.ForInput(write_floats_packed(point.data(), d), k);
+  }
+
+  auto res = kmeans_uda_tester.Result();
+  px::carnot::exec::ml::KMeans kmeans(k);
+  kmeans.FromJSON(res);
+  EXPECT_THAT(kmeans.centroids(), UnorderedRowsAre(expected_centroids, 0.1));
+}
+
+TEST(Embedding, packed_and_json_load_the_same) {
+  std::vector<float> values = {1.5, -2.25, 0.0, 3.0};
+  Eigen::VectorXf from_packed(values.size());
+  Eigen::VectorXf from_json(values.size());
+  EXPECT_EQ(4, load_embedding(write_floats_packed(values.data(), values.size()), &from_packed,
+                              values.size()));
+  EXPECT_EQ(4, load_embedding(write_floats_to_json(values.data(), values.size()), &from_json,
+                              values.size()));
+  EXPECT_EQ(from_packed, from_json);
+}
+
 TEST(SentencePiece, basic) {
   auto udf_tester = udf::UDFTester<SentencePieceUDF>(FLAGS_sentencepiece_dir);
   udf_tester.ForInput("Test 123!");
@@ -150,6 +181,32 @@ TEST(Transformer, basic) {
       "15099024772644044,-0.10007300972938538,1.1897741556167603]");
 }
 
+TEST(Transformer, batch_matches_single_rows) {
+  auto pool = exec::ml::ModelPool::Create();
+  auto ctx = std::make_unique<FunctionContext>(nullptr, pool.get());
+  TransformerUDF udf(FLAGS_embedding_dir);
+  std::vector<types::StringValue> docs = {"[4,197,803,195,16,5001]", "not json",
+                                          "[4,197,803]", "[]", "[16,5001]"};
+
+  std::vector<types::StringValue> batch_out(docs.size());
+  ASSERT_OK(udf.ExecBatch(ctx.get(), docs.data(), batch_out.data(), docs.size()));
+  constexpr int kEmbeddingSize = exec::ml::TransformerExecutor::kEmbeddingSize;
+  for (size_t i = 0; i < docs.size(); ++i) {
+    auto single_out = udf.Exec(ctx.get(), docs[i]);
+    Eigen::VectorXf single(kEmbeddingSize);
+    Eigen::VectorXf batched(kEmbeddingSize);
+    ASSERT_EQ(load_embedding(single_out, &single, kEmbeddingSize),
+              load_embedding(batch_out[i], &batched, kEmbeddingSize))
+        << docs[i];
+    if (!single_out.empty()) {
+      // Batched kernels may accumulate in a different order.
+      EXPECT_TRUE(single.isApprox(batched, 1e-4)) << docs[i];
+    }
+  }
+  EXPECT_EQ("", batch_out[1]);
+  EXPECT_EQ("", batch_out[3]);
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -17,6 +17,7 @@
  */
 #include <algorithm>
 #include <map>
+#include <string>
 #include <vector>
 
 #include "src/carnot/funcs/builtins/pii_ops.h"
@@ -246,9 +247,48 @@ Status RedactPIIUDF::Init(FunctionContext*) {
   taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IMEI>>());
   taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IMEISV>>());
   taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::CC_NUMBER>>());
+
+  tagger_set_ = std::make_unique<RE2::Set>(RE2::DefaultOptions, RE2::UNANCHORED);
+  for (const auto& tagger : taggers_) {
+    std::string error;
+    auto pattern = tagger->Pattern();
+    if (tagger_set_->Add(re2::StringPiece(pattern.data(), pattern.size()), &error) < 0) {
+      return error::Internal("Failed to add PII pattern to RE2::Set: $0", error);
+    }
+  }
+  if (!tagger_set_->Compile()) {
+    return error::Internal("Failed to compile PII RE2::Set");
+  }
   return Status::OK();
 }
 
+// Every PII pattern requires at least one of these characters: IPv4 addresses, card numbers, IMEIs
+// and URL encoded emails contain a digit, other emails contain '@', and IPv6 and MAC addresses
+// written only with hex letters contain ':' or '-'. Text without any of them can't contain PII.
+static inline bool MayContainPII(std::string_view input) {
+  return std::any_of(input.begin(), input.end(), [](char c) {
+    return (c >= '0' && c <= '9') || c == '@' || c == ':' || c == '-';
+  });
+}
+
+void RedactPIIUDF::MatchTaggers(const std::string& input) {
+  matched_taggers_.clear();
+  RE2::Set::ErrorInfo error_info;
+  if (tagger_set_->Match(input, &matched_taggers_, &error_info)) {
+    // The tags are combined in tagger order, so keep that order to produce the same output.
+    std::sort(matched_taggers_.begin(), matched_taggers_.end());
+    return;
+  }
+  matched_taggers_.clear();
+  if (error_info.kind == RE2::Set::kNoError) {
+    return;
+  }
+  // The set's DFA can run out of memory on large inputs. Fall back to running every tagger.
+  for (size_t i = 0; i < taggers_.size(); ++i) {
+    matched_taggers_.push_back(i);
+  }
+}
+
 // Replace all tagged sequences in the string with the corresponding substitution string. For
 // overlapping tags, we take the longest tag.
 static inline std::string ReplaceTagsWithSubs(std::string input, std::vector<Tag>* tags) {
@@ -305,9 +345,18 @@ static inline std::string ReplaceTagsWithSubs(std::string input, std::vector<Tag
 }
 
 StringValue RedactPIIUDF::Exec(FunctionContext*, StringValue input) {
+  if (!MayContainPII(input)) {
+    return input;
+  }
+  // A single pass over the input finds which PII types are present. Only those taggers need to
+  // run their FindAndConsume loop to locate the matches, which is usually none or a few of them.
+  MatchTaggers(input);
+  if (matched_taggers_.empty()) {
+    return input;
+  }
   std::vector<Tag> tags;
-  for (const auto& tagger : taggers_) {
-    auto s = tagger->AddTags(&input, &tags);
+  for (int idx : matched_taggers_) {
+    auto s = taggers_[idx]->AddTags(&input, &tags);
     if (!s.ok()) {
       return "Invalid regex: " + s.msg();
     }
@@ -19,9 +19,11 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/utils.h"
 #include "src/shared/types/types.h"
@@ -55,6 +57,8 @@ class Tagger {
  public:
   virtual ~Tagger() = default;
   virtual Status AddTags(std::string* input, std::vector<Tag>* tags) = 0;
+  // The regex the tagger matches with, so that taggers can be prefiltered as a single RE2::Set.
+  virtual std::string_view Pattern() const = 0;
 };
 
 class RedactPIIUDF : public udf::ScalarUDF {
@@ -77,7 +81,15 @@ class RedactPIIUDF : public udf::ScalarUDF {
   }
 
  private:
+  // Fills matched_taggers_ with the indices of the taggers whose pattern occurs in the input, in
+  // tagger order.
+  void MatchTaggers(const std::string& input);
+
   std::vector<std::unique_ptr<Tagger>> taggers_;
+  // All tagger patterns combined, used to scan the input once and skip the taggers that can't
+  // match.
+  std::unique_ptr<RE2::Set> tagger_set_;
+  std::vector<int> matched_taggers_;
 };
 
 void RegisterPIIOpsOrDie(udf::Registry* registry);
@@ -116,6 +128,8 @@ class RegexTagger : public Tagger {
     return Status::OK();
   }
 
+  std::string_view Pattern() const { return TagTypeTraits<TTag>::BuildRegexPattern(); }
+
  private:
   re2::RE2 regex_;
 };
@@ -51,6 +51,35 @@ static void BM_RedactPII(benchmark::State& state) {
 
 BENCHMARK(BM_RedactPII)->RangeMultiplier(2)->Range(1, 12);
 
+// Typical JSON request bodies, where most contain no PII at all.
+static constexpr std::string_view http_body_no_pii = R"body(
+{"order_id": "a1b2c3", "items": [{"sku": "SHOE-RED-42", "qty": 1, "price": 59.99}],
+ "customer": {"name": "Jane", "note": "leave at the door"}, "created_at": "2022-03-04T10:11:12Z"}
+)body";
+static constexpr std::string_view http_body_pii = R"body(
+{"order_id": "a1b2c3", "items": [{"sku": "SHOE-RED-42", "qty": 1, "price": 59.99}],
+ "customer": {"email": "jane.doe@example.com", "client_ip": "10.0.12.7"}}
+)body";
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_RedactPIIHTTPBody(benchmark::State& state, std::string_view body) {
+  RedactPIIUDF udf;
+  PL_UNUSED(udf.Init(nullptr));
+
+  std::string text;
+  for (int i = 0; i < state.range(0); i++) {
+    text += body;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, text));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(text.length()) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_CAPTURE(BM_RedactPIIHTTPBody, no_pii, http_body_no_pii)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK_CAPTURE(BM_RedactPIIHTTPBody, pii, http_body_pii)->RangeMultiplier(4)->Range(1, 64);
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -221,6 +221,18 @@ INSTANTIATE_TEST_SUITE_P(TemplatedRedactionTest, RedactionTest,
                          ::testing::ValuesIn(TestCaseGen({IPv4Gen(), IPv6Gen(), EmailGen(), CCGen(),
                                                           IMEIGen(), NegativeExampleGen()})));
 
+TEST(RedactPIIUDF, only_matching_taggers) {
+  udf::UDFTester<RedactPIIUDF> udf_tester;
+  udf_tester.Init();
+  udf_tester.ForInput("no pii here, just text.").Expect("no pii here, just text.");
+  std::string body = R"({"sku": "SHOE-RED-42", "qty": 1})";
+  udf_tester.ForInput(body).Expect(body);
+  udf_tester.ForInput("mac ab-cd-ef-ab-cd-ef from abcd::1234")
+      .Expect("mac <REDACTED_MAC_ADDR> from <REDACTED_IPV6>");
+  udf_tester.ForInput("3530 1113333 00000 at a.b@c.com from 10.0.0.1")
+      .Expect("<REDACTED_CC_NUMBER> at <REDACTED_EMAIL> from <REDACTED_IPV4>");
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -75,7 +75,7 @@ types::StringValue NormalizePostgresSQLUDF::Exec(FunctionContext*, StringValue s
     return result.ToJSON();
   }
 
-  auto result_or_s = sql_parsing::normalize_pgsql(query, param_values);
+  auto result_or_s = normalizer_.Normalize(query, param_values);
   if (!result_or_s.ok()) {
     sql_parsing::NormalizeResult result;
     result.errmsg = result_or_s.status().msg();
@@ -105,7 +105,7 @@ types::StringValue NormalizeMySQLUDF::Exec(FunctionContext*, StringValue sql_str
     return result.ToJSON();
   }
 
-  auto result_or_s = sql_parsing::normalize_mysql(query, param_values);
+  auto result_or_s = normalizer_.Normalize(query, param_values);
   if (!result_or_s.ok()) {
     sql_parsing::NormalizeResult result;
     result.errmsg = result_or_s.status().msg();
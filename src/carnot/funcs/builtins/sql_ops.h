@@ -59,6 +59,9 @@ class NormalizePostgresSQLUDF : public udf::ScalarUDF {
             "The normalized query with the values of the parameters in the query "
             "as JSON.");
   }
+
+ private:
+  sql_parsing::PgSQLNormalizer normalizer_;
 };
 
 class NormalizeMySQLUDF : public udf::ScalarUDF {
@@ -84,6 +87,9 @@ class NormalizeMySQLUDF : public udf::ScalarUDF {
             "The normalized query with the values of the parameters in the query "
             "as JSON.");
   }
+
+ private:
+  sql_parsing::MySQLNormalizer normalizer_;
 };
 
 void RegisterSQLOpsOrDie(udf::Registry* registry);
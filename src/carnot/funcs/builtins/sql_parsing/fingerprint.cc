@@ -0,0 +1,166 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>
+
+#include "src/carnot/funcs/builtins/sql_parsing/fingerprint.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+namespace sql_parsing {
+
+namespace {
+
+inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool IsIdentifierStart(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+inline bool IsIdentifierChar(char c) { return IsIdentifierStart(c) || IsDigit(c) || c == '$'; }
+
+// Separates tokens in the fingerprint. Tokenize rejects queries containing it.
+constexpr char kTokenSeparator = '\0';
+
+}  // namespace
+
+size_t SQLFingerprinter::ScanQuoted(std::string_view sql, size_t start) {
+  char quote = sql[start];
+  size_t i = start + 1;
+  while (i < sql.size()) {
+    if (sql[i] == '\\') {
+      return std::string_view::npos;
+    }
+    if (sql[i] == quote) {
+      // A doubled quote is an escaped quote inside the token.
+      if (i + 1 < sql.size() && sql[i + 1] == quote) {
+        i += 2;
+        continue;
+      }
+      return i + 1;
+    }
+    ++i;
+  }
+  return std::string_view::npos;
+}
+
+void SQLFingerprinter::AppendToFingerprint(std::string_view sql, const SQLToken& token,
+                                           bool after_space) {
+  // Whether a token is separated from the previous one matters to the grammar (eg. N'abc' vs
+  // N 'abc'), so it is part of the fingerprint.
+  fingerprint_.push_back(after_space ? ' ' : kTokenSeparator);
+  auto text = sql.substr(token.start, token.length);
+  switch (token.kind) {
+    case SQLToken::OTHER:
+      fingerprint_.push_back('o');
+      fingerprint_.append(text);
+      break;
+    case SQLToken::STRING:
+      // Keep only the quote character.
+      fingerprint_.push_back('s');
+      fingerprint_.push_back(text[0]);
+      break;
+    case SQLToken::NUMBER:
+      // Keep the shape of the number, with every run of digits collapsed to a single 9, so that
+      // eg. 12 and 1.5 or 0x1F get different fingerprints.
+      fingerprint_.push_back('n');
+      for (size_t i = 0; i < text.size(); ++i) {
+        if (!IsDigit(text[i])) {
+          fingerprint_.push_back(text[i]);
+        } else if (i == 0 || !IsDigit(text[i - 1])) {
+          fingerprint_.push_back('9');
+        }
+      }
+      break;
+  }
+}
+
+bool SQLFingerprinter::Tokenize(std::string_view sql) {
+  tokens_.clear();
+  fingerprint_.clear();
+  bool after_space = false;
+  size_t i = 0;
+  while (i < sql.size()) {
+    char c = sql[i];
+    char next = i + 1 < sql.size() ? sql[i + 1] : kTokenSeparator;
+    if (c == kTokenSeparator || (c & 0x80) != 0) {
+      return false;
+    }
+    if (IsSpace(c)) {
+      after_space = true;
+      ++i;
+      continue;
+    }
+    // Comments and escapes are left to the full parser.
+    if ((c == '-' && next == '-') || (c == '/' && next == '*') || c == '#' || c == '\\') {
+      return false;
+    }
+
+    SQLToken token{i, 0, SQLToken::OTHER};
+    if (string_quotes_.find(c) != std::string_view::npos || c == identifier_quote_) {
+      i = ScanQuoted(sql, i);
+      if (i == std::string_view::npos) {
+        return false;
+      }
+      if (c != identifier_quote_) {
+        token.kind = SQLToken::STRING;
+      }
+    } else if (IsDigit(c) || (c == '.' && IsDigit(next))) {
+      while (i < sql.size() && (IsIdentifierChar(sql[i]) || sql[i] == '.')) {
+        ++i;
+      }
+      token.kind = SQLToken::NUMBER;
+    } else if (c == '$') {
+      // Only numbered placeholders, eg. $1. Anything else is dollar quoting.
+      if (!IsDigit(next)) {
+        return false;
+      }
+      ++i;
+      while (i < sql.size() && IsDigit(sql[i])) {
+        ++i;
+      }
+    } else if (IsIdentifierStart(c) || c == '@') {
+      while (i < sql.size() && sql[i] == '@') {
+        ++i;
+      }
+      while (i < sql.size() && IsIdentifierChar(sql[i])) {
+        ++i;
+      }
+    } else {
+      ++i;
+    }
+    token.length = i - token.start;
+    tokens_.push_back(token);
+    AppendToFingerprint(sql, token, after_space);
+    after_space = false;
+  }
+  return true;
+}
+
+int SQLFingerprinter::TokenAt(size_t offset) const {
+  auto it = std::lower_bound(tokens_.begin(), tokens_.end(), offset,
+                             [](const SQLToken& token, size_t off) { return token.start < off; });
+  if (it == tokens_.end() || it->start != offset) {
+    return -1;
+  }
+  return static_cast<int>(it - tokens_.begin());
+}
+
+}  // namespace sql_parsing
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace px {
+namespace carnot {
+namespace builtins {
+namespace sql_parsing {
+
+struct SQLToken {
+  enum Kind {
+    OTHER = 0,
+    STRING = 1,
+    NUMBER = 2,
+  };
+  size_t start;
+  size_t length;
+  Kind kind;
+};
+
+/**
+ * SQLFingerprinter splits a query into tokens with a small hand-written lexer, and builds a
+ * fingerprint of the query in which the values of string and number literals are masked out.
+ * Queries with the same fingerprint differ only in their literal values, so the grammar
+ * classifies their tokens the same way.
+ *
+ * The lexer only handles plain SQL. Queries with comments, backslashes, dollar quoting or
+ * non-ASCII bytes are rejected, and should go through the full parser instead.
+ * The token and fingerprint buffers are reused between calls to Tokenize.
+ */
+class SQLFingerprinter {
+ public:
+  /**
+   * @param string_quotes: Characters that start a string literal in this SQL dialect.
+   * @param identifier_quote: Character that starts a quoted identifier in this SQL dialect.
+   */
+  SQLFingerprinter(std::string_view string_quotes, char identifier_quote)
+      : string_quotes_(string_quotes), identifier_quote_(identifier_quote) {}
+
+  /**
+   * Tokenizes the query and computes its fingerprint.
+   * @return false if the query contains syntax the lexer doesn't handle.
+   */
+  bool Tokenize(std::string_view sql);
+
+  /**
+   * Returns the index of the token that starts at the given offset into the query, or -1 if no
+   * token starts there.
+   */
+  int TokenAt(size_t offset) const;
+
+  const std::vector<SQLToken>& tokens() const { return tokens_; }
+  const std::string& fingerprint() const { return fingerprint_; }
+
+ private:
+  // Returns the offset just past the closing quote of the quoted token starting at start, or
+  // std::string_view::npos if the token is unterminated or contains a backslash.
+  static size_t ScanQuoted(std::string_view sql, size_t start);
+  void AppendToFingerprint(std::string_view sql, const SQLToken& token, bool after_space);
+
+  std::string_view string_quotes_;
+  char identifier_quote_;
+  std::vector<SQLToken> tokens_;
+  std::string fingerprint_;
+};
+
+}  // namespace sql_parsing
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
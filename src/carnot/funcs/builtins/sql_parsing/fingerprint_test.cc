@@ -0,0 +1,79 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string>
+
+#include "src/carnot/funcs/builtins/sql_parsing/fingerprint.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+namespace sql_parsing {
+
+std::string Fingerprint(SQLFingerprinter* fingerprinter, std::string_view sql) {
+  EXPECT_TRUE(fingerprinter->Tokenize(sql)) << sql;
+  return fingerprinter->fingerprint();
+}
+
+TEST(SQLFingerprinter, tokens) {
+  SQLFingerprinter fingerprinter("'\"", '`');
+  ASSERT_TRUE(fingerprinter.Tokenize("SELECT `a b` FROM t WHERE c='it''s' AND d>=1.5e3"));
+
+  const auto& tokens = fingerprinter.tokens();
+  ASSERT_EQ(13, tokens.size());
+  EXPECT_EQ(7, tokens[1].start);
+  EXPECT_EQ(5, tokens[1].length);
+  EXPECT_EQ(SQLToken::OTHER, tokens[1].kind);
+  EXPECT_EQ(SQLToken::STRING, tokens[7].kind);
+  EXPECT_EQ(7, tokens[7].length);
+  EXPECT_EQ(SQLToken::NUMBER, tokens[12].kind);
+  EXPECT_EQ(5, tokens[12].length);
+
+  EXPECT_EQ(7, fingerprinter.TokenAt(tokens[7].start));
+  EXPECT_EQ(-1, fingerprinter.TokenAt(tokens[7].start + 1));
+}
+
+TEST(SQLFingerprinter, literals_masked) {
+  SQLFingerprinter fingerprinter("'\"", '`');
+  auto fingerprint = Fingerprint(&fingerprinter, "SELECT * FROM t WHERE a=1 AND b='x'");
+
+  EXPECT_EQ(fingerprint, Fingerprint(&fingerprinter, "SELECT * FROM t WHERE a=123 AND b='yy'"));
+  EXPECT_EQ(fingerprint, Fingerprint(&fingerprinter, "SELECT *  FROM t\nWHERE a=123 AND b='yy'"));
+  // Everything other than literal values is part of the fingerprint.
+  EXPECT_NE(fingerprint, Fingerprint(&fingerprinter, "SELECT * FROM t WHERE a=1.5 AND b='x'"));
+  EXPECT_NE(fingerprint, Fingerprint(&fingerprinter, "SELECT * FROM t WHERE a=1 AND b=\"x\""));
+  EXPECT_NE(fingerprint, Fingerprint(&fingerprinter, "SELECT * FROM u WHERE a=1 AND b='x'"));
+  EXPECT_NE(fingerprint, Fingerprint(&fingerprinter, "SELECT * FROM t WHERE a= 1 AND b='x'"));
+  EXPECT_NE(fingerprint, Fingerprint(&fingerprinter, "select * FROM t WHERE a=1 AND b='x'"));
+}
+
+TEST(SQLFingerprinter, unsupported_syntax) {
+  SQLFingerprinter fingerprinter("'", '"');
+  EXPECT_TRUE(fingerprinter.Tokenize("SELECT * FROM t WHERE a=$1"));
+  EXPECT_FALSE(fingerprinter.Tokenize("SELECT $$abc$$"));
+  EXPECT_FALSE(fingerprinter.Tokenize("SELECT 1 -- comment"));
+  EXPECT_FALSE(fingerprinter.Tokenize("SELECT /* comment */ 1"));
+  EXPECT_FALSE(fingerprinter.Tokenize(R"(SELECT E'\\xDEADBEEF')"));
+  EXPECT_FALSE(fingerprinter.Tokenize("SELECT 'unterminated"));
+  EXPECT_FALSE(fingerprinter.Tokenize("SELECT '\xc3\xa9'"));
+}
+
+}  // namespace sql_parsing
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
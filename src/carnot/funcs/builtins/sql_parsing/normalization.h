@@ -41,6 +41,7 @@
 #include "pgsql_parser/PostgresSQLLexer.h"
 #include "pgsql_parser/PostgresSQLParser.h"
 #include "src/carnot/funcs/builtins/sql_parsing/antlr_parse.h"
+#include "src/carnot/funcs/builtins/sql_parsing/fingerprint.h"
 #include "src/common/base/logging.h"
 #include "src/common/base/statusor.h"
 #include "src/common/base/utils.h"
@@ -72,6 +73,9 @@ struct ParserTypeTraits<pgsql_parser::PostgresSQLParser> {
       pgsql_parser::PostgresSQLParser::RuleUnsigned_value_specification;
   static constexpr size_t param_placeholder_rule_index =
       pgsql_parser::PostgresSQLParser::RuleDollar_number;
+
+  static constexpr char string_quotes[] = "'";
+  static constexpr char identifier_quote = '"';
 };
 
 template <>
@@ -88,6 +92,9 @@ struct ParserTypeTraits<mysql_parser::MySQLParser> {
   static constexpr size_t constant_rule_index = mysql_parser::MySQLParser::RuleConstant;
   static constexpr size_t param_placeholder_rule_index =
       mysql_parser::MySQLParser::RuleMysqlVariable;
+
+  static constexpr char string_quotes[] = "'\"";
+  static constexpr char identifier_quote = '`';
 };
 
 struct SQLFragment {
@@ -219,31 +226,17 @@ class ConstantFragmentHandler : public SQLFragmentHandler {
 };
 
 /**
- * normalize_sql replaces table names and constants in a sql query with placeholders, inplace.
- * @param sql: Unnormalized SQL query.
- * @param param_values: Parameters already account for in the unnormalized version of the query. For
- * non-EXECUTE type queries this should be empty.
- * @return status or result, whether the query was successful or not and if it was the normalization
- * result.
+ * ParseFragments parses a sql query and returns its constant and parameter placeholder fragments,
+ * in the order they appear in the query.
  */
 template <typename TParser, typename TLexer, typename TCharStream = antlr4::ANTLRInputStream>
-StatusOr<NormalizeResult> normalize_sql(std::string sql,
-                                        const std::vector<std::string>& param_values) {
+StatusOr<std::vector<SQLFragment>> ParseFragments(const std::string& sql) {
   AntlrParser<TParser, TLexer, TCharStream> parser(sql);
   ParserRuleFragmentListener listener({ParserTypeTraits<TParser>::constant_rule_index,
                                        ParserTypeTraits<TParser>::param_placeholder_rule_index},
                                       {SQLFragment::CONSTANT, SQLFragment::PARAM_PLACEHOLDER});
   PL_RETURN_IF_ERROR(parser.ParseWalk(&listener));
 
-  NormalizationState state;
-  NormalizeResult result;
-  result.normalized_query = sql;
-  CalculateLineOffsets(sql, &state);
-  state.next_placeholder = ParserTypeTraits<TParser>::FirstPlaceholder();
-
-  ConstantFragmentHandler<TParser> constant_handler(&state, &result);
-  ParamFragmentHandler<TParser> param_handler(param_values, &state, &result);
-
   // Sort fragments into the order they appear in the query.
   std::vector<SQLFragment> sorted_fragments(listener.fragments());
   std::sort(sorted_fragments.begin(), sorted_fragments.end(), [](SQLFragment a, SQLFragment b) {
@@ -252,6 +245,28 @@ StatusOr<NormalizeResult> normalize_sql(std::string sql,
     }
     return a.start_char_index < b.start_char_index;
   });
+  return sorted_fragments;
+}
+
+/**
+ * NormalizeFragments replaces the given fragments of a sql query with placeholders.
+ * @param sql: Unnormalized SQL query.
+ * @param sorted_fragments: Fragments of the query, in the order they appear in the query.
+ * @param param_values: Parameters already account for in the unnormalized version of the query.
+ * @param state: Normalization state, with the line offsets that the fragment positions are relative
+ * to already calculated.
+ */
+template <typename TParser>
+StatusOr<NormalizeResult> NormalizeFragments(const std::string& sql,
+                                             const std::vector<SQLFragment>& sorted_fragments,
+                                             const std::vector<std::string>& param_values,
+                                             NormalizationState* state) {
+  NormalizeResult result;
+  result.normalized_query = sql;
+  state->next_placeholder = ParserTypeTraits<TParser>::FirstPlaceholder();
+
+  ConstantFragmentHandler<TParser> constant_handler(state, &result);
+  ParamFragmentHandler<TParser> param_handler(param_values, state, &result);
 
   for (const auto& fragment : sorted_fragments) {
     switch (fragment.type) {
@@ -266,6 +281,116 @@ StatusOr<NormalizeResult> normalize_sql(std::string sql,
   return result;
 }
 
+/**
+ * normalize_sql replaces table names and constants in a sql query with placeholders, inplace.
+ * @param sql: Unnormalized SQL query.
+ * @param param_values: Parameters already account for in the unnormalized version of the query. For
+ * non-EXECUTE type queries this should be empty.
+ * @return status or result, whether the query was successful or not and if it was the normalization
+ * result.
+ */
+template <typename TParser, typename TLexer, typename TCharStream = antlr4::ANTLRInputStream>
+StatusOr<NormalizeResult> normalize_sql(std::string sql,
+                                        const std::vector<std::string>& param_values) {
+  PL_ASSIGN_OR_RETURN(auto sorted_fragments, (ParseFragments<TParser, TLexer, TCharStream>(sql)));
+  NormalizationState state;
+  CalculateLineOffsets(sql, &state);
+  return NormalizeFragments<TParser>(sql, sorted_fragments, param_values, &state);
+}
+
+// Maximum number of query fingerprints a CachedNormalizer remembers.
+constexpr size_t kMaxCachedFingerprints = 4096;
+
+/**
+ * CachedNormalizer normalizes sql queries like normalize_sql, but only runs the full parser once
+ * per query fingerprint (see SQLFingerprinter).
+ *
+ * The first time a fingerprint is seen, the query is parsed and its fragments are matched up with
+ * the fingerprinter's tokens. If every fragment is exactly one token, the fingerprint's template
+ * records which tokens are fragments. Later queries with the same fingerprint only need to be
+ * tokenized: their fragments are rebuilt from the template and normalized by the same handlers as
+ * normalize_sql, so the result is identical. Fingerprints whose fragments don't line up with tokens
+ * keep going through the full parser.
+ */
+template <typename TParser, typename TLexer, typename TCharStream = antlr4::ANTLRInputStream>
+class CachedNormalizer {
+ public:
+  CachedNormalizer()
+      : fingerprinter_(ParserTypeTraits<TParser>::string_quotes,
+                       ParserTypeTraits<TParser>::identifier_quote) {}
+
+  StatusOr<NormalizeResult> Normalize(const std::string& sql,
+                                      const std::vector<std::string>& param_values) {
+    if (!fingerprinter_.Tokenize(sql)) {
+      return normalize_sql<TParser, TLexer, TCharStream>(sql, param_values);
+    }
+    auto it = templates_.find(fingerprinter_.fingerprint());
+    if (it == templates_.end()) {
+      PL_ASSIGN_OR_RETURN(auto sorted_fragments,
+                          (ParseFragments<TParser, TLexer, TCharStream>(sql)));
+      NormalizationState state;
+      CalculateLineOffsets(sql, &state);
+      AddTemplate(sql, sorted_fragments, state);
+      return NormalizeFragments<TParser>(sql, sorted_fragments, param_values, &state);
+    }
+    const FragmentTemplate& tmpl = it->second;
+    if (!tmpl.tokens_only) {
+      return normalize_sql<TParser, TLexer, TCharStream>(sql, param_values);
+    }
+
+    fragments_.clear();
+    for (const auto& [token_idx, type] : tmpl.fragments) {
+      const auto& token = fingerprinter_.tokens()[token_idx];
+      // Fragments are positioned relative to the start of the query, as if it were a single line.
+      fragments_.push_back(
+          SQLFragment{1, token.start, sql.substr(token.start, token.length), type});
+    }
+    NormalizationState state;
+    state.line_start_offsets.push_back(0);
+    return NormalizeFragments<TParser>(sql, fragments_, param_values, &state);
+  }
+
+  size_t num_cached_fingerprints() const { return templates_.size(); }
+
+ private:
+  struct FragmentTemplate {
+    // Whether every fragment lined up with a token, so that the template can be used.
+    bool tokens_only = true;
+    // The token index and type of each fragment, in query order.
+    std::vector<std::pair<size_t, SQLFragment::FragmentType>> fragments;
+  };
+
+  void AddTemplate(const std::string& sql, const std::vector<SQLFragment>& sorted_fragments,
+                   const NormalizationState& state) {
+    if (templates_.size() >= kMaxCachedFingerprints) {
+      templates_.clear();
+    }
+    FragmentTemplate tmpl;
+    for (const auto& fragment : sorted_fragments) {
+      size_t offset = state.line_start_offsets[fragment.line - 1] + fragment.start_char_index;
+      int token_idx = fingerprinter_.TokenAt(offset);
+      if (token_idx == -1 || fingerprinter_.tokens()[token_idx].length != fragment.text.length() ||
+          sql.compare(offset, fragment.text.length(), fragment.text) != 0) {
+        tmpl.tokens_only = false;
+        tmpl.fragments.clear();
+        break;
+      }
+      tmpl.fragments.emplace_back(token_idx, fragment.type);
+    }
+    templates_.emplace(fingerprinter_.fingerprint(), std::move(tmpl));
+  }
+
+  SQLFingerprinter fingerprinter_;
+  absl::flat_hash_map<std::string, FragmentTemplate> templates_;
+  // Reused between queries that hit the cache.
+  std::vector<SQLFragment> fragments_;
+};
+
+using PgSQLNormalizer =
+    CachedNormalizer<pgsql_parser::PostgresSQLParser, pgsql_parser::PostgresSQLLexer>;
+using MySQLNormalizer =
+    CachedNormalizer<mysql_parser::MySQLParser, mysql_parser::MySQLLexer, UpperCaseCharStream>;
+
 StatusOr<NormalizeResult> normalize_pgsql(std::string sql,
                                           const std::vector<std::string>& param_values);
 
@@ -19,6 +19,11 @@
 #include <gflags/gflags.h>
 
 #include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
 #include "src/carnot/funcs/builtins/sql_parsing/normalization.h"
 #include "src/common/perf/perf.h"
 
@@ -72,3 +77,58 @@ BENCHMARK_CAPTURE(BM_NormalizeMySQL, sock_shop,
                   "JOIN sock_tag ON sock.sock_id=sock_tag.sock_id JOIN tag ON "
                   "sock_tag.tag_id=tag.tag_id "
                   "WHERE sock.sock_id =abcde GROUP BY sock.sock_id;");
+
+// A query log like the ones captured from a MySQL backed app: a handful of statements repeated with
+// different literal values.
+static std::vector<std::string> MySQLQueryLog() {
+  std::vector<std::string> log;
+  for (int i = 0; i < 1000; ++i) {
+    switch (i % 4) {
+      case 0:
+        log.push_back(absl::Substitute(
+            "SELECT sock.sock_id AS id, sock.name, sock.price FROM sock JOIN sock_tag ON "
+            "sock.sock_id=sock_tag.sock_id WHERE sock.sock_id='$0' GROUP BY sock.sock_id;",
+            i * 7919));
+        break;
+      case 1:
+        log.push_back(
+            absl::Substitute("SELECT * FROM cart WHERE customer_id=$0 LIMIT $1", i, i % 50));
+        break;
+      case 2:
+        log.push_back(absl::Substitute(
+            "INSERT INTO orders (customer_id, total, status) VALUES ($0, $1.$2, 'pending')", i,
+            i % 100, i % 10));
+        break;
+      case 3:
+        log.push_back(absl::Substitute("UPDATE sock SET count=$0 WHERE sock_id='$1'", i % 30, i));
+        break;
+    }
+  }
+  return log;
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_NormalizeMySQLQueryLog(benchmark::State& state) {
+  auto log = MySQLQueryLog();
+  for (auto _ : state) {
+    for (const auto& query : log) {
+      benchmark::DoNotOptimize(px::carnot::builtins::sql_parsing::normalize_mysql(query, {}));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * log.size());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_CachedNormalizeMySQLQueryLog(benchmark::State& state) {
+  auto log = MySQLQueryLog();
+  px::carnot::builtins::sql_parsing::MySQLNormalizer normalizer;
+  for (auto _ : state) {
+    for (const auto& query : log) {
+      benchmark::DoNotOptimize(normalizer.Normalize(query, {}));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * log.size());
+}
+
+BENCHMARK(BM_NormalizeMySQLQueryLog);
+BENCHMARK(BM_CachedNormalizeMySQLQueryLog);
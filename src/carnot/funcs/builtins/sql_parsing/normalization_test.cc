@@ -54,6 +54,23 @@ TEST_P(NormPGSQLTest, basic) {
   EXPECT_EQ(result.errmsg, test_case.expected_result.errmsg);
 }
 
+TEST_P(NormPGSQLTest, cached) {
+  auto test_case = GetParam();
+
+  // The second call normalizes from the cached fingerprint template.
+  PgSQLNormalizer normalizer;
+  for (int i = 0; i < 2; ++i) {
+    auto result_or_s = normalizer.Normalize(test_case.input_sql_str, test_case.input_params);
+
+    ASSERT_OK(result_or_s);
+    auto result = result_or_s.ConsumeValueOrDie();
+
+    EXPECT_EQ(result.normalized_query, test_case.expected_result.normalized_query);
+    EXPECT_EQ(result.params, test_case.expected_result.params);
+    EXPECT_EQ(result.errmsg, test_case.expected_result.errmsg);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     NormPGSQLVariants, NormPGSQLTest,
     ::testing::Values(
@@ -158,6 +175,23 @@ TEST_P(NormMySQLTest, basic) {
   EXPECT_EQ(result.errmsg, test_case.expected_result.errmsg);
 }
 
+TEST_P(NormMySQLTest, cached) {
+  auto test_case = GetParam();
+
+  // The second call normalizes from the cached fingerprint template.
+  MySQLNormalizer normalizer;
+  for (int i = 0; i < 2; ++i) {
+    auto result_or_s = normalizer.Normalize(test_case.input_sql_str, test_case.input_params);
+
+    ASSERT_OK(result_or_s);
+    auto result = result_or_s.ConsumeValueOrDie();
+
+    EXPECT_EQ(result.normalized_query, test_case.expected_result.normalized_query);
+    EXPECT_EQ(result.params, test_case.expected_result.params);
+    EXPECT_EQ(result.errmsg, test_case.expected_result.errmsg);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     NormMySQLVariants, NormMySQLTest,
     ::testing::Values(
@@ -237,6 +271,40 @@ INSTANTIATE_TEST_SUITE_P(
             },
         }));
 
+TEST(CachedNormalizer, same_fingerprint_different_literals) {
+  MySQLNormalizer normalizer;
+
+  ASSERT_OK_AND_ASSIGN(auto first,
+                       normalizer.Normalize("SELECT * FROM test WHERE a=1 AND b='x'", {}));
+  ASSERT_OK_AND_ASSIGN(auto second,
+                       normalizer.Normalize("SELECT * FROM test WHERE a=234 AND b='yz'", {}));
+  EXPECT_EQ(1, normalizer.num_cached_fingerprints());
+
+  EXPECT_EQ(first.normalized_query, "SELECT * FROM test WHERE a=? AND b=?");
+  EXPECT_EQ(second.normalized_query, "SELECT * FROM test WHERE a=? AND b=?");
+  EXPECT_THAT(second.params, ::testing::ElementsAre("234", "'yz'"));
+
+  // A different shape of number literal gets its own fingerprint.
+  ASSERT_OK_AND_ASSIGN(auto third,
+                       normalizer.Normalize("SELECT * FROM test WHERE a=2.5 AND b='x'", {}));
+  EXPECT_EQ(2, normalizer.num_cached_fingerprints());
+  EXPECT_THAT(third.params, ::testing::ElementsAre("2.5", "'x'"));
+}
+
+TEST(CachedNormalizer, params_from_cached_template) {
+  PgSQLNormalizer normalizer;
+
+  ASSERT_OK_AND_ASSIGN(auto first, normalizer.Normalize("SELECT * FROM t WHERE a=$1 AND b=2",
+                                                        {"'abc'"}));
+  ASSERT_OK_AND_ASSIGN(auto second, normalizer.Normalize("SELECT * FROM t WHERE a=$1 AND b=3",
+                                                         {"'def'"}));
+  EXPECT_EQ(second.normalized_query, "SELECT * FROM t WHERE a=$1 AND b=$2");
+  EXPECT_THAT(second.params, ::testing::ElementsAre("'def'", "3"));
+
+  // Errors from the fragment handlers are the same as without the cache.
+  EXPECT_NOT_OK(normalizer.Normalize("SELECT * FROM t WHERE a=$1 AND b=3", {}));
+}
+
 }  // namespace sql_parsing
 }  // namespace builtins
 }  // namespace carnot
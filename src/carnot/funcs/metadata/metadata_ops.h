@@ -99,6 +99,8 @@ class UPIDToASIDUDF : public ScalarUDF {
 
 class PodIDToPodNameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
 
@@ -123,6 +125,8 @@ class PodIDToPodNameUDF : public ScalarUDF {
 
 class PodNameToPodIDUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
     return GetPodID(md, pod_name);
@@ -146,6 +150,8 @@ class PodNameToPodIDUDF : public ScalarUDF {
 
 class PodNameToPodIPUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue pod_name) {
     auto md = GetMetadataState(ctx);
     StringValue pod_id = PodNameToPodIDUDF::GetPodID(md, pod_name);
@@ -167,6 +173,8 @@ class PodNameToPodIPUDF : public ScalarUDF {
 
 class PodIDToNamespaceUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue pod_id) {
     auto md = GetMetadataState(ctx);
 
@@ -213,6 +221,8 @@ class PodNameToNamespaceUDF : public ScalarUDF {
 
 class UPIDToContainerIDUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
 
@@ -254,6 +264,8 @@ inline const md::ContainerInfo* UPIDToContainer(const px::md::AgentMetadataState
 
 class UPIDToContainerNameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto container_info = UPIDToContainer(md, upid_value);
@@ -319,6 +331,8 @@ inline types::StringValue StringifyVector(const std::vector<std::string>& vec) {
 
 class UPIDToNamespaceUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto pod_info = UPIDtoPod(md, upid_value);
@@ -351,6 +365,8 @@ class UPIDToNamespaceUDF : public ScalarUDF {
 
 class UPIDToPodIDUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto container_info = UPIDToContainer(md, upid_value);
@@ -378,6 +394,8 @@ class UPIDToPodIDUDF : public ScalarUDF {
 
 class UPIDToPodNameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto pod_info = UPIDtoPod(md, upid_value);
@@ -409,6 +427,8 @@ class UPIDToPodNameUDF : public ScalarUDF {
 
 class ServiceIDToServiceNameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue service_id) {
     auto md = GetMetadataState(ctx);
 
@@ -437,6 +457,8 @@ class ServiceIDToServiceNameUDF : public ScalarUDF {
 
 class ServiceIDToClusterIPUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue service_id) {
     auto md = GetMetadataState(ctx);
     const auto* service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
@@ -462,6 +484,8 @@ class ServiceIDToClusterIPUDF : public ScalarUDF {
 
 class ServiceIDToExternalIPsUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue service_id) {
     auto md = GetMetadataState(ctx);
     const auto* service_info = md->k8s_metadata_state().ServiceInfoByID(service_id);
@@ -485,6 +509,8 @@ class ServiceIDToExternalIPsUDF : public ScalarUDF {
 
 class ServiceNameToServiceIDUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, StringValue service_name) {
     auto md = GetMetadataState(ctx);
     // This UDF expects the service name to be in the format of "<ns>/<service-name>".
@@ -537,6 +563,8 @@ class ServiceNameToNamespaceUDF : public ScalarUDF {
  */
 class UPIDToServiceIDUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto pod_info = UPIDtoPod(md, upid_value);
@@ -550,7 +578,7 @@ class UPIDToServiceIDUDF : public ScalarUDF {
         continue;
       }
       if (service_info->stop_time_ns() == 0) {
-        running_service_ids.push_back(service_id);
+        running_service_ids.push_back(service_id.str());
       }
     }
 
@@ -579,6 +607,8 @@ class UPIDToServiceIDUDF : public ScalarUDF {
  */
 class UPIDToServiceNameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto pod_info = UPIDtoPod(md, upid_value);
@@ -625,6 +655,8 @@ class UPIDToServiceNameUDF : public ScalarUDF {
  */
 class UPIDToNodeNameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto pod_info = UPIDtoPod(md, upid_value);
@@ -657,6 +689,8 @@ class UPIDToNodeNameUDF : public ScalarUDF {
  */
 class UPIDToHostnameUDF : public ScalarUDF {
  public:
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto pod_info = UPIDtoPod(md, upid_value);
@@ -742,7 +776,7 @@ class PodIDToServiceIDUDF : public ScalarUDF {
         continue;
       }
       if (service_info->stop_time_ns() == 0) {
-        running_service_ids.push_back(service_id);
+        running_service_ids.push_back(service_id.str());
       }
     }
     return StringifyVector(running_service_ids);
@@ -857,7 +891,7 @@ class PodNameToServiceIDUDF : public ScalarUDF {
         continue;
       }
       if (service_info->stop_time_ns() == 0) {
-        running_service_ids.push_back(service_id);
+        running_service_ids.push_back(service_id.str());
       }
     }
     return StringifyVector(running_service_ids);
@@ -1326,6 +1360,8 @@ class UPIDToPodStatusUDF : public ScalarUDF {
    * @param upid_vlue: the UPID to query for.
    * @return StringValue: the status of the pod.
    */
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     return PodInfoToPodStatus(UPIDtoPod(md, upid_value));
@@ -1365,6 +1401,8 @@ class UPIDToCmdLineUDF : public ScalarUDF {
    * @param upid_value: The UPID value
    * @return StringValue: the cmdline for the UPID.
    */
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     auto upid_uint128 = absl::MakeUint128(upid_value.High64(), upid_value.Low64());
@@ -1406,6 +1444,8 @@ class UPIDToPodQoSUDF : public ScalarUDF {
    * @param upid_value: The UPID value
    * @return StringValue: the cmdline for the UPID.
    */
+  static constexpr bool IsPure() { return true; }
+
   StringValue Exec(FunctionContext* ctx, UInt128Value upid_value) {
     auto md = GetMetadataState(ctx);
     return PodInfoToPodQoS(UPIDtoPod(md, upid_value));
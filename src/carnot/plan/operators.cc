@@ -102,6 +102,7 @@ Status MemorySourceOperator::Init(const planpb::MemorySourceOperator& pb) {
   for (int i = 0; i < pb_.column_idxs_size(); ++i) {
     column_idxs_.emplace_back(pb_.column_idxs(i));
   }
+  tablets_.assign(pb_.tablets().begin(), pb_.tablets().end());
   is_initialized_ = true;
   return Status::OK();
 }
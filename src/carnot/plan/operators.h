@@ -96,11 +96,13 @@ class MemorySourceOperator : public Operator {
   int64_t stop_time() const { return pb_.stop_time().value(); }
   std::vector<int64_t> Columns() const { return column_idxs_; }
   const types::TabletID& Tablet() const { return pb_.tablet(); }
+  const std::vector<types::TabletID>& Tablets() const { return tablets_; }
   bool infinite_stream() const { return pb_.streaming(); }
 
  private:
   planpb::MemorySourceOperator pb_;
   std::vector<int64_t> column_idxs_;
+  std::vector<types::TabletID> tablets_;
 };
 
 class MapOperator : public Operator {
@@ -215,6 +217,11 @@ class GRPCSinkOperator : public Operator {
   }
   std::string table_name() const { return pb_.output_table().table_name(); }
 
+  // The encoding the planner picked for row batches sent to a GRPCSource.
+  planpb::GRPCSinkOperator::RowBatchEncoding row_batch_encoding() const {
+    return pb_.row_batch_encoding();
+  }
+
  private:
   planpb::GRPCSinkOperator pb_;
 };
@@ -60,13 +60,16 @@ StatusOr<std::shared_ptr<IR>> Compiler::CompileToIR(const std::string& query,
                                                     CompilerState* compiler_state,
                                                     const ExecFuncs& exec_funcs) {
   PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> ir, QueryToIR(query, compiler_state, exec_funcs));
-  PL_RETURN_IF_ERROR(Analyze(ir.get(), compiler_state));
-  PL_RETURN_IF_ERROR(Optimize(ir.get(), compiler_state));
-
-  PL_RETURN_IF_ERROR(VerifyGraphHasResultSink(ir.get()));
+  PL_RETURN_IF_ERROR(CompileIR(ir.get(), compiler_state));
   return ir;
 }
 
+Status Compiler::CompileIR(IR* ir, CompilerState* compiler_state) {
+  PL_RETURN_IF_ERROR(Analyze(ir, compiler_state));
+  PL_RETURN_IF_ERROR(Optimize(ir, compiler_state));
+  return VerifyGraphHasResultSink(ir);
+}
+
 Status Compiler::Analyze(IR* ir, CompilerState* compiler_state) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<Analyzer> analyzer, Analyzer::Create(compiler_state));
   return analyzer->Execute(ir);
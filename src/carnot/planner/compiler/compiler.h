@@ -53,6 +53,18 @@ class Compiler {
   StatusOr<std::shared_ptr<IR>> CompileToIR(const std::string& query,
                                             CompilerState* compiler_state);
 
+  /**
+   * @brief Parses the query and walks its AST into an IR, without analyzing or optimizing it.
+   * CompileToIR is QueryToIR followed by CompileIR.
+   */
+  StatusOr<std::shared_ptr<IR>> QueryToIR(const std::string& query, CompilerState* compiler_state,
+                                          const ExecFuncs& exec_funcs);
+
+  /**
+   * @brief Runs the analyzer and optimizer over an IR produced by QueryToIR.
+   */
+  Status CompileIR(IR* ir, CompilerState* compiler_state);
+
   /**
    * @brief Compiles the query to a Trace
    *
@@ -66,9 +78,6 @@ class Compiler {
                                                       const ExecFuncs& exec_funcs);
 
  private:
-  StatusOr<std::shared_ptr<IR>> QueryToIR(const std::string& query, CompilerState* compiler_state,
-                                          const ExecFuncs& exec_funcs);
-
   Status Analyze(IR* ir, CompilerState* compiler_state);
   Status Optimize(IR* ir, CompilerState* compiler_state);
   Status VerifyGraphHasResultSink(IR* ir);
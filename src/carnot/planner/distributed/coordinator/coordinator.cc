@@ -25,9 +25,11 @@
 #include <vector>
 
 #include "src/carnot/planner/distributed/coordinator/coordinator.h"
+#include "src/carnot/planner/distributed/coordinator/kelvin_partitioner.h"
 #include "src/carnot/planner/distributed/coordinator/plan_clusters.h"
 #include "src/carnot/planner/distributed/coordinator/prune_unavailable_sources_rule.h"
 #include "src/carnot/planner/distributed/coordinator/removable_ops_rule.h"
+#include "src/carnot/planner/distributed/coordinator/tablet_sources_rule.h"
 #include "src/carnot/planner/distributed/splitter/splitter.h"
 #include "src/carnot/planner/rules/rules.h"
 #include "src/carnot/udfspb/udfs.pb.h"
@@ -164,6 +166,50 @@ const distributedpb::CarnotInfo& CoordinatorImpl::GetRemoteProcessor() const {
   return remote_processor_nodes_[0];
 }
 
+bool CoordinatorImpl::CanPartitionAcrossKelvins() const {
+  // Kelvins that also store data run their own PEM plan, which the partitioner doesn't split.
+  for (const auto& remote_processor : remote_processor_nodes_) {
+    if (remote_processor.has_data_store()) {
+      return false;
+    }
+  }
+  return remote_processor_nodes_.size() > 1;
+}
+
+Status CoordinatorImpl::PartitionAcrossKelvins(DistributedPlan* distributed_plan,
+                                               const std::vector<IR*>& pem_plans,
+                                               const std::vector<int64_t>& source_node_ids) {
+  CarnotInstance* kelvin = distributed_plan->kelvin();
+  int64_t num_partitions = static_cast<int64_t>(remote_processor_nodes_.size());
+  KelvinPartitioner partitioner(compiler_state_, num_partitions);
+  PL_ASSIGN_OR_RETURN(bool can_partition, partitioner.Analyze(kelvin->plan(), pem_plans));
+  if (!can_partition) {
+    return Status::OK();
+  }
+
+  for (IR* pem_plan : pem_plans) {
+    PL_RETURN_IF_ERROR(partitioner.PartitionSinks(pem_plan));
+  }
+  for (int64_t i = 1; i < num_partitions; ++i) {
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> partition_plan_uptr,
+                        partitioner.CreatePartitionPlan(kelvin->plan(), i));
+    PL_ASSIGN_OR_RETURN(int64_t partition_node_id,
+                        distributed_plan->AddCarnot(remote_processor_nodes_[i]));
+    CarnotInstance* partition_kelvin = distributed_plan->Get(partition_node_id);
+    partition_kelvin->AddPlan(partition_plan_uptr.get());
+    distributed_plan->AddPlan(std::move(partition_plan_uptr));
+
+    for (int64_t source_node_id : source_node_ids) {
+      if (distributed_plan->HasNode(source_node_id)) {
+        distributed_plan->AddEdge(source_node_id, partition_node_id);
+      }
+    }
+    distributed_plan->AddEdge(partition_node_id, kelvin->id());
+    distributed_plan->AddPartitionKelvin(partition_kelvin);
+  }
+  return partitioner.AddGatherSources(kelvin->plan());
+}
+
 /**
  * A mapping of agent IDs to the corresponding plan.
  */
@@ -181,20 +227,9 @@ StatusOr<AgentToPlanMap> GetUniquePEMPlans(IR* query, DistributedPlan* plan,
       OperatorToAgentSet removable_ops_to_agents,
       MapRemovableOperatorsRule::GetRemovableOperators(plan, schema_map, all_agents, query));
   AgentToPlanMap agent_to_plan_map;
-  if (removable_ops_to_agents.empty()) {
-    // Create the default single PEM map.
-    PL_ASSIGN_OR_RETURN(auto default_ir_uptr, query->Clone());
-    auto default_ir = default_ir_uptr.get();
-    agent_to_plan_map.plan_pool.push_back(std::move(default_ir_uptr));
-    for (int64_t carnot_i : carnot_instances) {
-      agent_to_plan_map.agent_to_plan_map[carnot_i] = default_ir;
-    }
-    agent_to_plan_map.plan_to_agents[default_ir] = all_agents;
-    return agent_to_plan_map;
-  }
-
   std::vector<PlanCluster> clusters = ClusterOperators(removable_ops_to_agents);
-  // Cluster representing the original plan if any exist.
+  // Cluster representing the original plan if any exist. Without removable operators, this is the
+  // default single PEM plan.
   auto remaining_agents = RemainingAgents(removable_ops_to_agents, all_agents);
   if (!remaining_agents.empty()) {
     clusters.emplace_back(remaining_agents, absl::flat_hash_set<OperatorIR*>{});
@@ -202,6 +237,11 @@ StatusOr<AgentToPlanMap> GetUniquePEMPlans(IR* query, DistributedPlan* plan,
   for (const auto& c : clusters) {
     PL_ASSIGN_OR_RETURN(auto cluster_plan_uptr, c.CreatePlan(query));
     auto cluster_plan = cluster_plan_uptr.get();
+    // Read the tablets the cluster's agents hold, which may prune away sources.
+    PL_ASSIGN_OR_RETURN(auto table_to_tablets,
+                        TabletSourcesRule::CollectTablets(plan, c.agent_set));
+    TabletSourcesRule tablet_sources_rule(table_to_tablets);
+    PL_RETURN_IF_ERROR(tablet_sources_rule.Execute(cluster_plan));
     if (cluster_plan->FindNodesThatMatch(Operator()).empty()) {
       continue;
     }
@@ -286,6 +326,14 @@ StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const
   PL_RETURN_IF_ERROR(prune_sources_rule.Apply(remote_carnot));
 
   distributed_plan->SetKelvin(remote_carnot);
+  if (CanPartitionAcrossKelvins()) {
+    std::vector<IR*> pem_plans;
+    for (const auto& [plan, agents] : agent_to_plan_map.plan_to_agents) {
+      pem_plans.push_back(plan);
+    }
+    PL_RETURN_IF_ERROR(
+        PartitionAcrossKelvins(distributed_plan.get(), pem_plans, source_node_ids));
+  }
   distributed_plan->AddPlanToAgentMap(std::move(agent_to_plan_map.plan_to_agents));
 
   return distributed_plan;
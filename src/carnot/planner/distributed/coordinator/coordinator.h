@@ -80,7 +80,8 @@ class Coordinator : public NotCopyable {
 
 /**
  * @brief This coordinator creates a plan layout with 1 remote processor getting data
- * from N sources. If the passed in plan has special conditions, it will split differntly.
+ * from N sources. If the passed in plan has special conditions, it will split differntly. Grouped
+ * aggregates and joins are hash-partitioned across every remote processor when there are several.
  *
  */
 class CoordinatorImpl : public Coordinator {
@@ -92,6 +93,16 @@ class CoordinatorImpl : public Coordinator {
 
  private:
   const distributedpb::CarnotInfo& GetRemoteProcessor() const;
+  bool CanPartitionAcrossKelvins() const;
+
+  /**
+   * @brief Spreads the Kelvin portion of the plan across every remote processor with a
+   * hash-partitioned exchange, when the plan allows it. Otherwise the plan stays on a single
+   * Kelvin.
+   */
+  Status PartitionAcrossKelvins(DistributedPlan* distributed_plan,
+                                const std::vector<IR*>& pem_plans,
+                                const std::vector<int64_t>& source_node_ids);
   bool HasExecutableNodes(const IR* plan);
 
   /**
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/distributed/coordinator/kelvin_partitioner.h"
+#include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/column_ir.h"
+#include "src/carnot/planner/ir/func_ir.h"
+#include "src/carnot/planner/ir/grpc_sink_ir.h"
+#include "src/carnot/planner/ir/grpc_source_group_ir.h"
+#include "src/carnot/planner/ir/int_ir.h"
+#include "src/carnot/planner/ir/join_ir.h"
+#include "src/carnot/planner/ir/map_ir.h"
+#include "src/carnot/planner/ir/union_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+StatusOr<std::string> KelvinPartitioner::PartitionKey(OperatorIR* source_group,
+                                                      OperatorIR* child) {
+  std::string key;
+  if (Match(child, BlockingAgg())) {
+    auto agg = static_cast<BlockingAggIR*>(child);
+    if (agg->groups().empty()) {
+      return std::string();
+    }
+    key = agg->groups()[0]->col_name();
+  } else if (Match(child, Join())) {
+    auto join = static_cast<JoinIR*>(child);
+    // Both sides of the join must be partitioned the same way, so both must be GRPC bridges.
+    const auto& parents = join->parents();
+    if (parents.size() != 2 || parents[0] == parents[1] || !Match(parents[0], GRPCSourceGroup()) ||
+        !Match(parents[1], GRPCSourceGroup())) {
+      return std::string();
+    }
+    const auto& on_columns =
+        parents[0] == source_group ? join->left_on_columns() : join->right_on_columns();
+    if (on_columns.empty()) {
+      return std::string();
+    }
+    key = on_columns[0]->col_name();
+  } else {
+    return std::string();
+  }
+
+  // Make sure the key has a type that can be hashed.
+  PL_ASSIGN_OR_RETURN(TypePtr key_type, source_group->resolved_table_type()->GetColumnType(key));
+  auto key_data_type = std::static_pointer_cast<ValueType>(key_type)->data_type();
+  if (!compiler_state_->registry_info()
+           ->GetUDFDataType(kPartitionIDUDF, {key_data_type, types::INT64})
+           .ok()) {
+    return std::string();
+  }
+  return key;
+}
+
+bool KelvinPartitioner::OnlyRowWiseOpsDownstream(OperatorIR* op,
+                                                 absl::flat_hash_set<OperatorIR*>* result_sinks) {
+  std::queue<OperatorIR*> q;
+  q.push(op);
+  while (!q.empty()) {
+    OperatorIR* parent = q.front();
+    q.pop();
+    for (OperatorIR* child : parent->Children()) {
+      if (Match(child, ExternalGRPCSink())) {
+        result_sinks->insert(child);
+        continue;
+      }
+      if (!Match(child, Map()) && !Match(child, Filter())) {
+        return false;
+      }
+      q.push(child);
+    }
+  }
+  return true;
+}
+
+StatusOr<bool> KelvinPartitioner::Analyze(IR* kelvin_plan, const std::vector<IR*>& pem_plans) {
+  if (num_partitions_ <= 1) {
+    return false;
+  }
+  absl::flat_hash_map<int64_t, std::string> bridge_keys;
+  absl::flat_hash_set<OperatorIR*> partitioned_ops;
+  int64_t max_bridge_id = -1;
+  for (OperatorIR* source : kelvin_plan->GetSources()) {
+    if (!Match(source, GRPCSourceGroup()) || source->Children().size() != 1) {
+      return false;
+    }
+    auto source_group = static_cast<GRPCSourceGroupIR*>(source);
+    OperatorIR* child = source_group->Children()[0];
+    PL_ASSIGN_OR_RETURN(std::string key, PartitionKey(source_group, child));
+    if (key.empty()) {
+      return false;
+    }
+    bridge_keys[source_group->source_id()] = key;
+    partitioned_ops.insert(child);
+    max_bridge_id = std::max(max_bridge_id, source_group->source_id());
+  }
+  if (bridge_keys.empty()) {
+    return false;
+  }
+
+  // Each Kelvin's output must be a slice of the final result, so the partitioned operators may
+  // only be followed by row-wise operators.
+  absl::flat_hash_set<OperatorIR*> result_sinks;
+  for (OperatorIR* op : partitioned_ops) {
+    if (!OnlyRowWiseOpsDownstream(op, &result_sinks)) {
+      return false;
+    }
+  }
+
+  for (IR* pem_plan : pem_plans) {
+    for (IRNode* node : pem_plan->FindNodesThatMatch(InternalGRPCSink())) {
+      max_bridge_id = std::max(max_bridge_id, static_cast<GRPCSinkIR*>(node)->destination_id());
+    }
+  }
+
+  // Assign the new bridge ids in a stable order so the same query always gets the same plan.
+  std::vector<int64_t> bridge_ids;
+  for (const auto& [bridge_id, key] : bridge_keys) {
+    bridge_ids.push_back(bridge_id);
+  }
+  std::sort(bridge_ids.begin(), bridge_ids.end());
+  std::vector<int64_t> result_sink_ids;
+  for (OperatorIR* sink : result_sinks) {
+    result_sink_ids.push_back(sink->id());
+  }
+  std::sort(result_sink_ids.begin(), result_sink_ids.end());
+
+  int64_t next_bridge_id = max_bridge_id + 1;
+  for (int64_t bridge_id : bridge_ids) {
+    PartitionedBridge& bridge = bridges_[bridge_id];
+    bridge.key = bridge_keys[bridge_id];
+    bridge.bridge_ids.push_back(bridge_id);
+    for (int64_t i = 1; i < num_partitions_; ++i) {
+      bridge.bridge_ids.push_back(next_bridge_id++);
+    }
+  }
+  for (int64_t sink_id : result_sink_ids) {
+    result_sink_gather_ids_[sink_id] = next_bridge_id++;
+  }
+  return true;
+}
+
+StatusOr<MapIR*> KelvinPartitioner::CreatePartitionIDMap(OperatorIR* parent,
+                                                        const std::string& key) {
+  IR* graph = parent->graph();
+  PL_ASSIGN_OR_RETURN(ColumnIR * key_column,
+                      graph->CreateNode<ColumnIR>(parent->ast(), key, /*parent_op_idx*/ 0));
+  PL_ASSIGN_OR_RETURN(IntIR * num_partitions,
+                      graph->CreateNode<IntIR>(parent->ast(), num_partitions_));
+  PL_ASSIGN_OR_RETURN(
+      FuncIR * partition_id,
+      graph->CreateNode<FuncIR>(parent->ast(),
+                                FuncIR::Op{FuncIR::Opcode::non_op, "", kPartitionIDUDF},
+                                std::vector<ExpressionIR*>{key_column, num_partitions}));
+  ColExpressionVector partition_id_expr{ColumnExpression(kPartitionIDColumn, partition_id)};
+  PL_ASSIGN_OR_RETURN(MapIR * map,
+                      graph->CreateNode<MapIR>(parent->ast(), parent, partition_id_expr,
+                                               /*keep_input_columns*/ true));
+  PL_RETURN_IF_ERROR(ResolveOperatorType(map, compiler_state_));
+  return map;
+}
+
+StatusOr<OperatorIR*> KelvinPartitioner::CreatePartitionFilter(MapIR* partition_id_map,
+                                                               int64_t partition) {
+  IR* graph = partition_id_map->graph();
+  const pypa::AstPtr& ast = partition_id_map->ast();
+  PL_ASSIGN_OR_RETURN(ColumnIR * partition_id,
+                      graph->CreateNode<ColumnIR>(ast, kPartitionIDColumn, /*parent_op_idx*/ 0));
+  PL_ASSIGN_OR_RETURN(IntIR * partition_ir, graph->CreateNode<IntIR>(ast, partition));
+  PL_ASSIGN_OR_RETURN(
+      FuncIR * equals,
+      graph->CreateNode<FuncIR>(ast, FuncIR::Op{FuncIR::Opcode::eq, "==", "equal"},
+                                std::vector<ExpressionIR*>{partition_id, partition_ir}));
+  PL_ASSIGN_OR_RETURN(FilterIR * filter,
+                      graph->CreateNode<FilterIR>(ast, partition_id_map, equals));
+  PL_RETURN_IF_ERROR(ResolveOperatorType(filter, compiler_state_));
+
+  // Drop the partition id again, so the bridge carries the columns the Kelvin expects.
+  ColExpressionVector columns;
+  auto input_type = partition_id_map->parents()[0]->resolved_table_type();
+  for (const auto& col_name : input_type->ColumnNames()) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * column,
+                        graph->CreateNode<ColumnIR>(ast, col_name, /*parent_op_idx*/ 0));
+    columns.emplace_back(col_name, column);
+  }
+  PL_ASSIGN_OR_RETURN(MapIR * project, graph->CreateNode<MapIR>(ast, filter, columns,
+                                                                /*keep_input_columns*/ false));
+  PL_RETURN_IF_ERROR(ResolveOperatorType(project, compiler_state_));
+  return project;
+}
+
+Status KelvinPartitioner::PartitionSinks(IR* pem_plan) {
+  for (IRNode* node : pem_plan->FindNodesThatMatch(InternalGRPCSink())) {
+    auto sink = static_cast<GRPCSinkIR*>(node);
+    auto bridge_iter = bridges_.find(sink->destination_id());
+    if (bridge_iter == bridges_.end()) {
+      continue;
+    }
+    const PartitionedBridge& bridge = bridge_iter->second;
+    OperatorIR* parent = sink->parents()[0];
+    // Hash each row once; the per-partition filters then only compare the resulting id.
+    PL_ASSIGN_OR_RETURN(MapIR * partition_id_map, CreatePartitionIDMap(parent, bridge.key));
+    for (int64_t i = 0; i < num_partitions_; ++i) {
+      PL_ASSIGN_OR_RETURN(OperatorIR * partition, CreatePartitionFilter(partition_id_map, i));
+      if (i == 0) {
+        PL_RETURN_IF_ERROR(sink->ReplaceParent(parent, partition));
+        continue;
+      }
+      PL_ASSIGN_OR_RETURN(
+          GRPCSinkIR * partition_sink,
+          pem_plan->CreateNode<GRPCSinkIR>(sink->ast(), partition, bridge.bridge_ids[i]));
+      PL_RETURN_IF_ERROR(partition_sink->SetResolvedType(partition->resolved_type()));
+    }
+  }
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<IR>> KelvinPartitioner::CreatePartitionPlan(IR* kelvin_plan,
+                                                                     int64_t partition) {
+  DCHECK_GT(partition, 0);
+  DCHECK_LT(partition, num_partitions_);
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> plan, kelvin_plan->Clone());
+  for (IRNode* node : plan->FindNodesOfType(IRNodeType::kGRPCSourceGroup)) {
+    auto source_group = static_cast<GRPCSourceGroupIR*>(node);
+    source_group->SetSourceID(bridges_.at(source_group->source_id()).bridge_ids[partition]);
+  }
+  // Send the results to the Kelvin that runs partition 0 instead of the query broker.
+  for (const auto& [sink_id, gather_id] : result_sink_gather_ids_) {
+    auto sink = static_cast<GRPCSinkIR*>(plan->Get(sink_id));
+    OperatorIR* parent = sink->parents()[0];
+    PL_ASSIGN_OR_RETURN(GRPCSinkIR * gather_sink,
+                        plan->CreateNode<GRPCSinkIR>(sink->ast(), parent, gather_id));
+    PL_RETURN_IF_ERROR(gather_sink->SetResolvedType(parent->resolved_type()));
+    PL_RETURN_IF_ERROR(sink->RemoveParent(parent));
+    PL_RETURN_IF_ERROR(plan->DeleteNode(sink_id));
+  }
+  return plan;
+}
+
+Status KelvinPartitioner::AddGatherSources(IR* kelvin_plan) {
+  for (const auto& [sink_id, gather_id] : result_sink_gather_ids_) {
+    auto sink = static_cast<GRPCSinkIR*>(kelvin_plan->Get(sink_id));
+    OperatorIR* parent = sink->parents()[0];
+    PL_ASSIGN_OR_RETURN(GRPCSourceGroupIR * gather_source,
+                        kelvin_plan->CreateNode<GRPCSourceGroupIR>(sink->ast(), gather_id,
+                                                                   parent->resolved_type()));
+    PL_ASSIGN_OR_RETURN(UnionIR * union_op,
+                        kelvin_plan->CreateNode<UnionIR>(
+                            sink->ast(), std::vector<OperatorIR*>{parent, gather_source}));
+    PL_RETURN_IF_ERROR(union_op->SetResolvedType(parent->resolved_type()));
+    PL_RETURN_IF_ERROR(union_op->SetDefaultColumnMapping());
+    PL_RETURN_IF_ERROR(sink->ReplaceParent(parent, union_op));
+  }
+  return Status::OK();
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
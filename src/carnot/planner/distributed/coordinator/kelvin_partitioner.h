@@ -0,0 +1,118 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/ir.h"
+#include "src/carnot/planner/ir/map_ir.h"
+#include "src/carnot/planner/ir/pattern_match.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+// The UDF that maps a key to the partition, and therefore the Kelvin, that processes it.
+constexpr char kPartitionIDUDF[] = "_partition_id";
+// The column that PEMs store each row's partition in, before splitting rows between Kelvins.
+constexpr char kPartitionIDColumn[] = "__partition_id";
+
+/**
+ * @brief KelvinPartitioner spreads the Kelvin portion of a query across several Kelvins with a
+ * hash-partitioned exchange.
+ *
+ * Each PEM computes the partition of every row it sends over a GRPC bridge once, in a Map, and
+ * filters the rows into one stream per Kelvin on that id. The partition is keyed on the first
+ * group or join column of the operator that consumes the bridge, so every Kelvin runs the
+ * aggregate or join on a disjoint slice of the keys. Kelvins 1..N-1 then send their results to
+ * Kelvin 0, which unions them into the result sinks so each output table still has a single
+ * producer.
+ *
+ * Only plans where every Kelvin source is a GRPC bridge into a grouped aggregate or an equijoin,
+ * followed by nothing but Maps and Filters, are partitioned. Anything else (a Limit, a second
+ * aggregate, a Kelvin UDTF) needs every row in one place and stays on a single Kelvin.
+ */
+class KelvinPartitioner {
+ public:
+  KelvinPartitioner(CompilerState* compiler_state, int64_t num_partitions)
+      : compiler_state_(compiler_state), num_partitions_(num_partitions) {}
+
+  /**
+   * @brief Determines whether the Kelvin plan can be partitioned and, if so, which key each GRPC
+   * bridge is partitioned by.
+   *
+   * @param kelvin_plan the plan of the Kelvin that produces the query results.
+   * @param pem_plans the plans that send data to the Kelvin.
+   * @return true if the plan can be partitioned.
+   */
+  StatusOr<bool> Analyze(IR* kelvin_plan, const std::vector<IR*>& pem_plans);
+
+  /**
+   * @brief Splits each GRPCSink of the PEM plan into one Filter and GRPCSink per partition, fed by
+   * a single Map that computes the partition of each row.
+   */
+  Status PartitionSinks(IR* pem_plan);
+
+  /**
+   * @brief Creates the plan for the Kelvin that processes the given partition (>= 1). Its result
+   * sinks are replaced by GRPCSinks that send to the Kelvin that runs partition 0.
+   */
+  StatusOr<std::unique_ptr<IR>> CreatePartitionPlan(IR* kelvin_plan, int64_t partition);
+
+  /**
+   * @brief Unions the results of the other partitions into the result sinks of the Kelvin plan.
+   * Call after every partition plan has been created.
+   */
+  Status AddGatherSources(IR* kelvin_plan);
+
+ private:
+  struct PartitionedBridge {
+    // The column that rows crossing the bridge are partitioned by.
+    std::string key;
+    // The GRPC bridge id used for each partition. Partition 0 keeps the original id.
+    std::vector<int64_t> bridge_ids;
+  };
+
+  StatusOr<std::string> PartitionKey(OperatorIR* source_group, OperatorIR* child);
+  bool OnlyRowWiseOpsDownstream(OperatorIR* op, absl::flat_hash_set<OperatorIR*>* result_sinks);
+  // Adds a Map that appends the partition of each row, as kPartitionIDColumn, to parent's columns.
+  StatusOr<MapIR*> CreatePartitionIDMap(OperatorIR* parent, const std::string& key);
+  // Adds the Filter that selects a partition's rows, followed by a Map that drops the partition
+  // id. Returns the Map.
+  StatusOr<OperatorIR*> CreatePartitionFilter(MapIR* partition_id_map, int64_t partition);
+
+  CompilerState* compiler_state_;
+  int64_t num_partitions_;
+  // Maps the original GRPC bridge id to the ids used for each partition.
+  absl::flat_hash_map<int64_t, PartitionedBridge> bridges_;
+  // Maps the node id of each result sink to the bridge id used to gather its results.
+  absl::flat_hash_map<int64_t, int64_t> result_sink_gather_ids_;
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/distributed/coordinator/tablet_sources_rule.h"
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/int_ir.h"
+#include "src/carnot/planner/ir/string_ir.h"
+#include "src/carnot/planner/ir/uint128_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+namespace {
+
+// Returns the tablet ID that holds the rows whose tablet key equals the literal expr.
+std::optional<types::TabletID> TabletIDFromLiteral(ExpressionIR* expr) {
+  if (Match(expr, String())) {
+    return static_cast<StringIR*>(expr)->str();
+  }
+  if (Match(expr, Int())) {
+    return std::to_string(static_cast<IntIR*>(expr)->val());
+  }
+  if (Match(expr, UInt128Value())) {
+    std::ostringstream tablet;
+    tablet << static_cast<UInt128IR*>(expr)->val();
+    return tablet.str();
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+StatusOr<TableToTabletsMap> TabletSourcesRule::CollectTablets(
+    DistributedPlan* plan, const absl::flat_hash_set<int64_t>& agents) {
+  TableToTabletsMap table_to_tablets;
+  for (int64_t agent : agents) {
+    auto carnot = plan->Get(agent);
+    if (!carnot) {
+      return error::InvalidArgument("Cannot find agent $0 in distributed plan", agent);
+    }
+    for (const auto& table_info : carnot->carnot_info().table_info()) {
+      if (table_info.tabletization_key().empty() || table_info.tablets().empty()) {
+        continue;
+      }
+      auto& table = table_to_tablets[table_info.table()];
+      if (table.tablet_key.empty()) {
+        table.tablet_key = table_info.tabletization_key();
+      } else if (table.tablet_key != table_info.tabletization_key()) {
+        return error::InvalidArgument(
+            "Table '$0' has tablet keys '$1' and '$2' on different agents", table_info.table(),
+            table.tablet_key, table_info.tabletization_key());
+      }
+      table.tablets.insert(table_info.tablets().begin(), table_info.tablets().end());
+    }
+  }
+  return table_to_tablets;
+}
+
+StatusOr<bool> TabletSourcesRule::Apply(IRNode* ir_node) {
+  if (Match(ir_node, MemorySource())) {
+    return SetSourceTablets(static_cast<MemorySourceIR*>(ir_node));
+  }
+  return false;
+}
+
+StatusOr<bool> TabletSourcesRule::SetSourceTablets(MemorySourceIR* mem_src) {
+  if (mem_src->HasTablet() || mem_src->HasTablets()) {
+    return false;
+  }
+  auto table_it = table_to_tablets_.find(mem_src->table_name());
+  if (table_it == table_to_tablets_.end()) {
+    return false;
+  }
+  const TabletizedTable& table = table_it->second;
+
+  std::optional<TabletSet> tablets;
+  auto children = mem_src->Children();
+  if (children.size() == 1 && Match(children[0], Filter())) {
+    tablets = TabletsMatchingExpr(static_cast<FilterIR*>(children[0])->filter_expr(), table);
+  }
+  if (!tablets.has_value()) {
+    mem_src->SetTablets(
+        std::vector<types::TabletID>(table.tablets.begin(), table.tablets.end()));
+    return true;
+  }
+  if (tablets->empty()) {
+    // None of the agents hold rows that pass the filter.
+    PL_RETURN_IF_ERROR(mem_src->graph()->DeleteOrphansInSubtree(mem_src->id()));
+    return true;
+  }
+  mem_src->SetTablets(std::vector<types::TabletID>(tablets->begin(), tablets->end()));
+  return true;
+}
+
+std::optional<TabletSourcesRule::TabletSet> TabletSourcesRule::TabletsMatchingExpr(
+    ExpressionIR* expr, const TabletizedTable& table) {
+  auto logical_and = Match(expr, LogicalAnd(Value(), Value()));
+  auto logical_or = Match(expr, LogicalOr(Value(), Value()));
+  if (logical_and || logical_or) {
+    FuncIR* func = static_cast<FuncIR*>(expr);
+    auto lhs = TabletsMatchingExpr(func->args()[0], table);
+    auto rhs = TabletsMatchingExpr(func->args()[1], table);
+    if (logical_or) {
+      // Either side may keep rows from any tablet.
+      if (!lhs.has_value() || !rhs.has_value()) {
+        return std::nullopt;
+      }
+      lhs->insert(rhs->begin(), rhs->end());
+      return lhs;
+    }
+    if (!lhs.has_value()) {
+      return rhs;
+    }
+    if (!rhs.has_value()) {
+      return lhs;
+    }
+    TabletSet intersection;
+    for (const auto& tablet : *lhs) {
+      if (rhs->contains(tablet)) {
+        intersection.insert(tablet);
+      }
+    }
+    return intersection;
+  }
+
+  if (!Match(expr, Equals(ColumnNode(table.tablet_key), Value()))) {
+    return std::nullopt;
+  }
+  FuncIR* func = static_cast<FuncIR*>(expr);
+  ExpressionIR* literal = func->args()[Match(func->args()[0], ColumnNode()) ? 1 : 0];
+  auto tablet = TabletIDFromLiteral(literal);
+  if (!tablet.has_value()) {
+    return std::nullopt;
+  }
+  TabletSet tablets;
+  if (table.tablets.contains(*tablet)) {
+    tablets.insert(*tablet);
+  }
+  return tablets;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
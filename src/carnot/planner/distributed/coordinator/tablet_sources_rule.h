@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <absl/container/btree_set.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief The tablets that a table is split into on a group of agents.
+ */
+struct TabletizedTable {
+  // The column whose value names the tablet a row is stored in.
+  std::string tablet_key;
+  absl::btree_set<types::TabletID> tablets;
+};
+
+using TableToTabletsMap = absl::flat_hash_map<std::string, TabletizedTable>;
+
+/**
+ * @brief Sets the tablets to read on each MemorySource of a tabletized table.
+ *
+ * A PEM plan may be shared by several agents, so the sources read the union of the tablets held
+ * by those agents and each agent skips the tablets it doesn't hold. When the source feeds a
+ * Filter that only keeps rows whose tablet key equals some literals (such as
+ * `df[df.upid == px.uint128(...)]`), the list is pruned to the matching tablets, and a source
+ * left without tablets is removed along with its children.
+ *
+ * Tablet IDs are the decimal string of the key value, which is how Stirling names tablets.
+ */
+class TabletSourcesRule : public Rule {
+ public:
+  explicit TabletSourcesRule(const TableToTabletsMap& table_to_tablets)
+      : Rule(nullptr, /*use_topo*/ false, /*reverse_topological_execution*/ false),
+        table_to_tablets_(table_to_tablets) {}
+
+  /**
+   * @brief Collects the tablets of every tabletized table held by the given agents.
+   */
+  static StatusOr<TableToTabletsMap> CollectTablets(DistributedPlan* plan,
+                                                    const absl::flat_hash_set<int64_t>& agents);
+
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+
+ private:
+  using TabletSet = absl::btree_set<types::TabletID>;
+
+  StatusOr<bool> SetSourceTablets(MemorySourceIR* mem_src);
+  // Returns the tablets that can hold rows passing expr, or std::nullopt if expr doesn't
+  // constrain the tablet key.
+  static std::optional<TabletSet> TabletsMatchingExpr(ExpressionIR* expr,
+                                                      const TabletizedTable& table);
+
+  const TableToTabletsMap& table_to_tablets_;
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
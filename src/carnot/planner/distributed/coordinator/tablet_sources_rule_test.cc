@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/coordinator/tablet_sources_rule.h"
+#include "src/carnot/planner/test_utils.h"
+#include "src/common/uuid/uuid_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using table_store::schema::Relation;
+
+class TabletSourcesRuleTest : public OperatorTests {
+ protected:
+  void SetUpImpl() override {
+    relation_ = Relation({types::DataType::TIME64NS, types::DataType::UINT128},
+                         {"time_", "upid"});
+    table_to_tablets_["process_stats"] = TabletizedTable{"upid", {"42", "43", "44"}};
+  }
+
+  ExpressionIR* UPIDEquals(uint64_t upid) {
+    auto upid_value =
+        graph->CreateNode<UInt128IR>(ast, absl::MakeUint128(0, upid)).ConsumeValueOrDie();
+    return MakeEqualsFunc(MakeColumn("upid", 0), upid_value);
+  }
+
+  Relation relation_;
+  TableToTabletsMap table_to_tablets_;
+};
+
+TEST_F(TabletSourcesRuleTest, ReadsAllTabletsWithoutFilter) {
+  auto mem_src = MakeMemSource("process_stats", relation_);
+  MakeMemSink(mem_src, "out");
+  auto other_src = MakeMemSource("http_events", relation_);
+  MakeMemSink(other_src, "out2");
+
+  TabletSourcesRule rule(table_to_tablets_);
+  ASSERT_OK_AND_ASSIGN(bool changed, rule.Execute(graph.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_THAT(mem_src->tablets(), ElementsAre("42", "43", "44"));
+  EXPECT_THAT(other_src->tablets(), IsEmpty());
+}
+
+TEST_F(TabletSourcesRuleTest, PrunesTabletsToUPIDFilter) {
+  auto mem_src = MakeMemSource("process_stats", relation_);
+  auto filter = MakeFilter(mem_src, MakeOrFunc(UPIDEquals(44), UPIDEquals(42)));
+  MakeMemSink(filter, "out");
+
+  TabletSourcesRule rule(table_to_tablets_);
+  ASSERT_OK(rule.Execute(graph.get()));
+  EXPECT_THAT(mem_src->tablets(), ElementsAre("42", "44"));
+}
+
+TEST_F(TabletSourcesRuleTest, KeepsAllTabletsWhenFilterDoesNotConstrainKey) {
+  auto mem_src = MakeMemSource("process_stats", relation_);
+  auto filter = MakeFilter(
+      mem_src, MakeOrFunc(UPIDEquals(42), MakeEqualsFunc(MakeColumn("time_", 0), MakeInt(1))));
+  MakeMemSink(filter, "out");
+
+  TabletSourcesRule rule(table_to_tablets_);
+  ASSERT_OK(rule.Execute(graph.get()));
+  EXPECT_THAT(mem_src->tablets(), ElementsAre("42", "43", "44"));
+}
+
+TEST_F(TabletSourcesRuleTest, RemovesSourceWithoutMatchingTablets) {
+  auto mem_src = MakeMemSource("process_stats", relation_);
+  auto filter = MakeFilter(mem_src, UPIDEquals(7));
+  auto sink = MakeMemSink(filter, "out");
+  auto other_src = MakeMemSource("process_stats", relation_);
+  auto other_sink = MakeMemSink(other_src, "out2");
+
+  TabletSourcesRule rule(table_to_tablets_);
+  ASSERT_OK_AND_ASSIGN(bool changed, rule.Execute(graph.get()));
+  EXPECT_TRUE(changed);
+  EXPECT_FALSE(graph->HasNode(mem_src->id()));
+  EXPECT_FALSE(graph->HasNode(sink->id()));
+  EXPECT_TRUE(graph->HasNode(other_src->id()));
+  EXPECT_TRUE(graph->HasNode(other_sink->id()));
+}
+
+TEST_F(TabletSourcesRuleTest, CollectTabletsAcrossAgents) {
+  DistributedPlan plan;
+  distributedpb::CarnotInfo carnot_info;
+  carnot_info.set_query_broker_address("pem1");
+  ToProto(sole::uuid4(), carnot_info.mutable_agent_id());
+  auto table_info = carnot_info.add_table_info();
+  table_info->set_table("process_stats");
+  table_info->set_tabletization_key("upid");
+  table_info->add_tablets("43");
+  table_info->add_tablets("42");
+  ASSERT_OK_AND_ASSIGN(int64_t pem1, plan.AddCarnot(carnot_info));
+
+  carnot_info.set_query_broker_address("pem2");
+  ToProto(sole::uuid4(), carnot_info.mutable_agent_id());
+  carnot_info.mutable_table_info(0)->clear_tablets();
+  carnot_info.mutable_table_info(0)->add_tablets("44");
+  ASSERT_OK_AND_ASSIGN(int64_t pem2, plan.AddCarnot(carnot_info));
+
+  ASSERT_OK_AND_ASSIGN(auto table_to_tablets, TabletSourcesRule::CollectTablets(&plan, {pem1}));
+  EXPECT_EQ("upid", table_to_tablets["process_stats"].tablet_key);
+  EXPECT_THAT(table_to_tablets["process_stats"].tablets, ElementsAre("42", "43"));
+
+  ASSERT_OK_AND_ASSIGN(table_to_tablets, TabletSourcesRule::CollectTablets(&plan, {pem1, pem2}));
+  EXPECT_THAT(table_to_tablets["process_stats"].tablets, ElementsAre("42", "43", "44"));
+
+  carnot_info.set_query_broker_address("pem3");
+  ToProto(sole::uuid4(), carnot_info.mutable_agent_id());
+  carnot_info.mutable_table_info(0)->set_tabletization_key("pid");
+  ASSERT_OK_AND_ASSIGN(int64_t pem3, plan.AddCarnot(carnot_info));
+  EXPECT_NOT_OK(TabletSourcesRule::CollectTablets(&plan, {pem1, pem3}));
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -158,11 +158,23 @@ class DistributedPlan {
 
   CarnotInstance* kelvin() const { return kelvin_; }
 
+  /**
+   * @brief Adds a Kelvin that runs one partition of a hash-partitioned query and sends its
+   * results to kelvin().
+   */
+  void AddPartitionKelvin(CarnotInstance* partition_kelvin) {
+    DCHECK(id_to_node_map_.contains(partition_kelvin->id()));
+    partition_kelvins_.push_back(partition_kelvin);
+  }
+
+  const std::vector<CarnotInstance*>& partition_kelvins() const { return partition_kelvins_; }
+
  private:
   plan::DAG dag_;
   absl::flat_hash_map<int64_t, std::unique_ptr<CarnotInstance>> id_to_node_map_;
   absl::flat_hash_map<IR*, absl::flat_hash_set<int64_t>> plan_to_agent_map_;
   CarnotInstance* kelvin_ = nullptr;
+  std::vector<CarnotInstance*> partition_kelvins_;
   std::vector<std::unique_ptr<IR>> plan_pool_;
   absl::flat_hash_map<int64_t, IR*> agent_to_plan_map_;
   absl::flat_hash_map<sole::uuid, int64_t> uuid_to_id_map_;
@@ -45,28 +45,48 @@ Status StitchPlan(DistributedPlan* distributed_plan) {
   DCHECK(distributed_plan);
   auto remote_carnot = distributed_plan->kelvin();
   DCHECK(remote_carnot);
-  auto remote_node_id = remote_carnot->id();
   IR* remote_plan = remote_carnot->plan();
   DCHECK(remote_plan);
 
-  DistributedSetSourceGroupGRPCAddressRule set_grpc_address_rule;
-  PL_RETURN_IF_ERROR(set_grpc_address_rule.Apply(remote_carnot));
+  // The Kelvin that produces the results comes first, followed by any Kelvins that each run a
+  // partition of a hash-partitioned query.
+  std::vector<CarnotInstance*> kelvins{remote_carnot};
+  for (CarnotInstance* partition_kelvin : distributed_plan->partition_kelvins()) {
+    kelvins.push_back(partition_kelvin);
+  }
+
+  for (CarnotInstance* kelvin : kelvins) {
+    DistributedSetSourceGroupGRPCAddressRule set_grpc_address_rule;
+    PL_RETURN_IF_ERROR(set_grpc_address_rule.Apply(kelvin));
+  }
 
   // Connect the plans.
   for (const auto& [plan, agents] : distributed_plan->plan_to_agent_map()) {
-    PL_ASSIGN_OR_RETURN(auto did_connect_plan, AssociateDistributedPlanEdgesRule::ConnectGraphs(
-                                                   plan, agents, remote_plan));
+    bool did_connect_plan = false;
+    for (CarnotInstance* kelvin : kelvins) {
+      PL_ASSIGN_OR_RETURN(bool did_connect_kelvin, AssociateDistributedPlanEdgesRule::ConnectGraphs(
+                                                       plan, agents, kelvin->plan()));
+      did_connect_plan |= did_connect_kelvin;
+    }
     DCHECK(did_connect_plan);
   }
+  // Partition Kelvins send their results to the Kelvin that produces the results.
+  for (CarnotInstance* partition_kelvin : distributed_plan->partition_kelvins()) {
+    PL_RETURN_IF_ERROR(AssociateDistributedPlanEdgesRule::ConnectGraphs(
+        partition_kelvin->plan(), {partition_kelvin->id()}, remote_plan));
+  }
 
-  // TODO(philkuz) make this connect to self without a grpc bridge.
-  PL_RETURN_IF_ERROR(
-      AssociateDistributedPlanEdgesRule::ConnectGraphs(remote_plan, {remote_node_id}, remote_plan));
+  for (CarnotInstance* kelvin : kelvins) {
+    // TODO(philkuz) make this connect to self without a grpc bridge.
+    PL_RETURN_IF_ERROR(AssociateDistributedPlanEdgesRule::ConnectGraphs(
+        kelvin->plan(), {kelvin->id()}, kelvin->plan()));
 
-  // Expand GRPCSourceGroups in the remote_plan.
-  GRPCSourceGroupConversionRule conversion_rule;
-  PL_RETURN_IF_ERROR(conversion_rule.Execute(remote_plan));
-  return MergeSameNodeGRPCBridgeRule(remote_node_id).Execute(remote_plan).status();
+    // Expand GRPCSourceGroups in the Kelvin plan.
+    GRPCSourceGroupConversionRule conversion_rule;
+    PL_RETURN_IF_ERROR(conversion_rule.Execute(kelvin->plan()));
+    PL_RETURN_IF_ERROR(MergeSameNodeGRPCBridgeRule(kelvin->id()).Execute(kelvin->plan()).status());
+  }
+  return Status::OK();
 }
 
 StatusOr<std::unique_ptr<DistributedPlan>> DistributedPlanner::Plan(
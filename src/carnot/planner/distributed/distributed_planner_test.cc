@@ -27,6 +27,7 @@
 
 #include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
 #include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/coordinator/kelvin_partitioner.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/rules/rules.h"
@@ -42,6 +43,7 @@ using compiler::ResolveTypesRule;
 using px::testing::proto::EqualsProto;
 using ::testing::ContainsRegex;
 using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
 using ::testing::UnorderedElementsAreArray;
 using testutils::DistributedRulesTest;
 using testutils::kThreePEMsOneKelvinDistributedState;
@@ -398,6 +400,97 @@ TEST_F(DistributedRulesTest, init_args) {
   EXPECT_OK(distributed_plan_or_s);
 }
 
+class DistributedPlannerPartitionTest : public DistributedRulesTest {
+ protected:
+  void SetUpImpl() override {
+    DistributedRulesTest::SetUpImpl();
+    logical_state_ = testutils::LoadLogicalPlannerStatePB(
+        testutils::MakeDistributedState(
+            {testutils::MakePEMCarnotInfo("pem1", "00000001-0000-0000-0000-000000000001", 123, {}),
+             testutils::MakePEMCarnotInfo("pem2", "00000001-0000-0000-0000-000000000002", 456, {}),
+             testutils::MakeKelvinCarnotInfo("kelvin1", "00000001-0000-0000-0000-000000000003",
+                                             "1111", 789),
+             testutils::MakeKelvinCarnotInfo("kelvin2", "00000001-0000-0000-0000-000000000004",
+                                             "1112", 790)}),
+        testutils::LoadSchemaPb(testutils::kHttpEventsSchema));
+  }
+};
+
+constexpr char kPartitionedAggQuery[] = R"pxl(
+import px
+df = px.DataFrame('http_events')
+df = df.groupby('remote_addr').agg(count=('remote_port', px.count))
+df.doubled = df.count * 2
+px.display(df)
+)pxl";
+
+TEST_F(DistributedPlannerPartitionTest, agg_partitioned_across_kelvins) {
+  auto physical_plan = PlanQuery(kPartitionedAggQuery);
+  ASSERT_EQ(physical_plan->dag().nodes().size(), 4UL);
+  ASSERT_EQ(physical_plan->partition_kelvins().size(), 1UL);
+  CarnotInstance* kelvin = physical_plan->kelvin();
+  CarnotInstance* partition_kelvin = physical_plan->partition_kelvins()[0];
+  EXPECT_EQ(kelvin->carnot_info().query_broker_address(), "kelvin1");
+  EXPECT_EQ(partition_kelvin->carnot_info().query_broker_address(), "kelvin2");
+
+  // Each PEM computes the partition of its rows once, then filters them into one stream per
+  // Kelvin.
+  for (int64_t plan_id : physical_plan->dag().nodes()) {
+    auto instance = physical_plan->Get(plan_id);
+    if (!IsPEM(instance->carnot_info())) {
+      continue;
+    }
+    SCOPED_TRACE(instance->carnot_info().query_broker_address());
+    std::vector<std::string> destinations;
+    absl::flat_hash_set<OperatorIR*> partition_id_maps;
+    for (IRNode* node : instance->plan()->FindNodesThatMatch(InternalGRPCSink())) {
+      auto sink = static_cast<GRPCSinkIR*>(node);
+      ASSERT_MATCH(sink->parents()[0], Map());
+      auto project = static_cast<MapIR*>(sink->parents()[0]);
+      EXPECT_FALSE(project->resolved_table_type()->HasColumn(kPartitionIDColumn));
+      ASSERT_MATCH(project->parents()[0], Filter());
+      OperatorIR* partition_id_map = project->parents()[0]->parents()[0];
+      ASSERT_MATCH(partition_id_map, Map());
+      EXPECT_TRUE(partition_id_map->resolved_table_type()->HasColumn(kPartitionIDColumn));
+      partition_id_maps.insert(partition_id_map);
+      destinations.push_back(sink->destination_address());
+    }
+    EXPECT_THAT(destinations, UnorderedElementsAre("1111", "1112"));
+    EXPECT_EQ(partition_id_maps.size(), 1);
+  }
+
+  // Both Kelvins run the aggregate, but only the first one produces results.
+  EXPECT_EQ(kelvin->plan()->FindNodesOfType(IRNodeType::kBlockingAgg).size(), 1);
+  EXPECT_EQ(partition_kelvin->plan()->FindNodesOfType(IRNodeType::kBlockingAgg).size(), 1);
+  EXPECT_EQ(partition_kelvin->plan()->FindNodesThatMatch(ExternalGRPCSink()).size(), 0);
+  auto gather_sinks = partition_kelvin->plan()->FindNodesThatMatch(InternalGRPCSink());
+  ASSERT_EQ(gather_sinks.size(), 1);
+  EXPECT_EQ(static_cast<GRPCSinkIR*>(gather_sinks[0])->destination_address(), "1111");
+
+  auto result_sinks = kelvin->plan()->FindNodesThatMatch(ExternalGRPCSink());
+  ASSERT_EQ(result_sinks.size(), 1);
+  auto result_sink = static_cast<GRPCSinkIR*>(result_sinks[0]);
+  ASSERT_MATCH(result_sink->parents()[0], Union());
+  auto gather_union = static_cast<UnionIR*>(result_sink->parents()[0]);
+  ASSERT_EQ(gather_union->parents().size(), 2);
+  EXPECT_MATCH(gather_union->parents()[0], Map());
+  EXPECT_MATCH(gather_union->parents()[1], GRPCSource());
+}
+
+constexpr char kAggWithLimitQuery[] = R"pxl(
+import px
+df = px.DataFrame('http_events')
+df = df.groupby('remote_addr').agg(count=('remote_port', px.count))
+px.display(df.head(10))
+)pxl";
+
+TEST_F(DistributedPlannerPartitionTest, limit_stays_on_one_kelvin) {
+  auto physical_plan = PlanQuery(kAggWithLimitQuery);
+  EXPECT_EQ(physical_plan->dag().nodes().size(), 3UL);
+  EXPECT_EQ(physical_plan->partition_kelvins().size(), 0UL);
+  EXPECT_EQ(physical_plan->kelvin()->plan()->FindNodesOfType(IRNodeType::kUnion).size(), 1);
+}
+
 }  // namespace distributed
 }  // namespace planner
 }  // namespace carnot
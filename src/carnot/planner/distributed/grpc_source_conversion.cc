@@ -109,8 +109,11 @@ StatusOr<bool> MergeSameNodeGRPCBridgeRule::Apply(IRNode* ir_node) {
     return false;
   }
   GRPCSinkIR* grpc_sink = static_cast<GRPCSinkIR*>(ir_node);
-  DCHECK(grpc_sink->agent_id_to_destination_id().contains(current_agent_id_))
-      << "Expected the grpc sink to contain this current agent ID as a a target";
+  // Sinks that only target another agent, such as a partition Kelvin sending its results to the
+  // Kelvin that gathers them, cross the network.
+  if (!grpc_sink->agent_id_to_destination_id().contains(current_agent_id_)) {
+    return false;
+  }
   int64_t dest_id = grpc_sink->agent_id_to_destination_id().at(current_agent_id_);
   auto node = grpc_sink->graph()->Get(dest_id);
   if (!Match(node, GRPCSource())) {
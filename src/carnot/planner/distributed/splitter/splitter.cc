@@ -33,12 +33,74 @@ namespace carnot {
 namespace planner {
 namespace distributed {
 
+// Returns true if `col_name` in the output of `op` is the upid column of a MemorySource, passed
+// through unchanged by Maps and Filters. A upid encodes the agent that owns the process, so rows
+// that share a upid are always read by the same PEM.
+bool IsAgentLocalUPIDColumn(OperatorIR* op, std::string col_name) {
+  while (true) {
+    if (Match(op, MemorySource())) {
+      if (col_name != "upid" || !op->is_type_resolved()) {
+        return false;
+      }
+      auto type_or_s = op->resolved_table_type()->GetColumnType(col_name);
+      if (!type_or_s.ok() || !type_or_s.ValueOrDie()->IsValueType()) {
+        return false;
+      }
+      auto value_type = std::static_pointer_cast<ValueType>(type_or_s.ConsumeValueOrDie());
+      return value_type->data_type() == types::UINT128;
+    }
+    if (Match(op, Filter())) {
+      op = op->parents()[0];
+      continue;
+    }
+    if (!Match(op, Map())) {
+      return false;
+    }
+    auto map = static_cast<MapIR*>(op);
+    bool found = false;
+    for (const auto& expr : map->col_exprs()) {
+      if (expr.name != col_name) {
+        continue;
+      }
+      if (!Match(expr.node, ColumnNode())) {
+        return false;
+      }
+      col_name = static_cast<ColumnIR*>(expr.node)->col_name();
+      found = true;
+      break;
+    }
+    if (!found && !map->keep_input_columns()) {
+      return false;
+    }
+    op = map->parents()[0];
+  }
+}
+
+// A join is colocated if one of its equality conditions matches the upid of both sides. Every
+// match for a row then lives on the same PEM, so the join can run before the data leaves the
+// agent and unmatched rows never cross the network.
+bool IsColocatedJoin(OperatorIR* op) {
+  if (!Match(op, Join())) {
+    return false;
+  }
+  auto join = static_cast<JoinIR*>(op);
+  const auto& left_on = join->left_on_columns();
+  const auto& right_on = join->right_on_columns();
+  for (size_t i = 0; i < left_on.size() && i < right_on.size(); ++i) {
+    if (IsAgentLocalUPIDColumn(join->parents()[0], left_on[i]->col_name()) &&
+        IsAgentLocalUPIDColumn(join->parents()[1], right_on[i]->col_name())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 StatusOr<bool> OperatorMustRunOnKelvin(CompilerState* compiler_state, OperatorIR* op) {
   // If the operator can't run on a PEM, or is a blocking operator, we should
-  // schedule this node to run on a Kelvin.
+  // schedule this node to run on a Kelvin. Colocated joins are the exception.
   PL_ASSIGN_OR_RETURN(bool runs_on_pem,
                       ScalarUDFsRunOnPEMRule::OperatorUDFsRunOnPEM(compiler_state, op));
-  return !runs_on_pem || op->IsBlocking();
+  return !runs_on_pem || (op->IsBlocking() && !IsColocatedJoin(op));
 }
 
 StatusOr<bool> OperatorCanRunOnPEM(CompilerState* compiler_state, OperatorIR* op) {
@@ -46,7 +108,7 @@ StatusOr<bool> OperatorCanRunOnPEM(CompilerState* compiler_state, OperatorIR* op
   // schedule this node to run on a PEM.
   PL_ASSIGN_OR_RETURN(bool runs_on_pem,
                       ScalarUDFsRunOnPEMRule::OperatorUDFsRunOnPEM(compiler_state, op));
-  return runs_on_pem && !op->IsBlocking();
+  return runs_on_pem && (!op->IsBlocking() || IsColocatedJoin(op));
 }
 
 BlockingSplitNodeIDGroups Splitter::GetSplitGroups(
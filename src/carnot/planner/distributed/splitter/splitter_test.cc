@@ -569,6 +569,78 @@ TEST_F(SplitterTest, agg_join_children) {
   EXPECT_EQ(join_parent->source_id(), grpc_sink->destination_id());
 }
 
+/** Tests the following graph:
+ *  T1(upid)  T2(upid)
+ *       \      /
+ *    Join(on upid)
+ *          |
+ *        Sink
+ *
+ * A join on upid only ever matches rows read by the same agent, so it stays before the split.
+ */
+TEST_F(SplitterTest, upid_join_runs_on_pem) {
+  Relation stats_relation({types::UINT128, types::INT64}, {"upid", "rss"});
+  Relation info_relation({types::UINT128, types::STRING}, {"upid", "cmd"});
+  compiler_state_->relation_map()->emplace("process_stats", stats_relation);
+  compiler_state_->relation_map()->emplace("proc_info", info_relation);
+
+  auto stats = MakeMemSource("process_stats", stats_relation);
+  auto info = MakeMemSource("proc_info", info_relation);
+  auto info_filter =
+      MakeFilter(info, MakeEqualsFunc(MakeColumn("cmd", 0), MakeString("python")));
+  auto info_map = MakeMap(info_filter, {{"pid", MakeColumn("upid", 0)}});
+  auto join = MakeJoin({stats, info_map}, "inner", stats_relation,
+                       Relation({types::UINT128}, {"pid"}), {"upid"}, {"pid"}, {"", "_right"});
+  auto sink = MakeMemSink(join, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  auto splitter_or_s = Splitter::Create(compiler_state_.get(), /* perform_partial_agg */ false);
+  ASSERT_OK(splitter_or_s);
+  std::unique_ptr<Splitter> splitter = splitter_or_s.ConsumeValueOrDie();
+  std::unique_ptr<BlockingSplitPlan> split_plan =
+      splitter->SplitKelvinAndAgents(graph.get()).ConsumeValueOrDie();
+  auto before_blocking = split_plan->before_blocking.get();
+  auto after_blocking = split_plan->after_blocking.get();
+
+  EXPECT_TRUE(HasEquivalentInNewPlan(before_blocking, join));
+  EXPECT_FALSE(HasEquivalentInNewPlan(after_blocking, join));
+  HasGRPCSinkChild(join->id(), before_blocking, "colocated join should feed a GRPCSink");
+  HasGRPCSourceGroupParent(sink->id(), after_blocking, "");
+}
+
+TEST_F(SplitterTest, non_upid_join_runs_on_kelvin) {
+  Relation stats_relation({types::UINT128, types::INT64}, {"upid", "rss"});
+  Relation info_relation({types::UINT128, types::INT64}, {"upid", "pid"});
+  compiler_state_->relation_map()->emplace("process_stats", stats_relation);
+  compiler_state_->relation_map()->emplace("proc_info", info_relation);
+
+  auto stats = MakeMemSource("process_stats", stats_relation);
+  auto info = MakeMemSource("proc_info", info_relation);
+  // rss and pid are not agent-local keys, so matches can come from any PEM.
+  auto join = MakeJoin({stats, info}, "inner", stats_relation, info_relation, {"rss"}, {"pid"},
+                       {"", "_right"});
+  MakeMemSink(join, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  auto splitter_or_s = Splitter::Create(compiler_state_.get(), /* perform_partial_agg */ false);
+  ASSERT_OK(splitter_or_s);
+  std::unique_ptr<Splitter> splitter = splitter_or_s.ConsumeValueOrDie();
+  std::unique_ptr<BlockingSplitPlan> split_plan =
+      splitter->SplitKelvinAndAgents(graph.get()).ConsumeValueOrDie();
+  auto before_blocking = split_plan->before_blocking.get();
+  auto after_blocking = split_plan->after_blocking.get();
+
+  EXPECT_FALSE(HasEquivalentInNewPlan(before_blocking, join));
+  auto new_join = GetEquivalentInNewPlan(after_blocking, join);
+  ASSERT_EQ(new_join->parents().size(), 2);
+  EXPECT_MATCH(new_join->parents()[0], GRPCSourceGroup());
+  EXPECT_MATCH(new_join->parents()[1], GRPCSourceGroup());
+}
+
 TEST_F(SplitterTest, simple_split_test) {
   auto mem_src = MakeMemSource("cpu", cpu_relation);
   auto map1 = MakeMap(mem_src, {{"cpu0", MakeColumn("cpu0", 0)}, {"cpu1", MakeColumn("cpu1", 0)}});
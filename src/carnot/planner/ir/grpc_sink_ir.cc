@@ -62,6 +62,9 @@ Status GRPCSinkIR::ToProto(planpb::Operator* op, int64_t agent_id) const {
     return CreateIRNodeError("No agent ID '$0' found in grpc sink '$1'", agent_id, DebugString());
   }
   pb->set_grpc_source_id(agent_id_to_destination_id_.find(agent_id)->second);
+  // Both ends of an internal sink are Carnot instances from the same build, so they can exchange
+  // the raw Arrow buffers instead of re-encoding every value into RowBatchData.
+  pb->set_row_batch_encoding(planpb::GRPCSinkOperator::ARROW);
   return Status::OK();
 }
 
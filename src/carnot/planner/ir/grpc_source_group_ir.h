@@ -59,6 +59,7 @@ class GRPCSourceGroupIR : public OperatorIR {
     return SetResolvedType(type);
   }
 
+  void SetSourceID(int64_t source_id) { source_id_ = source_id; }
   void SetGRPCAddress(const std::string& grpc_address) { grpc_address_ = grpc_address; }
   void SetSSLTargetName(const std::string& ssl_targetname) { ssl_targetname_ = ssl_targetname; }
 
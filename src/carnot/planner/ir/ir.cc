@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <farmhash.h>
 #include <queue>
 
@@ -183,6 +184,8 @@ StatusOr<std::unique_ptr<IR>> IR::Clone() const {
   PL_RETURN_IF_ERROR(new_ir->CopySelectedNodesAndDeps(this, nodes));
   // TODO(philkuz) check to make sure these are the same.
   new_ir->dag_ = dag_;
+  // Keep allocating ids where this IR would, so that the clone compiles to the same plan.
+  new_ir->id_node_counter = std::max(new_ir->id_node_counter, id_node_counter);
   return new_ir;
 }
 
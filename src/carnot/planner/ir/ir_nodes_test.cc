@@ -247,6 +247,48 @@ TEST_F(ToProtoTest, memory_source_ir_with_tablet) {
                                                absl::Substitute("\"$0\"", tablet_value))));
 }
 
+constexpr char kExpectedMemSrcWithTabletsPb[] = R"(
+  op_type: MEMORY_SOURCE_OPERATOR
+  mem_source_op {
+    name: "test_table"
+    column_idxs: 0
+    column_idxs: 1
+    column_names: "cpu0"
+    column_names: "cpu1"
+    column_types: INT64
+    column_types: FLOAT64
+    tablets: "1"
+    tablets: "2"
+  }
+)";
+
+TEST_F(ToProtoTest, memory_source_ir_with_tablets) {
+  auto mem_src =
+      graph->CreateNode<MemorySourceIR>(ast, "test_table", std::vector<std::string>{"cpu0", "cpu1"})
+          .ConsumeValueOrDie();
+
+  auto rel = Relation({types::DataType::INT64, types::DataType::FLOAT64}, {"cpu0", "cpu1"});
+  compiler_state_->relation_map()->emplace("test_table", rel);
+  mem_src->SetTablets({"1", "2"});
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  planpb::Operator pb;
+  EXPECT_OK(mem_src->ToProto(&pb));
+  EXPECT_THAT(pb, EqualsProto(kExpectedMemSrcWithTabletsPb));
+
+  // A tablet source group serializes as its memory source, reading the group's tablets.
+  auto tablet_source =
+      graph->CreateNode<TabletSourceGroupIR>(ast, mem_src, std::vector<types::TabletID>{"1", "2"},
+                                             "cpu0")
+          .ConsumeValueOrDie();
+  mem_src->SetTablets({});
+  planpb::Operator group_pb;
+  EXPECT_OK(tablet_source->ToProto(&group_pb));
+  EXPECT_THAT(group_pb, EqualsProto(kExpectedMemSrcWithTabletsPb));
+}
+
 constexpr char kExpectedMemSinkPb[] = R"(
   op_type: MEMORY_SINK_OPERATOR
   mem_sink_op {
@@ -1209,6 +1251,7 @@ constexpr char kExpectedInternalGRPCSinkPb[] = R"proto(
     connection_options {
       ssl_targetname: "$2"
     }
+    row_batch_encoding: ARROW
   }
 )proto";
 
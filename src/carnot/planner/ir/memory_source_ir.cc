@@ -59,6 +59,9 @@ Status MemorySourceIR::ToProto(planpb::Operator* op) const {
   if (HasTablet()) {
     pb->set_tablet(tablet_value());
   }
+  for (const auto& tablet : tablets_) {
+    pb->add_tablets(tablet);
+  }
 
   pb->set_streaming(streaming());
   return Status::OK();
@@ -135,6 +138,9 @@ Status MemorySourceIR::CopyFromNodeImpl(
   column_index_map_ = source_ir->column_index_map_;
   has_time_expressions_ = source_ir->has_time_expressions_;
   streaming_ = source_ir->streaming_;
+  tablet_value_ = source_ir->tablet_value_;
+  has_tablet_value_ = source_ir->has_tablet_value_;
+  tablets_ = source_ir->tablets_;
 
   if (has_time_expressions_) {
     PL_ASSIGN_OR_RETURN(ExpressionIR * new_start_expr,
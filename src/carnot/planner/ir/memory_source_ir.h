@@ -111,6 +111,12 @@ class MemorySourceIR : public OperatorIR {
     return tablet_value_;
   }
 
+  // The tablets to read when the table is split across many tablets on an agent. The executor
+  // skips tablets it doesn't have.
+  void SetTablets(const std::vector<types::TabletID>& tablets) { tablets_ = tablets; }
+  bool HasTablets() const { return !tablets_.empty(); }
+  const std::vector<types::TabletID>& tablets() const { return tablets_; }
+
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override {
     return std::vector<absl::flat_hash_set<std::string>>{};
   }
@@ -146,6 +152,7 @@ class MemorySourceIR : public OperatorIR {
 
   types::TabletID tablet_value_;
   bool has_tablet_value_ = false;
+  std::vector<types::TabletID> tablets_;
 };
 
 }  // namespace planner
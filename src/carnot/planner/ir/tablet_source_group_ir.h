@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
 #include "src/carnot/planner/ir/operator_ir.h"
 #include "src/carnot/planner/types/types.h"
 #include "src/carnot/udfspb/udfs.pb.h"
@@ -63,9 +64,18 @@ class TabletSourceGroupIR : public OperatorIR {
 
   explicit TabletSourceGroupIR(int64_t id) : OperatorIR(id, IRNodeType::kTabletSourceGroup) {}
 
-  Status ToProto(planpb::Operator*) const override {
-    return error::Unimplemented("$0::ToProto not implemented because no use found for it yet.",
-                                DebugString());
+  /**
+   * @brief Serializes the replaced memory source, reading from this group's tablets.
+   */
+  Status ToProto(planpb::Operator* op) const override {
+    PL_RETURN_IF_ERROR(memory_source_ir_->ToProto(op));
+    auto pb = op->mutable_mem_source_op();
+    pb->clear_tablet();
+    pb->clear_tablets();
+    for (const auto& tablet : tablets_) {
+      pb->add_tablets(tablet);
+    }
+    return Status::OK();
   }
   Status CopyFromNodeImpl(const IRNode*, absl::flat_hash_map<const IRNode*, IRNode*>*) override {
     return error::Unimplemented("$0::CopyFromNode not implemented because no use found for it yet.",
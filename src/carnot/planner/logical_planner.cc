@@ -121,16 +121,32 @@ StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::Plan(
   PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
                       CreateCompilerState(logical_state, registry_info_.get(), ms));
 
-  std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
-                                                   query_request.exec_funcs().end());
-  PL_ASSIGN_OR_RETURN(
-      std::shared_ptr<IR> single_node_plan,
-      compiler_.CompileToIR(query_request.query_str(), compiler_state.get(), exec_funcs));
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> single_node_plan,
+                      CompileToIR(logical_state, query_request, compiler_state.get()));
   // Create the distributed plan.
   return distributed_planner_->Plan(logical_state.distributed_state(), compiler_state.get(),
                                     single_node_plan.get());
 }
 
+StatusOr<std::shared_ptr<IR>> LogicalPlanner::CompileToIR(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request, CompilerState* compiler_state) {
+  auto key = PlanCache::Key(logical_state, query_request);
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<IR> ir, plan_cache_.Lookup(key));
+  if (ir == nullptr) {
+    std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
+                                                     query_request.exec_funcs().end());
+    PL_ASSIGN_OR_RETURN(ir,
+                        compiler_.QueryToIR(query_request.query_str(), compiler_state, exec_funcs));
+    // Scripts that call px.now() have the compile time baked into their IR, so can't be reused.
+    if (!compiler_state->time_now_read()) {
+      PL_RETURN_IF_ERROR(plan_cache_.Insert(key, *ir));
+    }
+  }
+  PL_RETURN_IF_ERROR(compiler_.CompileIR(ir.get(), compiler_state));
+  return ir;
+}
+
 StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
     const distributedpb::LogicalPlannerState& logical_state,
     const plannerpb::CompileMutationsRequest& mutations_req) {
@@ -25,6 +25,7 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/plan_cache.h"
 #include "src/carnot/planner/plannerpb/func_args.pb.h"
 #include "src/carnot/planner/probes/probes.h"
 #include "src/shared/scriptspb/scripts.pb.h"
@@ -65,11 +66,19 @@ class LogicalPlanner : public NotCopyable {
   Status Init(std::unique_ptr<planner::RegistryInfo> registry_info);
   Status Init(const udfspb::UDFInfo& udf_info);
 
+  const PlanCache& plan_cache() const { return plan_cache_; }
+
  protected:
   LogicalPlanner() {}
 
  private:
+  // Compiles the query into a single node plan, reusing the cached IR of the script if possible.
+  StatusOr<std::shared_ptr<IR>> CompileToIR(const distributedpb::LogicalPlannerState& logical_state,
+                                            const plannerpb::QueryRequest& query_request,
+                                            CompilerState* compiler_state);
+
   compiler::Compiler compiler_;
+  PlanCache plan_cache_;
   std::unique_ptr<distributed::Planner> distributed_planner_;
   std::unique_ptr<planner::RegistryInfo> registry_info_;
 };
@@ -18,6 +18,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <absl/strings/str_cat.h>
+
 #include "src/carnot/planner/logical_planner.h"
 #include "src/carnot/planner/test_utils.h"
 #include "src/carnot/udf_exporter/udf_exporter.h"
@@ -42,7 +44,24 @@ void BM_Query(benchmark::State& state) {
   }
 }
 
+// NOLINTNEXTLINE : runtime/references.
+void BM_QueryColdPlanCache(benchmark::State& state) {
+  auto info = udfexporter::ExportUDFInfo().ConsumeValueOrDie()->info_pb();
+  auto planner = LogicalPlanner::Create(info).ConsumeValueOrDie();
+  auto planner_state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  plannerpb::QueryRequest query_request;
+  int64_t i = 0;
+  for (auto _ : state) {
+    // A different comment each time makes every query miss the plan cache.
+    query_request.set_query_str(absl::StrCat(testutils::kHttpRequestStats, "\n# ", i++));
+    auto plan_or_s = planner->Plan(planner_state, query_request);
+    EXPECT_OK(plan_or_s);
+  }
+}
+
+// BM_Query hits the plan cache after the first iteration.
 BENCHMARK(BM_Query);
+BENCHMARK(BM_QueryColdPlanCache);
 
 }  // namespace logical_planner
 }  // namespace planner
@@ -20,6 +20,7 @@
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -639,6 +640,78 @@ TEST_F(LogicalPlannerTest, default_compiler_state_has_nullptr) {
   EXPECT_EQ(compiler_state->endpoint_config(), nullptr);
 }
 
+TEST_F(LogicalPlannerTest, plan_cache) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto query = MakeQueryRequest("import px\npx.display(px.DataFrame('http_events'), 'out')");
+
+  ASSERT_OK_AND_ASSIGN(auto first_plan, planner->Plan(state, query));
+  EXPECT_EQ(0, planner->plan_cache().hits());
+  EXPECT_EQ(1, planner->plan_cache().size());
+
+  ASSERT_OK_AND_ASSIGN(auto second_plan, planner->Plan(state, query));
+  EXPECT_EQ(1, planner->plan_cache().hits());
+  ASSERT_OK_AND_ASSIGN(auto first_pb, first_plan->ToProto());
+  ASSERT_OK_AND_ASSIGN(auto second_pb, second_plan->ToProto());
+  EXPECT_THAT(second_pb, EqualsProto(first_pb.DebugString()));
+
+  // A different set of agents gets its own entry.
+  auto other_state = testutils::CreateOnePEMOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  ASSERT_OK(planner->Plan(other_state, query));
+  EXPECT_EQ(1, planner->plan_cache().hits());
+  EXPECT_EQ(2, planner->plan_cache().size());
+}
+
+TEST_F(LogicalPlannerTest, plan_cache_relative_time) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+
+  // Relative start times are resolved after the cached stage, so the script is still cached.
+  ASSERT_OK(planner->Plan(state, MakeQueryRequest(testutils::kHttpRequestStats)));
+  ASSERT_OK_AND_ASSIGN(auto plan,
+                       planner->Plan(state, MakeQueryRequest(testutils::kHttpRequestStats)));
+  EXPECT_EQ(1, planner->plan_cache().hits());
+  EXPECT_OK(plan->ToProto());
+}
+
+// The query broker shares one planner between concurrent requests.
+TEST_F(LogicalPlannerTest, plan_cache_concurrent_queries) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto query = MakeQueryRequest("import px\npx.display(px.DataFrame('http_events'), 'out')");
+
+  constexpr int kNumThreads = 4;
+  constexpr int kQueriesPerThread = 8;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < kQueriesPerThread; ++j) {
+        EXPECT_OK(planner->Plan(state, query));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(1, planner->plan_cache().size());
+  EXPECT_EQ(kNumThreads * kQueriesPerThread,
+            planner->plan_cache().hits() + planner->plan_cache().misses());
+}
+
+constexpr char kNowQuery[] = R"pxl(
+import px
+t1 = px.DataFrame(table='http_events', start_time=px.now() - px.minutes(5))
+px.display(t1)
+)pxl";
+
+TEST_F(LogicalPlannerTest, plan_cache_skips_now) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+
+  ASSERT_OK(planner->Plan(state, MakeQueryRequest(kNowQuery)));
+  EXPECT_EQ(0, planner->plan_cache().size());
+}
+
 }  // namespace planner
 }  // namespace carnot
 }  // namespace px
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/carnot/planner/plan_cache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <absl/hash/hash.h>
+#include <absl/strings/str_cat.h>
+
+#include "src/common/metrics/metrics.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+namespace {
+
+// Map fields are serialized in an unspecified order unless serialization is deterministic.
+std::string SerializeDeterministic(const google::protobuf::Message& msg) {
+  std::string out;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&out);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    msg.SerializeToCodedStream(&coded_stream);
+  }
+  return out;
+}
+
+}  // namespace
+
+PlanCache::PlanCache(size_t capacity)
+    : capacity_(capacity),
+      hits_counter_(BuildCounter("planner_plan_cache_hits",
+                                 "Number of queries whose IR was found in the plan cache")),
+      misses_counter_(BuildCounter("planner_plan_cache_misses",
+                                   "Number of queries that were compiled from scratch")) {}
+
+std::string PlanCache::Key(const distributedpb::LogicalPlannerState& logical_state,
+                           const plannerpb::QueryRequest& query_request) {
+  // The planner state is large (it holds the schemas of every table), so only its hash is kept.
+  size_t state_hash = absl::Hash<std::string>()(SerializeDeterministic(logical_state));
+  return absl::StrCat(state_hash, ":", SerializeDeterministic(query_request));
+}
+
+StatusOr<std::shared_ptr<IR>> PlanCache::Lookup(const std::string& key) {
+  std::shared_ptr<const IR> cached;
+  {
+    absl::MutexLock lock(&lock_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++misses_;
+      misses_counter_.Increment();
+      return std::shared_ptr<IR>(nullptr);
+    }
+    ++hits_;
+    hits_counter_.Increment();
+    entries_.splice(entries_.begin(), entries_, it->second);
+    cached = it->second->second;
+  }
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> ir, cached->Clone());
+  return std::shared_ptr<IR>(std::move(ir));
+}
+
+Status PlanCache::Insert(const std::string& key, const IR& ir) {
+  if (capacity_ == 0) {
+    return Status::OK();
+  }
+  {
+    absl::MutexLock lock(&lock_);
+    if (index_.contains(key)) {
+      return Status::OK();
+    }
+  }
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> copy, ir.Clone());
+
+  absl::MutexLock lock(&lock_);
+  // Another query may have compiled and inserted the same script while this one was cloning.
+  if (index_.contains(key)) {
+    return Status::OK();
+  }
+  if (entries_.size() >= capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, std::shared_ptr<const IR>(std::move(copy)));
+  index_[entries_.front().first] = entries_.begin();
+  return Status::OK();
+}
+
+void PlanCache::Clear() {
+  absl::MutexLock lock(&lock_);
+  index_.clear();
+  entries_.clear();
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <prometheus/counter.h>
+
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/carnot/planner/ir/ir.h"
+#include "src/carnot/planner/plannerpb/func_args.pb.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+// Maximum number of scripts whose IR the plan cache keeps.
+constexpr size_t kPlanCacheSize = 256;
+
+/**
+ * PlanCache is an LRU cache of the IR that a script compiles to before analysis, i.e. the output of
+ * parsing the script and walking its AST.
+ *
+ * Entries are keyed by the query request, which holds the script and its exec func arguments,
+ * together with a hash of the logical planner state. A change of agents or schemas changes the
+ * state hash, so plans compiled against an old state are never returned and age out of the cache.
+ *
+ * The rest of the pipeline (analyzer, optimizer and distributed planner) still runs on every query,
+ * because it resolves relative times such as start_time='-5m' against the current time.
+ *
+ * The cache is thread-safe: a single planner serves concurrent queries.
+ */
+class PlanCache : public NotCopyable {
+ public:
+  explicit PlanCache(size_t capacity = kPlanCacheSize);
+
+  /**
+   * Returns the cache key for a query compiled against the given planner state.
+   */
+  static std::string Key(const distributedpb::LogicalPlannerState& logical_state,
+                         const plannerpb::QueryRequest& query_request);
+
+  /**
+   * Returns a copy of the cached IR for the key, or nullptr if there is none.
+   */
+  StatusOr<std::shared_ptr<IR>> Lookup(const std::string& key);
+
+  /**
+   * Caches a copy of the IR under the key.
+   */
+  Status Insert(const std::string& key, const IR& ir);
+
+  void Clear();
+
+  size_t size() const {
+    absl::MutexLock lock(&lock_);
+    return entries_.size();
+  }
+  int64_t hits() const {
+    absl::MutexLock lock(&lock_);
+    return hits_;
+  }
+  int64_t misses() const {
+    absl::MutexLock lock(&lock_);
+    return misses_;
+  }
+
+ private:
+  // Entries are shared, so that they can be cloned outside of the lock, even if evicted meanwhile.
+  using Entry = std::pair<std::string, std::shared_ptr<const IR>>;
+  using EntryList = std::list<Entry>;
+
+  const size_t capacity_;
+
+  mutable absl::Mutex lock_;
+  EntryList entries_ ABSL_GUARDED_BY(lock_);
+  absl::flat_hash_map<std::string, EntryList::iterator> index_ ABSL_GUARDED_BY(lock_);
+  int64_t hits_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t misses_ ABSL_GUARDED_BY(lock_) = 0;
+
+  prometheus::Counter& hits_counter_;
+  prometheus::Counter& misses_counter_;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -153,6 +153,13 @@ column_names: "usage"
 tablet: $0
 )";
 
+constexpr char kMemSourceOperatorWithTablets[] = R"(
+name: "cpu"
+column_idxs: 1
+column_types: FLOAT64
+column_names: "usage"
+)";
+
 constexpr char kMemSourceOperatorRange[] = R"(
 name: "cpu"
 start_time: {
@@ -1342,6 +1349,17 @@ planpb::Operator CreateTestSourceWithTablets1PB(const types::TabletID& tablet_va
   return op;
 }
 
+planpb::Operator CreateTestSourceWithTabletsPB(const std::vector<types::TabletID>& tablets) {
+  planpb::Operator op;
+  auto op_proto = absl::Substitute(kOperatorProtoTmpl, "MEMORY_SOURCE_OPERATOR", "mem_source_op",
+                                   kMemSourceOperatorWithTablets);
+  CHECK(google::protobuf::TextFormat::MergeFromString(op_proto, &op)) << "Failed to parse proto";
+  for (const auto& tablet : tablets) {
+    op.mutable_mem_source_op()->add_tablets(tablet);
+  }
+  return op;
+}
+
 planpb::Operator CreateTestSourceRangePB() {
   planpb::Operator op;
   auto op_proto = absl::Substitute(kOperatorProtoTmpl, "MEMORY_SOURCE_OPERATOR", "mem_source_op",
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace udf {
+
+// Maximum number of distinct inputs remembered per UDF instance.
+constexpr size_t kExecCacheSize = 4096;
+
+/**
+ * Type erased base for ExecCache, so that ScalarUDF can own a cache without knowing its types.
+ */
+class AnyExecCache {
+ public:
+  virtual ~AnyExecCache() = default;
+};
+
+/**
+ * ExecCache is an LRU cache from a single UDF argument to the UDF's result.
+ * @tparam TArg The UDF value type of the argument.
+ * @tparam TResult The UDF value type of the result.
+ */
+template <typename TArg, typename TResult>
+class ExecCache : public AnyExecCache {
+  // Strings are looked up by view, so a hit never allocates.
+  static constexpr bool kIsString = std::is_same_v<TArg, types::StringValue>;
+  using Key = typename types::ValueTypeTraits<TArg>::native_type;
+  using KeyView = std::conditional_t<kIsString, std::string_view, Key>;
+  using Entry = std::pair<Key, TResult>;
+  using EntryList = std::list<Entry>;
+
+ public:
+  explicit ExecCache(size_t capacity = kExecCacheSize) : capacity_(capacity) {}
+
+  /**
+   * Returns the cached result for arg, or nullptr if there is none.
+   * The pointer is valid until the next call to Insert.
+   */
+  const TResult* Lookup(const TArg& arg) { return LookupKey(ToKeyView(arg)); }
+
+  void Insert(const TArg& arg, const TResult& result) { InsertKey(ToKeyView(arg), result); }
+
+  /**
+   * Same as Lookup and Insert, but keyed by the argument's native value (or a view of it for
+   * strings), so callers reading arrow arrays don't have to build a UDF value first.
+   */
+  const TResult* LookupKey(const KeyView& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->second;
+  }
+
+  void InsertKey(const KeyView& key, const TResult& result) {
+    if (entries_.size() >= capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.emplace_front(Key(key), result);
+    index_[entries_.front().first] = entries_.begin();
+  }
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  static KeyView ToKeyView(const TArg& arg) {
+    if constexpr (kIsString) {
+      return std::string_view(arg);
+    } else {
+      return arg.val;
+    }
+  }
+
+  size_t capacity_;
+  EntryList entries_;
+  absl::flat_hash_map<Key, typename EntryList::iterator> index_;
+};
+
+}  // namespace udf
+}  // namespace carnot
+}  // namespace px
@@ -31,6 +31,7 @@
 #include <functional>
 
 #include "src/carnot/udf/base.h"
+#include "src/carnot/udf/exec_cache.h"
 #include "src/carnot/udfspb/udfs.pb.h"
 #include "src/common/base/base.h"
 #include "src/shared/metadata/metadata_state.h"
@@ -74,10 +75,28 @@ class AnyUDA : public BaseFunc {
  *      Status Init(FunctionContext *ctx, UDFValue... init_args) {}
  *  This function is called once during initialization of each instance (many instances
  *  may exists in a given query). The arguments are as provided by the query.
+ *
+ * UDFs whose result depends only on the arguments and the FunctionContext (e.g. metadata
+ * lookups, comparisons) can declare:
+ *      static constexpr bool IsPure() { return true; }
+ *  Single argument pure UDFs are memoized per UDF instance (and therefore per query), so the
+ *  Exec function is only called once for each distinct input, and those returning a STRING emit
+ *  dictionary encoded columns. A pure UDF applied to a dictionary encoded column, with all other
+ *  arguments constant, runs once per dictionary value instead of once per row.
+ *
+ * Single argument UDFs with a high fixed cost per call (e.g. model inference) can implement:
+ *      Status ExecBatch(FunctionContext *ctx, const UDFValue* in, UDFValue* out, size_t count) {}
+ *  When present it is used instead of Exec to evaluate whole column chunks at once.
  */
 class ScalarUDF : public AnyUDF {
  public:
   ~ScalarUDF() override = default;
+
+ private:
+  template <typename TUDF>
+  friend struct ScalarUDFWrapper;
+
+  std::unique_ptr<AnyExecCache> exec_cache_;
 };
 
 /**
@@ -167,6 +186,20 @@ struct has_udf_executor_fn<T, std::void_t<decltype(&T::Executor)>> : std::true_t
       "If an executor function exists, it must have the form: UDFSourceExecutor Executor()");
 };
 
+// SFINAE test for IsPure fn.
+template <typename T, typename = void>
+struct has_udf_pure_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_pure_fn<T, std::void_t<decltype(&T::IsPure)>> : std::true_type {};
+
+// SFINAE test for ExecBatch fn.
+template <typename T, typename = void>
+struct has_udf_exec_batch_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_exec_batch_fn<T, std::void_t<decltype(&T::ExecBatch)>> : std::true_type {};
+
 template <typename T, typename = void>
 struct check_executor_fn {};
 
@@ -228,6 +261,26 @@ class ScalarUDFTraits {
    */
   static constexpr bool HasExecutor() { return has_udf_executor_fn<T>::value; }
 
+  /**
+   * Checks if the UDF declared that its results can be memoized.
+   */
+  static constexpr bool IsPure() {
+    if constexpr (has_udf_pure_fn<T>::value) {
+      return T::IsPure();
+    }
+    return false;
+  }
+
+  /**
+   * Checks if the UDF can evaluate a chunk of rows in a single ExecBatch call.
+   */
+  static constexpr bool HasExecBatch() {
+    if constexpr (has_udf_exec_batch_fn<T>::value) {
+      static_assert(ExecArguments().size() == 1, "ExecBatch requires a single argument UDF");
+    }
+    return has_udf_exec_batch_fn<T>::value;
+  }
+
   template <typename Q = T, std::enable_if_t<ScalarUDFTraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
@@ -95,6 +95,8 @@ class ScalarUDFDefinition : public UDFDefinition {
     exec_arguments_ = {begin(exec_arguments_array), end(exec_arguments_array)};
     exec_wrapper_fn_ = ScalarUDFWrapper<TUDF>::ExecBatch;
     exec_wrapper_arrow_fn_ = ScalarUDFWrapper<TUDF>::ExecBatchArrow;
+    exec_wrapper_arrow_dictionary_fn_ = ScalarUDFWrapper<TUDF>::ExecBatchArrowDictionary;
+    is_pure_ = ScalarUDFTraits<TUDF>::IsPure();
     init_wrapper_fn_ = ScalarUDFWrapper<TUDF>::ExecInit;
 
     auto init_arguments_array = ScalarUDFTraits<TUDF>::InitArguments();
@@ -131,6 +133,17 @@ class ScalarUDFDefinition : public UDFDefinition {
     return exec_wrapper_arrow_fn_(udf, ctx, inputs, output, count);
   }
 
+  /**
+   * Executes the UDF into a dictionary encoded STRING column. Only valid when
+   * ProducesDictionary() is true.
+   */
+  StatusOr<std::shared_ptr<arrow::Array>> ExecBatchArrowDictionary(ScalarUDF* udf,
+                                                                   FunctionContext* ctx,
+                                                                   arrow::Array* input, int count,
+                                                                   arrow::MemoryPool* mem_pool) {
+    return exec_wrapper_arrow_dictionary_fn_(udf, ctx, input, count, mem_pool);
+  }
+
   Status ExecInit(ScalarUDF* udf, FunctionContext* ctx,
                   const std::vector<std::shared_ptr<types::BaseValueType>>& inputs) {
     return init_wrapper_fn_(udf, ctx, inputs);
@@ -144,6 +157,15 @@ class ScalarUDFDefinition : public UDFDefinition {
   const std::vector<types::DataType>& exec_arguments() const { return exec_arguments_; }
   const std::vector<types::DataType>& init_arguments() const { return init_arguments_; }
   udfspb::UDFSourceExecutor executor() const { return executor_; }
+  bool is_pure() const { return is_pure_; }
+
+  /**
+   * Whether the UDF's results can be emitted as a dictionary encoded column: it is pure, takes a
+   * single argument and returns a STRING (e.g. the metadata lookups).
+   */
+  bool ProducesDictionary() const {
+    return is_pure_ && exec_arguments_.size() == 1 && exec_return_type_ == types::DataType::STRING;
+  }
 
   const std::vector<types::DataType>& RegistryArgTypes() override { return registry_arguments_; }
   size_t Arity() const { return exec_arguments_.size(); }
@@ -155,6 +177,7 @@ class ScalarUDFDefinition : public UDFDefinition {
   std::vector<types::DataType> registry_arguments_;
   types::DataType exec_return_type_;
   udfspb::UDFSourceExecutor executor_;
+  bool is_pure_ = false;
   std::function<std::unique_ptr<ScalarUDF>()> make_fn_;
   std::function<Status(ScalarUDF*, FunctionContext* ctx,
                        const std::vector<const types::ColumnWrapper*>& inputs,
@@ -166,6 +189,11 @@ class ScalarUDFDefinition : public UDFDefinition {
                        int count)>
       exec_wrapper_arrow_fn_;
 
+  std::function<StatusOr<std::shared_ptr<arrow::Array>>(
+      ScalarUDF* udf, FunctionContext* ctx, arrow::Array* input, int count,
+      arrow::MemoryPool* mem_pool)>
+      exec_wrapper_arrow_dictionary_fn_;
+
   std::function<Status(ScalarUDF* udf, FunctionContext* ctx,
                        const std::vector<std::shared_ptr<types::BaseValueType>>& inputs)>
       init_wrapper_fn_;
@@ -67,6 +67,50 @@ class InitArgUDF : public ScalarUDF {
   int64_t i_;
 };
 
+class CountingPureUDF : public ScalarUDF {
+ public:
+  static constexpr bool IsPure() { return true; }
+
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v) {
+    ++exec_count;
+    return v.val * 2;
+  }
+
+  int exec_count = 0;
+};
+
+class CountingPureStringUDF : public ScalarUDF {
+ public:
+  static constexpr bool IsPure() { return true; }
+
+  types::StringValue Exec(FunctionContext*, types::Int64Value v) {
+    ++exec_count;
+    return v.val % 2 == 0 ? "even" : "odd";
+  }
+
+  int exec_count = 0;
+};
+
+class CountingBatchUDF : public ScalarUDF {
+ public:
+  types::StringValue Exec(FunctionContext* ctx, types::StringValue v) {
+    types::StringValue out;
+    PL_CHECK_OK(ExecBatch(ctx, &v, &out, 1));
+    return out;
+  }
+
+  Status ExecBatch(FunctionContext*, const types::StringValue* in, types::StringValue* out,
+                   size_t count) {
+    ++batch_count;
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = in[i] + "!";
+    }
+    return Status::OK();
+  }
+
+  int batch_count = 0;
+};
+
 TEST(UDFDefinition, no_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   ScalarUDFDefinition def("noargudf");
@@ -115,6 +159,130 @@ TEST(UDFDefinition, str_args) {
   EXPECT_EQ("el", out[2]);
 }
 
+TEST(UDFDefinition, pure_udf_memoized) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("double");
+  EXPECT_OK(def.Init<CountingPureUDF>());
+  auto u = def.Make();
+  auto* counting_udf = static_cast<CountingPureUDF*>(u.get());
+
+  types::Int64ValueColumnWrapper v1({1, 1, 2, 1, 3, 2});
+  types::Int64ValueColumnWrapper out(v1.Size());
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&v1}, &out, v1.Size()));
+  EXPECT_EQ(3, counting_udf->exec_count);
+  EXPECT_EQ(2, out[0].val);
+  EXPECT_EQ(2, out[1].val);
+  EXPECT_EQ(4, out[2].val);
+  EXPECT_EQ(2, out[3].val);
+  EXPECT_EQ(6, out[4].val);
+  EXPECT_EQ(4, out[5].val);
+
+  // Results are remembered across batches.
+  types::Int64ValueColumnWrapper v2({3, 4, 1});
+  types::Int64ValueColumnWrapper out2(v2.Size());
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&v2}, &out2, v2.Size()));
+  EXPECT_EQ(4, counting_udf->exec_count);
+  EXPECT_EQ(6, out2[0].val);
+  EXPECT_EQ(8, out2[1].val);
+  EXPECT_EQ(2, out2[2].val);
+}
+
+TEST(UDFDefinition, batch_udf) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("exclaim");
+  EXPECT_OK(def.Init<CountingBatchUDF>());
+  auto u = def.Make();
+  auto* batch_udf = static_cast<CountingBatchUDF*>(u.get());
+
+  types::StringValueColumnWrapper v1({"a", "b", "c"});
+  types::StringValueColumnWrapper out(v1.Size());
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&v1}, &out, v1.Size()));
+  EXPECT_EQ(1, batch_udf->batch_count);
+  EXPECT_EQ("a!", out[0]);
+  EXPECT_EQ("b!", out[1]);
+  EXPECT_EQ("c!", out[2]);
+
+  std::vector<types::StringValue> v2 = {"x", "y"};
+  auto v2a = ToArrow(v2, arrow::default_memory_pool());
+  auto output_builder = std::make_shared<arrow::StringBuilder>();
+  EXPECT_OK(ScalarUDFWrapper<CountingBatchUDF>::ExecBatchArrow(u.get(), &ctx, {v2a.get()},
+                                                               output_builder.get(), 2));
+  EXPECT_EQ(2, batch_udf->batch_count);
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* res_arr = static_cast<arrow::StringArray*>(res.get());
+  EXPECT_EQ("x!", res_arr->GetString(0));
+  EXPECT_EQ("y!", res_arr->GetString(1));
+}
+
+TEST(UDFDefinition, pure_udf_memoized_arrow) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  CountingPureUDF udf;
+
+  std::vector<types::Int64Value> v1 = {1, 1, 2, 1, 3, 2};
+  auto v1a = ToArrow(v1, arrow::default_memory_pool());
+  arrow::Int64Builder output_builder;
+  EXPECT_OK(ScalarUDFWrapper<CountingPureUDF>::ExecBatchArrow(&udf, &ctx, {v1a.get()},
+                                                              &output_builder, v1.size()));
+  EXPECT_EQ(3, udf.exec_count);
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_OK(output_builder.Finish(&res));
+  auto* res_arr = static_cast<arrow::Int64Array*>(res.get());
+  ASSERT_EQ(6, res_arr->length());
+  EXPECT_EQ(2, res_arr->Value(0));
+  EXPECT_EQ(2, res_arr->Value(1));
+  EXPECT_EQ(4, res_arr->Value(2));
+  EXPECT_EQ(2, res_arr->Value(3));
+  EXPECT_EQ(6, res_arr->Value(4));
+  EXPECT_EQ(4, res_arr->Value(5));
+
+  // Results are remembered across batches, and shared with the column wrapper path.
+  types::Int64ValueColumnWrapper v2({3, 4, 1});
+  types::Int64ValueColumnWrapper out2(v2.Size());
+  EXPECT_OK(ScalarUDFWrapper<CountingPureUDF>::ExecBatch(&udf, &ctx, {&v2}, &out2, v2.Size()));
+  EXPECT_EQ(4, udf.exec_count);
+  EXPECT_EQ(8, out2[1].val);
+}
+
+TEST(UDFDefinition, pure_string_udf_dictionary) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("counting_pure_string");
+  ASSERT_OK(def.Init<CountingPureStringUDF>());
+  EXPECT_TRUE(def.ProducesDictionary());
+  auto udf = def.Make();
+
+  std::vector<types::Int64Value> v1 = {1, 1, 2, 3, 4, 2};
+  auto v1a = ToArrow(v1, arrow::default_memory_pool());
+  ASSERT_OK_AND_ASSIGN(auto res, def.ExecBatchArrowDictionary(udf.get(), &ctx, v1a.get(),
+                                                              v1.size(),
+                                                              arrow::default_memory_pool()));
+  // Exec runs once per distinct input, and the column holds each distinct result once.
+  EXPECT_EQ(4, static_cast<CountingPureStringUDF*>(udf.get())->exec_count);
+  ASSERT_TRUE(types::IsDictionaryEncoded(res.get()));
+  EXPECT_EQ(2, types::DictionaryValues(res.get())->length());
+  std::vector<std::string> expected = {"odd", "odd", "even", "odd", "even", "even"};
+  for (const auto& [idx, value] : Enumerate(expected)) {
+    EXPECT_EQ(value, types::GetStringViewFromArrowArray(res.get(), idx));
+  }
+
+  ScalarUDFDefinition int_def("counting_pure");
+  ASSERT_OK(int_def.Init<CountingPureUDF>());
+  EXPECT_FALSE(int_def.ProducesDictionary());
+}
+
+TEST(ExecCache, evicts_least_recently_used) {
+  ExecCache<types::StringValue, types::Int64Value> cache(2);
+  cache.Insert("a", 1);
+  cache.Insert("b", 2);
+  ASSERT_NE(nullptr, cache.Lookup("a"));
+  cache.Insert("c", 3);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(nullptr, cache.Lookup("b"));
+  ASSERT_NE(nullptr, cache.Lookup("a"));
+  EXPECT_EQ(1, cache.Lookup("a")->val);
+  EXPECT_EQ(3, cache.Lookup("c")->val);
+}
+
 TEST(UDFDefinition, arrow_write) {
   auto ctx = FunctionContext(nullptr, nullptr);
   std::vector<types::Int64Value> v1 = {1, 2, 3};
@@ -19,8 +19,13 @@
 #include <benchmark/benchmark.h>
 
 #include <random>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/substitute.h>
+
 #include "src/carnot/udf/registry.h"
 #include "src/carnot/udf/udf_wrapper.h"
 #include "src/common/base/base.h"
@@ -40,6 +45,7 @@ using px::types::Int64Value;
 using px::types::Int64ValueColumnWrapper;
 using px::types::StringValue;
 using px::types::StringValueColumnWrapper;
+using px::types::UInt128Value;
 using px::types::ToArrow;
 
 using px::datagen::CreateLargeData;
@@ -62,6 +68,30 @@ class SubStrUDF : public ScalarUDF {
   StringValue Exec(FunctionContext*, StringValue v1) { return v1.substr(1, 2); }
 };
 
+// Stands in for the K8s metadata state: UPID -> (namespace, pod name).
+absl::flat_hash_map<absl::uint128, std::pair<std::string, std::string>>& FakePodsByUPID() {
+  static auto* pods = new absl::flat_hash_map<absl::uint128, std::pair<std::string, std::string>>;
+  return *pods;
+}
+
+// Mimics UPIDToPodNameUDF: a hash lookup and a string allocation per call.
+class UPIDToPodNameUDF : public ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext*, UInt128Value upid) {
+    const auto& pods = FakePodsByUPID();
+    auto it = pods.find(upid.val);
+    if (it == pods.end()) {
+      return "";
+    }
+    return absl::Substitute("$0/$1", it->second.first, it->second.second);
+  }
+};
+
+class PureUPIDToPodNameUDF : public UPIDToPodNameUDF {
+ public:
+  static constexpr bool IsPure() { return true; }
+};
+
 // This benchmark add two columns using Int64ValueVectors.
 // NOLINTNEXTLINE : runtime/references.
 static void BM_AddInt64Values(benchmark::State& state) {
@@ -244,6 +274,45 @@ static void BM_SubStrArrow(benchmark::State& state) {
   state.SetBytesProcessed(int64_t(state.iterations()) * width * data.size());
 }
 
+// Benchmark a metadata style UDF on a batch with few distinct UPIDs, as is typical of tables
+// like http_events. Runs through ExecBatchArrow, which is how MapNode evaluates scalar UDFs.
+// NOLINTNEXTLINE : runtime/references.
+template <typename TUDF>
+static void BM_UPIDToPodName(benchmark::State& state) {
+  constexpr int kNumPods = 100;
+  auto& pods = FakePodsByUPID();
+  for (int i = 0; i < kNumPods; ++i) {
+    pods[absl::MakeUint128(i, i)] = {"pl", absl::Substitute("pod-$0", i)};
+  }
+
+  std::mt19937 gen(37);
+  std::uniform_int_distribution<int> dist(0, kNumPods - 1);
+  std::vector<UInt128Value> upids(state.range(0));
+  for (auto& upid : upids) {
+    int pod = dist(gen);
+    upid = UInt128Value(pod, pod);
+  }
+  auto in_arr = ToArrow(upids, arrow::default_memory_pool());
+
+  std::shared_ptr<arrow::Array> out;
+  ScalarUDFDefinition def("upid_to_pod_name");
+  CHECK(def.template Init<TUDF>().ok());
+  auto u = def.Make();
+  // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
+  for (auto _ : state) {
+    arrow::StringBuilder output_builder;
+    auto res = ScalarUDFWrapper<TUDF>::ExecBatchArrow(u.get(), nullptr, {in_arr.get()},
+                                                      &output_builder, upids.size());
+    PL_CHECK_OK(res);
+    PL_CHECK_OK(output_builder.Finish(&out));
+    benchmark::DoNotOptimize(out);
+  }
+
+  CHECK_EQ(absl::Substitute("pl/pod-$0", upids[0].Low64()),
+           static_cast<arrow::StringArray*>(out.get())->GetString(0));
+  state.SetItemsProcessed(int64_t(state.iterations()) * upids.size());
+}
+
 BENCHMARK(BM_AddInt64ValueToArrow)->RangeMultiplier(2)->Range(1, 1 << 16);
 BENCHMARK(BM_AddTwoInt64sArrow)->RangeMultiplier(2)->Range(1, 1 << 16);
 BENCHMARK(BM_AddInt64Values)->RangeMultiplier(2)->Range(1, 1 << 16);
@@ -253,3 +322,8 @@ BENCHMARK(BM_ConvertToArrowInt64)->RangeMultiplier(2)->Range(1, 1 << 16);
 
 BENCHMARK(BM_SubStrArrow)->RangeMultiplier(2)->Range(1, 1 << 16);
 BENCHMARK(BM_SubStr)->RangeMultiplier(2)->Range(1, 1 << 16);
+
+BENCHMARK_TEMPLATE(BM_UPIDToPodName, UPIDToPodNameUDF)->RangeMultiplier(4)->Range(1 << 4, 1 << 16);
+BENCHMARK_TEMPLATE(BM_UPIDToPodName, PureUPIDToPodNameUDF)
+    ->RangeMultiplier(4)
+    ->Range(1 << 4, 1 << 16);
@@ -29,6 +29,7 @@
 #include "src/common/base/base.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/column_wrapper.h"
+#include "src/shared/types/string_dictionary.h"
 
 namespace px {
 namespace carnot {
@@ -197,6 +198,19 @@ struct ScalarUDFWrapper {
     // Check that the arity is correct.
     DCHECK(inputs.size() == ScalarUDFTraits<TUDF>::ExecArguments().size());
 
+    if constexpr (ScalarUDFTraits<TUDF>::HasExecBatch()) {
+      return ExecBatchArrowChunk(
+          static_cast<TUDF*>(udf), ctx, inputs[0],
+          static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output),
+          count);
+    }
+    if constexpr (ScalarUDFTraits<TUDF>::IsPure() && exec_argument_types.size() == 1) {
+      return ExecBatchArrowMemoized(
+          static_cast<TUDF*>(udf), ctx, inputs[0],
+          static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output),
+          count);
+    }
+
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
@@ -206,6 +220,166 @@ struct ScalarUDFWrapper {
         inputs, std::make_index_sequence<exec_argument_types.size()>{});
   }
 
+  /**
+   * Executes a UDF with an ExecBatch function on an arrow chunk by materializing the input
+   * values, running ExecBatch once, and appending the results to the output builder.
+   */
+  template <typename TOutput>
+  static Status ExecBatchArrowChunk(TUDF* udf, FunctionContext* ctx, arrow::Array* input,
+                                    TOutput* out, int count) {
+    constexpr types::DataType arg_type = ScalarUDFTraits<TUDF>::ExecArguments()[0];
+    constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+    std::vector<typename types::DataTypeTraits<arg_type>::value_type> args;
+    args.reserve(count);
+    for (int idx = 0; idx < count; ++idx) {
+      args.emplace_back(types::GetValueFromArrowArray<arg_type>(input, idx));
+    }
+    std::vector<typename types::DataTypeTraits<return_type>::value_type> results(count);
+    PL_RETURN_IF_ERROR(udf->ExecBatch(ctx, args.data(), results.data(), count));
+
+    PL_RETURN_IF_ERROR(out->Reserve(count));
+    // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+    if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
+      int64_t total_size = 0;
+      for (const auto& res : results) {
+        total_size += res.size();
+      }
+      PL_RETURN_IF_ERROR(out->ReserveData(total_size));
+    }
+    for (const auto& res : results) {
+      out->UnsafeAppend(UnWrap(res));
+    }
+    return Status::OK();
+  }
+
+  /**
+   * Arrow version of ExecBatchMemoized. Runs of equal inputs are compared in place in the arrow
+   * array, and cache lookups use the native value (a string view for strings), so repeated inputs
+   * don't allocate.
+   */
+  template <typename TOutput>
+  static Status ExecBatchArrowMemoized(TUDF* udf, FunctionContext* ctx, arrow::Array* input,
+                                       TOutput* out, int count) {
+    constexpr types::DataType arg_type = ScalarUDFTraits<TUDF>::ExecArguments()[0];
+    constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+    using result_type = typename types::DataTypeTraits<return_type>::value_type;
+    auto* cache = GetExecCache<result_type>(udf);
+
+    auto key_at = [input](int idx) {
+      if constexpr (arg_type == types::DataType::STRING) {
+        return types::GetStringViewFromArrowArray(input, idx);
+      } else {
+        return types::GetValueFromArrowArray<arg_type>(input, idx);
+      }
+    };
+
+    PL_RETURN_IF_ERROR(out->Reserve(count));
+    size_t reserved = count * kStringAssumedSizeHeuristic;
+    size_t total_size = 0;
+    // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+    if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
+      PL_RETURN_IF_ERROR(out->ReserveData(reserved));
+    }
+    result_type result;
+    decltype(key_at(0)) prev_key{};
+    for (int idx = 0; idx < count; ++idx) {
+      auto key = key_at(idx);
+      if (idx == 0 || key != prev_key) {
+        const result_type* cached = cache->LookupKey(key);
+        if (cached != nullptr) {
+          result = *cached;
+        } else {
+          result = udf->Exec(ctx, types::GetValueFromArrowArray<arg_type>(input, idx));
+          cache->InsertKey(key, result);
+        }
+        prev_key = key;
+      }
+      // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+      if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
+        total_size += result.size();
+        while (total_size >= reserved) {
+          reserved *= 2;
+          PL_RETURN_IF_ERROR(out->ReserveData(reserved));
+        }
+      }
+      out->UnsafeAppend(UnWrap(result));
+    }
+    return Status::OK();
+  }
+
+  /**
+   * Executes a pure single argument UDF that returns a STRING into a dictionary encoded column.
+   * Exec runs once per distinct input (through the ExecCache) and each distinct result is stored
+   * once in the column's dictionary, so rows only carry an int32 code.
+   *
+   * @param udf a pointer to the UDF.
+   * @param ctx The function context.
+   * @param input The argument column.
+   * @param count The number of rows in input.
+   * @param mem_pool The pool to allocate the output from.
+   * @return The dictionary encoded output column.
+   */
+  static StatusOr<std::shared_ptr<arrow::Array>> ExecBatchArrowDictionary(
+      ScalarUDF* udf, FunctionContext* ctx, arrow::Array* input, int count,
+      arrow::MemoryPool* mem_pool) {
+    constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+    constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+    if constexpr (return_type != types::DataType::STRING || !ScalarUDFTraits<TUDF>::IsPure() ||
+                  exec_argument_types.size() != 1) {
+      return error::Unimplemented("UDF does not produce dictionary encoded columns");
+    } else {
+      constexpr types::DataType arg_type = exec_argument_types[0];
+      auto* typed_udf = static_cast<TUDF*>(udf);
+      auto* cache = GetExecCache<types::StringValue>(typed_udf);
+
+      auto key_at = [input](int idx) {
+        if constexpr (arg_type == types::DataType::STRING) {
+          return types::GetStringViewFromArrowArray(input, idx);
+        } else {
+          return types::GetValueFromArrowArray<arg_type>(input, idx);
+        }
+      };
+
+      types::StringDictionary dictionary;
+      arrow::Int32Builder codes(mem_pool);
+      PL_RETURN_IF_ERROR(codes.Reserve(count));
+      int32_t code = 0;
+      decltype(key_at(0)) prev_key{};
+      for (int idx = 0; idx < count; ++idx) {
+        auto key = key_at(idx);
+        if (idx == 0 || key != prev_key) {
+          const types::StringValue* cached = cache->LookupKey(key);
+          if (cached != nullptr) {
+            code = dictionary.Insert(*cached);
+          } else {
+            auto result = typed_udf->Exec(ctx, types::GetValueFromArrowArray<arg_type>(input, idx));
+            cache->InsertKey(key, result);
+            code = dictionary.Insert(result);
+          }
+          prev_key = key;
+        }
+        codes.UnsafeAppend(code);
+      }
+      std::shared_ptr<arrow::Array> codes_array;
+      PL_RETURN_IF_ERROR(codes.Finish(&codes_array));
+      return types::MakeStringDictionaryArray(codes_array, dictionary.ToArrow(mem_pool));
+    }
+  }
+
+  /**
+   * Returns the UDF instance's ExecCache, creating it on first use. The cache is shared by the
+   * column wrapper and arrow paths.
+   */
+  template <typename TResult>
+  static auto* GetExecCache(TUDF* udf) {
+    constexpr types::DataType arg_type = ScalarUDFTraits<TUDF>::ExecArguments()[0];
+    using cache_type = ExecCache<typename types::DataTypeTraits<arg_type>::value_type, TResult>;
+    if (udf->exec_cache_ == nullptr) {
+      udf->exec_cache_ = std::make_unique<cache_type>();
+    }
+    return static_cast<cache_type*>(udf->exec_cache_.get());
+  }
+
   /**
    * Provides a method that executes the tempalated UDF on a batch of inputs.
    * The input batches are represented as vector of vectors to the inputs.
@@ -234,10 +408,19 @@ struct ScalarUDFWrapper {
     constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
     auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
     DCHECK(CheckTypes(inputs, exec_argument_types));
-    auto input_as_base_value = ConvertToBaseValue(inputs);
-
     using output_type = typename types::DataTypeTraits<return_type>::value_type;
     auto* casted_output = static_cast<output_type*>(output->UnsafeRawData());
+    auto input_as_base_value = ConvertToBaseValue(inputs);
+    if constexpr (ScalarUDFTraits<TUDF>::HasExecBatch()) {
+      return static_cast<TUDF*>(udf)->ExecBatch(
+          ctx, CastToUDFValueType<exec_argument_types[0]>(input_as_base_value[0]), casted_output,
+          count);
+    }
+    if constexpr (ScalarUDFTraits<TUDF>::IsPure() && exec_argument_types.size() == 1) {
+      return ExecBatchMemoized(static_cast<TUDF*>(udf), ctx, input_as_base_value[0],
+                               casted_output, count);
+    }
+
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
@@ -246,6 +429,32 @@ struct ScalarUDFWrapper {
                              std::make_index_sequence<exec_argument_types.size()>{});
   }
 
+  /**
+   * Executes a pure single argument UDF, calling Exec only for inputs that are not in the UDF
+   * instance's ExecCache. Runs of equal inputs reuse the previous result without a lookup.
+   */
+  template <typename TOutput>
+  static Status ExecBatchMemoized(TUDF* udf, FunctionContext* ctx,
+                                  const types::BaseValueType* input, TOutput* out, int count) {
+    constexpr types::DataType arg_type = ScalarUDFTraits<TUDF>::ExecArguments()[0];
+    auto* cache = GetExecCache<TOutput>(udf);
+    const auto* args = CastToUDFValueType<arg_type>(input);
+    for (int idx = 0; idx < count; ++idx) {
+      if (idx > 0 && args[idx] == args[idx - 1]) {
+        out[idx] = out[idx - 1];
+        continue;
+      }
+      const TOutput* cached = cache->Lookup(args[idx]);
+      if (cached != nullptr) {
+        out[idx] = *cached;
+        continue;
+      }
+      out[idx] = udf->Exec(ctx, args[idx]);
+      cache->Insert(args[idx], out[idx]);
+    }
+    return Status::OK();
+  }
+
   /**
    * Call the UDF's init method.
    *
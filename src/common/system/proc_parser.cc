@@ -609,6 +609,29 @@ std::string ProcParser::GetPIDCmdline(int32_t pid) const {
   return cmdline;
 }
 
+StatusOr<std::vector<std::string>> ProcParser::GetPIDCGroupPaths(int32_t pid) const {
+  std::string fpath = absl::Substitute("$0/$1/cgroup", proc_base_path_, pid);
+  std::ifstream ifs(fpath);
+  if (!ifs) {
+    return error::NotFound("Could not open file $0", fpath);
+  }
+
+  // Each line has the form <hierarchy-id>:<controllers>:<path>.
+  std::vector<std::string> paths;
+  std::string line;
+  while (std::getline(ifs, line)) {
+    size_t pos = line.find(':');
+    if (pos != std::string::npos) {
+      pos = line.find(':', pos + 1);
+    }
+    if (pos == std::string::npos) {
+      continue;
+    }
+    paths.push_back(line.substr(pos + 1));
+  }
+  return paths;
+}
+
 StatusOr<std::filesystem::path> ProcParser::GetExePath(int32_t pid) const {
   auto exe_path = std::filesystem::path(proc_base_path_) / std::to_string(pid) / "exe";
   PL_ASSIGN_OR_RETURN(std::filesystem::path proc_exe, fs::ReadSymlink(exe_path));
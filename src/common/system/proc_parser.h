@@ -204,6 +204,11 @@ class ProcParser {
    */
   StatusOr<std::filesystem::path> GetExePath(int32_t pid) const;
 
+  /**
+   * Returns the cgroup paths listed in /proc/<pid>/cgroup, one per hierarchy.
+   */
+  StatusOr<std::vector<std::string>> GetPIDCGroupPaths(int32_t pid) const;
+
   /**
    * Parses /proc/<pid>/io files.
    * @param pid is the pid for which to read IO data.
@@ -248,6 +248,14 @@ TEST_F(ProcParserTest, read_pid_cmdline) {
               parser_->GetPIDCmdline(123));
 }
 
+TEST_F(ProcParserTest, read_pid_cgroup_paths) {
+  constexpr char kPodPath[] =
+      "/kubepods/burstable/pod8dbc5577-d0e2-4706-8787-57d52c03ddf2/"
+      "14011c7d92a9e513dfd69211da0413dbf319a5e45a02b354ba6e98e10272542d";
+  ASSERT_OK_AND_THAT(parser_->GetPIDCGroupPaths(123), ElementsAre(kPodPath, kPodPath, "/"));
+  EXPECT_NOT_OK(parser_->GetPIDCGroupPaths(999));
+}
+
 TEST_F(ProcParserTest, read_pid_metadata_null) {
   EXPECT_THAT("/usr/lib/at-spi2-core/at-spi2-registryd --use-gnome-session",
               parser_->GetPIDCmdline(456));
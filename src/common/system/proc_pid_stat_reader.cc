@@ -0,0 +1,298 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/system/proc_pid_stat_reader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <absl/strings/match.h>
+#include <absl/strings/substitute.h>
+
+namespace px {
+namespace system {
+
+namespace {
+
+/*************************************************
+ * Field indices of the /proc/<pid>/stat file.
+ * Consistent with the constants in proc_parser.cc.
+ *************************************************/
+// The first field after the process name (the process state).
+constexpr int kStatFirstFieldAfterName = 2;
+constexpr int kStatMinorFaultsField = 9;
+constexpr int kStatMajorFaultsField = 11;
+constexpr int kStatUTimeField = 13;
+constexpr int kStatKTimeField = 14;
+constexpr int kStatNumThreadsField = 19;
+constexpr int kStatVSizeField = 22;
+constexpr int kStatRSSField = 23;
+
+// Parses a decimal integer at the start of buf, advancing buf past it.
+// Returns false if buf does not start with a number.
+template <typename TIntType>
+bool ConsumeInt(std::string_view* buf, TIntType* out) {
+  bool negative = false;
+  size_t i = 0;
+  if (i < buf->size() && (*buf)[i] == '-') {
+    negative = true;
+    ++i;
+  }
+  const size_t digits_start = i;
+  TIntType val = 0;
+  for (; i < buf->size() && (*buf)[i] >= '0' && (*buf)[i] <= '9'; ++i) {
+    val = val * 10 + ((*buf)[i] - '0');
+  }
+  if (i == digits_start) {
+    return false;
+  }
+  *out = negative ? -val : val;
+  buf->remove_prefix(i);
+  return true;
+}
+
+// Advances buf past the current field, and the separating space.
+void SkipField(std::string_view* buf) {
+  size_t pos = buf->find(' ');
+  buf->remove_prefix(pos == std::string_view::npos ? buf->size() : pos + 1);
+}
+
+}  // namespace
+
+ProcPIDStatReader::ProcPIDStatReader(const system::Config& cfg, size_t max_open_pids)
+    : ProcPIDStatReader(cfg.proc_path().string(), cfg.PageSizeBytes(), cfg.KernelTickTimeNS(),
+                        max_open_pids) {}
+
+ProcPIDStatReader::ProcPIDStatReader(std::string proc_path, int64_t page_size_bytes,
+                                     int64_t kernel_tick_time_ns, size_t max_open_pids)
+    : proc_path_(std::move(proc_path)),
+      page_size_bytes_(page_size_bytes),
+      kernel_tick_time_ns_(kernel_tick_time_ns),
+      max_open_pids_(max_open_pids) {}
+
+ProcPIDStatReader::~ProcPIDStatReader() {
+  for (auto& [pid, files] : pid_files_) {
+    CloseFiles(&files);
+  }
+}
+
+void ProcPIDStatReader::CloseFiles(PIDFiles* files) {
+  if (files->stat_fd >= 0) {
+    close(files->stat_fd);
+    files->stat_fd = -1;
+  }
+  if (files->io_fd >= 0) {
+    close(files->io_fd);
+    files->io_fd = -1;
+  }
+}
+
+int ProcPIDStatReader::OpenFile(int32_t pid, FileType type) const {
+  // Avoid absl::Substitute here, since it allocates; this is only called on a cache miss.
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%d/%s", proc_path_.c_str(), pid,
+           type == FileType::kStat ? "stat" : "io");
+  return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+StatusOr<std::string_view> ProcPIDStatReader::ReadFile(int32_t pid, FileType type) {
+  auto iter = pid_files_.find(pid);
+  if (iter == pid_files_.end() && pid_files_.size() < max_open_pids_) {
+    iter = pid_files_.try_emplace(pid).first;
+  }
+
+  // Without a cache slot, fall back to a one-shot open/read/close.
+  if (iter == pid_files_.end()) {
+    int fd = OpenFile(pid, type);
+    if (fd < 0) {
+      return error::Internal("Failed to open /proc/$0 file: $1", pid, std::strerror(errno));
+    }
+    ssize_t n = pread(fd, buf_.data(), buf_.size(), 0);
+    close(fd);
+    if (n <= 0) {
+      return error::Internal("Failed to read /proc/$0 file", pid);
+    }
+    return std::string_view(buf_.data(), n);
+  }
+
+  PIDFiles& files = iter->second;
+  files.used = true;
+  int& fd = type == FileType::kStat ? files.stat_fd : files.io_fd;
+
+  // A cached fd is stale if the process has exited; reads of it then fail (or are empty).
+  // In that case, re-open once, in case the PID has been reused by a new process.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    const bool cached = fd >= 0;
+    if (!cached) {
+      fd = OpenFile(pid, type);
+      if (fd < 0) {
+        return error::Internal("Failed to open /proc/$0 file: $1", pid, std::strerror(errno));
+      }
+    }
+
+    ssize_t n = pread(fd, buf_.data(), buf_.size(), 0);
+    if (n > 0) {
+      return std::string_view(buf_.data(), n);
+    }
+
+    close(fd);
+    fd = -1;
+    if (!cached) {
+      break;
+    }
+  }
+  return error::Internal("Failed to read /proc/$0 file", pid);
+}
+
+Status ProcPIDStatReader::ReadStat(int32_t pid, ProcParser::ProcessStats* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view buf, ReadFile(pid, FileType::kStat));
+  PL_RETURN_IF_ERROR(ParseStat(buf, page_size_bytes_, kernel_tick_time_ns_, out));
+  return Status::OK();
+}
+
+Status ProcPIDStatReader::ReadIO(int32_t pid, ProcParser::ProcessStats* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view buf, ReadFile(pid, FileType::kIO));
+  PL_RETURN_IF_ERROR(ParseIO(buf, out));
+  return Status::OK();
+}
+
+void ProcPIDStatReader::CloseUnused() {
+  for (auto iter = pid_files_.begin(); iter != pid_files_.end();) {
+    PIDFiles& files = iter->second;
+    if (!files.used) {
+      CloseFiles(&files);
+      pid_files_.erase(iter++);
+      continue;
+    }
+    files.used = false;
+    ++iter;
+  }
+}
+
+Status ProcPIDStatReader::ParseStat(std::string_view buf, int64_t page_size_bytes,
+                                    int64_t kernel_tick_time_ns, ProcParser::ProcessStats* out) {
+  // See ProcParser::ParseProcPIDStat() for a sample file.
+  // The process name is surrounded by (), and may itself contain spaces and parentheses,
+  // so the fields after it are located from the last ')'.
+  if (!ConsumeInt(&buf, &out->pid)) {
+    return error::Internal("Failed to parse pid in stat file.");
+  }
+  const size_t name_begin = buf.find('(');
+  const size_t name_end = buf.rfind(')');
+  if (name_begin == std::string_view::npos || name_end == std::string_view::npos ||
+      name_end <= name_begin + 1) {
+    return error::Internal("Failed to parse process name in stat file.");
+  }
+  out->process_name.assign(buf.data() + name_begin + 1, name_end - name_begin - 1);
+
+  // Skip the ") ".
+  buf.remove_prefix(std::min(name_end + 2, buf.size()));
+
+  bool ok = true;
+  int field = kStatFirstFieldAfterName;
+  for (; field <= kStatRSSField && !buf.empty(); ++field) {
+    switch (field) {
+      case kStatMinorFaultsField:
+        ok &= ConsumeInt(&buf, &out->minor_faults);
+        break;
+      case kStatMajorFaultsField:
+        ok &= ConsumeInt(&buf, &out->major_faults);
+        break;
+      case kStatUTimeField:
+        ok &= ConsumeInt(&buf, &out->utime_ns);
+        break;
+      case kStatKTimeField:
+        ok &= ConsumeInt(&buf, &out->ktime_ns);
+        break;
+      case kStatNumThreadsField:
+        ok &= ConsumeInt(&buf, &out->num_threads);
+        break;
+      case kStatVSizeField:
+        ok &= ConsumeInt(&buf, &out->vsize_bytes);
+        break;
+      case kStatRSSField:
+        ok &= ConsumeInt(&buf, &out->rss_bytes);
+        break;
+      default:
+        break;
+    }
+    SkipField(&buf);
+  }
+
+  if (field <= kStatRSSField) {
+    return error::Unknown("Incorrect number of fields in stat file.");
+  }
+  if (!ok) {
+    // This should never happen since it requires the file to be ill-formed by the kernel.
+    return error::Internal("Failed to parse stat file. ATOI failed.");
+  }
+
+  // The kernel tracks utime and ktime in kernel ticks.
+  out->utime_ns *= kernel_tick_time_ns;
+  out->ktime_ns *= kernel_tick_time_ns;
+
+  // RSS is in pages.
+  out->rss_bytes *= page_size_bytes;
+
+  return Status::OK();
+}
+
+Status ProcPIDStatReader::ParseIO(std::string_view buf, ProcParser::ProcessStats* out) {
+  // See ProcParser::ParseProcPIDStatIO() for a sample file.
+  static constexpr std::pair<std::string_view, int64_t ProcParser::ProcessStats::*> kFields[] = {
+      {"rchar: ", &ProcParser::ProcessStats::rchar_bytes},
+      {"wchar: ", &ProcParser::ProcessStats::wchar_bytes},
+      {"read_bytes: ", &ProcParser::ProcessStats::read_bytes},
+      {"write_bytes: ", &ProcParser::ProcessStats::write_bytes},
+  };
+
+  size_t num_parsed = 0;
+  while (!buf.empty()) {
+    const size_t eol = buf.find('\n');
+    std::string_view line = buf.substr(0, eol);
+    buf.remove_prefix(eol == std::string_view::npos ? buf.size() : eol + 1);
+
+    for (const auto& [prefix, member] : kFields) {
+      if (absl::StartsWith(line, prefix)) {
+        line.remove_prefix(prefix.size());
+        if (!ConsumeInt(&line, &(out->*member))) {
+          return error::Internal("Failed to parse io file. ATOI failed.");
+        }
+        ++num_parsed;
+        break;
+      }
+    }
+  }
+
+  if (num_parsed != std::size(kFields)) {
+    return error::Internal("Failed to parse io file. Missing fields.");
+  }
+  return Status::OK();
+}
+
+}  // namespace system
+}  // namespace px
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+#include "src/common/system/config.h"
+#include "src/common/system/proc_parser.h"
+
+namespace px {
+namespace system {
+
+/**
+ * ProcPIDStatReader reads /proc/<pid>/stat and /proc/<pid>/io for a set of processes,
+ * repeatedly. It produces the same results as ProcParser::ParseProcPIDStat() and
+ * ProcParser::ParseProcPIDStatIO(), but is meant for periodic collection across all PIDs:
+ *  - File descriptors are kept open across calls, and the files are re-read with pread().
+ *  - The files are parsed in place, without allocating.
+ *
+ * File descriptors are closed when reads fail (e.g. the process has exited), and by
+ * CloseUnused(), which should be called once per collection iteration.
+ */
+class ProcPIDStatReader {
+ public:
+  /**
+   * @param cfg The system config, which provides the proc path and kernel constants.
+   * @param max_open_pids The maximum number of PIDs for which file descriptors are kept open.
+   *                      Beyond this, files are opened and closed on every read.
+   */
+  explicit ProcPIDStatReader(const system::Config& cfg, size_t max_open_pids = kMaxOpenPIDs);
+  ProcPIDStatReader(std::string proc_path, int64_t page_size_bytes, int64_t kernel_tick_time_ns,
+                    size_t max_open_pids = kMaxOpenPIDs);
+  ~ProcPIDStatReader();
+
+  ProcPIDStatReader(const ProcPIDStatReader&) = delete;
+  ProcPIDStatReader& operator=(const ProcPIDStatReader&) = delete;
+
+  /**
+   * Reads /proc/<pid>/stat into out.
+   * Populates the same fields as ProcParser::ParseProcPIDStat().
+   */
+  Status ReadStat(int32_t pid, ProcParser::ProcessStats* out);
+
+  /**
+   * Reads /proc/<pid>/io into out.
+   * Populates the same fields as ProcParser::ParseProcPIDStatIO().
+   */
+  Status ReadIO(int32_t pid, ProcParser::ProcessStats* out);
+
+  /**
+   * Closes the file descriptors of PIDs that were not read since the previous call.
+   */
+  void CloseUnused();
+
+  /**
+   * Number of PIDs with open file descriptors.
+   */
+  size_t num_open_pids() const { return pid_files_.size(); }
+
+  // Default for max_open_pids. Two file descriptors are kept per PID.
+  static constexpr size_t kMaxOpenPIDs = 4096;
+
+  /**
+   * Parses the contents of a /proc/<pid>/stat file. Exposed for testing.
+   */
+  static Status ParseStat(std::string_view buf, int64_t page_size_bytes,
+                          int64_t kernel_tick_time_ns, ProcParser::ProcessStats* out);
+
+  /**
+   * Parses the contents of a /proc/<pid>/io file. Exposed for testing.
+   */
+  static Status ParseIO(std::string_view buf, ProcParser::ProcessStats* out);
+
+ private:
+  enum class FileType { kStat, kIO };
+
+  struct PIDFiles {
+    int stat_fd = -1;
+    int io_fd = -1;
+    bool used = false;
+  };
+
+  // Reads the requested file of the pid into buf_, reusing a cached fd when possible.
+  StatusOr<std::string_view> ReadFile(int32_t pid, FileType type);
+
+  int OpenFile(int32_t pid, FileType type) const;
+
+  static void CloseFiles(PIDFiles* files);
+
+  const std::string proc_path_;
+  const int64_t page_size_bytes_;
+  const int64_t kernel_tick_time_ns_;
+  const size_t max_open_pids_;
+
+  absl::flat_hash_map<int32_t, PIDFiles> pid_files_;
+
+  // /proc/<pid>/stat is ~300 bytes, and /proc/<pid>/io ~100 bytes.
+  std::array<char, 4096> buf_;
+};
+
+}  // namespace system
+}  // namespace px
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <vector>
+
+#include <absl/strings/numbers.h>
+
+#include "src/common/system/config.h"
+#include "src/common/system/proc_parser.h"
+#include "src/common/system/proc_pid_stat_reader.h"
+
+namespace px {
+namespace system {
+
+namespace {
+
+std::vector<int32_t> ListPIDs(const std::filesystem::path& proc_path) {
+  std::vector<int32_t> pids;
+  for (const auto& entry : std::filesystem::directory_iterator(proc_path)) {
+    int32_t pid;
+    if (absl::SimpleAtoi(entry.path().filename().string(), &pid)) {
+      pids.push_back(pid);
+    }
+  }
+  return pids;
+}
+
+}  // namespace
+
+// Reads the stat and io files of every process on the host, once per iteration,
+// which mirrors one tick of the process_stats connector.
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ProcParserAllPIDs(benchmark::State& state) {
+  const Config& cfg = Config::GetInstance();
+  const std::vector<int32_t> pids = ListPIDs(cfg.proc_path());
+  ProcParser parser(cfg);
+  for (auto _ : state) {
+    for (int32_t pid : pids) {
+      ProcParser::ProcessStats stats;
+      benchmark::DoNotOptimize(
+          parser.ParseProcPIDStat(pid, cfg.PageSizeBytes(), cfg.KernelTickTimeNS(), &stats));
+      benchmark::DoNotOptimize(parser.ParseProcPIDStatIO(pid, &stats));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ProcPIDStatReaderAllPIDs(benchmark::State& state) {
+  const Config& cfg = Config::GetInstance();
+  const std::vector<int32_t> pids = ListPIDs(cfg.proc_path());
+  ProcPIDStatReader reader(cfg);
+  for (auto _ : state) {
+    for (int32_t pid : pids) {
+      ProcParser::ProcessStats stats;
+      benchmark::DoNotOptimize(reader.ReadStat(pid, &stats));
+      benchmark::DoNotOptimize(reader.ReadIO(pid, &stats));
+    }
+    reader.CloseUnused();
+  }
+  state.SetItemsProcessed(state.iterations() * pids.size());
+}
+
+BENCHMARK(BM_ProcParserAllPIDs);
+BENCHMARK(BM_ProcPIDStatReaderAllPIDs);
+
+}  // namespace system
+}  // namespace px
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/system/proc_pid_stat_reader.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include "src/common/testing/test_environment.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace system {
+
+constexpr char kTestDataBasePath[] = "src/common/system";
+
+namespace {
+std::string GetPathToTestDataFile(std::string_view fname) {
+  return testing::TestFilePath(std::filesystem::path(kTestDataBasePath) / fname);
+}
+}  // namespace
+
+class ProcPIDStatReaderTest : public ::testing::Test {
+ protected:
+  static constexpr int kBytesPerPage = 4096;
+  static constexpr int kKernelTickTimeNS = 100;
+
+  ProcPIDStatReaderTest()
+      : reader_(GetPathToTestDataFile("testdata/proc"), kBytesPerPage, kKernelTickTimeNS),
+        parser_(GetPathToTestDataFile("testdata/proc")) {}
+
+  ProcPIDStatReader reader_;
+  ProcParser parser_;
+};
+
+TEST_F(ProcPIDStatReaderTest, ReadStat) {
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(reader_.ReadStat(123, &stats));
+
+  // The expected values are from the test file.
+  EXPECT_EQ(4602, stats.pid);
+  EXPECT_EQ("ibazel", stats.process_name);
+
+  EXPECT_EQ(800, stats.utime_ns);
+  EXPECT_EQ(2300, stats.ktime_ns);
+  EXPECT_EQ(13, stats.num_threads);
+
+  EXPECT_EQ(55, stats.major_faults);
+  EXPECT_EQ(1799, stats.minor_faults);
+
+  EXPECT_EQ(114384896, stats.vsize_bytes);
+  EXPECT_EQ(2577 * kBytesPerPage, stats.rss_bytes);
+}
+
+TEST_F(ProcPIDStatReaderTest, ReadIO) {
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(reader_.ReadIO(123, &stats));
+
+  // The expected values are from the test file.
+  EXPECT_EQ(5405203, stats.rchar_bytes);
+  EXPECT_EQ(1239158, stats.wchar_bytes);
+  EXPECT_EQ(17838080, stats.read_bytes);
+  EXPECT_EQ(634880, stats.write_bytes);
+}
+
+TEST_F(ProcPIDStatReaderTest, MatchesProcParser) {
+  for (int32_t pid : {1, 123, 456, 789}) {
+    ProcParser::ProcessStats expected;
+    ProcParser::ProcessStats actual;
+    ASSERT_OK(parser_.ParseProcPIDStat(pid, kBytesPerPage, kKernelTickTimeNS, &expected));
+    ASSERT_OK(reader_.ReadStat(pid, &actual));
+
+    EXPECT_EQ(actual.pid, expected.pid);
+    EXPECT_EQ(actual.process_name, expected.process_name);
+    EXPECT_EQ(actual.minor_faults, expected.minor_faults);
+    EXPECT_EQ(actual.major_faults, expected.major_faults);
+    EXPECT_EQ(actual.utime_ns, expected.utime_ns);
+    EXPECT_EQ(actual.ktime_ns, expected.ktime_ns);
+    EXPECT_EQ(actual.num_threads, expected.num_threads);
+    EXPECT_EQ(actual.vsize_bytes, expected.vsize_bytes);
+    EXPECT_EQ(actual.rss_bytes, expected.rss_bytes);
+  }
+}
+
+TEST_F(ProcPIDStatReaderTest, ProcessNameWithSpacesAndParens) {
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(ProcPIDStatReader::ParseStat(
+      "42 (my (weird) app) S 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24",
+      /*page_size_bytes*/ 1, /*kernel_tick_time_ns*/ 1, &stats));
+  EXPECT_EQ(42, stats.pid);
+  EXPECT_EQ("my (weird) app", stats.process_name);
+  EXPECT_EQ(7, stats.minor_faults);
+  EXPECT_EQ(9, stats.major_faults);
+  EXPECT_EQ(11, stats.utime_ns);
+  EXPECT_EQ(12, stats.ktime_ns);
+  EXPECT_EQ(17, stats.num_threads);
+  EXPECT_EQ(20, stats.vsize_bytes);
+  EXPECT_EQ(21, stats.rss_bytes);
+}
+
+TEST_F(ProcPIDStatReaderTest, TruncatedStat) {
+  ProcParser::ProcessStats stats;
+  EXPECT_NOT_OK(ProcPIDStatReader::ParseStat("42 (app) S 1 2 3", 1, 1, &stats));
+}
+
+TEST_F(ProcPIDStatReaderTest, CachesFileDescriptors) {
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(reader_.ReadStat(123, &stats));
+  ASSERT_OK(reader_.ReadIO(123, &stats));
+  ASSERT_OK(reader_.ReadStat(456, &stats));
+  EXPECT_EQ(reader_.num_open_pids(), 2);
+
+  // Both PIDs were read since the last call, so nothing is closed.
+  reader_.CloseUnused();
+  EXPECT_EQ(reader_.num_open_pids(), 2);
+
+  // Only 123 is read in this iteration.
+  ASSERT_OK(reader_.ReadStat(123, &stats));
+  reader_.CloseUnused();
+  EXPECT_EQ(reader_.num_open_pids(), 1);
+
+  reader_.CloseUnused();
+  EXPECT_EQ(reader_.num_open_pids(), 0);
+}
+
+TEST_F(ProcPIDStatReaderTest, MaxOpenPIDs) {
+  ProcPIDStatReader reader(GetPathToTestDataFile("testdata/proc"), kBytesPerPage,
+                           kKernelTickTimeNS, /*max_open_pids*/ 1);
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(reader.ReadStat(123, &stats));
+  ASSERT_OK(reader.ReadStat(456, &stats));
+  EXPECT_EQ(reader.num_open_pids(), 1);
+  EXPECT_EQ(stats.pid, 456);
+}
+
+TEST_F(ProcPIDStatReaderTest, MissingPID) {
+  ProcParser::ProcessStats stats;
+  EXPECT_NOT_OK(reader_.ReadStat(999, &stats));
+}
+
+TEST(ProcPIDStatReaderLiveTest, ReadSelf) {
+  ProcPIDStatReader reader("/proc", sysconf(_SC_PAGESIZE), 1);
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(reader.ReadStat(getpid(), &stats));
+  EXPECT_EQ(stats.pid, getpid());
+  EXPECT_GT(stats.num_threads, 0);
+  EXPECT_GT(stats.rss_bytes, 0);
+
+  // A second read goes through the cached file descriptor.
+  ASSERT_OK(reader.ReadStat(getpid(), &stats));
+  EXPECT_EQ(stats.pid, getpid());
+}
+
+}  // namespace system
+}  // namespace px
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace px {
+namespace md {
+
+/**
+ * CowHashMap is a hash map whose copies share storage until they are modified.
+ *
+ * Entries are spread across a fixed number of shards, each an absl::flat_hash_map held by a
+ * shared_ptr. Copying the map only copies the shard pointers, and the first write to a shard
+ * that is shared with another copy clones that one shard. Snapshotting a map is therefore
+ * O(kNumShards) and applying updates to the snapshot only copies the shards that change.
+ *
+ * Different copies can be used from different threads, but as with the standard containers a
+ * single instance must not be modified while it is being read.
+ */
+template <typename K, typename V, typename Hash = typename absl::flat_hash_map<K, V>::hasher,
+          typename Eq = typename absl::flat_hash_map<K, V>::key_equal>
+class CowHashMap {
+ public:
+  using Shard = absl::flat_hash_map<K, V, Hash, Eq>;
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = typename Shard::value_type;
+  using size_type = size_t;
+
+  static constexpr size_t kNumShardBits = 6;
+  static constexpr size_t kNumShards = 1 << kNumShardBits;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Shard::value_type;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    reference operator*() const { return *iter_; }
+    pointer operator->() const { return &*iter_; }
+
+    const_iterator& operator++() {
+      ++iter_;
+      SkipEmptyShards();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      if (shard_idx_ != other.shard_idx_) {
+        return false;
+      }
+      // All end iterators are equal, whichever shard they came from.
+      return shard_idx_ == kNumShards || iter_ == other.iter_;
+    }
+    bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class CowHashMap;
+
+    const_iterator(const CowHashMap* map, size_t shard_idx, typename Shard::const_iterator iter)
+        : map_(map), shard_idx_(shard_idx), iter_(iter) {}
+
+    // Moves to the first entry at or after the current position, or to end().
+    void SkipEmptyShards() {
+      while (shard_idx_ < kNumShards && iter_ == map_->shards_[shard_idx_]->end()) {
+        shard_idx_ = map_->NextShard(shard_idx_ + 1);
+        if (shard_idx_ < kNumShards) {
+          iter_ = map_->shards_[shard_idx_]->begin();
+        }
+      }
+    }
+
+    const CowHashMap* map_ = nullptr;
+    size_t shard_idx_ = kNumShards;
+    typename Shard::const_iterator iter_;
+  };
+  using iterator = const_iterator;
+
+  const_iterator begin() const {
+    size_t idx = NextShard(0);
+    if (idx == kNumShards) {
+      return end();
+    }
+    const_iterator it(this, idx, shards_[idx]->begin());
+    it.SkipEmptyShards();
+    return it;
+  }
+
+  const_iterator end() const { return const_iterator(this, kNumShards, {}); }
+
+  size_t size() const {
+    size_t size = 0;
+    for (const auto& shard : shards_) {
+      if (shard != nullptr) {
+        size += shard->size();
+      }
+    }
+    return size;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  template <typename Q>
+  const_iterator find(const Q& key) const {
+    size_t idx = ShardIndex(key);
+    const auto& shard = shards_[idx];
+    if (shard == nullptr) {
+      return end();
+    }
+    auto it = shard->find(key);
+    if (it == shard->end()) {
+      return end();
+    }
+    return const_iterator(this, idx, it);
+  }
+
+  template <typename Q>
+  bool contains(const Q& key) const {
+    return find(key) != end();
+  }
+
+  /**
+   * Returns a mutable pointer to the value for key, or nullptr if there isn't one. The shard
+   * holding the key is unshared first, so the pointer is only valid until the next write.
+   */
+  template <typename Q>
+  V* find_mutable(const Q& key) {
+    size_t idx = ShardIndex(key);
+    if (shards_[idx] == nullptr || !shards_[idx]->contains(key)) {
+      return nullptr;
+    }
+    return &MutableShard(idx)->find(key)->second;
+  }
+
+  V& operator[](const K& key) { return (*MutableShard(ShardIndex(key)))[key]; }
+
+  template <typename... Args>
+  std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+    auto [it, inserted] =
+        MutableShard(ShardIndex(key))->try_emplace(key, std::forward<Args>(args)...);
+    return {&it->second, inserted};
+  }
+
+  template <typename Q>
+  size_t erase(const Q& key) {
+    size_t idx = ShardIndex(key);
+    if (shards_[idx] == nullptr || !shards_[idx]->contains(key)) {
+      return 0;
+    }
+    return MutableShard(idx)->erase(key);
+  }
+
+  void clear() {
+    for (auto& shard : shards_) {
+      shard.reset();
+    }
+  }
+
+ private:
+  template <typename Q>
+  static size_t ShardIndex(const Q& key) {
+    // Use the high bits of the hash, since the shard maps use the low bits to place entries.
+    return Hash{}(key) >> (std::numeric_limits<size_t>::digits - kNumShardBits);
+  }
+
+  // Returns the index of the first allocated shard at or after idx, or kNumShards.
+  size_t NextShard(size_t idx) const {
+    while (idx < kNumShards && shards_[idx] == nullptr) {
+      ++idx;
+    }
+    return idx;
+  }
+
+  // Returns the shard at idx for writing, cloning it if it is shared with another copy.
+  // A use_count of one cannot race with another copy being taken, since that copy would need a
+  // reference of its own.
+  Shard* MutableShard(size_t idx) {
+    auto& shard = shards_[idx];
+    if (shard == nullptr) {
+      shard = std::make_shared<Shard>();
+    } else if (shard.use_count() > 1) {
+      shard = std::make_shared<Shard>(*shard);
+    }
+    return shard.get();
+  }
+
+  std::array<std::shared_ptr<Shard>, kNumShards> shards_;
+};
+
+}  // namespace md
+}  // namespace px
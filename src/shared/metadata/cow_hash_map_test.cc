@@ -0,0 +1,102 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include "src/shared/metadata/cow_hash_map.h"
+
+namespace px {
+namespace md {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(CowHashMapTest, basic) {
+  CowHashMap<std::string, int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+
+  map["a"] = 1;
+  EXPECT_TRUE(map.try_emplace("b", 2).second);
+  EXPECT_FALSE(map.try_emplace("b", 3).second);
+
+  EXPECT_EQ(2, map.size());
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("a", 1), Pair("b", 2)));
+
+  auto it = map.find(std::string_view("b"));
+  ASSERT_NE(it, map.end());
+  EXPECT_EQ(2, it->second);
+  EXPECT_EQ(map.end(), map.find("c"));
+  EXPECT_EQ(nullptr, map.find_mutable("c"));
+
+  *map.find_mutable("b") = 4;
+  EXPECT_EQ(1, map.erase("a"));
+  EXPECT_EQ(0, map.erase("a"));
+  EXPECT_THAT(map, UnorderedElementsAre(Pair("b", 4)));
+}
+
+TEST(CowHashMapTest, copies_are_independent) {
+  CowHashMap<int, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    map[i] = i;
+  }
+
+  CowHashMap<int, int> copy = map;
+  *copy.find_mutable(1) = -1;
+  copy.erase(2);
+  copy[1000] = 1000;
+
+  EXPECT_EQ(1000, map.size());
+  EXPECT_EQ(1, map.find(1)->second);
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_FALSE(map.contains(1000));
+
+  EXPECT_EQ(1000, copy.size());
+  EXPECT_EQ(-1, copy.find(1)->second);
+  EXPECT_FALSE(copy.contains(2));
+  EXPECT_TRUE(copy.contains(1000));
+
+  int count = 0;
+  for (const auto& [k, v] : copy) {
+    EXPECT_EQ(k == 1 ? -1 : k, v);
+    ++count;
+  }
+  EXPECT_EQ(1000, count);
+}
+
+TEST(CowHashMapTest, iterates_over_emptied_shards) {
+  CowHashMap<int, int> map;
+  for (int i = 0; i < 100; ++i) {
+    map[i] = i;
+  }
+  for (int i = 0; i < 99; ++i) {
+    map.erase(i);
+  }
+  EXPECT_THAT(map, UnorderedElementsAre(Pair(99, 99)));
+
+  map.erase(99);
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+}  // namespace md
+}  // namespace px
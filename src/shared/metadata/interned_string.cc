@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "src/shared/metadata/interned_string.h"
+
+namespace px {
+namespace md {
+
+StringInternTable::~StringInternTable() {
+  for (auto& block : blocks_) {
+    delete block.load(std::memory_order_relaxed);
+  }
+}
+
+uint32_t StringInternTable::Intern(std::string_view value) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = ids_.find(value);
+  if (it != ids_.end()) {
+    // This may revive an entry whose last reference was just dropped, which Unref() checks for.
+    EntryAt(it->second)->refs.fetch_add(1, std::memory_order_relaxed);
+    return it->second;
+  }
+
+  uint32_t id;
+  if (!free_ids_.empty()) {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  } else {
+    id = next_id_++;
+    size_t block_idx = id >> kBlockBits;
+    CHECK_LT(block_idx, kMaxBlocks) << "Too many interned strings";
+    if (blocks_[block_idx].load(std::memory_order_relaxed) == nullptr) {
+      blocks_[block_idx].store(new Block(), std::memory_order_release);
+    }
+  }
+
+  Entry* entry = EntryAt(id);
+  entry->value = std::string(value);
+  entry->refs.store(1, std::memory_order_relaxed);
+  entry->live = true;
+  ids_.emplace(entry->value, id);
+  return id;
+}
+
+uint32_t StringInternTable::Find(std::string_view value) const {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = ids_.find(value);
+  return (it == ids_.end()) ? kInvalidID : it->second;
+}
+
+void StringInternTable::Unref(uint32_t id) {
+  Entry* entry = EntryAt(id);
+  if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  // Between the decrement and taking the lock, the value may have been interned again, or freed
+  // by another thread that revived and released it. The acquire pairs with the release in the
+  // decrement of any thread that revived and then dropped it, whose reads must finish first.
+  if (!entry->live || entry->refs.load(std::memory_order_acquire) != 0) {
+    return;
+  }
+  ids_.erase(std::string_view(entry->value));
+  entry->live = false;
+  entry->value.clear();
+  entry->value.shrink_to_fit();
+  free_ids_.push_back(id);
+}
+
+}  // namespace md
+}  // namespace px
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <absl/hash/hash.h>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace md {
+
+/**
+ * StringInternTable maps strings such as K8s UIDs and container IDs to dense 32-bit IDs, so that
+ * each distinct string is stored once no matter how many metadata maps refer to it.
+ *
+ * Entries are reference counted by InternedString handles and their IDs are reused once the last
+ * handle goes away. Values can be read without locking while a reference is held; only interning,
+ * finding and releasing take the table lock.
+ */
+class StringInternTable : NotCopyMoveable {
+ public:
+  static constexpr uint32_t kInvalidID = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * Returns the pointer to the process wide table.
+   */
+  static StringInternTable* GetSingleton() {
+    // Intentionally leaked, so handles in other static objects can outlive it.
+    static StringInternTable* singleton = new StringInternTable();
+    return singleton;
+  }
+
+  StringInternTable() = default;
+  ~StringInternTable();
+
+  /**
+   * Returns the ID of the value, adding it to the table if needed. The caller owns one reference
+   * to the ID and must release it with Unref().
+   */
+  uint32_t Intern(std::string_view value);
+
+  void Ref(uint32_t id) { EntryAt(id)->refs.fetch_add(1, std::memory_order_relaxed); }
+  void Unref(uint32_t id);
+
+  /**
+   * Returns the ID of the value without adding it, or kInvalidID if it isn't in the table. The
+   * caller gets no reference, so the ID is only meaningful while something else holds one, e.g.
+   * when looking up a map of InternedString keys that the caller is reading.
+   */
+  uint32_t Find(std::string_view value) const;
+
+  /**
+   * Returns the value for an ID that the caller holds a reference to.
+   */
+  const std::string& Value(uint32_t id) const { return EntryAt(id)->value; }
+
+  /**
+   * The number of distinct values currently in the table.
+   */
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    return ids_.size();
+  }
+
+ private:
+  static constexpr size_t kBlockBits = 10;
+  static constexpr size_t kBlockSize = 1 << kBlockBits;
+  static constexpr size_t kMaxBlocks = 1 << 14;
+
+  struct Entry {
+    std::string value;
+    std::atomic<int32_t> refs{0};
+    // Whether the entry holds a value, as opposed to sitting on the free list.
+    bool live = false;
+  };
+  using Block = std::array<Entry, kBlockSize>;
+
+  // Entries never move once their block is allocated, so they can be read without the lock.
+  Entry* EntryAt(uint32_t id) const {
+    DCHECK_NE(id, kInvalidID);
+    return &(*blocks_[id >> kBlockBits].load(std::memory_order_acquire))[id & (kBlockSize - 1)];
+  }
+
+  mutable std::mutex lock_;
+  // Keys point into the entries' values.
+  absl::flat_hash_map<std::string_view, uint32_t> ids_;
+  std::vector<uint32_t> free_ids_;
+  uint32_t next_id_ = 0;
+  std::array<std::atomic<Block*>, kMaxBlocks> blocks_ = {};
+};
+
+/**
+ * InternedString is a reference counted handle to a string in the global StringInternTable.
+ * Handles to equal strings hold the same ID, so comparing and hashing them only touches the ID.
+ */
+class InternedString {
+ public:
+  InternedString() = default;
+  explicit InternedString(std::string_view value)
+      : id_(value.empty() ? StringInternTable::kInvalidID
+                          : StringInternTable::GetSingleton()->Intern(value)) {}
+
+  InternedString(const InternedString& other) : id_(other.id_) {
+    if (id_ != StringInternTable::kInvalidID) {
+      StringInternTable::GetSingleton()->Ref(id_);
+    }
+  }
+  InternedString(InternedString&& other) noexcept
+      : id_(std::exchange(other.id_, StringInternTable::kInvalidID)) {}
+
+  InternedString& operator=(InternedString other) noexcept {
+    std::swap(id_, other.id_);
+    return *this;
+  }
+
+  ~InternedString() {
+    if (id_ != StringInternTable::kInvalidID) {
+      StringInternTable::GetSingleton()->Unref(id_);
+    }
+  }
+
+  // The ID of the string, or kInvalidID for the empty string.
+  uint32_t id() const { return id_; }
+
+  /**
+   * Returns the ID of the value if it is interned, or kInvalidID otherwise. See
+   * StringInternTable::Find().
+   */
+  static uint32_t Find(std::string_view value) {
+    return value.empty() ? StringInternTable::kInvalidID
+                         : StringInternTable::GetSingleton()->Find(value);
+  }
+
+  // The value stays valid for as long as this handle (or any other to the same ID) is alive.
+  const std::string& str() const {
+    static const std::string kEmpty;
+    return id_ == StringInternTable::kInvalidID ? kEmpty
+                                                : StringInternTable::GetSingleton()->Value(id_);
+  }
+  std::string_view view() const { return str(); }
+  bool empty() const { return id_ == StringInternTable::kInvalidID; }
+
+  bool operator==(const InternedString& other) const { return id_ == other.id_; }
+  bool operator!=(const InternedString& other) const { return id_ != other.id_; }
+  friend bool operator==(const InternedString& a, std::string_view b) { return a.view() == b; }
+  friend bool operator!=(const InternedString& a, std::string_view b) { return a.view() != b; }
+
+  friend std::ostream& operator<<(std::ostream& os, const InternedString& s) {
+    return os << s.view();
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const InternedString& s) {
+    return H::combine(std::move(h), s.id_);
+  }
+
+  /**
+   * Hash and Eq allow maps keyed by InternedString to be looked up by a bare ID, as returned by
+   * Find(), without taking a reference.
+   */
+  struct Hash {
+    using is_transparent = void;
+
+    size_t operator()(uint32_t id) const { return absl::Hash<uint32_t>{}(id); }
+    size_t operator()(const InternedString& s) const { return (*this)(s.id()); }
+  };
+
+  struct Eq {
+    using is_transparent = void;
+
+    template <typename T1, typename T2>
+    bool operator()(const T1& a, const T2& b) const {
+      return ID(a) == ID(b);
+    }
+
+   private:
+    static uint32_t ID(uint32_t id) { return id; }
+    static uint32_t ID(const InternedString& s) { return s.id(); }
+  };
+
+ private:
+  uint32_t id_ = StringInternTable::kInvalidID;
+};
+
+using InternedStringSet =
+    absl::flat_hash_set<InternedString, InternedString::Hash, InternedString::Eq>;
+
+}  // namespace md
+}  // namespace px
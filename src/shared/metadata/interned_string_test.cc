@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_cat.h>
+
+#include "src/shared/metadata/interned_string.h"
+
+namespace px {
+namespace md {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(InternedStringTest, equal_strings_share_an_id) {
+  InternedString a("0123-pod-uid");
+  InternedString b(std::string("0123-pod-uid"));
+  InternedString c("4567-pod-uid");
+
+  EXPECT_EQ(a.id(), b.id());
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ("0123-pod-uid", a.view());
+  EXPECT_EQ("4567-pod-uid", c.str());
+  EXPECT_TRUE(a == "0123-pod-uid");
+
+  InternedString empty("");
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(InternedString(), empty);
+  EXPECT_EQ("", empty.view());
+}
+
+TEST(InternedStringTest, ids_are_released_with_the_last_handle) {
+  auto* table = StringInternTable::GetSingleton();
+  size_t initial_size = table->size();
+
+  uint32_t id;
+  {
+    InternedString a("released-uid");
+    InternedString copy = a;
+    InternedString moved = std::move(a);
+    id = copy.id();
+    EXPECT_EQ(initial_size + 1, table->size());
+  }
+  EXPECT_EQ(initial_size, table->size());
+
+  // The freed ID is reused for the next new string.
+  InternedString b("another-uid");
+  EXPECT_EQ(id, b.id());
+  EXPECT_EQ("another-uid", b.view());
+}
+
+TEST(InternedStringTest, find_does_not_intern) {
+  auto* table = StringInternTable::GetSingleton();
+  size_t initial_size = table->size();
+
+  EXPECT_EQ(StringInternTable::kInvalidID, InternedString::Find("unknown-uid"));
+  EXPECT_EQ(StringInternTable::kInvalidID, InternedString::Find(""));
+  EXPECT_EQ(initial_size, table->size());
+
+  InternedString a("known-uid");
+  EXPECT_EQ(a.id(), InternedString::Find("known-uid"));
+  EXPECT_EQ(initial_size + 1, table->size());
+}
+
+TEST(InternedStringTest, lookup_by_id) {
+  static_assert(sizeof(InternedString) == sizeof(uint32_t));
+
+  absl::flat_hash_map<InternedString, int, InternedString::Hash, InternedString::Eq> ids;
+  InternedString a("pod_id1");
+  ids[a] = 1;
+  ids[InternedString("pod_id2")] = 2;
+
+  auto it = ids.find(InternedString::Find("pod_id2"));
+  ASSERT_NE(ids.end(), it);
+  EXPECT_EQ(2, it->second);
+  EXPECT_EQ(1, ids.find(a.id())->second);
+  EXPECT_EQ(ids.end(), ids.find(InternedString::Find("pod_id3")));
+
+  InternedStringSet set;
+  set.emplace("container_id1");
+  EXPECT_THAT(set, UnorderedElementsAre("container_id1"));
+  set.erase(InternedString::Find("container_id1"));
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(InternedStringTest, map_values) {
+  absl::flat_hash_map<std::string, InternedString> pods_by_ip;
+  pods_by_ip["1.2.3.4"] = InternedString("pod_id1");
+  pods_by_ip["1.2.3.5"] = InternedString("pod_id1");
+  EXPECT_THAT(pods_by_ip,
+              UnorderedElementsAre(Pair("1.2.3.4", "pod_id1"), Pair("1.2.3.5", "pod_id1")));
+}
+
+TEST(InternedStringTest, concurrent_intern_and_release) {
+  auto* table = StringInternTable::GetSingleton();
+  size_t initial_size = table->size();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 10000; ++i) {
+        std::string value = absl::StrCat("uid-", i % 17);
+        InternedString s(value);
+        InternedString copy = s;
+        EXPECT_EQ(value, copy.view());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(initial_size, table->size());
+}
+
+}  // namespace md
+}  // namespace px
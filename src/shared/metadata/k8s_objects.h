@@ -28,6 +28,7 @@
 #include <absl/container/flat_hash_set.h>
 #include "src/common/base/base.h"
 #include "src/shared/k8s/metadatapb/metadata.pb.h"
+#include "src/shared/metadata/interned_string.h"
 #include "src/shared/upid/upid.h"
 
 namespace px {
@@ -49,7 +50,7 @@ class K8sMetadataObject {
   K8sMetadataObject(K8sObjectType type, UID uid, std::string_view ns, std::string_view name,
                     int64_t start_time_ns = 0, int64_t stop_time_ns = 0)
       : type_(type),
-        uid_(std::move(uid)),
+        uid_(uid),
         ns_(ns),
         name_(name),
         start_time_ns_(start_time_ns),
@@ -57,10 +58,13 @@ class K8sMetadataObject {
 
   K8sObjectType type() { return type_; }
 
-  const UID& uid() const { return uid_; }
+  const UID& uid() const { return uid_.str(); }
+  const InternedString& interned_uid() const { return uid_; }
 
-  const std::string& name() const { return name_; }
-  const std::string& ns() const { return ns_; }
+  const std::string& name() const { return name_.str(); }
+  const std::string& ns() const { return ns_.str(); }
+  const InternedString& interned_name() const { return name_; }
+  const InternedString& interned_ns() const { return ns_; }
 
   int64_t start_time_ns() const { return start_time_ns_; }
   void set_start_time_ns(int64_t start_time_ns) { start_time_ns_ = start_time_ns; }
@@ -84,18 +88,17 @@ class K8sMetadataObject {
   /**
    * The ID assigned by K8s that is unique in both space and time.
    */
-  const UID uid_ = 0;
+  const InternedString uid_;
 
   /**
    * The namespace for this object.
    */
-
-  std::string ns_;
+  InternedString ns_;
 
   /**
    * The name which is unique in space but not time.
    */
-  std::string name_;
+  InternedString name_;
 
   /**
    * Start time of this K8s object.
@@ -272,10 +275,12 @@ class PodInfo : public K8sMetadataObject {
   virtual ~PodInfo() = default;
 
   void AddContainer(CIDView cid) { containers_.emplace(cid); }
-  void RmContainer(CIDView cid) { containers_.erase(cid); }
+  void AddContainer(const InternedString& cid) { containers_.insert(cid); }
+  void RmContainer(CIDView cid) { containers_.erase(InternedString::Find(cid)); }
 
   void AddService(UIDView uid) { services_.emplace(uid); }
-  void RmService(UIDView uid) { services_.erase(uid); }
+  void AddService(const InternedString& uid) { services_.insert(uid); }
+  void RmService(UIDView uid) { services_.erase(InternedString::Find(uid)); }
   PodQOSClass qos_class() const { return qos_class_; }
   PodPhase phase() const { return phase_; }
   void set_phase(PodPhase phase) { phase_ = phase; }
@@ -296,8 +301,8 @@ class PodInfo : public K8sMetadataObject {
   const std::string& hostname() const { return hostname_; }
   const std::string& pod_ip() const { return pod_ip_; }
 
-  const absl::flat_hash_set<std::string>& containers() const { return containers_; }
-  const absl::flat_hash_set<std::string>& services() const { return services_; }
+  const InternedStringSet& containers() const { return containers_; }
+  const InternedStringSet& services() const { return services_; }
 
   std::unique_ptr<K8sMetadataObject> Clone() const override {
     return std::unique_ptr<PodInfo>(new PodInfo(*this));
@@ -322,14 +327,14 @@ class PodInfo : public K8sMetadataObject {
    *
    * The ContainerInformation is located in containers in the K8s state.
    */
-  absl::flat_hash_set<CID> containers_;
+  InternedStringSet containers_;
   /**
    * The set of services that associate with this pod. K8s allows
    * multiple services from exposing the same pod.
    *
    * Should point to ServiceInfo via the data structure containing this pod.
    */
-  absl::flat_hash_set<UID> services_;
+  InternedStringSet services_;
 
   std::string node_name_;
   std::string hostname_;
@@ -362,7 +367,7 @@ class ContainerInfo {
   ContainerInfo(CID cid, std::string_view name, ContainerState state, ContainerType type,
                 std::string_view state_message, std::string_view state_reason,
                 int64_t start_time_ns, int64_t stop_time_ns = 0)
-      : cid_(std::move(cid)),
+      : cid_(cid),
         name_(std::string(name)),
         state_(state),
         type_(type),
@@ -379,12 +384,15 @@ class ContainerInfo {
                       container_update_info.start_timestamp_ns(),
                       container_update_info.stop_timestamp_ns()) {}
 
-  const CID& cid() const { return cid_; }
+  const CID& cid() const { return cid_.str(); }
+  const InternedString& interned_cid() const { return cid_; }
   const std::string& name() const { return name_; }
   ContainerType type() const { return type_; }
 
-  void set_pod_id(std::string_view pod_id) { pod_id_ = pod_id; }
-  const UID& pod_id() const { return pod_id_; }
+  void set_pod_id(std::string_view pod_id) { pod_id_ = InternedString(pod_id); }
+  void set_pod_id(const InternedString& pod_id) { pod_id_ = pod_id; }
+  const UID& pod_id() const { return pod_id_.str(); }
+  const InternedString& interned_pod_id() const { return pod_id_; }
 
   const StartTimeOrderedUPIDSet& active_upids() const { return active_upids_; }
   StartTimeOrderedUPIDSet* mutable_active_upids() { return &active_upids_; }
@@ -414,9 +422,9 @@ class ContainerInfo {
   ContainerInfo& operator=(const ContainerInfo& other) = delete;
 
  private:
-  const CID cid_;
+  const InternedString cid_;
   const std::string name_;
-  UID pod_id_ = "";
+  InternedString pod_id_;
 
   /**
    * The set of UPIDs that are running on this container.
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <absl/container/flat_hash_set.h>
 
@@ -27,7 +28,34 @@
 namespace px {
 namespace md {
 
-const K8sMetadataObject* K8sMetadataState::K8sMetadataObjectByID(UIDView id,
+namespace {
+
+// Objects are shared between clones of the state, so they are copied before being modified unless
+// this state holds the only reference.
+template <typename T>
+T* CopyOnWrite(std::shared_ptr<T>* obj) {
+  if (obj->use_count() > 1) {
+    *obj = (*obj)->Clone();
+  }
+  return obj->get();
+}
+
+K8sMetadataState::K8sNameIdent NameIdent(const K8sMetadataObject& obj) {
+  return {obj.interned_ns(), obj.interned_name()};
+}
+
+// Removes the name of the object from the map, unless the name now belongs to a newer object.
+void EraseNameIfOwned(const K8sMetadataObject& obj, K8sMetadataState::K8sEntityByNameMap* map) {
+  auto name = NameIdent(obj);
+  auto it = map->find(name);
+  if (it != map->end() && it->second == obj.interned_uid()) {
+    map->erase(name);
+  }
+}
+
+}  // namespace
+
+const K8sMetadataObject* K8sMetadataState::K8sMetadataObjectByID(uint32_t id,
                                                                  K8sObjectType type) const {
   auto it = k8s_objects_by_id_.find(id);
 
@@ -44,21 +72,38 @@ const K8sMetadataObject* K8sMetadataState::K8sMetadataObjectByID(UIDView id,
 
 const PodInfo* K8sMetadataState::PodInfoByID(UIDView pod_id) const {
   auto type = K8sObjectType::kPod;
-  return static_cast<const PodInfo*>(K8sMetadataObjectByID(pod_id, type));
+  return static_cast<const PodInfo*>(K8sMetadataObjectByID(InternedString::Find(pod_id), type));
+}
+
+const PodInfo* K8sMetadataState::PodInfoByID(const InternedString& pod_id) const {
+  auto type = K8sObjectType::kPod;
+  return static_cast<const PodInfo*>(K8sMetadataObjectByID(pod_id.id(), type));
 }
 
 const ServiceInfo* K8sMetadataState::ServiceInfoByID(UIDView service_id) const {
   auto type = K8sObjectType::kService;
-  return static_cast<const ServiceInfo*>(K8sMetadataObjectByID(service_id, type));
+  return static_cast<const ServiceInfo*>(
+      K8sMetadataObjectByID(InternedString::Find(service_id), type));
+}
+
+const ServiceInfo* K8sMetadataState::ServiceInfoByID(const InternedString& service_id) const {
+  auto type = K8sObjectType::kService;
+  return static_cast<const ServiceInfo*>(K8sMetadataObjectByID(service_id.id(), type));
 }
 
 const NamespaceInfo* K8sMetadataState::NamespaceInfoByID(UIDView ns_id) const {
   auto type = K8sObjectType::kNamespace;
-  return static_cast<const NamespaceInfo*>(K8sMetadataObjectByID(ns_id, type));
+  return static_cast<const NamespaceInfo*>(
+      K8sMetadataObjectByID(InternedString::Find(ns_id), type));
+}
+
+const NamespaceInfo* K8sMetadataState::NamespaceInfoByID(const InternedString& ns_id) const {
+  auto type = K8sObjectType::kNamespace;
+  return static_cast<const NamespaceInfo*>(K8sMetadataObjectByID(ns_id.id(), type));
 }
 
 const ContainerInfo* K8sMetadataState::ContainerInfoByID(CIDView id) const {
-  auto it = containers_by_id_.find(id);
+  auto it = containers_by_id_.find(InternedString::Find(id));
 
   if (it == containers_by_id_.end()) {
     return nullptr;
@@ -67,34 +112,54 @@ const ContainerInfo* K8sMetadataState::ContainerInfoByID(CIDView id) const {
   return it->second.get();
 }
 
+const ContainerInfo* K8sMetadataState::ContainerInfoByID(const InternedString& id) const {
+  auto it = containers_by_id_.find(id.id());
+  return (it == containers_by_id_.end()) ? nullptr : it->second.get();
+}
+
+ContainerInfo* K8sMetadataState::MutableContainerInfoByID(CIDView id) {
+  auto* container = containers_by_id_.find_mutable(InternedString::Find(id));
+  return (container == nullptr) ? nullptr : CopyOnWrite(container);
+}
+
+K8sMetadataObject* K8sMetadataState::MutableK8sMetadataObjectByID(UIDView id) {
+  auto* k8s_object = k8s_objects_by_id_.find_mutable(InternedString::Find(id));
+  return (k8s_object == nullptr) ? nullptr : CopyOnWrite(k8s_object);
+}
+
+const InternedString& K8sMetadataState::EntityIDByName(const K8sEntityByNameMap& map,
+                                                       K8sNameIdentView name) {
+  static const InternedString kNotFound;
+  auto it = map.find(K8sNameIdentIDs(InternedString::Find(name.first),
+                                     InternedString::Find(name.second)));
+  return (it == map.end()) ? kNotFound : it->second;
+}
+
 UID K8sMetadataState::PodIDByName(K8sNameIdentView pod_name) const {
-  auto it = pods_by_name_.find(pod_name);
-  return (it == pods_by_name_.end()) ? "" : it->second;
+  return EntityIDByName(pods_by_name_, pod_name).str();
 }
 
 UID K8sMetadataState::PodIDByIP(std::string_view pod_ip) const {
   auto it = pods_by_ip_.find(pod_ip);
-  return (it == pods_by_ip_.end()) ? "" : it->second;
+  return (it == pods_by_ip_.end()) ? "" : it->second.str();
 }
 
 UID K8sMetadataState::ServiceIDByClusterIP(std::string_view cluster_ip) const {
   auto it = services_by_cluster_ip_.find(cluster_ip);
-  return (it == services_by_cluster_ip_.end()) ? "" : it->second;
+  return (it == services_by_cluster_ip_.end()) ? "" : it->second.str();
 }
 
 CID K8sMetadataState::ContainerIDByName(std::string_view container_name) const {
   auto it = containers_by_name_.find(container_name);
-  return (it == containers_by_name_.end()) ? "" : it->second;
+  return (it == containers_by_name_.end()) ? "" : it->second.str();
 }
 
 UID K8sMetadataState::ServiceIDByName(K8sNameIdentView service_name) const {
-  auto it = services_by_name_.find(service_name);
-  return (it == services_by_name_.end()) ? "" : it->second;
+  return EntityIDByName(services_by_name_, service_name).str();
 }
 
 UID K8sMetadataState::NamespaceIDByName(K8sNameIdentView namespace_name) const {
-  auto it = namespaces_by_name_.find(namespace_name);
-  return (it == namespaces_by_name_.end()) ? "" : it->second;
+  return EntityIDByName(namespaces_by_name_, namespace_name).str();
 }
 
 std::unique_ptr<K8sMetadataState> K8sMetadataState::Clone() const {
@@ -103,16 +168,8 @@ std::unique_ptr<K8sMetadataState> K8sMetadataState::Clone() const {
   other->pod_cidrs_ = pod_cidrs_;
   other->service_cidr_ = service_cidr_;
 
-  other->k8s_objects_by_id_.reserve(k8s_objects_by_id_.size());
-  for (const auto& [k, v] : k8s_objects_by_id_) {
-    other->k8s_objects_by_id_[k] = v->Clone();
-  }
-
-  other->containers_by_id_.reserve(containers_by_id_.size());
-  for (const auto& [k, v] : containers_by_id_) {
-    other->containers_by_id_[k] = v->Clone();
-  }
-
+  other->k8s_objects_by_id_ = k8s_objects_by_id_;
+  other->containers_by_id_ = containers_by_id_;
   other->pods_by_name_ = pods_by_name_;
   other->services_by_name_ = services_by_name_;
   other->namespaces_by_name_ = namespaces_by_name_;
@@ -139,10 +196,10 @@ std::string K8sMetadataState::DebugString(int indent_level) const {
   str += "\n";
   str += prefix + "IPs:\n";
   for (const auto& [k, v] : pods_by_ip_) {
-    str += absl::Substitute("pod_id: $0, ip: $1\n", v, k);
+    str += absl::Substitute("pod_id: $0, ip: $1\n", v.view(), k);
   }
   for (const auto& [k, v] : services_by_cluster_ip_) {
-    str += absl::Substitute("service_id: $0, cluster_ip: $1\n", v, k);
+    str += absl::Substitute("service_id: $0, cluster_ip: $1\n", v.view(), k);
   }
 
   str += prefix + absl::Substitute("PodCIDRs($0): ", pod_cidrs_.size());
@@ -159,13 +216,13 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   const std::string& name = update.name();
   const std::string& ns = update.namespace_();
 
-  auto it = k8s_objects_by_id_.find(object_uid);
-  if (it == k8s_objects_by_id_.end()) {
-    auto pod = std::make_unique<PodInfo>(update);
+  auto pod_info = static_cast<PodInfo*>(MutableK8sMetadataObjectByID(object_uid));
+  if (pod_info == nullptr) {
+    auto pod = std::make_shared<PodInfo>(update);
     VLOG(1) << "Adding Pod: " << pod->DebugString();
-    it = k8s_objects_by_id_.try_emplace(object_uid, std::move(pod)).first;
+    pod_info = pod.get();
+    k8s_objects_by_id_.try_emplace(pod->interned_uid(), std::move(pod));
   }
-  auto pod_info = static_cast<PodInfo*>(it->second.get());
 
   // We always just add to the container set even if the container is stopped.
   // We expect all cleanup to happen periodically to allow stale objects to be queried for some
@@ -174,7 +231,8 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   // state might be periodically inconsistent.
 
   for (const auto& cid : update.container_ids()) {
-    if (containers_by_id_.find(cid) == containers_by_id_.end()) {
+    ContainerInfo* container_info = MutableContainerInfoByID(cid);
+    if (container_info == nullptr) {
       // We should be resilient to the case where we happened to miss a pod update
       // in the stream of events. If we did miss a pod update, just skip adding the
       // pod to this particular service to avoid dangling references.
@@ -182,8 +240,8 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
       continue;
     }
 
-    pod_info->AddContainer(cid);
-    containers_by_id_[cid]->set_pod_id(object_uid);
+    pod_info->AddContainer(container_info->interned_cid());
+    container_info->set_pod_id(pod_info->interned_uid());
   }
 
   pod_info->set_start_time_ns(update.start_timestamp_ns());
@@ -196,10 +254,10 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   pod_info->set_phase_message(update.message());
   pod_info->set_phase_reason(update.reason());
 
-  pods_by_name_[{ns, name}] = object_uid;
+  pods_by_name_[NameIdent(*pod_info)] = pod_info->interned_uid();
   // Filter out daemonsets which don't have their own, unique podIP.
   if (update.host_ip() != update.pod_ip() && update.pod_ip() != "") {
-    pods_by_ip_[update.pod_ip()] = object_uid;
+    pods_by_ip_[update.pod_ip()] = pod_info->interned_uid();
   }
 
   return Status::OK();
@@ -208,21 +266,21 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
 Status K8sMetadataState::HandleContainerUpdate(const ContainerUpdate& update) {
   const CID& cid = update.cid();
 
-  auto it = containers_by_id_.find(cid);
-  if (it == containers_by_id_.end()) {
-    auto container = std::make_unique<ContainerInfo>(update);
+  auto* container_info = MutableContainerInfoByID(cid);
+  if (container_info == nullptr) {
+    auto container = std::make_shared<ContainerInfo>(update);
     VLOG(1) << "Adding Container: " << container->DebugString();
-    it = containers_by_id_.try_emplace(cid, std::move(container)).first;
+    container_info = container.get();
+    containers_by_id_.try_emplace(container->interned_cid(), std::move(container));
   }
   VLOG(1) << "container update: " << update.name();
 
-  auto* container_info = it->second.get();
   container_info->set_stop_time_ns(update.stop_timestamp_ns());
   container_info->set_state(ConvertToContainerState(update.container_state()));
   container_info->set_state_message(update.message());
   container_info->set_state_reason(update.reason());
 
-  containers_by_name_[update.name()] = cid;
+  containers_by_name_[update.name()] = container_info->interned_cid();
 
   return Status::OK();
 }
@@ -232,26 +290,27 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
   const std::string& name = update.name();
   const std::string& ns = update.namespace_();
 
-  auto it = k8s_objects_by_id_.find(service_uid);
-  if (it == k8s_objects_by_id_.end()) {
-    auto service = std::make_unique<ServiceInfo>(service_uid, ns, name);
+  auto service_info = static_cast<ServiceInfo*>(MutableK8sMetadataObjectByID(service_uid));
+  if (service_info == nullptr) {
+    auto service = std::make_shared<ServiceInfo>(service_uid, ns, name);
     VLOG(1) << "Adding Service: " << service->DebugString();
-    it = k8s_objects_by_id_.try_emplace(service_uid, std::move(service)).first;
+    service_info = service.get();
+    k8s_objects_by_id_.try_emplace(service->interned_uid(), std::move(service));
   }
-  auto service_info = static_cast<ServiceInfo*>(it->second.get());
 
   for (const auto& uid : update.pod_ids()) {
-    if (k8s_objects_by_id_.find(uid) == k8s_objects_by_id_.end()) {
+    K8sMetadataObject* k8s_object = MutableK8sMetadataObjectByID(uid);
+    if (k8s_object == nullptr) {
       // We should be resilient to the case where we happened to miss a pod update
       // in the stream of events. If we did miss a pod update, just skip adding the
       // pod to this particular service to avoid dangling references.
       LOG(INFO) << absl::Substitute("Didn't find pod UID $0 for service $1/$2", uid, ns, name);
       continue;
     }
-    ECHECK(k8s_objects_by_id_[uid]->type() == K8sObjectType::kPod);
+    ECHECK(k8s_object->type() == K8sObjectType::kPod);
     // We add the service uid to the pod. Lifetime of service still handled by the service object.
-    PodInfo* pod_info = static_cast<PodInfo*>(k8s_objects_by_id_[uid].get());
-    pod_info->AddService(service_uid);
+    PodInfo* pod_info = static_cast<PodInfo*>(k8s_object);
+    pod_info->AddService(service_info->interned_uid());
   }
   if (update.start_timestamp_ns() != 0) {
     service_info->set_start_time_ns(update.start_timestamp_ns());
@@ -260,7 +319,7 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
     service_info->set_stop_time_ns(update.stop_timestamp_ns());
   }
   if (update.cluster_ip() != "") {
-    services_by_cluster_ip_[update.cluster_ip()] = service_uid;
+    services_by_cluster_ip_[update.cluster_ip()] = service_info->interned_uid();
     service_info->set_cluster_ip(update.cluster_ip());
   }
   if (update.external_ips().size()) {
@@ -270,7 +329,7 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
   }
 
   VLOG(1) << "service update: " << update.name();
-  services_by_name_[{ns, name}] = service_uid;
+  services_by_name_[NameIdent(*service_info)] = service_info->interned_uid();
   return Status::OK();
 }
 
@@ -279,20 +338,20 @@ Status K8sMetadataState::HandleNamespaceUpdate(const NamespaceUpdate& update) {
   const std::string& name = update.name();
   const std::string& ns = update.name();
 
-  auto it = k8s_objects_by_id_.find(namespace_uid);
-  if (it == k8s_objects_by_id_.end()) {
-    auto ns_obj = std::make_unique<NamespaceInfo>(namespace_uid, ns, name);
+  auto ns_info = static_cast<NamespaceInfo*>(MutableK8sMetadataObjectByID(namespace_uid));
+  if (ns_info == nullptr) {
+    auto ns_obj = std::make_shared<NamespaceInfo>(namespace_uid, ns, name);
     VLOG(1) << "Adding Namespace: " << ns_obj->DebugString();
-    it = k8s_objects_by_id_.try_emplace(namespace_uid, std::move(ns_obj)).first;
+    ns_info = ns_obj.get();
+    k8s_objects_by_id_.try_emplace(ns_obj->interned_uid(), std::move(ns_obj));
   }
-  auto ns_info = static_cast<NamespaceInfo*>(it->second.get());
 
   ns_info->set_start_time_ns(update.start_timestamp_ns());
   ns_info->set_stop_time_ns(update.stop_timestamp_ns());
 
   VLOG(1) << "namespace update: " << update.name();
 
-  namespaces_by_name_[{ns, name}] = namespace_uid;
+  namespaces_by_name_[NameIdent(*ns_info)] = ns_info->interned_uid();
   return Status::OK();
 }
 
@@ -317,57 +376,52 @@ bool IsExpired(const T& obj, int64_t retention_time, int64_t now) {
 Status K8sMetadataState::CleanupExpiredMetadata(int64_t retention_time_ns) {
   int64_t now = CurrentTimeNS();
 
-  for (auto iter = k8s_objects_by_id_.begin(); iter != k8s_objects_by_id_.end();) {
-    const auto& k8s_object = iter->second;
-
-    if (!IsExpired(*k8s_object, retention_time_ns, now)) {
-      ++iter;
-      continue;
+  // Expired objects are collected first, since erasing may replace the shards being iterated.
+  std::vector<K8sMetadataObjectSPtr> expired_objects;
+  for (const auto& entry : k8s_objects_by_id_) {
+    if (IsExpired(*entry.second, retention_time_ns, now)) {
+      expired_objects.push_back(entry.second);
     }
+  }
 
+  for (const auto& k8s_object : expired_objects) {
+    const InternedString& uid = k8s_object->interned_uid();
     switch (k8s_object->type()) {
-      case K8sObjectType::kPod:
-        if (PodIDByName(std::make_pair(k8s_object->ns(), k8s_object->name())) ==
-            k8s_object->uid()) {
-          pods_by_name_.erase({k8s_object->ns(), k8s_object->name()});
-        }
-        if (PodIDByIP(static_cast<PodInfo*>(k8s_object.get())->pod_ip()) ==
-            k8s_object
-                ->uid()) {  // There could be a new pod assigned to the podIP now, we should only
-                            // delete the IP from the map if it belongs to the terminated pod.
-          pods_by_ip_.erase(static_cast<PodInfo*>(k8s_object.get())->pod_ip());
+      case K8sObjectType::kPod: {
+        EraseNameIfOwned(*k8s_object, &pods_by_name_);
+        // There could be a new pod assigned to the podIP now, we should only delete the IP from
+        // the map if it belongs to the terminated pod.
+        const std::string& pod_ip = static_cast<PodInfo*>(k8s_object.get())->pod_ip();
+        auto it = pods_by_ip_.find(pod_ip);
+        if (it != pods_by_ip_.end() && it->second == uid) {
+          pods_by_ip_.erase(pod_ip);
         }
         break;
+      }
       case K8sObjectType::kNamespace:
-        if (NamespaceIDByName(std::make_pair(k8s_object->ns(), k8s_object->name())) ==
-            k8s_object->uid()) {
-          namespaces_by_name_.erase({k8s_object->ns(), k8s_object->name()});
-        }
+        EraseNameIfOwned(*k8s_object, &namespaces_by_name_);
         break;
       case K8sObjectType::kService:
-        if (ServiceIDByName(std::make_pair(k8s_object->ns(), k8s_object->name())) ==
-            k8s_object->uid()) {
-          services_by_name_.erase({k8s_object->ns(), k8s_object->name()});
-        }
+        EraseNameIfOwned(*k8s_object, &services_by_name_);
         break;
       default:
         LOG(DFATAL) << absl::Substitute("Unexpected object type: $0",
                                         static_cast<int>(k8s_object->type()));
     }
 
-    k8s_objects_by_id_.erase(iter++);
+    k8s_objects_by_id_.erase(uid.id());
   }
 
-  for (auto iter = containers_by_id_.begin(); iter != containers_by_id_.end();) {
-    const auto& cinfo = iter->second;
-
-    if (!IsExpired(*cinfo, retention_time_ns, now)) {
-      ++iter;
-      continue;
+  std::vector<ContainerInfoSPtr> expired_containers;
+  for (const auto& entry : containers_by_id_) {
+    if (IsExpired(*entry.second, retention_time_ns, now)) {
+      expired_containers.push_back(entry.second);
     }
+  }
 
+  for (const auto& cinfo : expired_containers) {
     containers_by_name_.erase(cinfo->name());
-    containers_by_id_.erase(iter++);
+    containers_by_id_.erase(cinfo->interned_cid().id());
   }
 
   return Status::OK();
@@ -29,6 +29,8 @@
 
 #include "src/common/base/base.h"
 #include "src/shared/k8s/metadatapb/metadata.pb.h"
+#include "src/shared/metadata/cow_hash_map.h"
+#include "src/shared/metadata/interned_string.h"
 #include "src/shared/metadata/k8s_objects.h"
 #include "src/shared/metadata/pids.h"
 #include "src/shared/upid/upid.h"
@@ -36,13 +38,22 @@
 namespace px {
 namespace md {
 
-using K8sMetadataObjectUPtr = std::unique_ptr<K8sMetadataObject>;
-using ContainerInfoUPtr = std::unique_ptr<ContainerInfo>;
+using K8sMetadataObjectSPtr = std::shared_ptr<K8sMetadataObject>;
+using ContainerInfoSPtr = std::shared_ptr<ContainerInfo>;
 using PIDInfoUPtr = std::unique_ptr<PIDInfo>;
 using AgentID = sole::uuid;
 
 /**
  * This class contains all kubernetes relate metadata.
+ *
+ * The maps and the objects in them are shared with the states returned by Clone(), and are only
+ * copied when one of the states modifies them. This keeps a clone per update cheap even when the
+ * cluster has tens of thousands of pods.
+ *
+ * UIDs, CIDs and object names are held as InternedStrings, so each one is stored once in the
+ * process and every map or object that refers to it holds a 32-bit ID. The maps are keyed and
+ * hashed by those IDs. Lookups by string first resolve the ID, and the InternedString overloads
+ * skip that step.
  */
 class K8sMetadataState : NotCopyable {
  public:
@@ -53,22 +64,19 @@ class K8sMetadataState : NotCopyable {
   using NodeUpdate = px::shared::k8s::metadatapb::NodeUpdate;
 
   // K8s names consist of both a namespace and name : <ns, name>.
-  using K8sNameIdent = std::pair<std::string, std::string>;
+  using K8sNameIdent = std::pair<InternedString, InternedString>;
   using K8sNameIdentView = std::pair<std::string_view, std::string_view>;
+  // The IDs of an interned <ns, name>, used to look up names without taking references.
+  using K8sNameIdentIDs = std::pair<uint32_t, uint32_t>;
 
   /**
-   * K8sIdentHashEq provides hash an ident functions to allow
+   * K8sIdentHashEq provides hash and equality functions over the IDs of a name, to allow
    * heterogeneous lookups of maps.
    */
   struct K8sIdentHashEq {
-    /**
-     * K8sIdentCheck validates that the template argument is one of the valid ident types.
-     */
-    template <typename T>
-    static constexpr void K8sIdentCheck() {
-      static_assert(
-          std::is_base_of<K8sNameIdent, T>::value || std::is_base_of<K8sNameIdentView, T>::value,
-          "T must be a K8s ident");
+    static K8sNameIdentIDs IDs(const K8sNameIdentIDs& ids) { return ids; }
+    static K8sNameIdentIDs IDs(const K8sNameIdent& ident) {
+      return {ident.first.id(), ident.second.id()};
     }
 
     struct Hash {
@@ -76,8 +84,7 @@ class K8sMetadataState : NotCopyable {
 
       template <typename T>
       size_t operator()(const T& v) const {
-        K8sIdentCheck<T>();
-        return absl::Hash<K8sNameIdentView>{}(v);
+        return absl::Hash<K8sNameIdentIDs>{}(IDs(v));
       }
     };
 
@@ -85,22 +92,25 @@ class K8sMetadataState : NotCopyable {
       using is_transparent = void;
 
       template <typename T1, typename T2>
-      size_t operator()(const T1& a, const T2& b) const {
-        K8sIdentCheck<T1>();
-        K8sIdentCheck<T2>();
-        return a.first == b.first && a.second == b.second;
+      bool operator()(const T1& a, const T2& b) const {
+        return IDs(a) == IDs(b);
       }
     };
   };
   using K8sEntityByNameMap =
-      absl::flat_hash_map<K8sNameIdent, UID, K8sIdentHashEq::Hash, K8sIdentHashEq::Eq>;
+      CowHashMap<K8sNameIdent, InternedString, K8sIdentHashEq::Hash, K8sIdentHashEq::Eq>;
+
+  template <typename V>
+  using InternedStringMap = CowHashMap<InternedString, V, InternedString::Hash, InternedString::Eq>;
 
   using PodsByNameMap = K8sEntityByNameMap;
   using ServicesByNameMap = K8sEntityByNameMap;
   using NamespacesByNameMap = K8sEntityByNameMap;
-  using ContainersByNameMap = absl::flat_hash_map<std::string, CID>;
-  using PodsByPodIpMap = absl::flat_hash_map<std::string, UID>;
-  using ServicesByServiceIpMap = absl::flat_hash_map<std::string, UID>;
+  using ContainersByNameMap = CowHashMap<std::string, InternedString>;
+  using PodsByPodIpMap = CowHashMap<std::string, InternedString>;
+  using ServicesByServiceIpMap = CowHashMap<std::string, InternedString>;
+  using K8sObjectsByIDMap = InternedStringMap<K8sMetadataObjectSPtr>;
+  using ContainersByIDMap = InternedStringMap<ContainerInfoSPtr>;
 
   void set_service_cidr(CIDRBlock cidr) {
     if (!service_cidr_.has_value() || service_cidr_.value() != cidr) {
@@ -123,6 +133,7 @@ class K8sMetadataState : NotCopyable {
    * @return Pointer to the PodInfo.
    */
   const PodInfo* PodInfoByID(UIDView pod_id) const;
+  const PodInfo* PodInfoByID(const InternedString& pod_id) const;
 
   /**
    * PodIDByName returns the PodID for the pod of the given name.
@@ -151,6 +162,7 @@ class K8sMetadataState : NotCopyable {
    * @return ContainerInfo or nullptr if not found.
    */
   const ContainerInfo* ContainerInfoByID(CIDView id) const;
+  const ContainerInfo* ContainerInfoByID(const InternedString& id) const;
 
   /**
    * ContainerIDByName returns the ContainerID for the container of the given name.
@@ -166,6 +178,7 @@ class K8sMetadataState : NotCopyable {
    * @return Pointer to the ServiceInfo.
    */
   const ServiceInfo* ServiceInfoByID(UIDView service_id) const;
+  const ServiceInfo* ServiceInfoByID(const InternedString& service_id) const;
 
   /**
    * ServiceIDByName returns the ServiceID for the service of the given name.
@@ -181,6 +194,7 @@ class K8sMetadataState : NotCopyable {
    * @return Pointer to the NamespaceInfo.
    */
   const NamespaceInfo* NamespaceInfoByID(UIDView ns_id) const;
+  const NamespaceInfo* NamespaceInfoByID(const InternedString& ns_id) const;
 
   /**
    * NamespaceIDByName returns the NamespaceID for the namespace of the given name.
@@ -189,6 +203,10 @@ class K8sMetadataState : NotCopyable {
    */
   UID NamespaceIDByName(K8sNameIdentView namespace_name) const;
 
+  /**
+   * Clone returns a copy of this state. The copy shares the underlying maps and objects with
+   * this state, so it is cheap to make, and each side copies what it modifies afterwards.
+   */
   std::unique_ptr<K8sMetadataState> Clone() const;
 
   Status HandlePodUpdate(const PodUpdate& update);
@@ -199,11 +217,26 @@ class K8sMetadataState : NotCopyable {
 
   Status CleanupExpiredMetadata(int64_t retention_time_ns);
 
-  absl::flat_hash_map<CID, ContainerInfoUPtr>& containers_by_id() { return containers_by_id_; }
+  const ContainersByIDMap& containers_by_id() const { return containers_by_id_; }
+
+  /**
+   * MutableContainerInfoByID returns the container info by ID for modification. The object is
+   * copied first if it is shared with another state, so the pointer is only valid until the
+   * next modification of this state.
+   * @param id The ID of the container.
+   * @return ContainerInfo or nullptr if not found.
+   */
+  ContainerInfo* MutableContainerInfoByID(CIDView id);
+
   std::string DebugString(int indent_level = 0) const;
 
  private:
-  const K8sMetadataObject* K8sMetadataObjectByID(UIDView id, K8sObjectType type) const;
+  // Takes the ID of an interned UID, see InternedString::Find().
+  const K8sMetadataObject* K8sMetadataObjectByID(uint32_t id, K8sObjectType type) const;
+
+  // Returns the UID the name maps to, or an empty string.
+  static const InternedString& EntityIDByName(const K8sEntityByNameMap& map,
+                                              K8sNameIdentView name);
 
   // The CIDR block used for services inside the cluster.
   std::optional<CIDRBlock> service_cidr_;
@@ -211,11 +244,14 @@ class K8sMetadataState : NotCopyable {
   // The CIDRs used for pods inside the cluster.
   std::vector<CIDRBlock> pod_cidrs_;
 
+  // Returns the object for modification, copying it first if it is shared with another state.
+  K8sMetadataObject* MutableK8sMetadataObjectByID(UIDView id);
+
   // This stores K8s native objects (services, pods, etc).
-  absl::flat_hash_map<UID, K8sMetadataObjectUPtr> k8s_objects_by_id_;
+  K8sObjectsByIDMap k8s_objects_by_id_;
 
   // This stores container objects, complementing k8s_objects_by_id_.
-  absl::flat_hash_map<CID, ContainerInfoUPtr> containers_by_id_;
+  ContainersByIDMap containers_by_id_;
 
   /**
    * Mapping of pods by name.
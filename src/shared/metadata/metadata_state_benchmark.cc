@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+#include <sole.hpp>
+
+#include "src/common/datagen/datagen.h"
+#include "src/common/perf/memory_tracker.h"
+#include "src/shared/metadata/metadata_state.h"
+
+namespace px {
+namespace md {
+
+namespace {
+
+constexpr int kContainersPerPod = 2;
+constexpr int kPodsPerService = 8;
+constexpr int kCIDLength = 64;
+
+struct ClusterUpdates {
+  std::vector<K8sMetadataState::ContainerUpdate> containers;
+  std::vector<K8sMetadataState::PodUpdate> pods;
+  std::vector<K8sMetadataState::ServiceUpdate> services;
+};
+
+// Generates updates shaped like a real cluster: UUID pod and service UIDs, 64 character container
+// IDs, and a handful of namespaces shared by all the pods.
+ClusterUpdates GenerateClusterUpdates(int num_pods) {
+  ClusterUpdates updates;
+  for (int i = 0; i < num_pods; ++i) {
+    K8sMetadataState::PodUpdate pod;
+    pod.set_uid(sole::uuid4().str());
+    pod.set_name(absl::StrCat("frontend-7d9f8b6c5-", i));
+    pod.set_namespace_(absl::StrCat("ns", i % 4));
+    pod.set_pod_ip(absl::StrCat("10.", i / 65536, ".", (i / 256) % 256, ".", i % 256));
+    for (int c = 0; c < kContainersPerPod; ++c) {
+      K8sMetadataState::ContainerUpdate container;
+      container.set_cid(datagen::RandomString(kCIDLength));
+      container.set_name(absl::StrCat("container", c));
+      container.set_pod_id(pod.uid());
+      pod.add_container_ids(container.cid());
+      updates.containers.push_back(std::move(container));
+    }
+    if (i % kPodsPerService == 0) {
+      K8sMetadataState::ServiceUpdate service;
+      service.set_uid(sole::uuid4().str());
+      service.set_name(absl::StrCat("service-", i));
+      service.set_namespace_(pod.namespace_());
+      updates.services.push_back(std::move(service));
+    }
+    updates.services.back().add_pod_ids(pod.uid());
+    updates.pods.push_back(std::move(pod));
+  }
+  return updates;
+}
+
+std::unique_ptr<K8sMetadataState> BuildState(const ClusterUpdates& updates) {
+  auto state = std::make_unique<K8sMetadataState>();
+  for (const auto& container : updates.containers) {
+    PL_CHECK_OK(state->HandleContainerUpdate(container));
+  }
+  for (const auto& pod : updates.pods) {
+    PL_CHECK_OK(state->HandlePodUpdate(pod));
+  }
+  for (const auto& service : updates.services) {
+    PL_CHECK_OK(state->HandleServiceUpdate(service));
+  }
+  return state;
+}
+
+}  // namespace
+
+// Measures the heap held by the K8s state of a cluster of the given number of pods. The bytes are
+// only reported when running with tcmalloc.
+// NOLINTNEXTLINE : runtime/references.
+void BM_K8sMetadataStateMemory(benchmark::State& state) {
+  auto updates = GenerateClusterUpdates(state.range(0));
+  MemoryStats mem_stats;
+  for (auto _ : state) {
+    MemoryTracker mem_tracker(/*enable*/ true);
+    mem_tracker.Start();
+    auto md_state = BuildState(updates);
+    mem_stats = mem_tracker.End();
+    benchmark::DoNotOptimize(md_state);
+  }
+  state.counters["bytes_per_pod"] =
+      static_cast<double>(mem_stats.end.allocated - mem_stats.start.allocated) / state.range(0);
+}
+
+// Measures looking up pods by their UID string, which resolves the interned ID first.
+// NOLINTNEXTLINE : runtime/references.
+void BM_PodInfoByUIDString(benchmark::State& state) {
+  auto updates = GenerateClusterUpdates(state.range(0));
+  auto md_state = BuildState(updates);
+  for (auto _ : state) {
+    for (const auto& pod : updates.pods) {
+      benchmark::DoNotOptimize(md_state->PodInfoByID(pod.uid()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * updates.pods.size());
+}
+
+// Measures looking up pods by their interned UID, as done when following the references between
+// containers, pods and services.
+// NOLINTNEXTLINE : runtime/references.
+void BM_PodInfoByInternedUID(benchmark::State& state) {
+  auto updates = GenerateClusterUpdates(state.range(0));
+  auto md_state = BuildState(updates);
+  std::vector<InternedString> uids;
+  for (const auto& pod : updates.pods) {
+    uids.emplace_back(pod.uid());
+  }
+  for (auto _ : state) {
+    for (const auto& uid : uids) {
+      benchmark::DoNotOptimize(md_state->PodInfoByID(uid));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * uids.size());
+}
+
+BENCHMARK(BM_K8sMetadataStateMemory)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK(BM_PodInfoByUIDString)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK(BM_PodInfoByInternedUID)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+}  // namespace md
+}  // namespace px
@@ -20,6 +20,8 @@
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 
+#include <absl/strings/str_cat.h>
+
 #include "src/common/testing/testing.h"
 #include "src/shared/metadata/metadata_state.h"
 
@@ -169,6 +171,43 @@ TEST(K8sMetadataStateTest, CloneCopiedCIDR) {
   EXPECT_EQ(service_cidr.prefix_length, state_copy->service_cidr()->prefix_length);
 }
 
+TEST(K8sMetadataStateTest, CloneSharesUnmodifiedObjects) {
+  K8sMetadataState state;
+
+  K8sMetadataState::ContainerUpdate container_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kContainer0UpdatePbTxt, &container_update))
+      << "Failed to parse proto";
+  K8sMetadataState::PodUpdate pod_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod0UpdatePbTxt, &pod_update))
+      << "Failed to parse proto";
+  EXPECT_OK(state.HandleContainerUpdate(container_update));
+  EXPECT_OK(state.HandlePodUpdate(pod_update));
+
+  auto state_copy = state.Clone();
+  EXPECT_EQ(state.PodInfoByID("pod0_uid"), state_copy->PodInfoByID("pod0_uid"));
+  EXPECT_EQ(state.ContainerInfoByID("container0_uid"),
+            state_copy->ContainerInfoByID("container0_uid"));
+
+  // Updating the copy must leave the original untouched.
+  container_update.set_message("another container message");
+  EXPECT_OK(state_copy->HandleContainerUpdate(container_update));
+
+  EXPECT_EQ("a container message", state.ContainerInfoByID("container0_uid")->state_message());
+  EXPECT_EQ("another container message",
+            state_copy->ContainerInfoByID("container0_uid")->state_message());
+  EXPECT_EQ(state.PodInfoByID("pod0_uid"), state_copy->PodInfoByID("pod0_uid"));
+
+  // Objects added to the copy are not visible in the original.
+  K8sMetadataState::PodUpdate pod1_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod1UpdatePbTxt, &pod1_update))
+      << "Failed to parse proto";
+  EXPECT_OK(state_copy->HandlePodUpdate(pod1_update));
+  EXPECT_EQ(nullptr, state.PodInfoByID("pod1_uid"));
+  EXPECT_NE(nullptr, state_copy->PodInfoByID("pod1_uid"));
+  EXPECT_EQ("", state.PodIDByName({"ns0", "pod1"}));
+  EXPECT_EQ("pod1_uid", state_copy->PodIDByName({"ns0", "pod1"}));
+}
+
 TEST(K8sMetadataStateTest, HandleContainerUpdate) {
   K8sMetadataState state;
 
@@ -421,5 +460,87 @@ TEST(K8sMetadataStateTest, CleanupExpiredMetadata) {
   }
 }
 
+TEST(K8sMetadataStateTest, InternedIDsAreShared) {
+  K8sMetadataState state;
+
+  K8sMetadataState::ContainerUpdate container_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kContainer0UpdatePbTxt, &container_update));
+  K8sMetadataState::PodUpdate pod_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod0UpdatePbTxt, &pod_update));
+  K8sMetadataState::ServiceUpdate service_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kRunningServiceUpdatePbTxt, &service_update));
+
+  EXPECT_OK(state.HandleContainerUpdate(container_update));
+  EXPECT_OK(state.HandlePodUpdate(pod_update));
+  EXPECT_OK(state.HandleServiceUpdate(service_update));
+
+  const PodInfo* pod_info = state.PodInfoByID("pod0_uid");
+  ASSERT_NE(nullptr, pod_info);
+  const ContainerInfo* container_info = state.ContainerInfoByID("container0_uid");
+  ASSERT_NE(nullptr, container_info);
+  const ServiceInfo* service_info = state.ServiceInfoByID("service0_uid");
+  ASSERT_NE(nullptr, service_info);
+
+  // Every reference to a UID holds the same ID.
+  EXPECT_EQ(pod_info->interned_uid().id(), container_info->interned_pod_id().id());
+  EXPECT_THAT(pod_info->containers(), UnorderedElementsAre(container_info->interned_cid()));
+  EXPECT_THAT(pod_info->services(), UnorderedElementsAre(service_info->interned_uid()));
+  EXPECT_EQ(pod_info->interned_ns(), service_info->interned_ns());
+  auto it = state.pods_by_name().find(
+      K8sMetadataState::K8sNameIdent(pod_info->interned_ns(), pod_info->interned_name()));
+  ASSERT_NE(state.pods_by_name().end(), it);
+  EXPECT_EQ(pod_info->interned_uid(), it->second);
+
+  // The IDs can be used for lookups directly.
+  EXPECT_EQ(pod_info, state.PodInfoByID(container_info->interned_pod_id()));
+  EXPECT_EQ(container_info, state.ContainerInfoByID(*pod_info->containers().begin()));
+  EXPECT_EQ(service_info, state.ServiceInfoByID(*pod_info->services().begin()));
+  EXPECT_EQ(nullptr, state.NamespaceInfoByID(pod_info->interned_uid()));
+}
+
+TEST(K8sMetadataStateTest, StringsAreStoredOnce) {
+  constexpr int kNumPods = 64;
+  auto* table = StringInternTable::GetSingleton();
+  size_t initial_size = table->size();
+
+  {
+    K8sMetadataState state;
+    for (int i = 0; i < kNumPods; ++i) {
+      K8sMetadataState::PodUpdate pod_update;
+      pod_update.set_uid(absl::StrCat("pod_uid_", i));
+      pod_update.set_name(absl::StrCat("pod_", i));
+      pod_update.set_namespace_("ns0");
+      pod_update.set_pod_ip(absl::StrCat("10.0.0.", i));
+      for (int c = 0; c < 2; ++c) {
+        K8sMetadataState::ContainerUpdate container_update;
+        container_update.set_cid(absl::StrCat("container_uid_", i, "_", c));
+        container_update.set_name(absl::StrCat("container_", c));
+        container_update.set_pod_id(pod_update.uid());
+        EXPECT_OK(state.HandleContainerUpdate(container_update));
+        pod_update.add_container_ids(container_update.cid());
+      }
+      EXPECT_OK(state.HandlePodUpdate(pod_update));
+    }
+
+    // Each pod UID, pod name and container ID is held once however many maps and objects refer
+    // to it, and the namespace name is held once for all the pods.
+    size_t num_strings = 1 + kNumPods * 4;
+    EXPECT_EQ(initial_size + num_strings, table->size());
+
+    // Clones and the copies made when modifying them refer to the same strings.
+    auto state_copy = state.Clone();
+    K8sMetadataState::PodUpdate pod_update;
+    pod_update.set_uid("pod_uid_0");
+    pod_update.set_name("pod_0");
+    pod_update.set_namespace_("ns0");
+    pod_update.set_message("updated");
+    EXPECT_OK(state_copy->HandlePodUpdate(pod_update));
+    EXPECT_EQ(initial_size + num_strings, table->size());
+  }
+
+  // The strings are released along with the state.
+  EXPECT_EQ(initial_size, table->size());
+}
+
 }  // namespace md
 }  // namespace px
@@ -23,6 +23,7 @@
 #include <utility>
 
 #include "src/common/base/base.h"
+#include "src/shared/metadata/interned_string.h"
 #include "src/shared/upid/upid.h"
 
 namespace px {
@@ -38,7 +39,7 @@ class PIDInfo {
       : upid_(upid),
         exe_path_(std::move(exe_path)),
         cmdline_(std::move(cmdline)),
-        cid_(std::move(cid)),
+        cid_(cid),
         stop_time_ns_(0) {}
 
   UPID upid() const { return upid_; }
@@ -53,7 +54,8 @@ class PIDInfo {
 
   const std::string& cmdline() const { return cmdline_; }
 
-  const CID& cid() const { return cid_; }
+  const CID& cid() const { return cid_.str(); }
+  const InternedString& interned_cid() const { return cid_; }
 
   std::unique_ptr<PIDInfo> Clone() {
     auto pid_info = std::make_unique<PIDInfo>(*this);
@@ -86,7 +88,7 @@ class PIDInfo {
   /**
    * The container running this PID.
    */
-  CID cid_;
+  InternedString cid_;
 
   /**
    * The time that this PID stopped running. If 0 we can assume it's still running.
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "src/shared/metadata/proc_event_source.h"
+
+DEFINE_int32(metadata_proc_events_rcvbuf_bytes, 4 * 1024 * 1024,
+             "Socket receive buffer size for the netlink proc connector.");
+
+namespace px {
+namespace md {
+
+namespace {
+
+// Upper bound on undrained events. Beyond this we drop events and force a full scan.
+constexpr size_t kMaxPendingEvents = 256 * 1024;
+
+constexpr int kPollTimeoutMillis = 100;
+
+Status SendMcastOp(int fd, enum proc_cn_mcast_op op) {
+  // The subscription request is a netlink header, followed by a connector header, followed by the
+  // multicast op. All three must be contiguous.
+  alignas(struct nlmsghdr) char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(op))] = {};
+  auto* nl_hdr = reinterpret_cast<struct nlmsghdr*>(buf);
+  auto* cn_hdr = reinterpret_cast<struct cn_msg*>(NLMSG_DATA(nl_hdr));
+
+  nl_hdr->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+  nl_hdr->nlmsg_type = NLMSG_DONE;
+  nl_hdr->nlmsg_pid = 0;
+  cn_hdr->id.idx = CN_IDX_PROC;
+  cn_hdr->id.val = CN_VAL_PROC;
+  cn_hdr->len = sizeof(op);
+  std::memcpy(cn_hdr->data, &op, sizeof(op));
+
+  if (send(fd, buf, nl_hdr->nlmsg_len, 0) < 0) {
+    return error::Internal("Failed to subscribe to proc connector: $0", std::strerror(errno));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<NetlinkProcEventSource>> NetlinkProcEventSource::Create(
+    const system::Config& config) {
+  int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+  if (fd < 0) {
+    return error::Internal("Failed to create netlink connector socket: $0", std::strerror(errno));
+  }
+
+  int rcvbuf = FLAGS_metadata_proc_events_rcvbuf_bytes;
+  // SO_RCVBUFFORCE ignores net.core.rmem_max, but requires CAP_NET_ADMIN.
+  if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) < 0) {
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  }
+
+  struct sockaddr_nl addr = {};
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = CN_IDX_PROC;
+  addr.nl_pid = 0;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+    Status s = error::Internal("Failed to bind netlink connector socket: $0", std::strerror(errno));
+    close(fd);
+    return s;
+  }
+
+  Status s = SendMcastOp(fd, PROC_CN_MCAST_LISTEN);
+  if (!s.ok()) {
+    close(fd);
+    return s;
+  }
+
+  return std::unique_ptr<NetlinkProcEventSource>(new NetlinkProcEventSource(fd, config));
+}
+
+NetlinkProcEventSource::NetlinkProcEventSource(int fd, const system::Config& config)
+    : fd_(fd), proc_parser_(config) {
+  thread_ = std::thread(&NetlinkProcEventSource::Run, this);
+}
+
+NetlinkProcEventSource::~NetlinkProcEventSource() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  PL_UNUSED(SendMcastOp(fd_, PROC_CN_MCAST_IGNORE));
+  close(fd_);
+}
+
+Status NetlinkProcEventSource::Drain(std::vector<ProcEvent>* events) {
+  std::lock_guard<std::mutex> lock(pending_lock_);
+  for (auto& event : pending_) {
+    events->push_back(std::move(event));
+  }
+  pending_.clear();
+  pending_started_.clear();
+
+  if (overflowed_) {
+    overflowed_ = false;
+    return error::ResourceUnavailable("Process events were dropped.");
+  }
+  return Status::OK();
+}
+
+void NetlinkProcEventSource::Run() {
+  struct pollfd pfd = {};
+  pfd.fd = fd_;
+  pfd.events = POLLIN;
+  while (!stop_) {
+    // Poll with a timeout so that stop_ is observed without needing a separate wakeup fd.
+    if (poll(&pfd, 1, kPollTimeoutMillis) > 0) {
+      ReadEvents();
+    }
+  }
+}
+
+void NetlinkProcEventSource::ReadEvents() {
+  alignas(struct nlmsghdr) char buf[8192];
+
+  while (true) {
+    ssize_t len = recv(fd_, buf, sizeof(buf), 0);
+    if (len < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == ENOBUFS) {
+        // The kernel dropped events. Keep reading; the consumer resynchronizes with a full scan.
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        overflowed_ = true;
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        LOG(ERROR) << "Failed to read from netlink connector socket: " << std::strerror(errno);
+      }
+      return;
+    }
+
+    for (auto* nl_hdr = reinterpret_cast<struct nlmsghdr*>(buf); NLMSG_OK(nl_hdr, len);
+         nl_hdr = NLMSG_NEXT(nl_hdr, len)) {
+      if (nl_hdr->nlmsg_type == NLMSG_ERROR || nl_hdr->nlmsg_type == NLMSG_NOOP) {
+        continue;
+      }
+      const auto* cn_hdr = reinterpret_cast<const struct cn_msg*>(NLMSG_DATA(nl_hdr));
+      if (cn_hdr->id.idx != CN_IDX_PROC || cn_hdr->id.val != CN_VAL_PROC ||
+          cn_hdr->len < sizeof(struct proc_event)) {
+        continue;
+      }
+      const auto* ev = reinterpret_cast<const struct proc_event*>(cn_hdr->data);
+
+      switch (ev->what) {
+        case proc_event::PROC_EVENT_FORK:
+          // Thread creation is reported as a fork whose child is not a group leader.
+          if (ev->event_data.fork.child_pid == ev->event_data.fork.child_tgid) {
+            AddStartedEvent(static_cast<uint32_t>(ev->event_data.fork.child_tgid));
+          }
+          break;
+        case proc_event::PROC_EVENT_EXEC:
+          AddStartedEvent(static_cast<uint32_t>(ev->event_data.exec.process_tgid));
+          break;
+        case proc_event::PROC_EVENT_EXIT:
+          if (ev->event_data.exit.process_pid == ev->event_data.exit.process_tgid) {
+            AddTerminatedEvent(static_cast<uint32_t>(ev->event_data.exit.process_tgid));
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+}
+
+void NetlinkProcEventSource::AddStartedEvent(uint32_t pid) {
+  // Capture everything needed to attribute the process now, while it is still alive.
+  // Reads happen outside of the lock so that Drain() is never blocked on procfs.
+  StatusOr<int64_t> start_time = proc_parser_.GetPIDStartTimeTicks(pid);
+  StatusOr<std::vector<std::string>> cgroup_paths = proc_parser_.GetPIDCGroupPaths(pid);
+  if (!start_time.ok() || !cgroup_paths.ok()) {
+    // Already gone. The matching exit event is ignored since the pid was never tracked.
+    return;
+  }
+  ProcEvent event;
+  event.type = ProcEvent::Type::kStarted;
+  event.pid = pid;
+  event.start_time_ticks = start_time.ConsumeValueOrDie();
+  event.cgroup_paths = cgroup_paths.ConsumeValueOrDie();
+  event.exe_path = proc_parser_.GetExePath(event.pid).ValueOr("");
+  event.cmdline = proc_parser_.GetPIDCmdline(event.pid);
+
+  std::lock_guard<std::mutex> lock(pending_lock_);
+  auto iter = pending_started_.find(event.pid);
+  if (iter != pending_started_.end() &&
+      pending_[iter->second].start_time_ticks == event.start_time_ticks) {
+    // An exec following a fork: same process, newer exe and cmdline.
+    pending_[iter->second] = std::move(event);
+    return;
+  }
+  if (pending_.size() >= kMaxPendingEvents) {
+    overflowed_ = true;
+    return;
+  }
+  pending_started_[event.pid] = pending_.size();
+  pending_.push_back(std::move(event));
+}
+
+void NetlinkProcEventSource::AddTerminatedEvent(uint32_t pid) {
+  std::lock_guard<std::mutex> lock(pending_lock_);
+  // A later start of the same pid is a different process, so it must not be folded.
+  pending_started_.erase(pid);
+  if (pending_.size() >= kMaxPendingEvents) {
+    overflowed_ = true;
+    return;
+  }
+  ProcEvent event;
+  event.type = ProcEvent::Type::kTerminated;
+  event.pid = pid;
+  pending_.push_back(std::move(event));
+}
+
+}  // namespace md
+}  // namespace px
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+#include "src/common/system/system.h"
+
+namespace px {
+namespace md {
+
+/**
+ * A process lifecycle event. Only whole processes (thread group leaders) are reported;
+ * thread creation and exit are filtered out by the source.
+ */
+struct ProcEvent {
+  enum class Type {
+    kStarted,
+    kTerminated,
+  };
+
+  Type type;
+  uint32_t pid;
+
+  // The fields below are only set for kStarted. They are captured when the event is received,
+  // so that processes which exit before the next metadata update can still be attributed.
+  int64_t start_time_ticks = 0;
+  std::string exe_path;
+  std::string cmdline;
+  std::vector<std::string> cgroup_paths;
+};
+
+/**
+ * ProcEventSource delivers process start/exit notifications, so that the metadata state can be
+ * updated incrementally instead of rescanning every container's cgroup on each update.
+ */
+class ProcEventSource : public NotCopyable {
+ public:
+  virtual ~ProcEventSource() = default;
+
+  /**
+   * Moves all events received since the last call into events, in arrival order.
+   * Returns an error if events may have been lost (e.g. the receive buffer overflowed), in which
+   * case the caller must fall back to a full scan to resynchronize.
+   */
+  virtual Status Drain(std::vector<ProcEvent>* events) = 0;
+};
+
+/**
+ * Receives process events from the kernel through the netlink proc connector
+ * (NETLINK_CONNECTOR/CN_IDX_PROC) on a background thread. Requires CAP_NET_ADMIN.
+ */
+class NetlinkProcEventSource : public ProcEventSource {
+ public:
+  static StatusOr<std::unique_ptr<NetlinkProcEventSource>> Create(const system::Config& config);
+
+  ~NetlinkProcEventSource() override;
+
+  Status Drain(std::vector<ProcEvent>* events) override;
+
+ private:
+  NetlinkProcEventSource(int fd, const system::Config& config);
+
+  void Run();
+  void ReadEvents();
+  void AddStartedEvent(uint32_t pid);
+  void AddTerminatedEvent(uint32_t pid);
+
+  int fd_ = -1;
+  system::ProcParser proc_parser_;
+
+  std::atomic<bool> stop_ = false;
+  std::thread thread_;
+
+  std::mutex pending_lock_;
+  std::vector<ProcEvent> pending_;
+  // Index into pending_ of the latest started event of each pid, used to fold the exec that
+  // usually follows a fork into a single event.
+  absl::flat_hash_map<uint32_t, size_t> pending_started_;
+  bool overflowed_ = false;
+};
+
+}  // namespace md
+}  // namespace px
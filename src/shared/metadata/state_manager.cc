@@ -21,8 +21,16 @@
 #include <vector>
 
 #include <absl/base/internal/spinlock.h>
+#include <absl/strings/strip.h>
 #include "src/shared/metadata/state_manager.h"
 
+DEFINE_bool(metadata_proc_events, true,
+            "Track process starts/exits with the netlink proc connector, instead of scanning the "
+            "cgroups of all containers on every metadata update.");
+DEFINE_uint64(metadata_pid_reconcile_epochs, 12,
+              "When process events are enabled, the number of metadata updates between full "
+              "cgroup scans that reconcile any missed events.");
+
 namespace px {
 namespace md {
 
@@ -52,6 +60,49 @@ std::unique_ptr<PIDStatusEvent> AgentMetadataStateManagerImpl::GetNextPIDStatusE
   return found ? std::move(event) : nullptr;
 }
 
+void AgentMetadataStateManagerImpl::InitProcEventSource(const px::system::Config& config) {
+  if (!FLAGS_metadata_proc_events) {
+    return;
+  }
+  auto source_or = NetlinkProcEventSource::Create(config);
+  if (!source_or.ok()) {
+    LOG(WARNING) << absl::Substitute(
+        "Process events are unavailable, falling back to periodic PID scans [msg=$0]",
+        source_or.msg());
+    return;
+  }
+  proc_event_source_ = source_or.ConsumeValueOrDie();
+}
+
+Status AgentMetadataStateManagerImpl::UpdatePIDs(int64_t ts, uint64_t epoch_id,
+                                                 AgentMetadataState* shadow_state) {
+  bool full_scan = proc_event_source_ == nullptr ||
+                   FLAGS_metadata_pid_reconcile_epochs == 0 ||
+                   epoch_id % FLAGS_metadata_pid_reconcile_epochs == 0;
+
+  std::vector<ProcEvent> proc_events;
+  if (proc_event_source_ != nullptr) {
+    // Always drain, so that a full scan starts from a clean slate. Events that raced with the scan
+    // are applied on the next update; applying them is idempotent.
+    Status s = proc_event_source_->Drain(&proc_events);
+    if (!s.ok()) {
+      LOG(WARNING) << absl::Substitute("Process events were lost, doing a full PID scan [msg=$0]",
+                                       s.msg());
+      full_scan = true;
+    }
+  }
+
+  if (full_scan) {
+    return ProcessPIDUpdates(ts, proc_parser_, shadow_state, md_reader_.get(), &pid_updates_);
+  }
+
+  ProcessPIDEvents(ts, proc_events, shadow_state, &pid_updates_);
+  // Containers reported by K8s after their processes started never see a start event for those
+  // processes, so seed them with a scan of just their cgroups.
+  return ProcessPIDUpdates(ts, proc_parser_, shadow_state, md_reader_.get(), &pid_updates_,
+                           /* untracked_containers_only */ true);
+}
+
 Status AgentMetadataStateManagerImpl::AddK8sUpdate(std::unique_ptr<ResourceUpdate> update) {
   incoming_k8s_updates_.enqueue(std::move(update));
   return Status::OK();
@@ -90,8 +141,7 @@ Status AgentMetadataStateManagerImpl::PerformMetadataStateUpdate() {
 
   if (collects_data_) {
     // Update PID information.
-    PL_RETURN_IF_ERROR(
-        ProcessPIDUpdates(ts, proc_parser_, shadow_state.get(), md_reader_.get(), &pid_updates_));
+    PL_RETURN_IF_ERROR(UpdatePIDs(ts, epoch_id, shadow_state.get()));
   }
 
   // Update the pod/service CIDRs if they have been updated.
@@ -227,10 +277,20 @@ void ProcessContainerPIDUpdates(
 Status ProcessPIDUpdates(
     int64_t ts, const system::ProcParser& proc_parser, AgentMetadataState* md,
     CGroupMetadataReader* md_reader,
-    moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates) {
-  const auto& k8s_md_state = md->k8s_metadata_state();
+    moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates,
+    bool untracked_containers_only) {
+  K8sMetadataState* k8s_md_state = md->k8s_metadata_state();
+
+  // Collect the IDs up front, since modifying a container may replace the map shards that hold it.
+  std::vector<InternedString> cids;
+  cids.reserve(k8s_md_state->containers_by_id().size());
+  for (const auto& entry : k8s_md_state->containers_by_id()) {
+    cids.push_back(entry.first);
+  }
 
-  for (const auto& [cid, cinfo] : k8s_md_state->containers_by_id()) {
+  for (const auto& interned_cid : cids) {
+    const CID& cid = interned_cid.str();
+    const ContainerInfo* cinfo = k8s_md_state->ContainerInfoByID(interned_cid);
     if (cinfo->stop_time_ns() != 0) {
       // Ignore dead containers.
       // TODO(zasgar): Come up with a cleaner way of doing this. Probably by using active/inactive
@@ -239,6 +299,10 @@ Status ProcessPIDUpdates(
       continue;
     }
 
+    if (untracked_containers_only && !cinfo->active_upids().empty()) {
+      continue;
+    }
+
     // For every container:
     //   1. Read the current PIDs (from cgroups).
     //   2. Get the list of current PIDs (from metadata).
@@ -256,7 +320,7 @@ Status ProcessPIDUpdates(
     if (pod_info->stop_time_ns() != 0) {
       VLOG(1) << absl::Substitute("Found a running container in a deleted pod [cid=$0, pod_id=$1]",
                                   cid, pod_id);
-      cinfo->set_stop_time_ns(pod_info->stop_time_ns());
+      k8s_md_state->MutableContainerInfoByID(cid)->set_stop_time_ns(pod_info->stop_time_ns());
       continue;
     }
 
@@ -274,22 +338,120 @@ Status ProcessPIDUpdates(
       // NOTE: Currently, MDS sends pods that do no belong to this Agent, so this is actually
       // required to avoid repeatedly printing out the warning message above.
       if (error::IsNotFound(s)) {
-        cinfo->set_stop_time_ns(ts);
-        for (const auto& upid : cinfo->active_upids()) {
+        ContainerInfo* mutable_cinfo = k8s_md_state->MutableContainerInfoByID(cid);
+        mutable_cinfo->set_stop_time_ns(ts);
+        for (const auto& upid : mutable_cinfo->active_upids()) {
           md->MarkUPIDAsStopped(upid, ts);
         }
-        cinfo->mutable_active_upids()->clear();
+        mutable_cinfo->mutable_active_upids()->clear();
       }
       continue;
     }
 
-    ProcessContainerPIDUpdates(cid, ts, proc_parser, md, cinfo->mutable_active_upids(),
+    ProcessContainerPIDUpdates(cid, ts, proc_parser, md,
+                               k8s_md_state->MutableContainerInfoByID(cid)->mutable_active_upids(),
                                &cgroups_active_pids, pid_updates);
   }
 
   return Status::OK();
 }
 
+namespace {
+
+// Finds the container of a process from its cgroup paths. Container runtimes name the leaf cgroup
+// after the container ID, optionally with a runtime prefix and a ".scope" suffix when using the
+// systemd cgroup driver (e.g. "cri-containerd-<cid>.scope").
+const ContainerInfo* ContainerForCGroupPaths(const std::vector<std::string>& cgroup_paths,
+                                             const K8sMetadataState& k8s_md_state) {
+  const auto& containers = k8s_md_state.containers_by_id();
+  for (const auto& path : cgroup_paths) {
+    std::string_view leaf = path;
+    size_t pos = leaf.rfind('/');
+    if (pos != std::string_view::npos) {
+      leaf.remove_prefix(pos + 1);
+    }
+    absl::ConsumeSuffix(&leaf, ".scope");
+
+    auto iter = containers.find(InternedString::Find(leaf));
+    if (iter == containers.end()) {
+      pos = leaf.rfind('-');
+      if (pos != std::string_view::npos) {
+        iter = containers.find(InternedString::Find(leaf.substr(pos + 1)));
+      }
+    }
+    if (iter != containers.end()) {
+      return iter->second.get();
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+void ProcessPIDEvents(
+    int64_t ts, const std::vector<ProcEvent>& proc_events, AgentMetadataState* md,
+    moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates) {
+  if (proc_events.empty()) {
+    return;
+  }
+  K8sMetadataState* k8s_md_state = md->k8s_metadata_state();
+
+  // Exit events only carry the pid.
+  absl::flat_hash_map<uint32_t, UPID> upids_by_pid;
+  for (const auto& upid : md->upids()) {
+    upids_by_pid.emplace(upid.pid(), upid);
+  }
+
+  for (const auto& event : proc_events) {
+    switch (event.type) {
+      case ProcEvent::Type::kStarted: {
+        UPID upid(md->asid(), event.pid, event.start_time_ticks);
+        if (md->upids().contains(upid)) {
+          // Already tracked, e.g. an exec by a process that was picked up by a scan.
+          break;
+        }
+        const ContainerInfo* found = ContainerForCGroupPaths(event.cgroup_paths, *k8s_md_state);
+        if (found == nullptr || found->stop_time_ns() != 0 || found->pod_id().empty()) {
+          // Not a process of a running container on this node (or not yet known to K8s).
+          break;
+        }
+
+        ContainerInfo* cinfo = k8s_md_state->MutableContainerInfoByID(found->cid());
+        cinfo->mutable_active_upids()->emplace(upid);
+        auto pid_info = std::make_unique<PIDInfo>(upid, event.exe_path, event.cmdline, cinfo->cid());
+
+        // Push creation events to the queue.
+        pid_updates->enqueue(std::make_unique<PIDStartedEvent>(*pid_info));
+
+        md->AddUPID(upid, std::move(pid_info));
+        upids_by_pid[event.pid] = upid;
+        break;
+      }
+      case ProcEvent::Type::kTerminated: {
+        auto iter = upids_by_pid.find(event.pid);
+        if (iter == upids_by_pid.end()) {
+          break;
+        }
+        UPID upid = iter->second;
+        upids_by_pid.erase(iter);
+
+        const PIDInfo* pid_info = md->GetPIDByUPID(upid);
+        if (pid_info != nullptr) {
+          ContainerInfo* cinfo = k8s_md_state->MutableContainerInfoByID(pid_info->cid());
+          if (cinfo != nullptr) {
+            cinfo->mutable_active_upids()->erase(upid);
+          }
+        }
+        md->MarkUPIDAsStopped(upid, ts);
+
+        // Push deletion events to the queue.
+        pid_updates->enqueue(std::make_unique<PIDTerminatedEvent>(upid, ts));
+        break;
+      }
+    }
+  }
+}
+
 Status DeleteMetadataForDeadObjects(AgentMetadataState* state, int64_t retention_time) {
   PL_RETURN_IF_ERROR(state->k8s_metadata_state()->CleanupExpiredMetadata(retention_time));
   return Status::OK();
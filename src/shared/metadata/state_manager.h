@@ -37,6 +37,7 @@
 #include "src/shared/metadata/metadata_filter.h"
 #include "src/shared/metadata/metadata_state.h"
 #include "src/shared/metadata/pids.h"
+#include "src/shared/metadata/proc_event_source.h"
 #include "src/shared/metadatapb/metadata.pb.h"
 #include "src/shared/upid/upid.h"
 
@@ -128,6 +129,9 @@ class AgentMetadataStateManagerImpl : public AgentMetadataStateManager {
     md_reader_ = std::make_unique<CGroupMetadataReader>(config);
     agent_metadata_state_ = std::make_shared<AgentMetadataState>(hostname, asid, pid, agent_id,
                                                                  pod_name, vizier_id, vizier_name);
+    if (collects_data_) {
+      InitProcEventSource(config);
+    }
   }
 
   AgentMetadataFilter* metadata_filter() const override { return metadata_filter_; }
@@ -158,8 +162,22 @@ class AgentMetadataStateManagerImpl : public AgentMetadataStateManager {
    */
   size_t NumPIDUpdates() const;
 
+  /**
+   * Subscribes to process lifecycle events. On failure, PID updates fall back to scanning the
+   * cgroups of every container on each update.
+   */
+  void InitProcEventSource(const px::system::Config& config);
+
+  /**
+   * Updates the PIDs of the shadow state, either incrementally from process events, or by a full
+   * scan of the container cgroups when events are unavailable or a reconciliation is due.
+   */
+  Status UpdatePIDs(int64_t ts, uint64_t epoch_id, AgentMetadataState* shadow_state);
+
   std::string pod_name_;
   system::ProcParser proc_parser_;
+  // Null if process events are not available, in which case every update does a full scan.
+  std::unique_ptr<ProcEventSource> proc_event_source_;
 
   std::unique_ptr<CGroupMetadataReader> md_reader_;
   // The metadata state stored here is immutable so that we can easily share a read only
@@ -194,10 +212,21 @@ Status ApplyK8sUpdates(
 void RemoveDeadPods(int64_t ts, AgentMetadataState* md, CGroupMetadataReader* md_reader);
 
 /**
- * Processes PID updates.
+ * Processes PID updates by diffing the PIDs in each container's cgroup against the tracked ones.
+ * If untracked_containers_only is set, only containers without any tracked PIDs are scanned;
+ * this picks up containers whose processes started before the container itself was known.
  */
 Status ProcessPIDUpdates(
     int64_t ts, const system::ProcParser& proc_parser, AgentMetadataState*, CGroupMetadataReader*,
+    moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates,
+    bool untracked_containers_only = false);
+
+/**
+ * Applies process start/exit events to the current state. Processes that cannot be attributed
+ * to a known, running container are ignored.
+ */
+void ProcessPIDEvents(
+    int64_t ts, const std::vector<ProcEvent>& proc_events, AgentMetadataState* md,
     moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates);
 
 /**
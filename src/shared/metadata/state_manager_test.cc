@@ -280,6 +280,57 @@ TEST_F(AgentMetadataStateTest, pid_created) {
   EXPECT_THAT(pids_started, UnorderedElementsAre(PIDStartedEvent{pid1}, PIDStartedEvent{pid2}));
 }
 
+TEST_F(AgentMetadataStateTest, pid_events) {
+  moodycamel::BlockingConcurrentQueue<std::unique_ptr<ResourceUpdate>> updates;
+  GenerateTestUpdateEvents(&updates);
+
+  EXPECT_OK(ApplyK8sUpdates(2000 /*ts*/, &metadata_state_, &md_filter_, &updates));
+
+  std::vector<ProcEvent> proc_events = {
+      {ProcEvent::Type::kStarted, 100, 1000, "/bin/foo", "cmdline100",
+       {"/kubepods/burstable/podpod_id1/container_id1"}},
+      // A host process, which is not attributed to any container.
+      {ProcEvent::Type::kStarted, 300, 3000, "/bin/bar", "cmdline300", {"/user.slice"}},
+      {ProcEvent::Type::kTerminated, 300, 0, "", "", {}},
+      // Leaf cgroup name as created by the systemd cgroup driver.
+      {ProcEvent::Type::kStarted, 200, 2000, "", "cmdline200",
+       {"/kubepods.slice/kubepods-burstable.slice/cri-containerd-container_id1.scope"}},
+      {ProcEvent::Type::kTerminated, 100, 0, "", "", {}},
+  };
+
+  moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>> events;
+  ProcessPIDEvents(3000 /*ts*/, proc_events, &metadata_state_, &events);
+
+  std::unique_ptr<PIDStatusEvent> event;
+  std::vector<PIDStartedEvent> pids_started;
+  std::vector<UPID> pids_terminated;
+  while (events.try_dequeue(event)) {
+    if (event->type == PIDStatusEventType::kStarted) {
+      pids_started.emplace_back(*static_cast<PIDStartedEvent*>(event.get()));
+    } else {
+      pids_terminated.push_back(static_cast<PIDTerminatedEvent*>(event.get())->upid);
+    }
+  }
+
+  UPID upid1(kASID, 100 /*pid*/, 1000 /*ts*/);
+  UPID upid2(kASID, 200 /*pid*/, 2000 /*ts*/);
+  PIDInfo pid1(upid1, "/bin/foo", "cmdline100", "container_id1");
+  PIDInfo pid2(upid2, "", "cmdline200", "container_id1");
+
+  EXPECT_THAT(pids_started, ElementsAre(PIDStartedEvent{pid1}, PIDStartedEvent{pid2}));
+  EXPECT_THAT(pids_terminated, ElementsAre(upid1));
+
+  EXPECT_THAT(metadata_state_.upids(), UnorderedElementsAre(upid2));
+  const auto* container_info =
+      metadata_state_.k8s_metadata_state()->ContainerInfoByID("container_id1");
+  ASSERT_NE(nullptr, container_info);
+  EXPECT_THAT(container_info->active_upids(), ElementsAre(upid2));
+
+  // Replaying the same events must not produce duplicate updates.
+  ProcessPIDEvents(4000 /*ts*/, {proc_events[3]}, &metadata_state_, &events);
+  EXPECT_EQ(0, events.size_approx());
+}
+
 TEST_F(AgentMetadataStateTest, insert_into_filter) {
   moodycamel::BlockingConcurrentQueue<std::unique_ptr<ResourceUpdate>> updates;
   GenerateTestUpdateEvents(&updates);
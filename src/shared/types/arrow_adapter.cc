@@ -37,6 +37,10 @@ namespace types {
 
 using arrow::Type;
 DataType ArrowToDataType(const arrow::Type::type& arrow_type) {
+  // The only dictionary encoded columns are STRING columns (see MakeStringDictionaryArray).
+  if (arrow_type == arrow::Type::DICTIONARY) {
+    return DataType::STRING;
+  }
 #define EXPR_CASE(_dt_) DataTypeTraits<_dt_>::arrow_type_id
 #define TYPE_CASE(_dt_) return _dt_;
   PL_SWITCH_FOREACH_DATATYPE_WITHEXPR(arrow_type, EXPR_CASE, TYPE_CASE);
@@ -58,6 +62,34 @@ int64_t ArrowTypeToBytes(const arrow::Type::type& arrow_type) {
 #undef TYPE_CASE
 }
 
+std::shared_ptr<arrow::Array> MakeStringDictionaryArray(
+    const std::shared_ptr<arrow::Array>& codes, const std::shared_ptr<arrow::Array>& values) {
+  DCHECK_EQ(codes->type_id(), arrow::Type::INT32);
+  DCHECK_EQ(values->type_id(), arrow::Type::STRING);
+  return std::make_shared<arrow::DictionaryArray>(arrow::dictionary(arrow::int32(), arrow::utf8()),
+                                                  codes, values);
+}
+
+std::shared_ptr<arrow::Array> DecodeStringDictionaryArray(const arrow::Array* arr,
+                                                          arrow::MemoryPool* mem_pool) {
+  const auto* codes = DictionaryCodes(arr);
+  const auto* values = DictionaryValues(arr);
+  int64_t total_size = 0;
+  for (int64_t i = 0; i < codes->length(); ++i) {
+    total_size += values->value_length(codes->Value(i));
+  }
+  arrow::StringBuilder builder(mem_pool);
+  PL_CHECK_OK(builder.Reserve(codes->length()));
+  PL_CHECK_OK(builder.ReserveData(total_size));
+  for (int64_t i = 0; i < codes->length(); ++i) {
+    auto value = values->GetView(codes->Value(i));
+    builder.UnsafeAppend(value.data(), static_cast<int32_t>(value.size()));
+  }
+  std::shared_ptr<arrow::Array> out;
+  PL_CHECK_OK(builder.Finish(&out));
+  return out;
+}
+
 #define BUILDER_CASE(__data_type__, __pool__) \
   case __data_type__:                         \
     return std::make_unique<DataTypeTraits<__data_type__>::arrow_builder_type>(__pool__)
@@ -141,7 +141,44 @@ constexpr auto GetValueFromArrowArray(const arrow::Array* arg, int64_t idx) {
   return GetValue(static_cast<const arrow_array_type*>(arg), idx);
 }
 
+/**
+ * Dictionary encoded STRING columns are arrow::DictionaryArrays of int32 codes into a StringArray
+ * of values. Only the exec nodes that read the codes see them; everything else gets the column
+ * materialized with DecodeStringDictionaryArray.
+ */
+inline bool IsDictionaryEncoded(const arrow::Array* arr) {
+  return arr->type_id() == arrow::Type::DICTIONARY;
+}
+
+inline const arrow::Int32Array* DictionaryCodes(const arrow::Array* arr) {
+  DCHECK(IsDictionaryEncoded(arr));
+  return static_cast<const arrow::Int32Array*>(
+      static_cast<const arrow::DictionaryArray*>(arr)->indices().get());
+}
+
+inline const arrow::StringArray* DictionaryValues(const arrow::Array* arr) {
+  DCHECK(IsDictionaryEncoded(arr));
+  return static_cast<const arrow::StringArray*>(
+      static_cast<const arrow::DictionaryArray*>(arr)->dictionary().get());
+}
+
+/**
+ * Makes a dictionary encoded STRING column from int32 codes and the StringArray they index.
+ */
+std::shared_ptr<arrow::Array> MakeStringDictionaryArray(
+    const std::shared_ptr<arrow::Array>& codes, const std::shared_ptr<arrow::Array>& values);
+
+/**
+ * Materializes a dictionary encoded STRING column as a plain StringArray.
+ */
+std::shared_ptr<arrow::Array> DecodeStringDictionaryArray(const arrow::Array* arr,
+                                                          arrow::MemoryPool* mem_pool);
+
 inline std::string_view GetStringViewFromArrowArray(const arrow::Array* arr, int64_t idx) {
+  if (IsDictionaryEncoded(arr)) {
+    idx = DictionaryCodes(arr)->Value(idx);
+    arr = DictionaryValues(arr);
+  }
   DCHECK(arr->type_id() == arrow::Type::STRING);
   auto arrow_string_view = static_cast<const arrow::StringArray*>(arr)->GetView(idx);
   return std::string_view(arrow_string_view.data(), arrow_string_view.size());
@@ -154,6 +191,11 @@ inline int64_t GetArrowArrayBytes(const arrow::Array* arr) {
 
 template <>
 inline int64_t GetArrowArrayBytes<types::DataType::STRING>(const arrow::Array* arr) {
+  if (IsDictionaryEncoded(arr)) {
+    // The codes plus the distinct values they point at.
+    return arr->length() * sizeof(int32_t) +
+           GetArrowArrayBytes<types::DataType::STRING>(DictionaryValues(arr));
+  }
   int64_t total_bytes = 0;
   // Loop through each string in the Arrow array.
   for (int64_t i = 0; i < arr->length(); i++) {
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/shared/types/string_dictionary.h"
+
+#include <arrow/builder.h>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace types {
+
+int32_t StringDictionary::Insert(std::string_view value) {
+  auto it = codes_.find(value);
+  if (it != codes_.end()) {
+    return it->second;
+  }
+  int32_t code = values_.size();
+  const auto& stored = values_.emplace_back(value);
+  codes_.emplace(stored, code);
+  return code;
+}
+
+void StringDictionary::Clear() {
+  codes_.clear();
+  values_.clear();
+}
+
+std::shared_ptr<arrow::Array> StringDictionary::ToArrow(arrow::MemoryPool* mem_pool) const {
+  int64_t total_size = 0;
+  for (const auto& value : values_) {
+    total_size += value.size();
+  }
+  arrow::StringBuilder builder(mem_pool);
+  PL_CHECK_OK(builder.Reserve(values_.size()));
+  PL_CHECK_OK(builder.ReserveData(total_size));
+  for (const auto& value : values_) {
+    builder.UnsafeAppend(value);
+  }
+  std::shared_ptr<arrow::Array> out;
+  PL_CHECK_OK(builder.Finish(&out));
+  return out;
+}
+
+}  // namespace types
+}  // namespace px
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace px {
+namespace types {
+
+/**
+ * StringDictionary assigns dense int32 codes to distinct strings, in insertion order. It backs
+ * the dictionary encoded STRING columns built by exec nodes (see MakeStringDictionaryArray).
+ */
+class StringDictionary {
+ public:
+  /**
+   * Returns the code of value, adding it to the dictionary if it hasn't been seen yet.
+   * Looking up an existing value does not allocate.
+   */
+  int32_t Insert(std::string_view value);
+
+  const std::string& value(int32_t code) const { return values_[code]; }
+  size_t size() const { return values_.size(); }
+  void Clear();
+
+  /**
+   * Returns the values as a StringArray, indexed by code.
+   */
+  std::shared_ptr<arrow::Array> ToArrow(arrow::MemoryPool* mem_pool) const;
+
+ private:
+  // A deque so that the views used as keys stay valid as values are added.
+  std::deque<std::string> values_;
+  absl::flat_hash_map<std::string_view, int32_t> codes_;
+};
+
+}  // namespace types
+}  // namespace px
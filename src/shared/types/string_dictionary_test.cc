@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <arrow/builder.h>
+
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/string_dictionary.h"
+
+namespace px {
+namespace types {
+
+TEST(StringDictionary, insert_assigns_dense_codes) {
+  StringDictionary dict;
+  EXPECT_EQ(0, dict.Insert("GET"));
+  EXPECT_EQ(1, dict.Insert("POST"));
+  EXPECT_EQ(0, dict.Insert(std::string("GET")));
+  EXPECT_EQ(2, dict.Insert(""));
+  EXPECT_EQ(3, dict.size());
+  EXPECT_EQ("POST", dict.value(1));
+
+  dict.Clear();
+  EXPECT_EQ(0, dict.size());
+  EXPECT_EQ(0, dict.Insert("POST"));
+}
+
+TEST(StringDictionary, keys_survive_growth) {
+  StringDictionary dict;
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i, dict.Insert(absl::StrCat("pl/pod-", i)));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i, dict.Insert(absl::StrCat("pl/pod-", i)));
+  }
+}
+
+TEST(StringDictionary, to_dictionary_array_and_decode) {
+  StringDictionary dict;
+  arrow::Int32Builder codes_builder;
+  for (const auto* value : {"pl/a", "pl/b", "pl/a", "pl/c", "pl/b"}) {
+    ASSERT_TRUE(codes_builder.Append(dict.Insert(value)).ok());
+  }
+  std::shared_ptr<arrow::Array> codes;
+  ASSERT_TRUE(codes_builder.Finish(&codes).ok());
+
+  auto arr = MakeStringDictionaryArray(codes, dict.ToArrow(arrow::default_memory_pool()));
+  ASSERT_TRUE(IsDictionaryEncoded(arr.get()));
+  EXPECT_EQ(DataType::STRING, ArrowToDataType(arr->type_id()));
+  EXPECT_EQ(3, DictionaryValues(arr.get())->length());
+  EXPECT_EQ("pl/c", GetStringViewFromArrowArray(arr.get(), 3));
+
+  auto decoded = DecodeStringDictionaryArray(arr.get(), arrow::default_memory_pool());
+  ASSERT_EQ(arrow::Type::STRING, decoded->type_id());
+  std::vector<std::string> expected = {"pl/a", "pl/b", "pl/a", "pl/c", "pl/b"};
+  ASSERT_EQ(expected.size(), decoded->length());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], GetValueFromArrowArray<DataType::STRING>(decoded.get(), i));
+  }
+  // Five codes plus "pl/a", "pl/b" and "pl/c".
+  EXPECT_EQ(5 * sizeof(int32_t) + 12, GetArrowArrayBytes<DataType::STRING>(arr.get()));
+}
+
+}  // namespace types
+}  // namespace px
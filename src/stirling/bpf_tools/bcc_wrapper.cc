@@ -18,9 +18,14 @@
 
 #include "src/stirling/bpf_tools/bcc_wrapper.h"
 
+#include <linux/bpf.h>
 #include <linux/perf_event.h>
 #include <sys/mount.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -218,7 +223,8 @@ Status BCCWrapper::AttachUProbe(const UProbeSpec& probe) {
 
 Status BCCWrapper::AttachSamplingProbe(const SamplingProbeSpec& probe) {
   constexpr uint64_t kNanosPerMilli = 1000 * 1000;
-  const uint64_t sample_period = probe.period_millis * kNanosPerMilli;
+  const uint64_t sample_period =
+      probe.period_nanos != 0 ? probe.period_nanos : probe.period_millis * kNanosPerMilli;
   // A sampling probe is just a PerfEventProbe, where the perf event is a clock counter.
   // When a requisite number of clock samples occur, the kernel will trigger the BPF code.
   // By specifying a frequency, the kernel will attempt to adjust the threshold to achieve
@@ -430,6 +436,130 @@ void BCCWrapper::PollPerfBuffers(int timeout_ms) {
   }
 }
 
+namespace {
+
+// BCC keeps the file descriptor of a map in a protected member of its table classes.
+// This thin subclass exposes it, so that raw bpf(2) map commands can be issued on BCC maps.
+class BPFTableFDAccessor : public ebpf::BPFTable {
+ public:
+  explicit BPFTableFDAccessor(const ebpf::BPFTable& table) : ebpf::BPFTable(table) {}
+  int fd() const { return desc.fd; }
+};
+
+// ENOTSUPP is kernel-internal, and not exported by the errno headers.
+constexpr int kENOTSUPP = 524;
+
+}  // namespace
+
+int BCCWrapper::GetMapFD(const std::string& table_name) {
+  return BPFTableFDAccessor(bpf_.get_table(table_name)).fd();
+}
+
+void BCCWrapper::DisableBatchOps(int err) {
+  batch_ops_supported_ = false;
+  LOG(INFO) << absl::Substitute(
+      "BPF map batch operations not supported; falling back to per-key access. Message: $0",
+      std::strerror(err));
+}
+
+StatusOr<uint32_t> BCCWrapper::LookupBatchImpl(bool delete_entries, int map_fd, size_t key_size,
+                                               size_t value_size, uint32_t max_entries,
+                                               void* keys, void* values,
+                                               LookupBatchCursor* cursor) {
+  const int cmd = delete_entries ? BPF_MAP_LOOKUP_AND_DELETE_BATCH : BPF_MAP_LOOKUP_BATCH;
+  const char* cmd_name =
+      delete_entries ? "BPF_MAP_LOOKUP_AND_DELETE_BATCH" : "BPF_MAP_LOOKUP_BATCH";
+
+  // The batch token is opaque to user-space; for hash maps it is a bucket index,
+  // but the kernel may write up to key_size bytes into it.
+  cursor->token.resize(std::max({cursor->token.size(), key_size, sizeof(uint64_t)}));
+  cursor->chunk_too_small = false;
+
+  union bpf_attr attr = {};
+  attr.batch.map_fd = map_fd;
+  attr.batch.in_batch = cursor->started ? reinterpret_cast<uint64_t>(cursor->token.data()) : 0;
+  attr.batch.out_batch = reinterpret_cast<uint64_t>(cursor->token.data());
+  attr.batch.keys = reinterpret_cast<uint64_t>(keys);
+  attr.batch.values = reinterpret_cast<uint64_t>(values);
+  attr.batch.count = max_entries;
+
+  const int rc = syscall(__NR_bpf, cmd, &attr, sizeof(attr));
+  const int err = errno;
+
+  // The kernel reports the number of entries processed, even when returning an error.
+  const uint32_t count = attr.batch.count;
+
+  if (rc == 0) {
+    cursor->started = true;
+    return count;
+  }
+  if (err == ENOENT) {
+    // The map has been fully traversed.
+    cursor->done = true;
+    return count;
+  }
+  if (err == ENOSPC) {
+    // The next hash bucket holds more entries than fit in the buffers. Nothing was read, and
+    // the token points at that bucket, so the caller can retry with larger buffers.
+    cursor->started = true;
+    cursor->chunk_too_small = true;
+    return count;
+  }
+  if (!cursor->started && count == 0 &&
+      (err == EINVAL || err == EOPNOTSUPP || err == kENOTSUPP)) {
+    DisableBatchOps(err);
+  }
+  if (delete_entries && count > 0) {
+    // The entries read so far are already gone from the map, so hand them back rather than
+    // dropping them with the error.
+    LOG(WARNING) << absl::Substitute("$0 failed after $1 entries: $2", cmd_name, count,
+                                     std::strerror(err));
+    cursor->done = true;
+    return count;
+  }
+  return error::Internal("$0 failed: $1", cmd_name, std::strerror(err));
+}
+
+Status BCCWrapper::UpdateOrDeleteBatchImpl(bool is_delete, int map_fd, size_t key_size,
+                                           const void* keys, const void* values, uint32_t count) {
+  const int cmd = is_delete ? BPF_MAP_DELETE_BATCH : BPF_MAP_UPDATE_BATCH;
+  const char* cmd_name = is_delete ? "BPF_MAP_DELETE_BATCH" : "BPF_MAP_UPDATE_BATCH";
+
+  uint32_t total = 0;
+  while (total < count) {
+    union bpf_attr attr = {};
+    attr.batch.map_fd = map_fd;
+    attr.batch.keys =
+        reinterpret_cast<uint64_t>(static_cast<const uint8_t*>(keys) + total * key_size);
+    if (!is_delete) {
+      // Only deletes are resumed after a partial failure, so values always lines up with keys.
+      attr.batch.values = reinterpret_cast<uint64_t>(values);
+    }
+    attr.batch.count = count - total;
+
+    const int rc = syscall(__NR_bpf, cmd, &attr, sizeof(attr));
+    const int err = errno;
+
+    if (rc == 0) {
+      return Status::OK();
+    }
+
+    // The kernel stops at the first key that fails, and reports how many were processed.
+    total += attr.batch.count;
+    if (is_delete && err == ENOENT) {
+      // The key at index total is not in the map; skip it.
+      ++total;
+      continue;
+    }
+    if (total == 0 && (err == EINVAL || err == EOPNOTSUPP || err == kENOTSUPP)) {
+      DisableBatchOps(err);
+    }
+    return error::Internal("$0 failed: $1", cmd_name, std::strerror(err));
+  }
+
+  return Status::OK();
+}
+
 void BCCWrapper::Close() {
   DetachPerfEvents();
   ClosePerfBuffers();
@@ -34,6 +34,8 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <map>
 #include <memory>
@@ -149,6 +151,11 @@ struct SamplingProbeSpec {
 
   // Sampling period in milliseconds to trigger the probe.
   uint64_t period_millis;
+
+  // Sampling period in nanoseconds to trigger the probe. If non-zero, it takes precedence over
+  // period_millis. Used for sampling rates that are not a whole number of milliseconds
+  // (e.g. 997 Hz).
+  uint64_t period_nanos = 0;
 };
 
 /**
@@ -399,6 +406,116 @@ class BCCWrapper {
     return bpf_.get_percpu_array_table<TValueType>(table_name);
   }
 
+  /**
+   * Returns the file descriptor of a BPF map declared in the BPF program.
+   * Used to issue map commands that BCC does not wrap (e.g. batch operations).
+   */
+  int GetMapFD(const std::string& table_name);
+
+  /**
+   * Reads out all entries of a BPF hash map, in bulk.
+   *
+   * Uses BPF_MAP_LOOKUP_BATCH, which transfers many entries per syscall.
+   * On kernels without batch support (pre-5.6), falls back to iterating over the map,
+   * one key at a time.
+   *
+   * @param table_name The name of the hash map, from its declaration in the BPF program.
+   * @return The key-value pairs in the map.
+   */
+  template <typename TKeyType, typename TValueType>
+  StatusOr<std::vector<std::pair<TKeyType, TValueType>>> LookupBatch(
+      const std::string& table_name) {
+    return LookupBatchEntries<TKeyType, TValueType>(table_name, /* delete_entries */ false);
+  }
+
+  /**
+   * Reads out and deletes all entries of a BPF hash map, in bulk.
+   *
+   * Uses BPF_MAP_LOOKUP_AND_DELETE_BATCH, which transfers many entries per syscall.
+   * On kernels without batch support (pre-5.6), falls back to iterating over the map,
+   * one key at a time.
+   *
+   * @param table_name The name of the hash map, from its declaration in the BPF program.
+   * @return The key-value pairs that were in the map.
+   */
+  template <typename TKeyType, typename TValueType>
+  StatusOr<std::vector<std::pair<TKeyType, TValueType>>> LookupAndDeleteBatch(
+      const std::string& table_name) {
+    return LookupBatchEntries<TKeyType, TValueType>(table_name, /* delete_entries */ true);
+  }
+
+  /**
+   * Inserts or updates entries of a BPF hash map, in bulk.
+   *
+   * Uses BPF_MAP_UPDATE_BATCH, with a fallback to one update per key on older kernels.
+   *
+   * @param table_name The name of the hash map, from its declaration in the BPF program.
+   * @param keys The keys to update.
+   * @param values The values to set, one per key.
+   */
+  template <typename TKeyType, typename TValueType>
+  Status UpdateBatch(const std::string& table_name, const std::vector<TKeyType>& keys,
+                     const std::vector<TValueType>& values) {
+    DCHECK_EQ(keys.size(), values.size());
+    if (keys.empty()) {
+      return Status::OK();
+    }
+
+    if (batch_ops_supported_) {
+      Status s = UpdateOrDeleteBatchImpl(/* is_delete */ false, GetMapFD(table_name),
+                                         sizeof(TKeyType), keys.data(), values.data(),
+                                         keys.size());
+      if (s.ok() || batch_ops_supported_) {
+        return s;
+      }
+    }
+
+    auto table = GetHashTable<TKeyType, TValueType>(table_name);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      ebpf::StatusTuple s = table.update_value(keys[i], values[i]);
+      if (!s.ok()) {
+        return error::Internal("Could not update BPF map $0: $1", table_name, s.msg());
+      }
+    }
+    return Status::OK();
+  }
+
+  /**
+   * Deletes entries of a BPF hash map, in bulk. Keys that are not in the map are ignored.
+   *
+   * Uses BPF_MAP_DELETE_BATCH, with a fallback to one delete per key on older kernels.
+   *
+   * @param table_name The name of the hash map, from its declaration in the BPF program.
+   * @param keys The keys to delete.
+   */
+  template <typename TKeyType, typename TValueType>
+  Status DeleteBatch(const std::string& table_name, const std::vector<TKeyType>& keys) {
+    if (keys.empty()) {
+      return Status::OK();
+    }
+
+    if (batch_ops_supported_) {
+      Status s = UpdateOrDeleteBatchImpl(/* is_delete */ true, GetMapFD(table_name),
+                                         sizeof(TKeyType), keys.data(), nullptr, keys.size());
+      if (s.ok() || batch_ops_supported_) {
+        return s;
+      }
+    }
+
+    auto table = GetHashTable<TKeyType, TValueType>(table_name);
+    for (const auto& key : keys) {
+      // Deleting a missing key fails; that is not an error here.
+      table.remove_value(key);
+    }
+    return Status::OK();
+  }
+
+  /**
+   * Returns true if the running kernel supports batched BPF map operations.
+   * Only meaningful after a first batch operation has been attempted.
+   */
+  bool batch_ops_supported() const { return batch_ops_supported_; }
+
   // These are static counters of attached/open probes across all instances.
   // It is meant for verification that we have cleaned-up all resources in tests.
   static size_t num_attached_probes() { return num_attached_kprobes_ + num_attached_uprobes_; }
@@ -415,6 +532,90 @@ class BCCWrapper {
   Status DetachPerfEvent(const PerfEventSpec& perf_event);
   void PollPerfBuffer(std::string_view perf_buffer_name, int timeout_ms);
 
+  // The position of a batched lookup over a map, carried from one LookupBatchImpl() call to the
+  // next.
+  struct LookupBatchCursor {
+    std::vector<uint8_t> token;
+    bool started = false;
+    bool done = false;
+    // Set when the next hash bucket does not fit in the buffers that were passed in.
+    bool chunk_too_small = false;
+  };
+
+  // The number of entries read per batched lookup call. Maps are read in chunks of this size,
+  // so that scanning a large but mostly empty map does not allocate buffers for its capacity.
+  static constexpr uint32_t kLookupBatchChunkSize = 1024;
+
+  template <typename TKeyType, typename TValueType>
+  StatusOr<std::vector<std::pair<TKeyType, TValueType>>> LookupBatchEntries(
+      const std::string& table_name, bool delete_entries) {
+    std::vector<std::pair<TKeyType, TValueType>> entries;
+
+    if (batch_ops_supported_) {
+      auto table = GetHashTable<TKeyType, TValueType>(table_name);
+      const int map_fd = GetMapFD(table_name);
+      const size_t capacity = table.capacity();
+      std::vector<TKeyType> keys(std::min<size_t>(kLookupBatchChunkSize, capacity));
+      std::vector<TValueType> values(keys.size());
+
+      LookupBatchCursor cursor;
+      while (!cursor.done) {
+        StatusOr<uint32_t> count_or =
+            LookupBatchImpl(delete_entries, map_fd, sizeof(TKeyType), sizeof(TValueType),
+                            static_cast<uint32_t>(keys.size()), keys.data(), values.data(),
+                            &cursor);
+        if (!count_or.ok()) {
+          if (delete_entries && !entries.empty()) {
+            // Earlier chunks were already drained from the map; don't lose them.
+            LOG(WARNING) << count_or.msg();
+            return entries;
+          }
+          if (batch_ops_supported_) {
+            return count_or.status();
+          }
+          // Fall through to the non-batched path below.
+          break;
+        }
+        if (cursor.chunk_too_small) {
+          if (keys.size() >= capacity) {
+            return error::Internal("BPF map $0 has a bucket larger than its capacity", table_name);
+          }
+          keys.resize(std::min(2 * keys.size(), capacity));
+          values.resize(keys.size());
+          continue;
+        }
+        const uint32_t count = count_or.ValueOrDie();
+        for (uint32_t i = 0; i < count; ++i) {
+          entries.emplace_back(keys[i], values[i]);
+        }
+      }
+      if (batch_ops_supported_) {
+        return entries;
+      }
+    }
+
+    return GetHashTable<TKeyType, TValueType>(table_name).get_table_offline(delete_entries);
+  }
+
+  // Non-templated core of LookupBatch() and LookupAndDeleteBatch(). Issues one batched lookup of
+  // up to max_entries entries into the keys and values buffers, resuming from cursor, and returns
+  // the number of entries read. Sets cursor->done once the map has been fully traversed, and
+  // cursor->chunk_too_small if the buffers must grow before the next call.
+  // When deleting, an error after some entries were drained is logged, and the partial count is
+  // returned, since those entries can no longer be read again.
+  // Sets batch_ops_supported_ to false if the kernel rejects the batch command.
+  StatusOr<uint32_t> LookupBatchImpl(bool delete_entries, int map_fd, size_t key_size,
+                                     size_t value_size, uint32_t max_entries, void* keys,
+                                     void* values, LookupBatchCursor* cursor);
+
+  // Non-templated core of UpdateBatch() and DeleteBatch(). values is ignored for deletes.
+  // Sets batch_ops_supported_ to false if the kernel rejects the batch command.
+  Status UpdateOrDeleteBatchImpl(bool is_delete, int map_fd, size_t key_size, const void* keys,
+                                 const void* values, uint32_t count);
+
+  // Logs, once, that the kernel does not support batched map operations.
+  void DisableBatchOps(int err);
+
   // Detaches all kprobes/uprobes/perf buffers/perf events that were attached by the wrapper.
   // If any fails to detach, an error is logged, and the function continues.
   void DetachKProbes();
@@ -434,6 +635,11 @@ class BCCWrapper {
 
   std::string system_headers_include_dir_;
 
+  // Set to false the first time the kernel rejects a batched map operation,
+  // after which the non-batched fallbacks are used. Atomic because map operations are also
+  // issued from background threads (e.g. uprobe deployment).
+  std::atomic<bool> batch_ops_supported_ = true;
+
   // Initialize this with one of the below bitmask flags to turn on different debug output.
   // For example, bpf_{0x2} instructs to print the BPF bytecode.
   // See https://github.com/iovisor/bcc/blob/master/src/cc/bpf_module.h for the effects of these
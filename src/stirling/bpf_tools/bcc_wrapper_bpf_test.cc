@@ -191,6 +191,67 @@ TEST(BCCWrapperTest, TestMapClearingAPIs) {
   ASSERT_THAT(alphabet.get_table_offline(), IsEmpty());
 }
 
+TEST(BCCWrapperTest, TestMapBatchAPIs) {
+  bpf_tools::BCCWrapper bcc_wrapper;
+  std::string_view kProgram = "BPF_HASH(squares, uint32_t, uint64_t, 1024);";
+  ASSERT_OK(bcc_wrapper.InitBPFProgram(kProgram));
+
+  using ::testing::IsEmpty;
+  using ::testing::Pair;
+  using ::testing::UnorderedElementsAre;
+  using ::testing::UnorderedElementsAreArray;
+
+  std::vector<uint32_t> keys;
+  std::vector<uint64_t> values;
+  std::vector<std::pair<uint32_t, uint64_t>> expected;
+  for (uint32_t i = 0; i < 100; ++i) {
+    keys.push_back(i);
+    values.push_back(i * i);
+    expected.emplace_back(i, i * i);
+  }
+
+  // The batched APIs must behave identically, whether or not the kernel supports batching.
+  ASSERT_OK((bcc_wrapper.UpdateBatch<uint32_t, uint64_t>("squares", keys, values)));
+  ASSERT_OK_AND_THAT((bcc_wrapper.LookupBatch<uint32_t, uint64_t>("squares")),
+                     UnorderedElementsAreArray(expected));
+
+  // Deleting keys that are not in the map is not an error.
+  std::vector<uint32_t> keys_to_delete;
+  for (uint32_t i = 2; i < 200; ++i) {
+    keys_to_delete.push_back(i);
+  }
+  ASSERT_OK((bcc_wrapper.DeleteBatch<uint32_t, uint64_t>("squares", keys_to_delete)));
+  ASSERT_OK_AND_THAT((bcc_wrapper.LookupAndDeleteBatch<uint32_t, uint64_t>("squares")),
+                     UnorderedElementsAre(Pair(0, 0), Pair(1, 1)));
+  ASSERT_OK_AND_THAT((bcc_wrapper.LookupBatch<uint32_t, uint64_t>("squares")), IsEmpty());
+}
+
+// Tests that maps holding more entries than one lookup chunk are read out completely.
+TEST(BCCWrapperTest, TestMapBatchLookupAcrossChunks) {
+  bpf_tools::BCCWrapper bcc_wrapper;
+  std::string_view kProgram = "BPF_HASH(squares, uint32_t, uint64_t, 8192);";
+  ASSERT_OK(bcc_wrapper.InitBPFProgram(kProgram));
+
+  using ::testing::IsEmpty;
+  using ::testing::UnorderedElementsAreArray;
+
+  std::vector<uint32_t> keys;
+  std::vector<uint64_t> values;
+  std::vector<std::pair<uint32_t, uint64_t>> expected;
+  for (uint32_t i = 0; i < 3000; ++i) {
+    keys.push_back(i);
+    values.push_back(i * i);
+    expected.emplace_back(i, i * i);
+  }
+
+  ASSERT_OK((bcc_wrapper.UpdateBatch<uint32_t, uint64_t>("squares", keys, values)));
+  ASSERT_OK_AND_THAT((bcc_wrapper.LookupBatch<uint32_t, uint64_t>("squares")),
+                     UnorderedElementsAreArray(expected));
+  ASSERT_OK_AND_THAT((bcc_wrapper.LookupAndDeleteBatch<uint32_t, uint64_t>("squares")),
+                     UnorderedElementsAreArray(expected));
+  ASSERT_OK_AND_THAT((bcc_wrapper.LookupBatch<uint32_t, uint64_t>("squares")), IsEmpty());
+}
+
 // Tests that BCCWrapper can load XDP program.
 TEST(BCCWrapperTest, LoadXDP) {
   bpf_tools::BCCWrapper bcc_wrapper;
@@ -308,7 +308,7 @@ StatusOr<const md::PodInfo*> ResolvePod(const md::K8sMetadataState& k8s_mds,
     if (name_ident.first != name_ident_view.first) {
       continue;
     }
-    if (!absl::StartsWith(name_ident.second, name_ident_view.second)) {
+    if (!absl::StartsWith(name_ident.second.view(), name_ident_view.second)) {
       continue;
     }
     const auto* pod_info = k8s_mds.PodInfoByID(uid);
@@ -318,7 +318,7 @@ StatusOr<const md::PodInfo*> ResolvePod(const md::K8sMetadataState& k8s_mds,
     if (pod_info->stop_time_ns() > 0) {
       return error::NotFound("Pod '$0' has died", pod_name);
     }
-    pod_names.push_back(absl::StrCat(name_ident.first, "/", name_ident.second));
+    pod_names.push_back(absl::StrCat(name_ident.first.view(), "/", name_ident.second.view()));
     pod_infos.push_back(pod_info);
   }
 
@@ -47,6 +47,12 @@ void JVMStatsConnector::FindJavaUPIDs(const ConnectorContext& ctx) {
   const auto& proc_parser = system::ProcParser(system::Config::GetInstance());
   proc_tracker_.Update(ctx.GetUPIDs());
 
+  // The hsperfdata mapping stays readable after the JVM exits, so terminated processes must be
+  // dropped explicitly rather than through export failures.
+  for (const auto& upid : proc_tracker_.deleted_upids()) {
+    java_procs_.erase(upid);
+  }
+
   for (const auto& upid : proc_tracker_.new_upids()) {
     // The host PID 1 is not a Java app. However, when later invoking HsperfdataPath(), it could be
     // confused to conclude that there is a hsperfdata file for PID 1, because of the limitations
@@ -65,21 +71,21 @@ void JVMStatsConnector::FindJavaUPIDs(const ConnectorContext& ctx) {
   }
 }
 
-Status JVMStatsConnector::ExportStats(const md::UPID& upid,
-                                      const std::filesystem::path& hsperf_data_path,
+Status JVMStatsConnector::ExportStats(const md::UPID& upid, JavaProcInfo* java_proc,
                                       DataTable* data_table) const {
-  PL_ASSIGN_OR_RETURN(std::string hsperf_data_str, ReadFileToString(hsperf_data_path));
-
-  if (hsperf_data_str.empty()) {
-    // Assume this is a transient failure.
-    return Status::OK();
+  if (java_proc->hsperf_data_reader == nullptr) {
+    PL_ASSIGN_OR_RETURN(java_proc->hsperf_data_reader,
+                        java::HsperfdataReader::Create(java_proc->hsperf_data_path));
   }
 
-  java::Stats stats(std::move(hsperf_data_str));
-  if (!stats.Parse().ok()) {
-    // Assumes this is a transient failure.
+  StatusOr<java::Stats> stats_status = java_proc->hsperf_data_reader->ReadStats();
+  if (!stats_status.ok()) {
+    // Assumes this is a transient failure, e.g. the JVM is still initializing the file.
+    // Re-open the file on the next attempt.
+    java_proc->hsperf_data_reader.reset();
     return Status::OK();
   }
+  const java::Stats& stats = stats_status.ValueOrDie();
 
   uint64_t time = AdjustedSteadyClockNowNS();
 
@@ -111,7 +117,7 @@ void JVMStatsConnector::TransferDataImpl(ConnectorContext* ctx,
     JavaProcInfo& java_proc = iter->second;
 
     md::UPID upid_with_asid(ctx->GetASID(), upid.pid(), upid.start_ts());
-    auto status = ExportStats(upid_with_asid, java_proc.hsperf_data_path, data_table);
+    auto status = ExportStats(upid_with_asid, &java_proc, data_table);
     if (!status.ok()) {
       ++java_proc.export_failure_count;
     }
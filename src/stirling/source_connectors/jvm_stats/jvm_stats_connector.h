@@ -30,6 +30,7 @@
 #include "src/shared/upid/upid.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/jvm_stats/jvm_stats_table.h"
+#include "src/stirling/source_connectors/jvm_stats/utils/hsperfdata_reader.h"
 #include "src/stirling/source_connectors/jvm_stats/utils/java.h"
 #include "src/stirling/utils/proc_tracker.h"
 
@@ -61,23 +62,26 @@ class JVMStatsConnector : public SourceConnector {
   explicit JVMStatsConnector(std::string_view source_name)
       : SourceConnector(source_name, kTables) {}
 
-  // Finds the UPIDs of newly-created processes as monitoring targets.
-  void FindJavaUPIDs(const ConnectorContext& ctx);
-
-  // Exports JVM performance metrics to data table.
-  Status ExportStats(const md::UPID& upid, const std::filesystem::path& hsperf_data_path,
-                     DataTable* data_table) const;
-
-  // Keeps track of the currently-running processes. Used to find the newly-created processes.
-  ProcTracker proc_tracker_;
-
   // Records the PIDs of previously scanned Java processes, and their hsperfdata file path.
   struct JavaProcInfo {
     // How many times we have failed to export stats for this process. Once this reaches a limit,
     // the process will no longer be monitored.
     int export_failure_count = 0;
     std::filesystem::path hsperf_data_path;
+    // Opened on the first export, and kept until the process terminates.
+    std::unique_ptr<java::HsperfdataReader> hsperf_data_reader;
   };
+
+  // Finds the UPIDs of newly-created processes as monitoring targets, and stops monitoring the
+  // terminated ones.
+  void FindJavaUPIDs(const ConnectorContext& ctx);
+
+  // Exports JVM performance metrics to data table.
+  Status ExportStats(const md::UPID& upid, JavaProcInfo* java_proc, DataTable* data_table) const;
+
+  // Keeps track of the currently-running processes. Used to find the newly-created processes.
+  ProcTracker proc_tracker_;
+
   absl::flat_hash_map<md::UPID, JavaProcInfo> java_procs_;
 };
 
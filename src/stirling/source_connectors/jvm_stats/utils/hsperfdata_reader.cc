@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/jvm_stats/utils/hsperfdata_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "src/common/base/byte_utils.h"
+#include "src/stirling/source_connectors/jvm_stats/utils/hsperfdata.h"
+
+namespace px {
+namespace stirling {
+namespace java {
+
+using ::px::utils::LEndianBytesToInt;
+
+namespace {
+
+constexpr size_t kLongByteSize = 8;
+
+}  // namespace
+
+StatusOr<std::unique_ptr<HsperfdataReader>> HsperfdataReader::Create(
+    const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open $0: $1", path.string(), std::strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    Status s = error::Internal("Failed to stat $0: $1", path.string(), std::strerror(errno));
+    close(fd);
+    return s;
+  }
+  const size_t size = st.st_size;
+  if (size < sizeof(hsperf::Prologue)) {
+    close(fd);
+    return error::InvalidArgument("$0 is too small: $1 bytes", path.string(), size);
+  }
+
+  // The JVM sizes the file once at startup and only updates it in place, so the mapping remains
+  // valid for the life of the process. The mapping also keeps the data readable after the file is
+  // unlinked when the JVM exits; callers must stop reading once the process is gone.
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return error::Internal("Failed to mmap $0: $1", path.string(), std::strerror(errno));
+  }
+
+  std::unique_ptr<HsperfdataReader> reader(
+      new HsperfdataReader(static_cast<const char*>(addr), size));
+  PL_RETURN_IF_ERROR(reader->ParseEntryDirectory());
+  return reader;
+}
+
+HsperfdataReader::~HsperfdataReader() { munmap(const_cast<char*>(data_), size_); }
+
+Status HsperfdataReader::ParseEntryDirectory() {
+  hsperf::HsperfData hsperf_data = {};
+  PL_RETURN_IF_ERROR(hsperf::ParseHsperfData(std::string_view(data_, size_), &hsperf_data));
+
+  counters_.clear();
+  for (const auto& entry : hsperf_data.data_entries) {
+    if (entry.header->data_type != static_cast<uint8_t>(hsperf::DataType::kLong) ||
+        entry.data.size() != kLongByteSize || !Stats::IsExported(entry.name)) {
+      continue;
+    }
+    counters_.push_back({entry.name, static_cast<size_t>(entry.data.data() - data_)});
+  }
+  num_entries_ = hsperf_data.prologue->num_entries;
+  return Status::OK();
+}
+
+StatusOr<Stats> HsperfdataReader::ReadStats() {
+  const auto* prologue = reinterpret_cast<const hsperf::Prologue*>(data_);
+  if (prologue->num_entries != num_entries_) {
+    PL_RETURN_IF_ERROR(ParseEntryDirectory());
+  }
+
+  std::vector<Stats::Stat> stats;
+  stats.reserve(counters_.size());
+  for (const auto& counter : counters_) {
+    auto value =
+        LEndianBytesToInt<uint64_t>(std::string_view(data_ + counter.offset, kLongByteSize));
+    stats.push_back({counter.name, value});
+  }
+  return Stats(std::move(stats));
+}
+
+}  // namespace java
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/jvm_stats/utils/java.h"
+
+namespace px {
+namespace stirling {
+namespace java {
+
+/**
+ * Reads JVM stats from a memory-mapped hsperfdata file.
+ *
+ * The file is mapped once, and its entry directory is parsed once to record the offsets of the
+ * counters used by Stats. Each ReadStats() then only loads those counters, instead of reading
+ * and parsing the whole file. The directory is re-parsed if the JVM adds entries.
+ */
+class HsperfdataReader : public NotCopyMoveable {
+ public:
+  static StatusOr<std::unique_ptr<HsperfdataReader>> Create(const std::filesystem::path& path);
+
+  ~HsperfdataReader();
+
+  /**
+   * Returns the current values of the exported counters. The names in the returned Stats refer
+   * to the mapped file, so the result must not outlive this reader.
+   */
+  StatusOr<Stats> ReadStats();
+
+ private:
+  HsperfdataReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  Status ParseEntryDirectory();
+
+  struct Counter {
+    std::string_view name;
+    size_t offset;
+  };
+
+  const char* data_;
+  size_t size_;
+
+  // The number of entries in the file when counters_ was populated.
+  uint32_t num_entries_ = 0;
+  std::vector<Counter> counters_;
+};
+
+}  // namespace java
+}  // namespace stirling
+}  // namespace px
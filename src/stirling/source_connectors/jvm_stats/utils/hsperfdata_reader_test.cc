@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/jvm_stats/utils/hsperfdata_reader.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+#include "src/common/base/base.h"
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/test_environment.h"
+#include "src/common/testing/testing.h"
+#include "src/stirling/source_connectors/jvm_stats/utils/hsperfdata.h"
+
+namespace px {
+namespace stirling {
+namespace java {
+
+using ::px::testing::TempDir;
+using ::px::testing::TestFilePath;
+
+constexpr char kTestHsperfdataPath[] =
+    "src/stirling/source_connectors/jvm_stats/utils/test_hsperfdata";
+
+// Tests that the mmapped reader produces the same stats as parsing the whole file.
+TEST(HsperfdataReaderTest, MatchesFullParse) {
+  const std::filesystem::path path = TestFilePath(kTestHsperfdataPath);
+
+  ASSERT_OK_AND_ASSIGN(std::string content, ReadFileToString(path));
+  Stats expected(std::move(content));
+  ASSERT_OK(expected.Parse());
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<HsperfdataReader> reader, HsperfdataReader::Create(path));
+  ASSERT_OK_AND_ASSIGN(Stats stats, reader->ReadStats());
+
+  EXPECT_EQ(stats.YoungGCTimeNanos(), expected.YoungGCTimeNanos());
+  EXPECT_EQ(stats.FullGCTimeNanos(), expected.FullGCTimeNanos());
+  EXPECT_EQ(stats.UsedHeapSizeBytes(), expected.UsedHeapSizeBytes());
+  EXPECT_EQ(stats.TotalHeapSizeBytes(), expected.TotalHeapSizeBytes());
+  EXPECT_EQ(stats.MaxHeapSizeBytes(), expected.MaxHeapSizeBytes());
+  EXPECT_GT(stats.MaxHeapSizeBytes(), 0);
+}
+
+// Tests that updates made to the file by the JVM are visible without reopening it.
+TEST(HsperfdataReaderTest, SeesInPlaceUpdates) {
+  ASSERT_OK_AND_ASSIGN(std::string content,
+                       ReadFileToString(TestFilePath(kTestHsperfdataPath)));
+
+  TempDir temp_dir;
+  const std::filesystem::path path = temp_dir.path() / "hsperfdata";
+  ASSERT_OK(WriteFileFromString(path, content));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<HsperfdataReader> reader, HsperfdataReader::Create(path));
+  ASSERT_OK_AND_ASSIGN(Stats before, reader->ReadStats());
+
+  // Find the young GC time counter, and overwrite it in place, like the JVM does.
+  hsperf::HsperfData data = {};
+  ASSERT_OK(hsperf::ParseHsperfData(content, &data));
+  size_t offset = 0;
+  for (const auto& entry : data.data_entries) {
+    if (entry.name == "sun.gc.collector.0.time") {
+      offset = entry.data.data() - content.data();
+    }
+  }
+  ASSERT_NE(offset, 0);
+
+  const uint64_t new_value = before.YoungGCTimeNanos() + 12345;
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&new_value), sizeof(new_value));
+  }
+
+  ASSERT_OK_AND_ASSIGN(Stats after, reader->ReadStats());
+  EXPECT_EQ(after.YoungGCTimeNanos(), new_value);
+  EXPECT_EQ(after.MaxHeapSizeBytes(), before.MaxHeapSizeBytes());
+}
+
+TEST(HsperfdataReaderTest, MissingFile) {
+  EXPECT_NOT_OK(HsperfdataReader::Create("/does/not/exist"));
+}
+
+}  // namespace java
+}  // namespace stirling
+}  // namespace px
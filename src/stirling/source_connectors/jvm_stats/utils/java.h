@@ -24,6 +24,8 @@
 #include <utility>
 #include <vector>
 
+#include <absl/types/span.h>
+
 #include "src/common/base/statusor.h"
 
 namespace px {
@@ -50,6 +52,11 @@ class Stats {
    */
   Status Parse();
 
+  /**
+   * Returns true if the named hsperf counter contributes to any of the stats below.
+   */
+  static bool IsExported(std::string_view name);
+
   uint64_t YoungGCTimeNanos() const;
   uint64_t FullGCTimeNanos() const;
   uint64_t UsedHeapSizeBytes() const;
@@ -58,7 +65,7 @@ class Stats {
 
  private:
   uint64_t StatForSuffix(std::string_view suffix) const;
-  uint64_t SumStatsForSuffixes(const std::vector<std::string_view>& suffixes) const;
+  uint64_t SumStatsForSuffixes(absl::Span<const std::string_view> suffixes) const;
 
   std::string hsperf_data_;
   std::vector<Stat> stats_;
@@ -29,10 +29,14 @@
 
 // This BPF probe samples stack-traces using two fundamental data structures:
 // 1. stack_traces: a map from stack-trace [1] to stack-trace-id (an integer).
-// 2. histogram: a map from stack-trace-id to observation count.
+// 2. histogram: a map from stack-trace-key [2] to observation count.
 // The higher a count, the more we have observed a particular stack-trace,
 // and the more likely something in that stack-trace is a potential perf. issue.
 
+// The histogram is aggregated in-kernel: each sample increments the count of its
+// stack-trace-key, so user space reads one entry per unique stack trace (instead of
+// one entry per sample). This decouples the user space cost from the sample rate.
+
 // To keep the stack-trace profiler "always on", we use a double buffering
 // scheme wherein we allocate two of each data structure. Therefore,
 // we have the following BPF tables:
@@ -42,16 +46,18 @@
 // 2b. histogram_b.
 
 // Periodically, we need to switch over from map-set-a to map-set-b, and vice versa.
-// We conservatively assume that each sample inserts a new key into the stack_traces
-// and into the histogram. The transfer between sets is controlled by user-space.
+// The transfer between sets is controlled by user-space, which then drains
+// the inactive set in bulk.
 
 // Notes:
 // [1] A stack trace is an (ordered) vector of addresses (u64s), i.e.
 // the set of instruction pointers found in the call stack at the moment
 // the sample was triggered.
+// [2] A stack-trace-key is the tuple (upid, user-stack-id, kernel-stack-id);
+// see stack_event.h.
 
-BPF_PERF_OUTPUT(histogram_a);
-BPF_PERF_OUTPUT(histogram_b);
+BPF_HASH(histogram_a, struct stack_trace_key_t, uint64_t, CFG_STACK_TRACE_ENTRIES);
+BPF_HASH(histogram_b, struct stack_trace_key_t, uint64_t, CFG_STACK_TRACE_ENTRIES);
 BPF_STACK_TRACE(stack_traces_a, CFG_STACK_TRACE_ENTRIES);
 BPF_STACK_TRACE(stack_traces_b, CFG_STACK_TRACE_ENTRIES);
 
@@ -62,14 +68,17 @@ BPF_ARRAY(profiler_state, uint64_t, kProfilerStateVectorSize);
 int sample_call_stack(struct bpf_perf_event_data* ctx) {
   int transfer_count_idx = kTransferCountIdx;
   int sample_count_a_idx = kSampleCountAIdx;
-  int sample_count_b_idx = kSampleCountAIdx;
+  int sample_count_b_idx = kSampleCountBIdx;
   int error_status_idx = kErrorStatusIdx;
+  int lost_sample_count_idx = kLostSampleCountIdx;
 
   uint64_t* transfer_count_ptr = profiler_state.lookup(&transfer_count_idx);
   uint64_t* sample_count_a_ptr = profiler_state.lookup(&sample_count_a_idx);
   uint64_t* sample_count_b_ptr = profiler_state.lookup(&sample_count_b_idx);
+  uint64_t* lost_sample_count_ptr = profiler_state.lookup(&lost_sample_count_idx);
 
-  if (transfer_count_ptr == NULL || sample_count_a_ptr == NULL || sample_count_b_ptr == NULL) {
+  if (transfer_count_ptr == NULL || sample_count_a_ptr == NULL || sample_count_b_ptr == NULL ||
+      lost_sample_count_ptr == NULL) {
     // One of the map lookups failed.
     // Set the appropriate error bit in the error bitfield:
     uint64_t rd_fail_status_code = kMapReadFailureError;
@@ -84,34 +93,34 @@ int sample_call_stack(struct bpf_perf_event_data* ctx) {
   key.upid.tgid = bpf_get_current_pid_tgid() >> 32;
   key.upid.start_time_ticks = get_tgid_start_time();
 
-  uint64_t sample_count = 0;
+  uint64_t zero = 0;
+  uint64_t* count_ptr = NULL;
 
   if (transfer_count % 2 == 0) {
     // map set A branch:
     key.user_stack_id = stack_traces_a.get_stackid(&ctx->regs, BPF_F_USER_STACK);
     key.kernel_stack_id = stack_traces_a.get_stackid(&ctx->regs, 0);
-    histogram_a.perf_submit(ctx, &key, sizeof(key));
-
-    sample_count = *sample_count_a_ptr;
-    *sample_count_a_ptr += 1;
+    count_ptr = histogram_a.lookup_or_try_init(&key, &zero);
+    __sync_fetch_and_add(sample_count_a_ptr, 1);
   } else {
     // map set B branch:
     key.user_stack_id = stack_traces_b.get_stackid(&ctx->regs, BPF_F_USER_STACK);
     key.kernel_stack_id = stack_traces_b.get_stackid(&ctx->regs, 0);
-    histogram_b.perf_submit(ctx, &key, sizeof(key));
-
-    sample_count = *sample_count_b_ptr;
-    *sample_count_b_ptr += 1;
+    count_ptr = histogram_b.lookup_or_try_init(&key, &zero);
+    __sync_fetch_and_add(sample_count_b_ptr, 1);
   }
 
-  // sample_count >= CFG_OVERRUN_THRESHOLD: indicates the number of samples taken has exceeded a
-  // threshold such that we risk dropping data. User-space code should have read the data by now.
-  // Report this error.
-  if (sample_count >= CFG_OVERRUN_THRESHOLD) {
+  if (count_ptr == NULL) {
+    // The histogram is full: the number of unique stack traces has exceeded the map capacity.
+    // User-space code should have read the data by now. Report this error.
+    __sync_fetch_and_add(lost_sample_count_ptr, 1);
     uint64_t overflow_status_code = kOverflowError;
     profiler_state.update(&error_status_idx, &overflow_status_code);
     return 0;
   }
 
+  // Samples are taken concurrently on all CPUs, and may hit the same stack-trace-key.
+  __sync_fetch_and_add(count_ptr, 1);
+
   return 0;
 }
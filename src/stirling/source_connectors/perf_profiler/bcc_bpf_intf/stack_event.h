@@ -26,15 +26,18 @@
 // profiler_state[0]: transfer count          # written on user side, read on BPF side
 // profiler_state[1]: sample count A          # updated on BPF side, reset on user side
 // profiler_state[2]: sample count B          # updated on BPF side, reset on user side
-// profiler_state[3]: error status bitfield   # written on BPF side, read on user side
+// profiler_state[3]: error status bitfield   # written on BPF side, read & reset on user side
+// profiler_state[4]: lost sample count       # updated on BPF side, read & reset on user side
 // TODO(jps): Consider switching to a C-style enum.
 static const uint32_t kTransferCountIdx = 0;
 static const uint32_t kSampleCountAIdx = 1;
 static const uint32_t kSampleCountBIdx = 2;
 static const uint32_t kErrorStatusIdx = 3;
-static const uint32_t kProfilerStateVectorSize = 4;
+static const uint32_t kLostSampleCountIdx = 4;
+static const uint32_t kProfilerStateVectorSize = 5;
 
 // stack_trace_key_t indexes into the stack-trace histogram.
+// The histogram is a BPF hash map from stack_trace_key_t to observation count.
 // By tying together the user & kernel stack-trace-ids [1],
 // it fully identifies a unique stack trace.
 //
@@ -21,6 +21,7 @@
 
 #include <sys/sysinfo.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -40,24 +41,38 @@ DEFINE_uint32(stirling_profiler_table_update_period_seconds,
               "Number of seconds between profiler table updates.");
 DEFINE_uint32(stirling_profiler_stack_trace_sample_period_ms, 11,
               "Number of milliseconds between stack trace samples.");
+DEFINE_uint32(stirling_profiler_stack_trace_sample_freq_hz, 0,
+              "If non-zero, the stack trace sample rate in Hz (e.g. 997). "
+              "Overrides stirling_profiler_stack_trace_sample_period_ms.");
 
 // Scaling factor is sized to avoid hash table collisions and timing variations.
 DEFINE_double(stirling_profiler_stack_trace_size_factor, 3.0,
               "Scaling factor to apply to Profiler's eBPF stack trace map sizes");
 
-// Scaling factor for perf buffer to account for timing variations.
-// This factor is smaller than the stack trace scaling factor because there is no need to account
-// for hash table collisions.
-DEFINE_double(stirling_profiler_perf_buffer_size_factor, 1.2,
-              "Scaling factor to apply to Profiler's eBPF perf buffer sizes");
+// Because the histogram is aggregated in BPF, the map sizes track the number of unique
+// stack traces, which does not grow with the sample rate. This cap prevents high sample
+// rates from inflating the (pre-allocated) BPF maps.
+DEFINE_uint32(stirling_profiler_stack_trace_max_entries, 256 * 1024,
+              "Upper bound on the number of entries in Profiler's eBPF stack trace maps");
 
 namespace px {
 namespace stirling {
 
+namespace {
+
+std::chrono::nanoseconds StackTraceSamplingPeriodFromFlags() {
+  if (FLAGS_stirling_profiler_stack_trace_sample_freq_hz != 0) {
+    return std::chrono::nanoseconds{std::chrono::seconds{1}} /
+           FLAGS_stirling_profiler_stack_trace_sample_freq_hz;
+  }
+  return std::chrono::milliseconds{FLAGS_stirling_profiler_stack_trace_sample_period_ms};
+}
+
+}  // namespace
+
 PerfProfileConnector::PerfProfileConnector(std::string_view source_name)
     : SourceConnector(source_name, kTables),
-      stack_trace_sampling_period_(
-          std::chrono::milliseconds{FLAGS_stirling_profiler_stack_trace_sample_period_ms}),
+      stack_trace_sampling_period_(StackTraceSamplingPeriodFromFlags()),
       sampling_period_(
           std::chrono::milliseconds{1000 * FLAGS_stirling_profiler_table_update_period_seconds}),
       push_period_(sampling_period_ / 2),
@@ -79,66 +94,37 @@ Status PerfProfileConnector::InitImpl() {
   // Given the targeted "transfer period" and the "stack trace sample period",
   // we can find the number of entries required to be allocated in each of the maps,
   // i.e. the number of expected stack traces:
-  const int32_t expected_stack_traces_per_cpu =
-      IntRoundUpDivide(sampling_period_.count(), stack_trace_sampling_period_.count());
+  const int64_t expected_stack_traces_per_cpu = IntRoundUpDivide(
+      std::chrono::nanoseconds{sampling_period_}.count(), stack_trace_sampling_period_.count());
 
   // Because sampling occurs per-cpu, the total number of expected stack traces is:
-  const int32_t expected_stack_traces = ncpus * expected_stack_traces_per_cpu;
+  const int64_t expected_stack_traces = ncpus * expected_stack_traces_per_cpu;
 
   // Include some margin to ensure that hash collisions and data races do not cause data drop:
   const double stack_traces_overprovision_factor = FLAGS_stirling_profiler_stack_trace_size_factor;
 
-  // Compute the size of the stack traces map.
-  const int32_t provisioned_stack_traces =
-      static_cast<int32_t>(stack_traces_overprovision_factor * expected_stack_traces);
-
-  // A threshold for checking that we've overrun the maps.
-  // This should be higher than expected_stack_traces due to timing variations,
-  // but it should be lower than provisioned_stack_traces.
-  const int32_t overrun_threshold = (expected_stack_traces + provisioned_stack_traces) / 2;
-
-  // Compute the size of the perf buffers.
-  const double perf_buffer_overprovision_factor = FLAGS_stirling_profiler_perf_buffer_size_factor;
-  const int32_t num_perf_buffer_entries =
-      static_cast<int32_t>(perf_buffer_overprovision_factor * expected_stack_traces_per_cpu);
-
-  // Perf buffer entries use the following struct:
-  //      struct {
-  //        struct perf_event_header {
-  //          __u32   type;
-  //          __u16   misc;
-  //          __u16   size;
-  //        } header;
-  //        u32    size;        /* if PERF_SAMPLE_RAW */
-  //        char  data[size];   /* if PERF_SAMPLE_RAW */
-  //      };
-  // The entire struct as a whole is 12-bytes + data[size].
-  const int32_t perf_buffer_entry_size =
-      sizeof(struct perf_event_header) + sizeof(uint32_t) + sizeof(stack_trace_key_t);
-  const int32_t perf_buffer_size = perf_buffer_entry_size * num_perf_buffer_entries;
+  // Compute the size of the stack traces map (and of the histogram, which is keyed by
+  // stack-trace-ids). The number of samples is an upper bound on the number of unique stack
+  // traces; at high sample rates, the cap bounds the size of the maps instead.
+  const int64_t provisioned_stack_traces =
+      std::min(static_cast<int64_t>(stack_traces_overprovision_factor * expected_stack_traces),
+               static_cast<int64_t>(FLAGS_stirling_profiler_stack_trace_max_entries));
 
   const std::vector<std::string> defines = {
       absl::Substitute("-DCFG_STACK_TRACE_ENTRIES=$0", provisioned_stack_traces),
-      absl::Substitute("-DCFG_OVERRUN_THRESHOLD=$0", overrun_threshold),
   };
 
   const auto probe_specs = MakeArray<bpf_tools::SamplingProbeSpec>(
-      {"sample_call_stack", static_cast<uint64_t>(stack_trace_sampling_period_.count())});
-
-  const auto perf_buffer_specs = MakeArray<bpf_tools::PerfBufferSpec>(
-      {{"histogram_a", HandleHistoEvent, HandleHistoLoss, perf_buffer_size},
-       {"histogram_b", HandleHistoEvent, HandleHistoLoss, perf_buffer_size}});
+      {.probe_fn = "sample_call_stack",
+       .period_millis = 0,
+       .period_nanos = static_cast<uint64_t>(stack_trace_sampling_period_.count())});
 
   PL_RETURN_IF_ERROR(InitBPFProgram(profiler_bcc_script, defines));
   PL_RETURN_IF_ERROR(AttachSamplingProbes(probe_specs));
-  PL_RETURN_IF_ERROR(OpenPerfBuffers(perf_buffer_specs, this));
 
   stack_traces_a_ = std::make_unique<ebpf::BPFStackTable>(GetStackTable("stack_traces_a"));
   stack_traces_b_ = std::make_unique<ebpf::BPFStackTable>(GetStackTable("stack_traces_b"));
 
-  histogram_a_perf_buffer_ = GetPerfBuffer("histogram_a");
-  histogram_b_perf_buffer_ = GetPerfBuffer("histogram_b");
-
   profiler_state_ =
       std::make_unique<ebpf::BPFArrayTable<uint64_t>>(GetArrayTable<uint64_t>("profiler_state"));
 
@@ -181,21 +167,36 @@ Status PerfProfileConnector::StopImpl() {
   return Status::OK();
 }
 
-void PerfProfileConnector::AcceptStackTraceKey(stack_trace_key_t* data) {
-  raw_histo_data_.push_back(*data);
+void PerfProfileConnector::ReadHistogram(const std::string& histogram_name) {
+  // The histogram is drained with a destructive bulk read, which leaves it empty
+  // for when BPF switches back to this map set.
+  auto histo_or = LookupAndDeleteBatch<stack_trace_key_t, uint64_t>(histogram_name);
+  if (!histo_or.ok()) {
+    LOG(ERROR) << absl::Substitute("Failed to read $0: $1", histogram_name, histo_or.msg());
+    return;
+  }
+  raw_histo_data_ = histo_or.ConsumeValueOrDie();
+  stats_.Increment(StatKey::kUniqueStackTraceKeys, raw_histo_data_.size());
 }
 
-void PerfProfileConnector::HandleHistoEvent(void* cb_cookie, void* data, int /*data_size*/) {
-  DCHECK(cb_cookie != nullptr) << "Perf buffer callback not set-up properly. Missing cb_cookie.";
-  auto* connector = static_cast<PerfProfileConnector*>(cb_cookie);
-  auto* histo_key_ptr = static_cast<stack_trace_key_t*>(data);
-  connector->AcceptStackTraceKey(histo_key_ptr);
-}
+void PerfProfileConnector::CheckBPFErrorStatus() {
+  uint64_t lost_sample_count = 0;
+  uint64_t error_status = 0;
+  profiler_state_->get_value(kLostSampleCountIdx, lost_sample_count);
+  profiler_state_->get_value(kErrorStatusIdx, error_status);
+
+  if (lost_sample_count != 0) {
+    stats_.Increment(StatKey::kLossHistoEvent, lost_sample_count);
+    profiler_state_->update_value(kLostSampleCountIdx, 0);
+  }
 
-void PerfProfileConnector::HandleHistoLoss(void* cb_cookie, uint64_t lost) {
-  DCHECK(cb_cookie != nullptr) << "Perf buffer callback not set-up properly. Missing cb_cookie.";
-  auto* connector = static_cast<PerfProfileConnector*>(cb_cookie);
-  connector->stats_.Increment(StatKey::kLossHistoEvent, lost);
+  if (error_status != 0) {
+    LOG_FIRST_N(WARNING, 10) << absl::Substitute(
+        "PerfProfiler: BPF reported error status $0 (lost samples: $1). "
+        "Consider increasing --stirling_profiler_stack_trace_max_entries.",
+        error_status, lost_sample_count);
+    profiler_state_->update_value(kErrorStatusIdx, 0);
+  }
 }
 
 void PerfProfileConnector::CleanupSymbolizers(const absl::flat_hash_set<md::UPID>& deleted_upids) {
@@ -221,9 +222,6 @@ void PerfProfileConnector::CleanupSymbolizers(const absl::flat_hash_set<md::UPID
 
 PerfProfileConnector::StackTraceHisto PerfProfileConnector::AggregateStackTraces(
     ConnectorContext* ctx, ebpf::BPFStackTable* stack_traces) {
-  // TODO(jps): switch from using get_table_offline() to directly stepping through
-  // the histogram data structure. Inline populating our own data structures with this.
-  // Avoid an unnecessary copy of the information in local stack_trace_keys_and_counts.
   StackTraceHisto symbolic_histogram;
   uint64_t cum_sum_count = 0;
 
@@ -239,7 +237,7 @@ PerfProfileConnector::StackTraceHisto PerfProfileConnector::AggregateStackTraces
 
   absl::flat_hash_set<int> k_stack_ids_to_remove;
 
-  for (const auto& stack_trace_key : raw_histo_data_) {
+  for (const auto& [stack_trace_key, count] : raw_histo_data_) {
     std::string stack_trace_str;
 
     const md::UPID upid(asid, stack_trace_key.upid.pid, stack_trace_key.upid.start_time_ticks);
@@ -269,8 +267,8 @@ PerfProfileConnector::StackTraceHisto PerfProfileConnector::AggregateStackTraces
 
     profiler::SymbolicStackTrace symbolic_stack_trace = {upid, std::move(stack_trace_str)};
 
-    ++symbolic_histogram[symbolic_stack_trace];
-    ++cum_sum_count;
+    symbolic_histogram[symbolic_stack_trace] += count;
+    cum_sum_count += count;
 
     // TODO(jps): If we see a perf. issue with having two maps keyed by symbolic-stack-trace,
     // refactor such that creating/finding symoblic-stack-trace-id and count aggregation
@@ -333,20 +331,19 @@ void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTabl
   // Choose the maps to consume.
   const bool using_map_set_a = transfer_count_ % 2 == 0;
   auto& stack_traces = using_map_set_a ? stack_traces_a_ : stack_traces_b_;
-  auto& histo_perf_buf = using_map_set_a ? histogram_a_perf_buffer_ : histogram_b_perf_buffer_;
+  const std::string histogram_name = using_map_set_a ? "histogram_a" : "histogram_b";
   const uint32_t sample_count_idx = using_map_set_a ? kSampleCountAIdx : kSampleCountBIdx;
 
-  // Read out the perf buffer that contains the histogram for this iteration.
-  // TODO(jps): change PollPerfBuffer() to use std::chrono.
-  constexpr int kPollTimeoutMS = 0;
-  histo_perf_buf->poll(kPollTimeoutMS);
-
   ++transfer_count_;
 
   // First, tell BPF to switch the maps it writes to.
   const ebpf::StatusTuple s = profiler_state_->update_value(kTransferCountIdx, transfer_count_);
   LOG_IF(ERROR, !s.ok()) << "Error writing transfer_count_";
 
+  // Drain the histogram that BPF just switched away from.
+  ReadHistogram(histogram_name);
+  CheckBPFErrorStatus();
+
   // Read BPF stack traces & histogram, build records, incorporate records to data table.
   CreateRecords(stack_traces.get(), ctx, data_table);
 
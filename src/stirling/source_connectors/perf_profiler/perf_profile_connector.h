@@ -60,21 +60,24 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
   void TransferDataImpl(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables) override;
 
   std::chrono::milliseconds SamplingPeriod() const { return sampling_period_; }
-  std::chrono::milliseconds StackTraceSamplingPeriod() const {
+  std::chrono::nanoseconds StackTraceSamplingPeriod() const {
     return stack_trace_sampling_period_;
   }
 
   enum class StatKey {
     kBPFMapSwitchoverEvent,
     kCumulativeSumOfAllStackTraces,
+    // Number of samples dropped in BPF because the histogram was full.
     kLossHistoEvent,
+    // Number of unique stack-trace-keys read out of the BPF histogram.
+    kUniqueStackTraceKeys,
   };
 
   utils::StatCounter<StatKey> stats() const { return stats_; }
 
  private:
   // The time interval between stack trace samples, i.e. the sample rate used inside of BPF.
-  const std::chrono::milliseconds stack_trace_sampling_period_;
+  const std::chrono::nanoseconds stack_trace_sampling_period_;
 
   // Push period is set to 1/2 of the sample period such that we push each new
   // sample when it becomes available. This is a UX decision so that the user
@@ -85,13 +88,19 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // StackTraceHisto: SymbolicStackTrace => observation-count
   using StackTraceHisto = absl::flat_hash_map<profiler::SymbolicStackTrace, uint64_t>;
 
-  // RawHistoData: a list of stack trace keys that will need to be histogrammed.
-  using RawHistoData = std::vector<stack_trace_key_t>;
+  // RawHistoData: stack trace keys and their counts, as aggregated in BPF.
+  using RawHistoData = std::vector<std::pair<stack_trace_key_t, uint64_t>>;
 
   explicit PerfProfileConnector(std::string_view source_name);
 
   void ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table);
 
+  // Drains the in-kernel histogram of the given map set into raw_histo_data_.
+  void ReadHistogram(const std::string& histogram_name);
+
+  // Reads (and resets) the error status & lost sample count written by BPF.
+  void CheckBPFErrorStatus();
+
   // Read BPF data structures, build & incorporate records to the table.
   void CreateRecords(ebpf::BPFStackTable* stack_traces, ConnectorContext* ctx,
                      DataTable* data_table);
@@ -114,7 +123,7 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // Tracks unique stack trace ids, for the lifetime of Stirling:
   StackTraceIDCache stack_trace_ids_;
 
-  // The raw histogram from BPF; it is populated on each iteration by a call to PollPerfBuffer().
+  // The raw histogram from BPF; it is populated on each iteration by a call to ReadHistogram().
   RawHistoData raw_histo_data_;
 
   // For converting stack trace addresses to symbols.
@@ -125,15 +134,6 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // TODO(oazizi): Investigate ways of sharing across source_connectors.
   ProcTracker proc_tracker_;
 
-  static void HandleHistoEvent(void* cb_cookie, void* data, int /*data_size*/);
-  static void HandleHistoLoss(void* cb_cookie, uint64_t lost);
-
-  // Called by HandleHistoEvent() to add the stack-trace-key to raw_histo_data_.
-  void AcceptStackTraceKey(stack_trace_key_t* data);
-
-  ebpf::BPFPerfBuffer* histogram_a_perf_buffer_;
-  ebpf::BPFPerfBuffer* histogram_b_perf_buffer_;
-
   const uint32_t stats_log_interval_;
   utils::StatCounter<StatKey> stats_;
 };
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "src/common/base/base.h"
+#include "src/stirling/core/connector_context.h"
+#include "src/stirling/source_connectors/perf_profiler/perf_profile_connector.h"
+#include "src/stirling/source_connectors/perf_profiler/stack_traces_table.h"
+#include "src/stirling/testing/common.h"
+
+DECLARE_uint32(stirling_profiler_stack_trace_sample_freq_hz);
+
+DEFINE_uint32(benchmark_num_workers, 4, "Number of busy worker threads to profile.");
+DEFINE_uint32(benchmark_collection_window_ms, 1000,
+              "Time for which samples are collected (in BPF) before each TransferData() call.");
+
+using ::benchmark::Counter;
+using ::px::stirling::DataTable;
+using ::px::stirling::kStackTraceTable;
+using ::px::stirling::PerfProfileConnector;
+using ::px::stirling::SystemWideStandaloneContext;
+
+namespace {
+
+// A few distinct call stacks for the profiler to observe.
+__attribute__((noinline)) double SpinA(double x) { return std::sqrt(x + 1.0); }
+__attribute__((noinline)) double SpinB(double x) { return std::log(x + 2.0); }
+__attribute__((noinline)) double SpinC(double x) { return std::sin(x) + SpinA(x); }
+
+// Keeps the CPUs busy, so that every sample lands on one of the workers.
+class BusyWorkers {
+ public:
+  explicit BusyWorkers(size_t num_workers) {
+    for (size_t i = 0; i < num_workers; ++i) {
+      threads_.emplace_back([this, i]() {
+        double x = static_cast<double>(i);
+        while (!stop_) {
+          x = SpinA(x) + SpinB(x) + SpinC(x);
+        }
+        benchmark::DoNotOptimize(x);
+      });
+    }
+  }
+
+  ~BusyWorkers() {
+    stop_ = true;
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+ private:
+  std::atomic<bool> stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace
+
+// Measures the user-space cost of draining & symbolizing one window of stack trace samples,
+// as a function of the BPF sample rate. With the histogram aggregated in-kernel, the cost
+// should track the number of unique stack traces, rather than the number of samples.
+// Requires root, because it deploys the profiler's BPF program.
+// NOLINTNEXTLINE: runtime/references.
+static void BM_PerfProfilerTransferData(benchmark::State& state) {
+  PL_SET_FOR_SCOPE(FLAGS_stirling_profiler_stack_trace_sample_freq_hz,
+                   static_cast<uint32_t>(state.range(0)));
+
+  auto source = PerfProfileConnector::Create("perf_profiler");
+  PL_CHECK_OK(source->Init());
+
+  DataTable data_table(/*id*/ 0, kStackTraceTable);
+  const std::vector<DataTable*> data_tables{&data_table};
+  BusyWorkers workers(FLAGS_benchmark_num_workers);
+  SystemWideStandaloneContext ctx;
+
+  const auto collection_window = std::chrono::milliseconds{FLAGS_benchmark_collection_window_ms};
+
+  // Drain whatever was sampled during start-up.
+  source->TransferData(&ctx, data_tables);
+  data_table.ConsumeRecords();
+  const auto stats_start = source->stats();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::this_thread::sleep_for(collection_window);
+    state.ResumeTiming();
+
+    source->TransferData(&ctx, data_tables);
+
+    state.PauseTiming();
+    data_table.ConsumeRecords();
+    state.ResumeTiming();
+  }
+
+  PL_CHECK_OK(source->Stop());
+
+  const auto stats_end = source->stats();
+  auto delta = [&](PerfProfileConnector::StatKey key) {
+    return static_cast<double>(stats_end.Get(key) - stats_start.Get(key));
+  };
+  state.counters["SamplesPerTransfer"] =
+      Counter(delta(PerfProfileConnector::StatKey::kCumulativeSumOfAllStackTraces),
+              Counter::kAvgIterations);
+  state.counters["UniqueKeysPerTransfer"] = Counter(
+      delta(PerfProfileConnector::StatKey::kUniqueStackTraceKeys), Counter::kAvgIterations);
+  state.counters["LostSamples"] = delta(PerfProfileConnector::StatKey::kLossHistoEvent);
+  state.SetItemsProcessed(
+      static_cast<int64_t>(delta(PerfProfileConnector::StatKey::kCumulativeSumOfAllStackTraces)));
+}
+
+BENCHMARK(BM_PerfProfilerTransferData)
+    ->Arg(49)
+    ->Arg(99)
+    ->Arg(199)
+    ->Arg(499)
+    ->Arg(997)
+    ->Iterations(10)
+    ->Unit(benchmark::kMillisecond);
@@ -244,8 +244,10 @@ class PerfProfileBPFTest : public ::testing::Test {
                            const std::chrono::duration<double> elapsed_time,
                            const std::string_view key1x, const std::string_view key2x) {
     const uint64_t table_period_ms = source_->SamplingPeriod().count();
-    const uint64_t bpf_period_ms = source_->StackTraceSamplingPeriod().count();
-    const double expected_rate = 1000.0 / static_cast<double>(bpf_period_ms);
+    const std::chrono::duration<double, std::milli> bpf_period =
+        source_->StackTraceSamplingPeriod();
+    const double bpf_period_ms = bpf_period.count();
+    const double expected_rate = 1000.0 / bpf_period_ms;
     const double expected_num_samples = num_subprocesses * elapsed_time.count() * expected_rate;
     const uint64_t expected_num_sample_lower = uint64_t(0.9 * expected_num_samples);
     const uint64_t expected_num_sample_upper = uint64_t(1.1 * expected_num_samples);
@@ -253,7 +255,7 @@ class PerfProfileBPFTest : public ::testing::Test {
     const double observed_rate = observedNumSamples / elapsed_time.count() / num_subprocesses;
 
     LOG(INFO) << absl::StrFormat("Table sampling period: %d [ms].", table_period_ms);
-    LOG(INFO) << absl::StrFormat("BPF sampling period: %d [ms].", bpf_period_ms);
+    LOG(INFO) << absl::StrFormat("BPF sampling period: %.3f [ms].", bpf_period_ms);
     LOG(INFO) << absl::StrFormat("Number of processes: %d.", num_subprocesses);
     LOG(INFO) << absl::StrFormat("expected num samples: %d.", uint64_t(expected_num_samples));
     LOG(INFO) << absl::StrFormat("total samples: %d.", cumulative_sum_);
@@ -50,8 +50,12 @@ void PIDRuntimeConnector::TransferDataImpl(ConnectorContext* /* ctx */,
     return;
   }
 
-  std::vector<std::pair<uint16_t, pidruntime_val_t>> items =
-      GetHashTable<uint16_t, pidruntime_val_t>("pid_cpu_time").get_table_offline();
+  auto items_or = LookupBatch<uint16_t, pidruntime_val_t>("pid_cpu_time");
+  if (!items_or.ok()) {
+    LOG(ERROR) << absl::Substitute("Failed to read pid_cpu_time: $0", items_or.msg());
+    return;
+  }
+  std::vector<std::pair<uint16_t, pidruntime_val_t>> items = items_or.ConsumeValueOrDie();
 
   for (auto& item : items) {
     // TODO(kgandhi): PL-460 Consider using other types of BPF tables to avoid a searching through
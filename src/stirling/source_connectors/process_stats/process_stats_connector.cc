@@ -27,11 +27,20 @@
 #include "src/common/system/proc_parser.h"
 #include "src/shared/metadata/metadata.h"
 
+DEFINE_uint32(stirling_process_stats_max_open_pids, 4096,
+              "Maximum number of processes for which process_stats keeps /proc files open "
+              "between iterations (two file descriptors per process).");
+
 namespace px {
 namespace stirling {
 
 using system::ProcParser;
 
+ProcessStatsConnector::ProcessStatsConnector(std::string_view source_name)
+    : SourceConnector(source_name, kTables),
+      stat_reader_(std::make_unique<system::ProcPIDStatReader>(
+          sysconfig_, FLAGS_stirling_process_stats_max_open_pids)) {}
+
 Status ProcessStatsConnector::InitImpl() {
   sampling_freq_mgr_.set_period(kSamplingPeriod);
   push_freq_mgr_.set_period(kPushPeriod);
@@ -57,16 +66,14 @@ void ProcessStatsConnector::TransferProcessStatsTable(ConnectorContext* ctx,
     int32_t pid = upid.pid();
     // TODO(zasgar): We should double check the process start time to make sure it still the same
     // PID.
-    auto s1 =
-        proc_parser_->ParseProcPIDStat(pid, system::Config::GetInstance().PageSizeBytes(),
-                                       system::Config::GetInstance().KernelTickTimeNS(), &stats);
+    auto s1 = stat_reader_->ReadStat(pid, &stats);
     if (!s1.ok()) {
       VLOG(1) << absl::Substitute(
           "Failed to fetch cpu stat info for PID ($0). Error=\"$1\" skipping.", pid, s1.msg());
       continue;
     }
 
-    auto s2 = proc_parser_->ParseProcPIDStatIO(pid, &stats);
+    auto s2 = stat_reader_->ReadIO(pid, &stats);
     if (!s2.ok()) {
       VLOG(1) << absl::Substitute(
           "Failed to fetch IO stat info for PID ($0). Error=\"$1\" skipping.", pid, s2.msg());
@@ -92,6 +99,9 @@ void ProcessStatsConnector::TransferProcessStatsTable(ConnectorContext* ctx,
     r.Append<r.ColIndex("read_bytes")>(stats.read_bytes);
     r.Append<r.ColIndex("write_bytes")>(stats.write_bytes);
   }
+
+  // Release the files of processes that are gone (or no longer tracked).
+  stat_reader_->CloseUnused();
 }
 
 void ProcessStatsConnector::TransferDataImpl(ConnectorContext* ctx,
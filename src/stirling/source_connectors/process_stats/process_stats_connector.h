@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "src/common/base/base.h"
+#include "src/common/system/proc_pid_stat_reader.h"
 #include "src/common/system/system.h"
 #include "src/shared/metadata/metadata.h"
 #include "src/stirling/core/canonical_types.h"
@@ -56,15 +57,14 @@ class ProcessStatsConnector : public SourceConnector {
   void TransferDataImpl(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables) override;
 
  protected:
-  explicit ProcessStatsConnector(std::string_view source_name)
-      : SourceConnector(source_name, kTables) {
-    proc_parser_ = std::make_unique<system::ProcParser>(sysconfig_);
-  }
+  explicit ProcessStatsConnector(std::string_view source_name);
 
  private:
   void TransferProcessStatsTable(ConnectorContext* ctx, DataTable* data_table);
 
-  std::unique_ptr<system::ProcParser> proc_parser_;
+  // Keeps /proc/<pid>/{stat,io} open across iterations, so that each iteration
+  // only re-reads and parses the files.
+  std::unique_ptr<system::ProcPIDStatReader> stat_reader_;
 };
 
 }  // namespace stirling
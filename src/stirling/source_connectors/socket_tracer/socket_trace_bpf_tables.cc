@@ -42,9 +42,12 @@ NO_OPT_ATTR void ConnInfoMapCleanupTrigger(int n, struct conn_id_t* conn_id_vec)
 namespace px {
 namespace stirling {
 
-ConnInfoMapManager::ConnInfoMapManager(bpf_tools::BCCWrapper* bcc)
-    : conn_info_map_(bcc->GetHashTable<uint64_t, struct conn_info_t>("conn_info_map")),
-      conn_disabled_map_(bcc->GetHashTable<uint64_t, uint64_t>("conn_disabled_map")) {
+namespace {
+constexpr char kConnInfoMapName[] = "conn_info_map";
+constexpr char kConnDisabledMapName[] = "conn_disabled_map";
+}  // namespace
+
+ConnInfoMapManager::ConnInfoMapManager(bpf_tools::BCCWrapper* bcc) : bcc_(bcc) {
   // Use address instead of symbol to specify this probe,
   // so that even if debug symbols are stripped, the uprobe can still attach.
   uint64_t symbol_addr = reinterpret_cast<uint64_t>(&ConnInfoMapCleanupTrigger);
@@ -70,17 +73,32 @@ void ConnInfoMapManager::ReleaseResources(struct conn_id_t conn_id) {
 }
 
 void ConnInfoMapManager::Disable(struct conn_id_t conn_id) {
-  uint64_t key = id(conn_id);
+  pending_disable_keys_.push_back(id(conn_id));
+  pending_disable_tsids_.push_back(conn_id.tsid);
+}
 
-  if (!conn_disabled_map_.update_value(key, conn_id.tsid).ok()) {
-    VLOG(1) << absl::Substitute("$0 Updating conn_disable_map entry failed.", ToString(conn_id));
+void ConnInfoMapManager::FlushDisabled() {
+  Status s = bcc_->UpdateBatch<uint64_t, uint64_t>(kConnDisabledMapName, pending_disable_keys_,
+                                                   pending_disable_tsids_);
+  if (!s.ok()) {
+    VLOG(1) << absl::Substitute("Updating $0 conn_disable_map entries failed: $1",
+                                pending_disable_keys_.size(), s.msg());
   }
+  pending_disable_keys_.clear();
+  pending_disable_tsids_.clear();
 }
 
 void ConnInfoMapManager::CleanupBPFMapLeaks(ConnTrackersManager* conn_trackers_mgr) {
   const auto& sysconfig = system::Config::GetInstance();
 
-  for (const auto& [pid_fd, conn_info] : conn_info_map_.get_table_offline()) {
+  auto conn_infos_or = bcc_->LookupBatch<uint64_t, struct conn_info_t>(kConnInfoMapName);
+  if (!conn_infos_or.ok()) {
+    LOG(WARNING) << absl::Substitute("Failed to read $0: $1", kConnInfoMapName,
+                                     conn_infos_or.msg());
+    return;
+  }
+
+  for (const auto& [pid_fd, conn_info] : conn_infos_or.ValueOrDie()) {
     uint32_t pid = pid_fd >> 32;
     int32_t fd = pid_fd;
 
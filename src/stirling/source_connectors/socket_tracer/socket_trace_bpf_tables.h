@@ -38,16 +38,23 @@ class ConnInfoMapManager {
 
   void ReleaseResources(struct conn_id_t conn_id);
 
+  // Queues the connection to be disabled in BPF. Takes effect on the next FlushDisabled().
   void Disable(struct conn_id_t conn_id);
 
+  // Writes all queued disables to conn_disabled_map, with a single batched update.
+  void FlushDisabled();
+
   void CleanupBPFMapLeaks(ConnTrackersManager* conn_trackers_mgr);
 
  private:
-  ebpf::BPFHashTable<uint64_t, struct conn_info_t> conn_info_map_;
-  ebpf::BPFHashTable<uint64_t, uint64_t> conn_disabled_map_;
+  bpf_tools::BCCWrapper* bcc_;
 
   std::vector<struct conn_id_t> pending_release_queue_;
 
+  // Keys and TSIDs of conn_disabled_map entries waiting for FlushDisabled().
+  std::vector<uint64_t> pending_disable_keys_;
+  std::vector<uint64_t> pending_disable_tsids_;
+
   // TODO(oazizi): Can we share this with the similar function in socket_trace.c?
   uint64_t id(struct conn_id_t conn_id) const {
     return (static_cast<uint64_t>(conn_id.upid.tgid) << 32) | conn_id.fd;
@@ -499,7 +499,8 @@ std::string DumpContext(ConnectorContext* ctx) {
 template <typename TBPFTableKey, typename TBPFTableVal>
 std::string BPFMapInfo(bpf_tools::BCCWrapper* bcc, std::string_view name) {
   auto map = bcc->GetHashTable<TBPFTableKey, TBPFTableVal>(name.data());
-  size_t map_size = map.get_table_offline().size();
+  size_t map_size =
+      bcc->LookupBatch<TBPFTableKey, TBPFTableVal>(std::string(name)).ValueOr({}).size();
   if (1.0 * map_size / map.capacity() > 0.9) {
     LOG(WARNING) << absl::Substitute("BPF Table $0 is nearly at capacity [size=$0 capacity=$1]",
                                      map_size, map.capacity());
@@ -653,6 +654,11 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     conn_tracker->IterationPostTick();
   }
 
+  // Push the connections disabled during this iteration to BPF in one go.
+  if (conn_info_map_mgr_ != nullptr) {
+    conn_info_map_mgr_->FlushDisabled();
+  }
+
   // Once we've cleared all the debug trace levels for this pid, we can remove it from the list.
   pids_to_trace_disable_.clear();
 }
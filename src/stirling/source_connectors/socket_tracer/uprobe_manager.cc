@@ -499,14 +499,18 @@ std::thread UProbeManager::RunDeployUProbesThread(const absl::flat_hash_set<md::
 }
 
 void UProbeManager::CleanupPIDMaps(const absl::flat_hash_set<md::UPID>& deleted_upids) {
-  for (const auto& pid : deleted_upids) {
-    openssl_symaddrs_map_->RemoveValue(pid.pid());
-    go_common_symaddrs_map_->RemoveValue(pid.pid());
-    go_tls_symaddrs_map_->RemoveValue(pid.pid());
-    go_http2_symaddrs_map_->RemoveValue(pid.pid());
-    node_tlswrap_symaddrs_map_->RemoveValue(pid.pid());
-    go_goid_map_->RemoveValue(pid.pid());
+  std::vector<uint32_t> pids;
+  pids.reserve(deleted_upids.size());
+  for (const auto& upid : deleted_upids) {
+    pids.push_back(upid.pid());
   }
+
+  openssl_symaddrs_map_->RemoveValues(pids);
+  go_common_symaddrs_map_->RemoveValues(pids);
+  go_tls_symaddrs_map_->RemoveValues(pids);
+  go_http2_symaddrs_map_->RemoveValues(pids);
+  node_tlswrap_symaddrs_map_->RemoveValues(pids);
+  go_goid_map_->RemoveValues(pids);
 }
 
 int UProbeManager::DeployOpenSSLUProbes(const absl::flat_hash_set<md::UPID>& pids) {
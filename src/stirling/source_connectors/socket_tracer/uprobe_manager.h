@@ -55,7 +55,7 @@ struct UProbeTmpl {
 };
 
 // A wrapper around BPF maps that are exclusively written by user-space.
-// Provides an optimized RemoveValue() interface that avoids the BPF access
+// Provides optimized RemoveValue()/RemoveValues() interfaces that avoid the BPF access
 // if the key doesn't exist.
 template <typename TKeyType, typename TValueType,
           typename TMapType = ebpf::BPFHashTable<TKeyType, TValueType>>
@@ -82,8 +82,34 @@ class UserSpaceManagedBPFMap {
     }
   }
 
+  // Removes the keys with a single batched delete, where supported.
+  void RemoveValues(const std::vector<TKeyType>& keys) {
+    std::vector<TKeyType> present_keys;
+    for (const auto& key : keys) {
+      if (shadow_keys_.erase(key) != 0) {
+        present_keys.push_back(key);
+      }
+    }
+    if (present_keys.empty()) {
+      return;
+    }
+
+    if constexpr (std::is_same_v<TMapType, ebpf::BPFMapInMapTable<TKeyType>>) {
+      // Batch operations are not available on all kernels for map-in-map types.
+      for (const auto& key : present_keys) {
+        map_->remove_value(key);
+      }
+    } else {
+      Status s = bcc_->DeleteBatch<TKeyType, TValueType>(map_name_, present_keys);
+      if (!s.ok()) {
+        LOG(WARNING) << absl::StrCat("Could not remove from BPF map. Message=", s.msg());
+      }
+    }
+  }
+
  private:
-  UserSpaceManagedBPFMap(bpf_tools::BCCWrapper* bcc, const std::string& map_name) {
+  UserSpaceManagedBPFMap(bpf_tools::BCCWrapper* bcc, const std::string& map_name)
+      : bcc_(bcc), map_name_(map_name) {
     if constexpr (std::is_same_v<TMapType, ebpf::BPFMapInMapTable<TKeyType>>) {
       map_ = std::make_unique<TMapType>(bcc->GetMapInMapTable<TKeyType>(map_name));
     } else {
@@ -91,6 +117,8 @@ class UserSpaceManagedBPFMap {
     }
   }
 
+  bpf_tools::BCCWrapper* bcc_;
+  std::string map_name_;
   std::unique_ptr<TMapType> map_;
   absl::flat_hash_set<TKeyType> shadow_keys_;
 };
@@ -17,13 +17,18 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/util/bit-util.h>
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <absl/strings/str_format.h>
 #include "src/common/base/base.h"
+#include "src/common/zlib/zlib_wrapper.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/schema/row_batch.h"
@@ -43,7 +48,9 @@ Status RowBatch::AddColumn(const std::shared_ptr<arrow::Array>& col) {
   if (col->length() != num_rows_) {
     return error::InvalidArgument("Schema only allows $0 rows, got $1", num_rows_, col->length());
   }
-  if (col->type_id() != types::ToArrowType(desc_.type(columns_.size()))) {
+  auto dt = desc_.type(columns_.size());
+  bool dictionary_string = dt == DataType::STRING && types::IsDictionaryEncoded(col.get());
+  if (!dictionary_string && col->type_id() != types::ToArrowType(dt)) {
     return error::InvalidArgument("Column[$0] was given incorrect type", columns_.size());
   }
 
@@ -78,6 +85,29 @@ int64_t RowBatch::NumBytes() const {
   return total_bytes;
 }
 
+bool RowBatch::HasDictionaryColumns() const {
+  return std::any_of(columns_.begin(), columns_.end(),
+                     [](const auto& col) { return types::IsDictionaryEncoded(col.get()); });
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::DecodeDictionaryColumns(
+    arrow::MemoryPool* mem_pool, const std::vector<int64_t>& keep_encoded) const {
+  auto output_rb = std::make_unique<RowBatch>(desc_, num_rows_);
+  for (int64_t col_idx = 0; col_idx < static_cast<int64_t>(columns_.size()); ++col_idx) {
+    const auto& col = columns_[col_idx];
+    bool keep = std::find(keep_encoded.begin(), keep_encoded.end(), col_idx) != keep_encoded.end();
+    if (keep || !types::IsDictionaryEncoded(col.get())) {
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(col));
+    } else {
+      PL_RETURN_IF_ERROR(
+          output_rb->AddColumn(types::DecodeStringDictionaryArray(col.get(), mem_pool)));
+    }
+  }
+  output_rb->set_eow(eow_);
+  output_rb->set_eos(eos_);
+  return output_rb;
+}
+
 // Serialize/deserialize from protobuf.
 
 // PL_CARNOT_UPDATE_FOR_NEW_TYPES
@@ -119,6 +149,13 @@ constexpr const auto& GetPBDataColumn(const table_store::schemapb::Column& data_
   }
 }
 
+// Fixed-width numeric columns share their memory layout between arrow and the repeated proto
+// fields, so they are copied in bulk instead of one value at a time.
+template <DataType T>
+constexpr bool IsBulkCopyable() {
+  return T == DataType::INT64 || T == DataType::TIME64NS || T == DataType::FLOAT64;
+}
+
 template <DataType T>
 void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array* input_column) {
   CHECK_NOTNULL(input_column);
@@ -126,14 +163,32 @@ void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array
 
   size_t col_length = input_column->length();
   auto casted_output_data = GetMutablePBDataColumn<T>(output_column);
-  for (size_t i = 0; i < col_length; ++i) {
-    if constexpr (T == DataType::UINT128) {
+  auto output_data = casted_output_data->mutable_data();
+  if constexpr (IsBulkCopyable<T>()) {
+    using native_type = typename types::DataTypeTraits<T>::native_type;
+    auto typed_input =
+        static_cast<const typename types::DataTypeTraits<T>::arrow_array_type*>(input_column);
+    output_data->Resize(col_length, native_type{});
+    std::memcpy(output_data->mutable_data(), typed_input->raw_values(),
+                col_length * sizeof(native_type));
+  } else if constexpr (T == DataType::BOOLEAN) {
+    output_data->Resize(col_length, false);
+    for (size_t i = 0; i < col_length; ++i) {
+      output_data->Set(i, types::GetValueFromArrowArray<T>(input_column, i));
+    }
+  } else if constexpr (T == DataType::STRING) {
+    output_data->Reserve(col_length);
+    for (size_t i = 0; i < col_length; ++i) {
+      auto val = types::GetStringViewFromArrowArray(input_column, i);
+      casted_output_data->add_data(val.data(), val.size());
+    }
+  } else {
+    output_data->Reserve(col_length);
+    for (size_t i = 0; i < col_length; ++i) {
       auto out_datum = casted_output_data->add_data();
       auto val = types::GetValueFromArrowArray<DataType::UINT128>(input_column, i);
       out_datum->set_high(absl::Uint128High64(val));
       out_datum->set_low(absl::Uint128Low64(val));
-    } else {
-      casted_output_data->add_data(types::GetValueFromArrowArray<T>(input_column, i));
     }
   }
 }
@@ -144,14 +199,29 @@ Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
   CHECK_NOTNULL(output_column);
 
   auto builder = MakeArrowBuilder(T, arrow::default_memory_pool());
-  auto input_data = GetPBDataColumn<T>(input_column);
+  const auto& input_data = GetPBDataColumn<T>(input_column);
   PL_RETURN_IF_ERROR(builder->Reserve(input_data.data_size()));
 
-  for (const auto& datum : input_data.data()) {
-    if constexpr (T == DataType::UINT128) {
-      PL_RETURN_IF_ERROR(CopyValue<T>(builder.get(), types::UInt128Value(datum).val));
-    } else {
-      PL_RETURN_IF_ERROR(CopyValue<T>(builder.get(), datum));
+  if constexpr (IsBulkCopyable<T>()) {
+    auto typed_builder =
+        static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder.get());
+    PL_RETURN_IF_ERROR(
+        typed_builder->AppendValues(input_data.data().data(), input_data.data_size()));
+  } else {
+    if constexpr (T == DataType::STRING) {
+      int64_t total_bytes = 0;
+      for (const auto& datum : input_data.data()) {
+        total_bytes += datum.size();
+      }
+      auto typed_builder = static_cast<arrow::StringBuilder*>(builder.get());
+      PL_RETURN_IF_ERROR(typed_builder->ReserveData(total_bytes));
+    }
+    for (const auto& datum : input_data.data()) {
+      if constexpr (T == DataType::UINT128) {
+        PL_RETURN_IF_ERROR(CopyValue<T>(builder.get(), types::UInt128Value(datum).val));
+      } else {
+        PL_RETURN_IF_ERROR(CopyValue<T>(builder.get(), datum));
+      }
     }
   }
   PL_RETURN_IF_ERROR(builder->Finish(output_column));
@@ -223,6 +293,259 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromProto(
   return output_rb;
 }
 
+// Serialize/deserialize from raw Arrow buffers.
+
+namespace {
+
+// Every buffer in the body of an ArrowRowBatchData starts at a multiple of this, so that the
+// columns read in place from a received body are aligned for their widest type (UINT128).
+constexpr int64_t kArrowBodyAlignment = 16;
+// zlib can't compress data by more than this ratio, which bounds the size of an inflated body
+// before allocating it.
+constexpr int64_t kMaxDeflateRatio = 1032;
+
+// Owns the body of a received ArrowRowBatchData. The decoded columns' buffers are slices of it.
+class StringBuffer : public arrow::Buffer {
+ public:
+  explicit StringBuffer(std::string str) : arrow::Buffer(nullptr, 0), str_(std::move(str)) {
+    data_ = reinterpret_cast<const uint8_t*>(str_.data());
+    size_ = static_cast<int64_t>(str_.size());
+    capacity_ = size_;
+  }
+
+ private:
+  std::string str_;
+};
+
+// PL_CARNOT_UPDATE_FOR_NEW_TYPES
+bool HasArrowBodyLayout(DataType type) {
+  switch (type) {
+    case DataType::BOOLEAN:
+    case DataType::INT64:
+    case DataType::UINT128:
+    case DataType::FLOAT64:
+    case DataType::STRING:
+    case DataType::TIME64NS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Appends the lengths of the buffers that hold the rows of col: validity, then the bit-packed
+// values for booleans, offsets and characters for strings, or the fixed width values otherwise.
+void AppendArrowBufferLengths(DataType type, const arrow::Array& col,
+                              std::vector<int64_t>* lengths) {
+  const int64_t num_rows = col.length();
+  lengths->push_back(col.null_count() > 0 ? arrow::BitUtil::BytesForBits(num_rows) : 0);
+  if (type == DataType::BOOLEAN) {
+    lengths->push_back(arrow::BitUtil::BytesForBits(num_rows));
+  } else if (type == DataType::STRING) {
+    const auto& str_col = static_cast<const arrow::StringArray&>(col);
+    lengths->push_back((num_rows + 1) * sizeof(int32_t));
+    lengths->push_back(str_col.value_offset(num_rows) - str_col.value_offset(0));
+  } else {
+    lengths->push_back(num_rows * types::ArrowTypeToBytes(types::ToArrowType(type)));
+  }
+}
+
+// Copies the buffers measured by AppendArrowBufferLengths into body, starting at *pos. Sliced
+// columns are shifted to start at their first row, and string offsets are rebased to zero.
+void CopyArrowBuffers(DataType type, const arrow::Array& col, const int64_t** lengths,
+                      uint8_t* body, int64_t* pos) {
+  auto next_buffer = [&]() {
+    uint8_t* dest = body + *pos;
+    *pos = SnapUpToMultiple<int64_t>(*pos + *(*lengths)++, kArrowBodyAlignment);
+    return dest;
+  };
+  const arrow::ArrayData& data = *col.data();
+  const int64_t num_rows = data.length;
+
+  uint8_t* validity = next_buffer();
+  if (col.null_count() > 0) {
+    arrow::internal::CopyBitmap(data.buffers[0]->data(), data.offset, num_rows, validity, 0);
+  }
+  if (type == DataType::BOOLEAN) {
+    uint8_t* values = next_buffer();
+    if (num_rows > 0) {
+      arrow::internal::CopyBitmap(data.buffers[1]->data(), data.offset, num_rows, values, 0);
+    }
+  } else if (type == DataType::STRING) {
+    const auto& str_col = static_cast<const arrow::StringArray&>(col);
+    auto* offsets = reinterpret_cast<int32_t*>(next_buffer());
+    const int32_t first_offset = str_col.value_offset(0);
+    for (int64_t i = 0; i <= num_rows; ++i) {
+      offsets[i] = str_col.value_offset(i) - first_offset;
+    }
+    uint8_t* chars = next_buffer();
+    if (offsets[num_rows] > 0) {
+      std::memcpy(chars, str_col.value_data()->data() + first_offset, offsets[num_rows]);
+    }
+  } else {
+    const int64_t width = types::ArrowTypeToBytes(types::ToArrowType(type));
+    uint8_t* values = next_buffer();
+    if (num_rows > 0) {
+      std::memcpy(values, data.buffers[1]->data() + data.offset * width, num_rows * width);
+    }
+  }
+}
+
+// Checks that string offsets start at zero, never decrease and stay within the characters.
+Status ValidateStringOffsets(const arrow::Buffer& offsets_buffer, int64_t num_rows,
+                             int64_t chars_length) {
+  const auto* offsets = reinterpret_cast<const int32_t*>(offsets_buffer.data());
+  if (offsets[0] != 0 || offsets[num_rows] > chars_length) {
+    return error::InvalidArgument("Arrow row batch has invalid string offsets");
+  }
+  for (int64_t i = 0; i < num_rows; ++i) {
+    if (offsets[i + 1] < offsets[i]) {
+      return error::InvalidArgument("Arrow row batch has invalid string offsets");
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+Status RowBatch::ToArrowProto(table_store::schemapb::ArrowRowBatchData* proto,
+                              bool deflate) const {
+  // The wire format only carries plain columns, so the strings are materialized here.
+  if (HasDictionaryColumns()) {
+    PL_ASSIGN_OR_RETURN(auto decoded, DecodeDictionaryColumns(arrow::default_memory_pool()));
+    return decoded->ToArrowProto(proto, deflate);
+  }
+  proto->set_num_rows(num_rows_);
+  proto->set_eow(eow_);
+  proto->set_eos(eos_);
+
+  std::vector<int64_t> lengths;
+  for (auto col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    proto->add_col_types(desc_.type(col_idx));
+    AppendArrowBufferLengths(desc_.type(col_idx), *ColumnAt(col_idx), &lengths);
+  }
+  int64_t body_size = 0;
+  for (auto length : lengths) {
+    proto->add_buffer_lengths(length);
+    body_size = SnapUpToMultiple<int64_t>(body_size + length, kArrowBodyAlignment);
+  }
+
+  std::string body(body_size, '\0');
+  const int64_t* next_length = lengths.data();
+  int64_t pos = 0;
+  for (auto col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    CopyArrowBuffers(desc_.type(col_idx), *ColumnAt(col_idx), &next_length,
+                     reinterpret_cast<uint8_t*>(body.data()), &pos);
+  }
+
+  proto->set_body_size(body_size);
+  if (deflate) {
+    PL_ASSIGN_OR_RETURN(*proto->mutable_body(), zlib::Deflate(body));
+    proto->set_deflated(true);
+  } else {
+    *proto->mutable_body() = std::move(body);
+  }
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromArrowProto(
+    table_store::schemapb::ArrowRowBatchData* proto) {
+  const int64_t num_rows = proto->num_rows();
+  const int64_t max_body_size = static_cast<int64_t>(proto->body().size()) *
+                                (proto->deflated() ? kMaxDeflateRatio : 1);
+  if (proto->body_size() < 0 || proto->body_size() > max_body_size || num_rows < 0 ||
+      (proto->col_types_size() > 0 && num_rows > proto->body_size() * 8)) {
+    return error::InvalidArgument("Arrow row batch has an invalid size");
+  }
+
+  std::string body;
+  if (proto->deflated()) {
+    PL_ASSIGN_OR_RETURN(body, zlib::Inflate(proto->body(), proto->body_size() + 1));
+  } else {
+    body = std::move(*proto->mutable_body());
+  }
+  if (static_cast<int64_t>(body.size()) != proto->body_size()) {
+    return error::InvalidArgument("Arrow row batch body has $0 bytes, expected $1", body.size(),
+                                  proto->body_size());
+  }
+  std::shared_ptr<arrow::Buffer> body_buffer = std::make_shared<StringBuffer>(std::move(body));
+  if (reinterpret_cast<uintptr_t>(body_buffer->data()) % kArrowBodyAlignment != 0) {
+    // Only bodies short enough for std::string to store inline can be misaligned.
+    std::shared_ptr<arrow::Buffer> aligned;
+    PL_RETURN_IF_ERROR(
+        body_buffer->Copy(0, body_buffer->size(), arrow::default_memory_pool(), &aligned));
+    body_buffer = std::move(aligned);
+  }
+
+  int64_t length_idx = 0;
+  int64_t pos = 0;
+  auto next_buffer = [&](int64_t min_length) -> StatusOr<std::shared_ptr<arrow::Buffer>> {
+    if (length_idx >= proto->buffer_lengths_size()) {
+      return error::InvalidArgument("Arrow row batch has too few buffers");
+    }
+    int64_t length = proto->buffer_lengths(length_idx++);
+    if (length < min_length || length > body_buffer->size() - pos) {
+      return error::InvalidArgument("Arrow row batch buffer $0 is invalid", length_idx - 1);
+    }
+    auto buffer = arrow::SliceBuffer(body_buffer, pos, length);
+    pos = SnapUpToMultiple<int64_t>(pos + length, kArrowBodyAlignment);
+    return buffer;
+  };
+
+  std::vector<DataType> col_types(proto->col_types_size());
+  std::vector<std::shared_ptr<arrow::Array>> data_columns(proto->col_types_size());
+  for (auto i = 0; i < proto->col_types_size(); ++i) {
+    col_types[i] = proto->col_types(i);
+    if (!HasArrowBodyLayout(col_types[i])) {
+      return error::InvalidArgument("Arrow row batch has unsupported column type '$0'",
+                                    magic_enum::enum_name(col_types[i]));
+    }
+
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+    PL_ASSIGN_OR_RETURN(auto validity, next_buffer(0));
+    int64_t null_count = 0;
+    if (validity->size() == 0) {
+      validity = nullptr;
+    } else if (validity->size() < arrow::BitUtil::BytesForBits(num_rows)) {
+      return error::InvalidArgument("Arrow row batch has an invalid validity buffer");
+    } else {
+      null_count = arrow::kUnknownNullCount;
+    }
+    buffers.push_back(std::move(validity));
+
+    if (col_types[i] == DataType::BOOLEAN) {
+      PL_ASSIGN_OR_RETURN(auto values, next_buffer(arrow::BitUtil::BytesForBits(num_rows)));
+      buffers.push_back(std::move(values));
+    } else if (col_types[i] == DataType::STRING) {
+      PL_ASSIGN_OR_RETURN(auto offsets, next_buffer((num_rows + 1) * sizeof(int32_t)));
+      PL_ASSIGN_OR_RETURN(auto chars, next_buffer(0));
+      PL_RETURN_IF_ERROR(ValidateStringOffsets(*offsets, num_rows, chars->size()));
+      buffers.push_back(std::move(offsets));
+      buffers.push_back(std::move(chars));
+    } else {
+      const int64_t width = types::ArrowTypeToBytes(types::ToArrowType(col_types[i]));
+      PL_ASSIGN_OR_RETURN(auto values, next_buffer(num_rows * width));
+      buffers.push_back(std::move(values));
+    }
+
+    auto arrow_type = types::MakeArrowBuilder(col_types[i], arrow::default_memory_pool())->type();
+    data_columns[i] = arrow::MakeArray(
+        arrow::ArrayData::Make(arrow_type, num_rows, std::move(buffers), null_count));
+  }
+  if (length_idx != proto->buffer_lengths_size()) {
+    return error::InvalidArgument("Arrow row batch has $0 buffers, expected $1",
+                                  proto->buffer_lengths_size(), length_idx);
+  }
+
+  RowDescriptor desc(col_types);
+  std::unique_ptr<RowBatch> output_rb = std::make_unique<RowBatch>(desc, num_rows);
+  output_rb->set_eow(proto->eow());
+  output_rb->set_eos(proto->eos());
+  for (const auto& col : data_columns) {
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(col));
+  }
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromColumnBuilders(
     const RowDescriptor& desc, bool eow, bool eos,
     std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders) {
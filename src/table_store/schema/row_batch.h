@@ -53,6 +53,22 @@ class RowBatch {
   static StatusOr<std::unique_ptr<RowBatch>> FromProto(
       const table_store::schemapb::RowBatchData& row_batch_proto);
 
+  /**
+   * Serializes the row batch as the raw Arrow buffers of its columns. Only the rows of sliced
+   * columns are written, not the whole buffers they share with their parent.
+   *
+   * @ param row_batch_proto the proto to fill in.
+   * @ param deflate whether to gzip compress the body.
+   */
+  Status ToArrowProto(table_store::schemapb::ArrowRowBatchData* row_batch_proto,
+                      bool deflate) const;
+  /**
+   * Deserializes a row batch written by ToArrowProto. The body is moved out of the proto and the
+   * columns reference it in place rather than copying it.
+   */
+  static StatusOr<std::unique_ptr<RowBatch>> FromArrowProto(
+      table_store::schemapb::ArrowRowBatchData* row_batch_proto);
+
   static StatusOr<std::unique_ptr<RowBatch>> FromColumnBuilders(
       const RowDescriptor& desc, bool eow, bool eos,
       std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders);
@@ -78,6 +94,7 @@ class RowBatch {
 
   /**
    * Adds the given column to the row batch, given that it correctly fits the schema.
+   * STRING columns may be dictionary encoded (see types::MakeStringDictionaryArray).
    * param col ptr to the arrow array that should be added to the row batch.
    */
   Status AddColumn(const std::shared_ptr<arrow::Array>& col);
@@ -120,6 +137,21 @@ class RowBatch {
 
   int64_t NumBytes() const;
 
+  /**
+   * @ return whether any of the STRING columns is dictionary encoded.
+   */
+  bool HasDictionaryColumns() const;
+
+  /**
+   * Returns a copy of the row batch where the dictionary encoded columns are materialized as
+   * plain string columns. Other columns are shared with this row batch.
+   *
+   * @ param mem_pool the pool to allocate the decoded strings from.
+   * @ param keep_encoded indices of the columns to leave dictionary encoded.
+   */
+  StatusOr<std::unique_ptr<RowBatch>> DecodeDictionaryColumns(
+      arrow::MemoryPool* mem_pool, const std::vector<int64_t>& keep_encoded = {}) const;
+
  private:
   RowDescriptor desc_;
   int64_t num_rows_;
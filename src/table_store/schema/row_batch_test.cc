@@ -17,6 +17,7 @@
  */
 
 #include <arrow/array.h>
+#include <arrow/builder.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <vector>
@@ -179,6 +180,118 @@ TEST_F(RowBatchTest, to_from_proto) {
   EXPECT_TRUE(differ.Compare(input_proto, output_proto));
 }
 
+TEST_F(RowBatchTest, sliced_to_from_proto) {
+  // Slices share buffers with an offset, which the bulk column copies must respect.
+  ASSERT_OK_AND_ASSIGN(auto sliced_rb, rb_->Slice(1, 2));
+
+  table_store::schemapb::RowBatchData proto;
+  EXPECT_OK(sliced_rb->ToProto(&proto));
+  ASSERT_EQ(3, proto.cols_size());
+  EXPECT_THAT(proto.cols(0).boolean_data().data(), ::testing::ElementsAre(false, true));
+  EXPECT_THAT(proto.cols(1).int64_data().data(), ::testing::ElementsAre(4, 5));
+  EXPECT_THAT(proto.cols(2).float64_data().data(), ::testing::ElementsAre(4.1, 5.6));
+
+  auto rb = RowBatch::FromProto(proto).ConsumeValueOrDie();
+  EXPECT_EQ(sliced_rb->DebugString(), rb->DebugString());
+}
+
+TEST_F(RowBatchTest, to_from_arrow_proto) {
+  table_store::schemapb::RowBatchData input_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kTestRowBatchProto, &input_proto));
+  auto input_rb = RowBatch::FromProto(input_proto).ConsumeValueOrDie();
+
+  for (bool deflate : {false, true}) {
+    table_store::schemapb::ArrowRowBatchData arrow_proto;
+    EXPECT_OK(input_rb->ToArrowProto(&arrow_proto, deflate));
+    EXPECT_EQ(deflate, arrow_proto.deflated());
+    ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromArrowProto(&arrow_proto));
+    EXPECT_TRUE(rb->eow());
+    EXPECT_FALSE(rb->eos());
+    EXPECT_EQ(input_rb->desc(), rb->desc());
+
+    table_store::schemapb::RowBatchData output_proto;
+    EXPECT_OK(rb->ToProto(&output_proto));
+    google::protobuf::util::MessageDifferencer differ;
+    EXPECT_TRUE(differ.Compare(input_proto, output_proto));
+  }
+}
+
+TEST_F(RowBatchTest, sliced_to_from_arrow_proto) {
+  // Only the rows of the slice are sent, starting from the first bit of the boolean bitmap.
+  ASSERT_OK_AND_ASSIGN(auto sliced_rb, rb_->Slice(1, 2));
+
+  table_store::schemapb::ArrowRowBatchData proto;
+  EXPECT_OK(sliced_rb->ToArrowProto(&proto, /* deflate */ false));
+  EXPECT_THAT(proto.buffer_lengths(), ::testing::ElementsAre(0, 1, 0, 16, 0, 16));
+
+  ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromArrowProto(&proto));
+  EXPECT_EQ(sliced_rb->DebugString(), rb->DebugString());
+}
+
+TEST_F(RowBatchTest, sliced_strings_to_from_arrow_proto) {
+  std::vector<types::StringValue> strs = {"a", "bc", "def", "ghij"};
+  RowBatch input_rb(RowDescriptor({types::DataType::STRING}), strs.size());
+  EXPECT_OK(input_rb.AddColumn(types::ToArrow(strs, arrow::default_memory_pool())));
+  ASSERT_OK_AND_ASSIGN(auto sliced_rb, input_rb.Slice(2, 2));
+
+  table_store::schemapb::ArrowRowBatchData proto;
+  EXPECT_OK(sliced_rb->ToArrowProto(&proto, /* deflate */ false));
+  // Three offsets rebased to start at zero, then only the characters of "def" and "ghij".
+  EXPECT_THAT(proto.buffer_lengths(), ::testing::ElementsAre(0, 12, 7));
+
+  ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromArrowProto(&proto));
+  EXPECT_EQ(sliced_rb->DebugString(), rb->DebugString());
+}
+
+TEST_F(RowBatchTest, dictionary_columns) {
+  std::vector<types::Int64Value> ints = {1, 2, 3, 4};
+  std::vector<types::StringValue> values = {"pod-a", "pod-b"};
+  auto ints_arr = types::ToArrow(ints, arrow::default_memory_pool());
+  arrow::Int32Builder codes_builder;
+  ASSERT_TRUE(codes_builder.AppendValues(std::vector<int32_t>{1, 0, 1, 1}).ok());
+  std::shared_ptr<arrow::Array> codes;
+  ASSERT_TRUE(codes_builder.Finish(&codes).ok());
+  auto dict_col =
+      types::MakeStringDictionaryArray(codes, types::ToArrow(values, arrow::default_memory_pool()));
+
+  RowBatch rb(RowDescriptor({types::DataType::INT64, types::DataType::STRING}), ints.size());
+  EXPECT_OK(rb.AddColumn(ints_arr));
+  EXPECT_OK(rb.AddColumn(dict_col));
+  rb.set_eow(true);
+  EXPECT_TRUE(rb.HasDictionaryColumns());
+  // Four int32 codes plus the two distinct values.
+  EXPECT_EQ(4 * 8 + 4 * 4 + 10, rb.NumBytes());
+
+  ASSERT_OK_AND_ASSIGN(auto kept, rb.DecodeDictionaryColumns(arrow::default_memory_pool(), {1}));
+  EXPECT_TRUE(kept->HasDictionaryColumns());
+
+  ASSERT_OK_AND_ASSIGN(auto decoded, rb.DecodeDictionaryColumns(arrow::default_memory_pool()));
+  EXPECT_FALSE(decoded->HasDictionaryColumns());
+  EXPECT_TRUE(decoded->eow());
+  EXPECT_EQ(ints_arr, decoded->ColumnAt(0));
+  std::vector<types::StringValue> expected = {"pod-b", "pod-a", "pod-b", "pod-b"};
+  EXPECT_TRUE(decoded->ColumnAt(1)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+
+  // Both wire formats carry the strings themselves.
+  table_store::schemapb::RowBatchData proto;
+  EXPECT_OK(rb.ToProto(&proto));
+  ASSERT_OK_AND_ASSIGN(auto from_proto, RowBatch::FromProto(proto));
+  EXPECT_EQ(decoded->DebugString(), from_proto->DebugString());
+
+  table_store::schemapb::ArrowRowBatchData arrow_proto;
+  EXPECT_OK(rb.ToArrowProto(&arrow_proto, /* deflate */ false));
+  ASSERT_OK_AND_ASSIGN(auto from_arrow_proto, RowBatch::FromArrowProto(&arrow_proto));
+  EXPECT_EQ(decoded->DebugString(), from_arrow_proto->DebugString());
+}
+
+TEST_F(RowBatchTest, invalid_arrow_proto) {
+  table_store::schemapb::ArrowRowBatchData proto;
+  EXPECT_OK(rb_->ToArrowProto(&proto, /* deflate */ false));
+  // The int64 column claims fewer bytes than its rows need.
+  proto.set_buffer_lengths(3, 8);
+  EXPECT_NOT_OK(RowBatch::FromArrowProto(&proto));
+}
+
 TEST_F(RowBatchTest, with_zero_rows) {
   bool eow = true;
   bool eos = false;
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/internal/arena_memory_pool.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <absl/strings/substitute.h>
+#include "src/common/base/base.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+// Arrow expects all buffers to be 64 byte aligned.
+constexpr int64_t kAlignment = 64;
+constexpr int64_t kPageSize = 4096;
+
+// Returned for zero sized allocations, like arrow's own pools do.
+alignas(kAlignment) uint8_t zero_size_area[1];
+
+int64_t RoundUp(int64_t size, int64_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+void ArenaMemoryPoolDeleter::operator()(ArenaMemoryPool* pool) const { pool->Release(); }
+
+ArenaMemoryPoolUPtr ArenaMemoryPool::Create(int64_t arena_size) {
+  return ArenaMemoryPoolUPtr(new ArenaMemoryPool(arena_size));
+}
+
+ArenaMemoryPool::ArenaMemoryPool(int64_t arena_size)
+    : arena_size_(RoundUp(std::max<int64_t>(arena_size, kPageSize), kPageSize)) {}
+
+ArenaMemoryPool::~ArenaMemoryPool() {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  for (const auto& [addr, arena] : arenas_) {
+    UnmapArena(arena);
+  }
+}
+
+void ArenaMemoryPool::Release() {
+  bool destroy;
+  {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    released_ = true;
+    destroy = num_allocations_ == 0;
+  }
+  if (destroy) {
+    delete this;
+  }
+}
+
+arrow::Status ArenaMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (size < 0) {
+    return arrow::Status::Invalid("negative malloc size");
+  }
+  if (size == 0) {
+    *out = zero_size_area;
+    return arrow::Status::OK();
+  }
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return AllocateUnlocked(size, out);
+}
+
+arrow::Status ArenaMemoryPool::AllocateUnlocked(int64_t size, uint8_t** out) {
+  int64_t aligned_size = RoundUp(size, kAlignment);
+  Arena* arena;
+  if (aligned_size > arena_size_) {
+    // Give buffers that don't fit in a regular arena an arena of their own, so that the current
+    // arena keeps being filled.
+    ARROW_RETURN_NOT_OK(NewArena(RoundUp(aligned_size, kPageSize), &arena));
+  } else {
+    if (current_ == nullptr || current_->used + aligned_size > current_->size) {
+      Arena* prev = current_;
+      ARROW_RETURN_NOT_OK(NewArena(arena_size_, &current_));
+      // The previous arena was only kept around to be filled further.
+      if (prev != nullptr && prev->num_allocations == 0) {
+        UnmapArena(*prev);
+        arenas_.erase(reinterpret_cast<uintptr_t>(prev->data));
+      }
+    }
+    arena = current_;
+  }
+
+  *out = arena->data + arena->used;
+  arena->used += aligned_size;
+  ++arena->num_allocations;
+  ++num_allocations_;
+  bytes_allocated_ += size;
+  max_bytes_allocated_ = std::max(max_bytes_allocated_, bytes_allocated_);
+  return arrow::Status::OK();
+}
+
+arrow::Status ArenaMemoryPool::Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  if (new_size < 0) {
+    return arrow::Status::Invalid("negative realloc size");
+  }
+  if (*ptr == zero_size_area) {
+    return Allocate(new_size, ptr);
+  }
+  bool destroy = false;
+  {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    if (new_size == 0) {
+      destroy = FreeUnlocked(*ptr, old_size);
+      *ptr = zero_size_area;
+    } else {
+      Arena* arena = FindArena(*ptr);
+      int64_t offset = *ptr - arena->data;
+      bool last_in_arena = offset + RoundUp(old_size, kAlignment) == arena->used;
+      int64_t new_end = offset + RoundUp(new_size, kAlignment);
+      // Shrink in place, or grow in place if the buffer is at the end of its arena.
+      if (new_size <= old_size || (last_in_arena && new_end <= arena->size)) {
+        if (last_in_arena) {
+          arena->used = new_end;
+        }
+        bytes_allocated_ += new_size - old_size;
+        max_bytes_allocated_ = std::max(max_bytes_allocated_, bytes_allocated_);
+        return arrow::Status::OK();
+      }
+
+      uint8_t* out;
+      ARROW_RETURN_NOT_OK(AllocateUnlocked(new_size, &out));
+      std::memcpy(out, *ptr, old_size);
+      // The old buffer's arena can't be released, since the pool is still in use.
+      FreeUnlocked(*ptr, old_size);
+      *ptr = out;
+      return arrow::Status::OK();
+    }
+  }
+  if (destroy) {
+    delete this;
+  }
+  return arrow::Status::OK();
+}
+
+void ArenaMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  if (buffer == zero_size_area) {
+    return;
+  }
+  bool destroy;
+  {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    destroy = FreeUnlocked(buffer, size);
+  }
+  if (destroy) {
+    delete this;
+  }
+}
+
+bool ArenaMemoryPool::FreeUnlocked(uint8_t* buffer, int64_t size) {
+  Arena* arena = FindArena(buffer);
+  DCHECK_GT(arena->num_allocations, 0);
+  --arena->num_allocations;
+  --num_allocations_;
+  bytes_allocated_ -= size;
+
+  if (arena->num_allocations == 0) {
+    if (arena == current_) {
+      // Start filling the current arena from the beginning again.
+      arena->used = 0;
+    } else {
+      UnmapArena(*arena);
+      arenas_.erase(reinterpret_cast<uintptr_t>(arena->data));
+    }
+  }
+  return released_ && num_allocations_ == 0;
+}
+
+arrow::Status ArenaMemoryPool::NewArena(int64_t size, Arena** arena) {
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) {
+    return arrow::Status::OutOfMemory(
+        absl::Substitute("Failed to map a $0 byte arena: $1", size, std::strerror(errno)));
+  }
+  auto addr = reinterpret_cast<uintptr_t>(data);
+  auto [it, inserted] =
+      arenas_.emplace(addr, Arena{static_cast<uint8_t*>(data), size, /*used*/ 0,
+                                  /*num_allocations*/ 0});
+  DCHECK(inserted);
+  arena_bytes_ += size;
+  *arena = &it->second;
+  return arrow::Status::OK();
+}
+
+void ArenaMemoryPool::UnmapArena(const Arena& arena) {
+  munmap(arena.data, arena.size);
+  arena_bytes_ -= arena.size;
+}
+
+ArenaMemoryPool::Arena* ArenaMemoryPool::FindArena(const uint8_t* buffer) {
+  auto it = arenas_.upper_bound(reinterpret_cast<uintptr_t>(buffer));
+  DCHECK(it != arenas_.begin());
+  --it;
+  DCHECK_LT(buffer, it->second.data + it->second.size);
+  return &it->second;
+}
+
+int64_t ArenaMemoryPool::bytes_allocated() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return bytes_allocated_;
+}
+
+int64_t ArenaMemoryPool::max_memory() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return max_bytes_allocated_;
+}
+
+int64_t ArenaMemoryPool::arena_bytes() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return arena_bytes_;
+}
+
+int64_t ArenaMemoryPool::num_arenas() const {
+  absl::base_internal::SpinLockHolder lock(&lock_);
+  return arenas_.size();
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include <absl/base/internal/spinlock.h>
+#include <absl/base/thread_annotations.h>
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class ArenaMemoryPool;
+
+/**
+ * ArenaMemoryPoolDeleter releases a pool from its owner. See ArenaMemoryPool::Release().
+ */
+struct ArenaMemoryPoolDeleter {
+  void operator()(ArenaMemoryPool* pool) const;
+};
+
+using ArenaMemoryPoolUPtr = std::unique_ptr<ArenaMemoryPool, ArenaMemoryPoolDeleter>;
+
+/**
+ * ArenaMemoryPool is an arrow::MemoryPool that carves buffers out of large anonymous memory
+ * mappings (arenas) with a bump pointer. An arena is unmapped as soon as the last buffer in it is
+ * freed, so memory is handed back to the OS wholesale instead of fragmenting the malloc heap.
+ *
+ * This works well for a table's cold batches: they are allocated and expired in the same (time)
+ * order, so arenas fill up and empty out one after another. Buffers larger than an arena get an
+ * arena of their own.
+ *
+ * Buffers can outlive the owner of the pool (eg. a query can still hold arrays of a table that has
+ * been deleted), so the pool is only destroyed once it has been released by its owner and all of
+ * its buffers have been freed.
+ */
+class ArenaMemoryPool : public arrow::MemoryPool {
+ public:
+  static constexpr int64_t kDefaultArenaSize = 1024 * 1024;
+
+  static ArenaMemoryPoolUPtr Create(int64_t arena_size = kDefaultArenaSize);
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  /**
+   * @return the number of bytes in buffers that are currently allocated from the pool.
+   */
+  int64_t bytes_allocated() const override;
+  int64_t max_memory() const override;
+
+  /**
+   * @return the number of bytes currently mapped for arenas. The difference with bytes_allocated()
+   * is the memory lost to fragmentation (and to the unused tail of the current arena).
+   */
+  int64_t arena_bytes() const;
+
+  /**
+   * @return the number of arenas currently mapped.
+   */
+  int64_t num_arenas() const;
+
+ private:
+  struct Arena {
+    uint8_t* data;
+    int64_t size;
+    // Offset of the first unused byte.
+    int64_t used;
+    int64_t num_allocations;
+  };
+
+  explicit ArenaMemoryPool(int64_t arena_size);
+  ~ArenaMemoryPool() override;
+
+  // Called by ArenaMemoryPoolDeleter. Destroys the pool now, or once its last buffer is freed.
+  void Release();
+
+  arrow::Status AllocateUnlocked(int64_t size, uint8_t** out) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns whether the pool should be destroyed, because it was released and has no buffers left.
+  bool FreeUnlocked(uint8_t* buffer, int64_t size) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  arrow::Status NewArena(int64_t size, Arena** arena) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void UnmapArena(const Arena& arena) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Arena* FindArena(const uint8_t* buffer) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const int64_t arena_size_;
+
+  mutable absl::base_internal::SpinLock lock_;
+  // Arenas keyed by their start address.
+  std::map<uintptr_t, Arena> arenas_ ABSL_GUARDED_BY(lock_);
+  // The arena that new (arena sized or smaller) buffers are carved from.
+  Arena* current_ ABSL_GUARDED_BY(lock_) = nullptr;
+  int64_t num_allocations_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t bytes_allocated_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t max_bytes_allocated_ ABSL_GUARDED_BY(lock_) = 0;
+  int64_t arena_bytes_ ABSL_GUARDED_BY(lock_) = 0;
+  bool released_ ABSL_GUARDED_BY(lock_) = false;
+
+  friend struct ArenaMemoryPoolDeleter;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
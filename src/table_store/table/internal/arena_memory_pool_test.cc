@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/table/internal/arena_memory_pool.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+TEST(ArenaMemoryPoolTest, AllocateFromArenas) {
+  auto pool = ArenaMemoryPool::Create(4096);
+
+  uint8_t* a;
+  uint8_t* b;
+  ASSERT_TRUE(pool->Allocate(100, &a).ok());
+  ASSERT_TRUE(pool->Allocate(100, &b).ok());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a) % 64);
+  EXPECT_EQ(a + 128, b);
+  EXPECT_EQ(200, pool->bytes_allocated());
+  EXPECT_EQ(1, pool->num_arenas());
+  EXPECT_EQ(4096, pool->arena_bytes());
+
+  // Buffers larger than an arena get their own arena, which is unmapped once the buffer is freed.
+  uint8_t* large;
+  ASSERT_TRUE(pool->Allocate(10000, &large).ok());
+  EXPECT_EQ(2, pool->num_arenas());
+  pool->Free(large, 10000);
+  EXPECT_EQ(1, pool->num_arenas());
+
+  // Filling up the current arena starts a new one. The first one is unmapped once it's empty.
+  uint8_t* c;
+  ASSERT_TRUE(pool->Allocate(4000, &c).ok());
+  EXPECT_EQ(2, pool->num_arenas());
+  pool->Free(a, 100);
+  EXPECT_EQ(2, pool->num_arenas());
+  pool->Free(b, 100);
+  EXPECT_EQ(1, pool->num_arenas());
+
+  pool->Free(c, 4000);
+  EXPECT_EQ(0, pool->bytes_allocated());
+  EXPECT_EQ(10000 + 200, pool->max_memory());
+}
+
+TEST(ArenaMemoryPoolTest, Reallocate) {
+  auto pool = ArenaMemoryPool::Create(4096);
+
+  uint8_t* a;
+  uint8_t* b;
+  ASSERT_TRUE(pool->Allocate(100, &a).ok());
+  ASSERT_TRUE(pool->Allocate(100, &b).ok());
+  std::memset(a, 1, 100);
+  std::memset(b, 2, 100);
+
+  // The last buffer in the arena grows in place.
+  uint8_t* old_b = b;
+  ASSERT_TRUE(pool->Reallocate(100, 1000, &b).ok());
+  EXPECT_EQ(old_b, b);
+  EXPECT_EQ(2, b[99]);
+
+  // Other buffers are moved.
+  uint8_t* old_a = a;
+  ASSERT_TRUE(pool->Reallocate(100, 200, &a).ok());
+  EXPECT_NE(old_a, a);
+  EXPECT_EQ(1, a[99]);
+
+  // Shrinking is always done in place.
+  old_b = b;
+  ASSERT_TRUE(pool->Reallocate(1000, 10, &b).ok());
+  EXPECT_EQ(old_b, b);
+  EXPECT_EQ(210, pool->bytes_allocated());
+
+  pool->Free(a, 200);
+  pool->Free(b, 10);
+  EXPECT_EQ(0, pool->bytes_allocated());
+}
+
+TEST(ArenaMemoryPoolTest, BuffersOutliveOwner) {
+  auto pool = ArenaMemoryPool::Create(4096);
+  ArenaMemoryPool* raw_pool = pool.get();
+
+  std::vector<uint8_t*> buffers(64);
+  for (auto& buffer : buffers) {
+    ASSERT_TRUE(pool->Allocate(256, &buffer).ok());
+  }
+  // Releasing the pool keeps it alive until the last buffer is freed.
+  pool.reset();
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = t; i < buffers.size(); i += 4) {
+        raw_pool->Free(buffers[i], 256);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
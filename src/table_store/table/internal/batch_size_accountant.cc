@@ -158,6 +158,18 @@ void BatchSizeAccountant::ExpireColdBatch() {
   cold_batch_bytes_.pop_front();
 }
 
+size_t BatchSizeAccountant::ExpireColdBatches(uint64_t bytes) {
+  size_t num_batches = 0;
+  uint64_t expired_bytes = 0;
+  while (num_batches < cold_batch_bytes_.size() && expired_bytes < bytes) {
+    expired_bytes += cold_batch_bytes_[num_batches];
+    ++num_batches;
+  }
+  cold_bytes_ -= expired_bytes;
+  cold_batch_bytes_.erase(cold_batch_bytes_.begin(), cold_batch_bytes_.begin() + num_batches);
+  return num_batches;
+}
+
 bool BatchSizeAccountant::CompactedBatchReady() const {
   return !compacted_batch_specs_.empty() &&
          (compacted_batch_specs_.front().bytes >= non_mutable_state_.compacted_size);
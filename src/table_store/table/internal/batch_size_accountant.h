@@ -113,6 +113,14 @@ class BatchSizeAccountant {
    * should update its accounting accordingly.
    */
   void ExpireColdBatch();
+  /**
+   * ExpireColdBatches notifies the BatchSizeAccountant that the fewest oldest cold batches holding
+   * at least `bytes` bytes (or all cold batches, if they hold fewer bytes) are being expired at
+   * once.
+   * @param bytes the number of bytes that need to be freed.
+   * @return the number of cold batches that should be removed from the front of the cold store.
+   */
+  size_t ExpireColdBatches(uint64_t bytes);
   /**
    * CompactedBatchReady returns whether there is enough data in the hot store to create a full
    * compacted batch.
@@ -201,6 +201,32 @@ TEST_P(BatchSizeAccountantTest, IndexThenCompactWithExpiry) {
   EXPECT_EQ(2 * half_compaction_rb_bytes_, accountant_->ColdBytes());
 }
 
+TEST_P(BatchSizeAccountantTest, ExpireColdBatches) {
+  // Every pair of half compaction batches is compacted into one cold batch.
+  for (int i = 0; i < 8; ++i) {
+    accountant_->NewHotBatch(
+        BatchSizeAccountant::CalcBatchStats(accountant_->NonMutableState(), *half_compaction_rb_));
+  }
+  while (accountant_->CompactedBatchReady()) {
+    EXPECT_EQ(0, accountant_->FinishCompactedBatch());
+  }
+  EXPECT_EQ(0, accountant_->HotBytes());
+  EXPECT_EQ(8 * half_compaction_rb_bytes_, accountant_->ColdBytes());
+
+  EXPECT_EQ(0, accountant_->ExpireColdBatches(0));
+  EXPECT_EQ(1, accountant_->ExpireColdBatches(1));
+  EXPECT_EQ(6 * half_compaction_rb_bytes_, accountant_->ColdBytes());
+
+  // Freeing just over one batch worth of bytes requires expiring two batches.
+  EXPECT_EQ(2, accountant_->ExpireColdBatches(2 * half_compaction_rb_bytes_ + 1));
+  EXPECT_EQ(2 * half_compaction_rb_bytes_, accountant_->ColdBytes());
+
+  // Asking for more bytes than are stored expires all the remaining batches.
+  EXPECT_EQ(1, accountant_->ExpireColdBatches(1024));
+  EXPECT_EQ(0, accountant_->ColdBytes());
+  EXPECT_EQ(0, accountant_->ExpireColdBatches(1024));
+}
+
 INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(BatchSizeAccountant, BatchSizeAccountantTest,
                                           /*include_mixed*/ true);
 
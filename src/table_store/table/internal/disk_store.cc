@@ -0,0 +1,158 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/internal/disk_store.h"
+
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_format.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "src/common/fs/fs_wrapper.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+constexpr char kSegmentExtension[] = ".seg";
+constexpr char kTmpExtension[] = ".tmp";
+}  // namespace
+
+DiskStore::DiskStore(const schema::Relation& rel, int64_t time_col_idx,
+                     std::filesystem::path dir, int64_t max_bytes)
+    : rel_(rel), dir_(std::move(dir)), max_bytes_(max_bytes), store_(rel_, time_col_idx) {}
+
+StatusOr<std::unique_ptr<DiskStore>> DiskStore::Open(const schema::Relation& rel,
+                                                     int64_t time_col_idx,
+                                                     const std::filesystem::path& dir,
+                                                     int64_t max_bytes) {
+  // Create a naked pointer, because std::make_unique() cannot access the private ctor.
+  std::unique_ptr<DiskStore> disk_store(new DiskStore(rel, time_col_idx, dir, max_bytes));
+  PL_RETURN_IF_ERROR(disk_store->Load());
+  return disk_store;
+}
+
+std::filesystem::path DiskStore::SegmentPath(int64_t segment_id) const {
+  return dir_ / absl::StrFormat("%016d%s", segment_id, kSegmentExtension);
+}
+
+Status DiskStore::Load() {
+  PL_RETURN_IF_ERROR(fs::CreateDirectories(dir_));
+
+  // Segment IDs are zero padded, but sort them numerically anyway.
+  std::map<int64_t, std::filesystem::path> segment_paths;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir_, ec)) {
+    const auto& path = entry.path();
+    int64_t segment_id;
+    if (path.extension() == kTmpExtension) {
+      // Left behind by a crash while a segment was being written.
+      PL_RETURN_IF_ERROR(fs::Remove(path));
+    } else if (path.extension() == kSegmentExtension &&
+               absl::SimpleAtoi(path.stem().string(), &segment_id)) {
+      segment_paths[segment_id] = path;
+    }
+  }
+  if (ec) {
+    return error::Internal("Failed to list $0: $1", dir_.string(), ec.message());
+  }
+
+  for (auto& [segment_id, path] : segment_paths) {
+    next_segment_id_ = segment_id + 1;
+    auto segment_or_s = ReadSegmentFile(path, rel_);
+    if (!segment_or_s.ok()) {
+      LOG(WARNING) << "Removing unreadable table segment: " << segment_or_s.msg();
+      PL_RETURN_IF_ERROR(fs::Remove(path));
+      continue;
+    }
+    SegmentFile segment = segment_or_s.ConsumeValueOrDie();
+    if (store_.Size() > 0 && segment.first_row_id <= store_.LastRowID()) {
+      LOG(WARNING) << "Removing table segment that overlaps the previous segment: "
+                   << path.string();
+      PL_RETURN_IF_ERROR(fs::Remove(path));
+      continue;
+    }
+    PushBackSegment(std::move(path), std::move(segment));
+  }
+  DropSegmentsOverLimit();
+  return Status::OK();
+}
+
+StatusOr<DiskStore::PendingSegment> DiskStore::WriteSegment(
+    RowID first_row_id, const std::vector<ColdBatch>& batches) {
+  DCHECK(!batches.empty());
+  std::vector<const ColdBatch*> batch_ptrs;
+  for (const auto& batch : batches) {
+    batch_ptrs.push_back(&batch);
+  }
+
+  auto path = SegmentPath(next_segment_id_++);
+  PL_RETURN_IF_ERROR(WriteSegmentFile(path, rel_, first_row_id, batch_ptrs));
+  // Map the segment back, so that the in-memory copies of the batches can be released.
+  auto segment_or_s = ReadSegmentFile(path, rel_);
+  if (!segment_or_s.ok()) {
+    PL_RETURN_IF_ERROR(fs::Remove(path));
+    return segment_or_s.status();
+  }
+  return PendingSegment{std::move(path), segment_or_s.ConsumeValueOrDie()};
+}
+
+size_t DiskStore::AddSegment(PendingSegment pending) {
+  DCHECK(store_.Size() == 0 || pending.segment.first_row_id > store_.LastRowID());
+  PushBackSegment(std::move(pending.path), std::move(pending.segment));
+  return DropSegmentsOverLimit();
+}
+
+void DiskStore::PushBackSegment(std::filesystem::path path, SegmentFile segment) {
+  RowID row_id = segment.first_row_id;
+  for (auto& batch : segment.batches) {
+    auto length = batch[0]->length();
+    store_.EmplaceBack(row_id, std::move(batch));
+    row_id += length;
+  }
+  bytes_ += segment.bytes;
+  segments_.push_back(Segment{std::move(path), segment.batches.size(), segment.bytes});
+}
+
+size_t DiskStore::DropSegmentsOverLimit() {
+  size_t num_dropped = 0;
+  while (segments_.size() > 1 && bytes_ > max_bytes_) {
+    num_dropped += DropFrontSegment();
+  }
+  return num_dropped;
+}
+
+size_t DiskStore::DropFrontSegment() {
+  auto segment = std::move(segments_.front());
+  segments_.pop_front();
+  store_.PopFrontN(segment.num_batches);
+  bytes_ -= segment.bytes;
+  // The batches stay readable by anyone still holding them, since the mapping outlives the file.
+  auto s = fs::Remove(segment.path);
+  LOG_IF(WARNING, !s.ok()) << s.msg();
+  return segment.num_batches;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
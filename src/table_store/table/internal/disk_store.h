@@ -0,0 +1,114 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/segment_file.h"
+#include "src/table_store/table/internal/store_with_row_accounting.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * DiskStore is the on-disk tier of a table. Cold batches that are expired from memory are written
+ * to segment files in the store's directory, and the segments are memory mapped back into a cold
+ * store, so that they can be read like any other cold batch while the kernel decides which pages
+ * stay resident. When the directory holds more than `max_bytes`, the oldest segments are removed.
+ *
+ * RowIDs increase from one segment to the next, but there may be gaps between segments, where
+ * batches left memory without being spilled. DiskStore is not thread-safe, but WriteSegment() only
+ * touches the file system, so the store can be read while a segment is being written.
+ */
+class DiskStore {
+  using ColdStore = StoreWithRowTimeAccounting<StoreType::Cold>;
+
+ public:
+  /**
+   * Opens the disk store in `dir`, creating the directory if needed, and maps the segments left
+   * in it by a previous process. Segments that are corrupt or don't match `rel` are removed.
+   */
+  static StatusOr<std::unique_ptr<DiskStore>> Open(const schema::Relation& rel,
+                                                   int64_t time_col_idx,
+                                                   const std::filesystem::path& dir,
+                                                   int64_t max_bytes);
+
+  // A segment that was written and mapped, but not yet added to the store.
+  struct PendingSegment {
+    std::filesystem::path path;
+    SegmentFile segment;
+  };
+
+  /**
+   * Writes `batches` to a new segment file, and maps it back. Calls to WriteSegment() must not run
+   * concurrently with each other, but may run concurrently with the other methods.
+   * @param first_row_id RowID of the first row in `batches`. It must be after store().LastRowID()
+   * when the segment is added.
+   */
+  StatusOr<PendingSegment> WriteSegment(RowID first_row_id, const std::vector<ColdBatch>& batches);
+
+  /**
+   * Adds a segment returned by WriteSegment() to the back of this store.
+   * @return the number of batches removed from the front of this store to stay within the disk
+   * limit.
+   */
+  size_t AddSegment(PendingSegment pending);
+
+  const ColdStore& store() const { return store_; }
+  // Bytes of the segment files on disk.
+  int64_t Bytes() const { return bytes_; }
+  size_t NumSegments() const { return segments_.size(); }
+
+ private:
+  DiskStore(const schema::Relation& rel, int64_t time_col_idx, std::filesystem::path dir,
+            int64_t max_bytes);
+
+  Status Load();
+  std::filesystem::path SegmentPath(int64_t segment_id) const;
+  void PushBackSegment(std::filesystem::path path, SegmentFile segment);
+  // Removes the oldest segments until the store is within max_bytes_, always keeping the newest
+  // segment. Returns the number of batches dropped.
+  size_t DropSegmentsOverLimit();
+  size_t DropFrontSegment();
+
+  struct Segment {
+    std::filesystem::path path;
+    size_t num_batches;
+    int64_t bytes;
+  };
+
+  const schema::Relation rel_;
+  const std::filesystem::path dir_;
+  const int64_t max_bytes_;
+  ColdStore store_;
+  std::deque<Segment> segments_;
+  int64_t bytes_ = 0;
+  int64_t next_segment_id_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
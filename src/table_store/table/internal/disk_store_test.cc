@@ -0,0 +1,182 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/table_store/table/internal/disk_store.h"
+#include "src/table_store/table/internal/test_utils.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class DiskStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = std::make_unique<schema::Relation>(
+        std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::STRING},
+        std::vector<std::string>{"time_", "col1"});
+    cold_ = std::make_unique<StoreWithRowTimeAccounting<StoreType::Cold>>(*rel_, 0);
+  }
+
+  // Adds a cold batch with the given times to the back of cold_.
+  void AddColdBatch(const std::vector<types::Time64NSValue>& times) {
+    std::vector<types::StringValue> strings(times.size(), "abcdefgh");
+    cold_->EmplaceBack(next_row_id_, ColdBatch{
+                                         types::ToArrow(times, arrow::default_memory_pool()),
+                                         types::ToArrow(strings, arrow::default_memory_pool()),
+                                     });
+    next_row_id_ += times.size();
+  }
+
+  // Writes the first num_batches batches of cold_ to disk_store, and removes them from cold_.
+  StatusOr<size_t> Spill(DiskStore* disk_store, size_t num_batches) {
+    std::vector<ColdBatch> batches;
+    for (size_t i = 0; i < num_batches; ++i) {
+      batches.push_back(cold_->at(i));
+    }
+    PL_ASSIGN_OR_RETURN(auto pending, disk_store->WriteSegment(cold_->FirstRowID(), batches));
+    cold_->PopFrontN(num_batches);
+    return disk_store->AddSegment(std::move(pending));
+  }
+
+  std::unique_ptr<schema::Relation> rel_;
+  std::unique_ptr<StoreWithRowTimeAccounting<StoreType::Cold>> cold_;
+  RowID next_row_id_ = 0;
+  px::testing::TempDir tmp_dir_;
+};
+
+TEST_F(DiskStoreTest, AppendAndReopen) {
+  ASSERT_OK_AND_ASSIGN(auto disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  EXPECT_EQ(0, disk_store->store().Size());
+
+  AddColdBatch({1, 2, 3});
+  AddColdBatch({4, 5});
+  AddColdBatch({6});
+  ASSERT_OK_AND_ASSIGN(size_t num_dropped, Spill(disk_store.get(), 2));
+  EXPECT_EQ(0, num_dropped);
+  ASSERT_OK(Spill(disk_store.get(), 1));
+
+  EXPECT_EQ(2, disk_store->NumSegments());
+  EXPECT_EQ(3, disk_store->store().Size());
+  EXPECT_EQ(0, disk_store->store().FirstRowID());
+  EXPECT_EQ(5, disk_store->store().LastRowID());
+  EXPECT_EQ(3, disk_store->store().FindRowIDFromTimeFirstGreaterThanOrEqual(4).value_or(-1));
+  int64_t bytes = disk_store->Bytes();
+  EXPECT_GT(bytes, 0);
+
+  // A leftover temporary file from an interrupted write is cleaned up.
+  std::ofstream(tmp_dir_.path() / "0000000000000002.seg.tmp") << "partial";
+
+  disk_store.reset();
+  ASSERT_OK_AND_ASSIGN(disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  EXPECT_EQ(2, disk_store->NumSegments());
+  EXPECT_EQ(bytes, disk_store->Bytes());
+  EXPECT_EQ(3, disk_store->store().Size());
+  EXPECT_EQ(0, disk_store->store().FirstRowID());
+  EXPECT_EQ(5, disk_store->store().LastRowID());
+  EXPECT_FALSE(std::filesystem::exists(tmp_dir_.path() / "0000000000000002.seg.tmp"));
+
+  // New segments don't overwrite the reloaded ones.
+  AddColdBatch({7, 8});
+  ASSERT_OK(Spill(disk_store.get(), 1));
+  EXPECT_EQ(3, disk_store->NumSegments());
+  EXPECT_EQ(7, disk_store->store().LastRowID());
+}
+
+TEST_F(DiskStoreTest, DropsOldestSegmentsOverLimit) {
+  ASSERT_OK_AND_ASSIGN(auto disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  AddColdBatch({1, 2});
+  ASSERT_OK(Spill(disk_store.get(), 1));
+  int64_t segment_bytes = disk_store->Bytes();
+
+  ASSERT_OK_AND_ASSIGN(disk_store,
+                       DiskStore::Open(*rel_, 0, tmp_dir_.path(), 2 * segment_bytes + 1));
+  for (int i = 0; i < 4; ++i) {
+    AddColdBatch({10 + 2 * i, 11 + 2 * i});
+    ASSERT_OK_AND_ASSIGN(size_t num_dropped, Spill(disk_store.get(), 1));
+    EXPECT_EQ(i == 0 ? 0 : 1, num_dropped);
+  }
+  EXPECT_EQ(2, disk_store->NumSegments());
+  EXPECT_EQ(6, disk_store->store().FirstRowID());
+  EXPECT_EQ(9, disk_store->store().LastRowID());
+  EXPECT_EQ(2, std::distance(std::filesystem::directory_iterator(tmp_dir_.path()),
+                             std::filesystem::directory_iterator()));
+}
+
+TEST_F(DiskStoreTest, KeepsSegmentsAcrossRowIDGaps) {
+  ASSERT_OK_AND_ASSIGN(auto disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  AddColdBatch({1, 2});
+  AddColdBatch({3, 4, 5});
+  AddColdBatch({6, 7});
+  ASSERT_OK(Spill(disk_store.get(), 1));
+  // The second batch leaves memory without being spilled.
+  cold_->PopFront();
+  ASSERT_OK_AND_ASSIGN(size_t num_dropped, Spill(disk_store.get(), 1));
+  EXPECT_EQ(0, num_dropped);
+
+  EXPECT_EQ(2, disk_store->NumSegments());
+  EXPECT_EQ(0, disk_store->store().FirstRowID());
+  EXPECT_EQ(6, disk_store->store().LastRowID());
+  EXPECT_EQ(5, disk_store->store().FindRowIDFromTimeFirstGreaterThanOrEqual(3).value_or(-1));
+
+  // Reads skip over the missing rows.
+  RowID last_read_row_id = 1;
+  BatchHints hints;
+  ASSERT_OK_AND_ASSIGN(auto rb, disk_store->store().GetNextRowBatch(&last_read_row_id, &hints,
+                                                                    std::nullopt, {0}));
+  ASSERT_NE(nullptr, rb);
+  EXPECT_EQ(2, rb->num_rows());
+  EXPECT_EQ(6, last_read_row_id);
+
+  // A read that would start in the gap and stop before the next segment returns nothing.
+  last_read_row_id = 1;
+  ASSERT_OK_AND_ASSIGN(rb, disk_store->store().GetNextRowBatch(&last_read_row_id, &hints, 4, {0}));
+  EXPECT_EQ(nullptr, rb);
+  EXPECT_EQ(3, last_read_row_id);
+
+  disk_store.reset();
+  ASSERT_OK_AND_ASSIGN(disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  EXPECT_EQ(2, disk_store->NumSegments());
+  EXPECT_EQ(0, disk_store->store().FirstRowID());
+  EXPECT_EQ(6, disk_store->store().LastRowID());
+}
+
+TEST_F(DiskStoreTest, RemovesCorruptSegments) {
+  ASSERT_OK_AND_ASSIGN(auto disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  AddColdBatch({1, 2});
+  AddColdBatch({3, 4});
+  ASSERT_OK(Spill(disk_store.get(), 1));
+  ASSERT_OK(Spill(disk_store.get(), 1));
+  disk_store.reset();
+
+  std::filesystem::resize_file(tmp_dir_.path() / "0000000000000001.seg", 10);
+  ASSERT_OK_AND_ASSIGN(disk_store, DiskStore::Open(*rel_, 0, tmp_dir_.path(), 1 << 30));
+  EXPECT_EQ(1, disk_store->NumSegments());
+  EXPECT_EQ(0, disk_store->store().FirstRowID());
+  EXPECT_EQ(1, disk_store->store().LastRowID());
+  EXPECT_FALSE(std::filesystem::exists(tmp_dir_.path() / "0000000000000001.seg"));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,357 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/internal/segment_file.h"
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'X', 'T', 'B', 'S', 'E', 'G', '\0'};
+constexpr uint32_t kVersion = 1;
+// Arrow expects all buffers to be 64 byte aligned.
+constexpr int64_t kAlignment = 64;
+// The table store's column types have at most 3 buffers (validity, offsets and data).
+constexpr int64_t kMaxBuffers = 3;
+
+// A segment file is laid out as follows:
+//   FileHeader
+//   int32_t column types, padded to 8 bytes
+//   ArrayEntry for each column of each batch
+//   buffers, each starting at a multiple of kAlignment
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_cols;
+  int64_t first_row_id;
+  int64_t num_batches;
+};
+
+struct BufferEntry {
+  // Offset of the buffer in the file, or -1 if the array doesn't have this buffer.
+  int64_t offset;
+  int64_t size;
+};
+
+struct ArrayEntry {
+  int64_t length;
+  int64_t offset;
+  int64_t null_count;
+  int64_t num_buffers;
+  BufferEntry buffers[kMaxBuffers];
+};
+
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+static_assert(std::is_trivially_copyable_v<ArrayEntry>);
+
+// The largest number of batches whose directory fits in a file of file_size bytes. Checked before
+// calling DataStart(), so that a corrupt header can't overflow it.
+int64_t MaxBatches(int64_t num_cols, int64_t file_size) {
+  return file_size / (std::max<int64_t>(num_cols, 1) * static_cast<int64_t>(sizeof(ArrayEntry)));
+}
+
+int64_t DataStart(int64_t num_cols, int64_t num_batches) {
+  int64_t types_bytes = SnapUpToMultiple<int64_t>(num_cols * sizeof(int32_t), 8);
+  int64_t directory_bytes = num_batches * num_cols * sizeof(ArrayEntry);
+  return SnapUpToMultiple<int64_t>(sizeof(FileHeader) + types_bytes + directory_bytes, kAlignment);
+}
+
+class FileWriter {
+ public:
+  FileWriter(std::filesystem::path path, int fd) : path_(std::move(path)), fd_(fd) {}
+
+  Status Write(const void* data, int64_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+      ssize_t written = write(fd_, bytes, size);
+      if (written < 0) {
+        if (errno == EINTR) continue;
+        return error::Internal("Failed to write $0: $1", path_.string(), std::strerror(errno));
+      }
+      bytes += written;
+      size -= written;
+      pos_ += written;
+    }
+    return Status::OK();
+  }
+
+  Status PadTo(int64_t pos) {
+    static constexpr uint8_t kZeros[kAlignment] = {};
+    while (pos_ < pos) {
+      PL_RETURN_IF_ERROR(Write(kZeros, std::min(pos - pos_, kAlignment)));
+    }
+    return Status::OK();
+  }
+
+  int64_t pos() const { return pos_; }
+
+ private:
+  const std::filesystem::path path_;
+  const int fd_;
+  int64_t pos_ = 0;
+};
+
+// Checks that the buffers of an array read from a segment are large enough for its offset and
+// length, and that string offsets stay within the string data, so that a corrupt segment is
+// rejected on load instead of being read out of bounds later. Array::Validate() runs as well, but
+// our version of arrow predates Array::ValidateFull(), which would cover this.
+Status ValidateArray(const arrow::Array& array) {
+  const arrow::ArrayData& data = *array.data();
+  auto buffer_size = [&data](size_t i) -> int64_t {
+    return i < data.buffers.size() && data.buffers[i] != nullptr ? data.buffers[i]->size() : 0;
+  };
+  // The caller bounds offset and length by the size of the file, so this can't overflow.
+  const int64_t end = data.offset + data.length;
+  if (data.null_count < 0 || data.null_count > data.length ||
+      (data.null_count > 0 && buffer_size(0) < (end + 7) / 8)) {
+    return error::InvalidArgument("invalid validity buffer");
+  }
+  if (data.type->id() == arrow::Type::STRING) {
+    if (data.buffers.size() != 3 ||
+        buffer_size(1) < (end + 1) * static_cast<int64_t>(sizeof(int32_t))) {
+      return error::InvalidArgument("invalid offsets buffer");
+    }
+    // Buffers are 64 byte aligned in the file, so the offsets can be read in place.
+    const auto* offsets = reinterpret_cast<const int32_t*>(data.buffers[1]->data());
+    if (offsets[data.offset] < 0) {
+      return error::InvalidArgument("invalid string offset");
+    }
+    for (int64_t i = data.offset; i < end; ++i) {
+      if (offsets[i + 1] < offsets[i]) {
+        return error::InvalidArgument("invalid string offset");
+      }
+    }
+    if (offsets[end] > buffer_size(2)) {
+      return error::InvalidArgument("string offsets are past the end of the data buffer");
+    }
+  } else {
+    // Booleans are bit-packed, and the other types are stored as their native values.
+    int64_t bit_width =
+        data.type->id() == arrow::Type::BOOL ? 1 : 8 * types::ArrowTypeToBytes(data.type->id());
+    if (data.buffers.size() != 2 || buffer_size(1) < (end * bit_width + 7) / 8) {
+      return error::InvalidArgument("invalid data buffer");
+    }
+  }
+  // Whatever else arrow checks for the type.
+  PL_RETURN_IF_ERROR(array.Validate());
+  return Status::OK();
+}
+// Owns the memory mapping of a segment file. The arrays' buffers are slices of this buffer.
+class MappedFileBuffer : public arrow::Buffer {
+ public:
+  MappedFileBuffer(const uint8_t* data, int64_t size) : arrow::Buffer(data, size) {}
+  ~MappedFileBuffer() override { munmap(const_cast<uint8_t*>(data()), size()); }
+};
+
+Status WriteSegment(FileWriter* writer, const schema::Relation& rel, RowID first_row_id,
+                    const std::vector<const ColdBatch*>& batches) {
+  int64_t num_cols = rel.NumColumns();
+
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_cols = num_cols;
+  header.first_row_id = first_row_id;
+  header.num_batches = batches.size();
+  PL_RETURN_IF_ERROR(writer->Write(&header, sizeof(header)));
+
+  std::vector<int32_t> col_types;
+  for (const auto& type : rel.col_types()) {
+    col_types.push_back(static_cast<int32_t>(type));
+  }
+  PL_RETURN_IF_ERROR(writer->Write(col_types.data(), col_types.size() * sizeof(int32_t)));
+  PL_RETURN_IF_ERROR(writer->PadTo(SnapUpToMultiple<int64_t>(writer->pos(), 8)));
+
+  // Lay out the buffers after the directory.
+  std::vector<const arrow::Buffer*> buffers;
+  int64_t offset = DataStart(num_cols, batches.size());
+  for (const auto* batch : batches) {
+    if (static_cast<int64_t>(batch->size()) != num_cols) {
+      return error::InvalidArgument("Batch has $0 columns, expected $1", batch->size(), num_cols);
+    }
+    for (const auto& array : *batch) {
+      const auto& data = array->data();
+      if (!data->child_data.empty() || static_cast<int64_t>(data->buffers.size()) > kMaxBuffers) {
+        return error::Unimplemented("Arrays of type $0 can't be written to a segment file",
+                                    data->type->ToString());
+      }
+      ArrayEntry entry = {};
+      entry.length = data->length;
+      entry.offset = data->offset;
+      entry.null_count = array->null_count();
+      entry.num_buffers = data->buffers.size();
+      for (const auto& [i, buffer] : Enumerate(data->buffers)) {
+        if (buffer == nullptr) {
+          entry.buffers[i] = BufferEntry{-1, 0};
+          continue;
+        }
+        entry.buffers[i] = BufferEntry{offset, buffer->size()};
+        buffers.push_back(buffer.get());
+        offset = SnapUpToMultiple<int64_t>(offset + buffer->size(), kAlignment);
+      }
+      PL_RETURN_IF_ERROR(writer->Write(&entry, sizeof(entry)));
+    }
+  }
+
+  for (const auto* buffer : buffers) {
+    PL_RETURN_IF_ERROR(writer->PadTo(SnapUpToMultiple<int64_t>(writer->pos(), kAlignment)));
+    PL_RETURN_IF_ERROR(writer->Write(buffer->data(), buffer->size()));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+StatusOr<int64_t> WriteSegmentFile(const std::filesystem::path& path, const schema::Relation& rel,
+                                   RowID first_row_id,
+                                   const std::vector<const ColdBatch*>& batches) {
+  std::filesystem::path tmp_path = path;
+  tmp_path += ".tmp";
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return error::Internal("Failed to create $0: $1", tmp_path.string(), std::strerror(errno));
+  }
+  FileWriter writer(tmp_path, fd);
+  Status s = WriteSegment(&writer, rel, first_row_id, batches);
+  if (s.ok() && fsync(fd) != 0) {
+    s = error::Internal("Failed to sync $0: $1", tmp_path.string(), std::strerror(errno));
+  }
+  close(fd);
+  if (s.ok() && rename(tmp_path.c_str(), path.c_str()) != 0) {
+    s = error::Internal("Failed to rename $0: $1", tmp_path.string(), std::strerror(errno));
+  }
+  if (!s.ok()) {
+    unlink(tmp_path.c_str());
+    return s;
+  }
+  return writer.pos();
+}
+
+StatusOr<SegmentFile> ReadSegmentFile(const std::filesystem::path& path,
+                                      const schema::Relation& rel) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open $0: $1", path.string(), std::strerror(errno));
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    Status s = error::Internal("Failed to stat $0: $1", path.string(), std::strerror(errno));
+    close(fd);
+    return s;
+  }
+  const int64_t size = st.st_size;
+  if (size < static_cast<int64_t>(sizeof(FileHeader))) {
+    close(fd);
+    return error::InvalidArgument("$0 is too small: $1 bytes", path.string(), size);
+  }
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return error::Internal("Failed to mmap $0: $1", path.string(), std::strerror(errno));
+  }
+  auto mapping = std::make_shared<MappedFileBuffer>(static_cast<const uint8_t*>(addr), size);
+  const uint8_t* data = mapping->data();
+
+  FileHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+    return error::InvalidArgument("$0 is not a version $1 segment file", path.string(), kVersion);
+  }
+  int64_t num_cols = rel.NumColumns();
+  if (header.num_cols != num_cols || header.num_batches <= 0 ||
+      header.num_batches > MaxBatches(num_cols, size) ||
+      DataStart(num_cols, header.num_batches) > size) {
+    return error::InvalidArgument("$0 has an invalid header", path.string());
+  }
+  const uint8_t* pos = data + sizeof(header);
+  std::vector<std::shared_ptr<arrow::DataType>> arrow_types;
+  for (const auto& type : rel.col_types()) {
+    int32_t file_type;
+    std::memcpy(&file_type, pos, sizeof(file_type));
+    pos += sizeof(file_type);
+    if (file_type != static_cast<int32_t>(type)) {
+      return error::InvalidArgument("$0 doesn't match the table's relation", path.string());
+    }
+    arrow_types.push_back(types::MakeArrowBuilder(type, arrow::default_memory_pool())->type());
+  }
+  pos = data + SnapUpToMultiple<int64_t>(pos - data, 8);
+
+  SegmentFile segment;
+  segment.first_row_id = header.first_row_id;
+  segment.bytes = size;
+  for (int64_t batch_idx = 0; batch_idx < header.num_batches; ++batch_idx) {
+    ColdBatch batch;
+    for (int64_t col_idx = 0; col_idx < num_cols; ++col_idx) {
+      ArrayEntry entry;
+      std::memcpy(&entry, pos, sizeof(entry));
+      pos += sizeof(entry);
+      // An array can't have more rows than there are bits in the file.
+      if (entry.length <= 0 || entry.length > size * 8 || entry.offset < 0 ||
+          entry.offset > size * 8 || entry.num_buffers < 0 || entry.num_buffers > kMaxBuffers ||
+          (col_idx > 0 && entry.length != batch[0]->length())) {
+        return error::InvalidArgument("$0 has an invalid array entry", path.string());
+      }
+      std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+      for (int64_t i = 0; i < entry.num_buffers; ++i) {
+        const auto& buffer = entry.buffers[i];
+        if (buffer.offset == -1) {
+          buffers.push_back(nullptr);
+          continue;
+        }
+        if (buffer.offset < 0 || buffer.offset % kAlignment != 0 || buffer.size < 0 ||
+            buffer.offset > size || buffer.size > size - buffer.offset) {
+          return error::InvalidArgument("$0 has an invalid buffer entry", path.string());
+        }
+        buffers.push_back(arrow::SliceBuffer(mapping, buffer.offset, buffer.size));
+      }
+      auto array_data = arrow::ArrayData::Make(arrow_types[col_idx], entry.length,
+                                               std::move(buffers), entry.null_count, entry.offset);
+      auto array = arrow::MakeArray(array_data);
+      Status s = ValidateArray(*array);
+      if (!s.ok()) {
+        return error::InvalidArgument("$0 has an invalid array: $1", path.string(), s.msg());
+      }
+      batch.push_back(std::move(array));
+    }
+    segment.batches.push_back(std::move(batch));
+  }
+  return segment;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * A segment file holds a run of consecutive cold batches of a table. All the arrow buffers are
+ * stored 64 byte aligned after a small directory, so that a segment can be memory mapped and its
+ * arrays used in place, without copying or deserializing them.
+ */
+struct SegmentFile {
+  // RowID of the first row in the first batch. The batches' rows have consecutive RowIDs.
+  RowID first_row_id = 0;
+  std::vector<ColdBatch> batches;
+  // Size of the file on disk.
+  int64_t bytes = 0;
+};
+
+/**
+ * Writes the given cold batches to a segment file at `path`. The file is first written under a
+ * temporary name and synced, and then renamed, so a crash never leaves a partial segment at `path`.
+ * @param path the path of the segment file.
+ * @param rel the relation of the batches.
+ * @param first_row_id RowID of the first row in `batches`.
+ * @param batches the cold batches to write.
+ * @return the size of the segment file in bytes, or an error.
+ */
+StatusOr<int64_t> WriteSegmentFile(const std::filesystem::path& path, const schema::Relation& rel,
+                                   RowID first_row_id,
+                                   const std::vector<const ColdBatch*>& batches);
+
+/**
+ * Memory maps the segment file at `path`. The arrays of the returned batches point into the
+ * mapping, which stays alive (even if the file is removed) until the last array is released.
+ * @param path the path of the segment file.
+ * @param rel the relation the segment is expected to have.
+ * @return the batches in the segment, or an error if the file isn't a valid segment for `rel`.
+ */
+StatusOr<SegmentFile> ReadSegmentFile(const std::filesystem::path& path,
+                                      const schema::Relation& rel);
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
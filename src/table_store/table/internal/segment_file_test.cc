@@ -0,0 +1,145 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/table_store/table/internal/segment_file.h"
+#include "src/table_store/table/internal/test_utils.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class SegmentFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = std::make_unique<schema::Relation>(
+        std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::INT64,
+                                     types::DataType::STRING},
+        std::vector<std::string>{"time_", "col1", "col2"});
+  }
+
+  ColdBatch MakeColdBatch(const std::vector<types::Time64NSValue>& times,
+                          const std::vector<types::Int64Value>& ints,
+                          const std::vector<types::StringValue>& strings) {
+    return ColdBatch{
+        types::ToArrow(times, arrow::default_memory_pool()),
+        types::ToArrow(ints, arrow::default_memory_pool()),
+        types::ToArrow(strings, arrow::default_memory_pool()),
+    };
+  }
+
+  std::unique_ptr<schema::Relation> rel_;
+  px::testing::TempDir tmp_dir_;
+};
+
+TEST_F(SegmentFileTest, WriteAndRead) {
+  auto batch0 = MakeColdBatch({1, 2, 3}, {10, 20, 30}, {"a", "bc", ""});
+  auto batch1 = MakeColdBatch({4, 5}, {40, 50}, {"def", "ghij"});
+  // Arrays with an offset into their buffers are preserved as such.
+  auto batch2 = MakeColdBatch({6, 7, 8, 9}, {60, 70, 80, 90}, {"k", "lm", "nop", "q"});
+  for (auto& array : batch2) {
+    array = array->Slice(1, 2);
+  }
+  auto path = tmp_dir_.path() / "0.seg";
+
+  ASSERT_OK_AND_ASSIGN(int64_t bytes,
+                       WriteSegmentFile(path, *rel_, 7, {&batch0, &batch1, &batch2}));
+  EXPECT_EQ(bytes, std::filesystem::file_size(path));
+  EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+  ASSERT_OK_AND_ASSIGN(auto segment, ReadSegmentFile(path, *rel_));
+  EXPECT_EQ(7, segment.first_row_id);
+  EXPECT_EQ(bytes, segment.bytes);
+  ASSERT_EQ(3, segment.batches.size());
+  std::vector<ColdBatch> expected = {batch0, batch1, batch2};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(3, segment.batches[i].size());
+    for (size_t col = 0; col < 3; ++col) {
+      EXPECT_TRUE(segment.batches[i][col]->Equals(expected[i][col]));
+    }
+  }
+
+  // The mapping outlives the file.
+  std::filesystem::remove(path);
+  EXPECT_TRUE(segment.batches[1][2]->Equals(batch1[2]));
+}
+
+TEST_F(SegmentFileTest, RejectsMismatchedOrCorruptFiles) {
+  auto batch = MakeColdBatch({1, 2, 3}, {10, 20, 30}, {"a", "bc", ""});
+  auto path = tmp_dir_.path() / "0.seg";
+  ASSERT_OK(WriteSegmentFile(path, *rel_, 0, {&batch}));
+
+  schema::Relation other_rel(
+      std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::FLOAT64,
+                                   types::DataType::STRING},
+      std::vector<std::string>{"time_", "col1", "col2"});
+  EXPECT_NOT_OK(ReadSegmentFile(path, other_rel));
+
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+  EXPECT_NOT_OK(ReadSegmentFile(path, *rel_));
+  std::filesystem::resize_file(path, 4);
+  EXPECT_NOT_OK(ReadSegmentFile(path, *rel_));
+  EXPECT_NOT_OK(ReadSegmentFile(tmp_dir_.path() / "missing.seg", *rel_));
+}
+
+TEST_F(SegmentFileTest, RejectsCorruptArrays) {
+  auto batch = MakeColdBatch({1, 2, 3}, {10, 20, 30}, {"a", "bc", ""});
+  auto path = tmp_dir_.path() / "0.seg";
+  ASSERT_OK(WriteSegmentFile(path, *rel_, 0, {&batch}));
+  std::string contents;
+  {
+    std::ifstream in(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  auto write_file = [&path](const std::string& data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+  };
+
+  // Point the last string offset past the end of the string data.
+  const std::vector<int32_t> offsets = {0, 1, 3, 3};
+  std::string offsets_bytes(reinterpret_cast<const char*>(offsets.data()),
+                            offsets.size() * sizeof(int32_t));
+  size_t pos = contents.find(offsets_bytes);
+  ASSERT_NE(std::string::npos, pos);
+  std::string corrupt = contents;
+  const int32_t bad_offset = 1 << 20;
+  corrupt.replace(pos + 3 * sizeof(int32_t), sizeof(bad_offset),
+                  reinterpret_cast<const char*>(&bad_offset), sizeof(bad_offset));
+  write_file(corrupt);
+  EXPECT_NOT_OK(ReadSegmentFile(path, *rel_));
+
+  // A batch count whose directory size would overflow.
+  corrupt = contents;
+  const int64_t num_batches = int64_t{1} << 60;
+  corrupt.replace(24, sizeof(num_batches), reinterpret_cast<const char*>(&num_batches),
+                  sizeof(num_batches));
+  write_file(corrupt);
+  EXPECT_NOT_OK(ReadSegmentFile(path, *rel_));
+
+  write_file(contents);
+  EXPECT_OK(ReadSegmentFile(path, *rel_));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
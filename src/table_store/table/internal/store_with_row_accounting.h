@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <deque>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -48,6 +50,18 @@ inline bool TimeIntervalComparatorUpperBound(Time val, const TimeInterval& inter
   return val < interval.second;
 }
 
+/**
+ * TimeSegment marks the first batch whose first time falls in a new fixed-size time window.
+ */
+struct TimeSegment {
+  Time start_time;
+  BatchID first_batch_id;
+};
+
+inline bool TimeSegmentComparatorUpperBound(Time val, const TimeSegment& segment) {
+  return val < segment.start_time;
+}
+
 template <bool always_false = false>
 void constexpr_else_static_assert_false() {
   static_assert(always_false, "constexpr else block reached");
@@ -66,14 +80,24 @@ void constexpr_else_static_assert_false() {
  * the batches changes when they are compacted from the hot store to the cold store, the unique
  * RowIDs are necessary to ensure that the query doesn't receive duplicate rows if the rows have
  * the same timestamp.
+ *
+ * If a segment window is given, the batches are additionally grouped into fixed-size time windows
+ * by the time of their first row. The resulting segments form a coarse time index that bounds the
+ * binary searches for time-based cursor seeks to the batches around a single segment.
+ *
+ * RowIDs increase from one batch to the next, but the store may have gaps between batches (e.g.
+ * the disk tier, when batches expire from memory without being spilled). Reads skip over them.
  */
 template <StoreType TStoreType>
 class StoreWithRowTimeAccounting {
   using TBatch = typename StoreTypeTraits<TStoreType>::batch_type;
 
  public:
-  StoreWithRowTimeAccounting(const schema::Relation& rel, int64_t time_col_idx)
-      : rel_(rel), time_col_idx_(time_col_idx) {}
+  StoreWithRowTimeAccounting(const schema::Relation& rel, int64_t time_col_idx,
+                             Time segment_window = 0)
+      : rel_(rel),
+        time_col_idx_(time_col_idx),
+        segment_window_(time_col_idx == -1 ? 0 : segment_window) {}
 
   /**
    * GetNextRowBatch returns the next row batch in this store after the given unique row id.
@@ -111,6 +135,14 @@ class StoreWithRowTimeAccounting {
     const auto& batch = GetBatchFromBatchID(batch_id);
     RowID batch_first_row_id = BatchFirstRowID(batch_id);
     RowID batch_last_row_id = BatchLastRowID(batch_id);
+    if (start_row_id < batch_first_row_id) {
+      // The rows before this batch are missing from the store, so continue from its first row.
+      start_row_id = batch_first_row_id;
+      if (stop_row_id.has_value() && start_row_id >= stop_row_id.value()) {
+        *last_read_row_id = stop_row_id.value() - 1;
+        return std::unique_ptr<schema::RowBatch>(nullptr);
+      }
+    }
     size_t row_offset = start_row_id - batch_first_row_id;
     size_t batch_size = batch_last_row_id - start_row_id + 1;
     if (stop_row_id.has_value() && batch_last_row_id >= stop_row_id.value()) {
@@ -154,6 +186,16 @@ class StoreWithRowTimeAccounting {
     return batches_.front();
   }
 
+  /**
+   * at gets a reference to the batch at the given position in the store.
+   * @param index, position of the batch, starting from the front of the store.
+   * @return reference to the batch.
+   */
+  const TBatch& at(size_t index) const {
+    DCHECK_LT(index, batches_.size());
+    return batches_[index];
+  }
+
   /**
    * PopFront removes the first batch in the store, and returns an rvalue reference to it.
    * @return rvalue reference to the removed batch.
@@ -167,9 +209,24 @@ class StoreWithRowTimeAccounting {
 
     auto&& front = std::move(batches_.front());
     batches_.pop_front();
+    TrimSegments();
     return std::move(front);
   }
 
+  /**
+   * PopFrontN removes the first num_batches batches in the store in one bulk operation.
+   * @param num_batches, number of batches to remove.
+   */
+  void PopFrontN(size_t num_batches) {
+    DCHECK_LE(num_batches, batches_.size());
+    first_batch_id_ += num_batches;
+
+    row_ids_.erase(row_ids_.begin(), row_ids_.begin() + num_batches);
+    if (time_col_idx_ != -1) times_.erase(times_.begin(), times_.begin() + num_batches);
+    batches_.erase(batches_.begin(), batches_.begin() + num_batches);
+    TrimSegments();
+  }
+
   /**
    * EmplaceBack creates a batch at the back of the store with the given args, and updates the
    * accounting such that the first RowID of the batch is the given first_row_id.
@@ -185,6 +242,13 @@ class StoreWithRowTimeAccounting {
       auto first_time = GetTimeValue(batch, 0);
       auto last_time = GetTimeValue(batch, BatchLength(batch) - 1);
       times_.emplace_back(first_time, last_time);
+      if (segment_window_ > 0) {
+        Time segment_start = first_time - ((first_time % segment_window_) + segment_window_) %
+                                              segment_window_;
+        if (segments_.empty() || segments_.back().start_time < segment_start) {
+          segments_.push_back(TimeSegment{segment_start, LastBatchID()});
+        }
+      }
     }
     return batch;
   }
@@ -218,8 +282,9 @@ class StoreWithRowTimeAccounting {
     if (time_col_idx_ == -1) {
       return std::nullopt;
     }
-    auto it =
-        std::lower_bound(times_.begin(), times_.end(), time, TimeIntervalComparatorLowerBound);
+    auto [begin, end] = SegmentSearchRange(time);
+    auto it = std::lower_bound(times_.begin() + begin, times_.begin() + end, time,
+                               TimeIntervalComparatorLowerBound);
     if (it == times_.end()) {
       return std::nullopt;
     }
@@ -239,8 +304,9 @@ class StoreWithRowTimeAccounting {
     if (time_col_idx_ == -1) {
       return std::nullopt;
     }
-    auto it =
-        std::upper_bound(times_.begin(), times_.end(), time, TimeIntervalComparatorUpperBound);
+    auto [begin, end] = SegmentSearchRange(time);
+    auto it = std::upper_bound(times_.begin() + begin, times_.begin() + end, time,
+                               TimeIntervalComparatorUpperBound);
     if (it == times_.end()) {
       return std::nullopt;
     }
@@ -271,6 +337,12 @@ class StoreWithRowTimeAccounting {
     }
   }
 
+  /**
+   * NumSegments returns the number of time segments in the store.
+   * @return number of time segments, or 0 if the store has no segment window.
+   */
+  size_t NumSegments() const { return segments_.size(); }
+
   /**
    * MinTime returns the minimum time in the store. Since the store is assumed to be time-sorted,
    * this is equivalent to returning the time of the first row in the store.
@@ -287,6 +359,43 @@ class StoreWithRowTimeAccounting {
  private:
   BatchID LastBatchID() const { return first_batch_id_ + batches_.size() - 1; }
 
+  size_t BatchIndex(BatchID batch_id) const {
+    return batch_id > first_batch_id_ ? batch_id - first_batch_id_ : 0;
+  }
+
+  // Drops the segments whose batches have all been removed from the store.
+  void TrimSegments() {
+    if (batches_.empty()) {
+      segments_.clear();
+      return;
+    }
+    while (segments_.size() > 1 && segments_[1].first_batch_id <= first_batch_id_) {
+      segments_.pop_front();
+    }
+  }
+
+  // Returns the range of indices into times_ that contains the first batch ending at (or after)
+  // the given time, if any batch does. Every batch before the last batch of the preceding segment
+  // ends before the segment containing `time` starts, and the first batch of the following segment
+  // starts after `time`, so only the batches in between need to be searched.
+  std::pair<size_t, size_t> SegmentSearchRange(Time time) const {
+    if (segments_.empty()) {
+      return {0, times_.size()};
+    }
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), time,
+                               TimeSegmentComparatorUpperBound);
+    size_t begin = 0;
+    if (it != segments_.begin()) {
+      begin = BatchIndex(std::prev(it)->first_batch_id);
+      if (begin > 0) --begin;
+    }
+    size_t end = times_.size();
+    if (it != segments_.end()) {
+      end = std::min(end, BatchIndex(it->first_batch_id) + 1);
+    }
+    return {begin, end};
+  }
+
   RowID BatchFirstRowID(BatchID batch_id) const {
     DCHECK_GE(batch_id, first_batch_id_);
     DCHECK_LT(batch_id, first_batch_id_ + batches_.size());
@@ -391,9 +500,11 @@ class StoreWithRowTimeAccounting {
   BatchID first_batch_id_ = 0;
   const schema::Relation& rel_;
   const int64_t time_col_idx_;
+  const Time segment_window_;
   std::deque<TBatch> batches_;
   std::deque<RowIDInterval> row_ids_;
   std::deque<TimeInterval> times_;
+  std::deque<TimeSegment> segments_;
 };
 
 }  // namespace internal
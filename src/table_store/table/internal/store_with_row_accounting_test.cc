@@ -124,6 +124,78 @@ TEST_F(ColdStoreTest, PushRowBatchesCheckProperties) {
   EXPECT_EQ(4, optional_row_id.value());
 }
 
+TEST_F(ColdStoreTest, PopFrontN) {
+  std::vector<types::BoolValue> bools = {true, false};
+  std::vector<types::StringValue> strings = {"ab", "cd"};
+  for (int64_t i = 0; i < 5; ++i) {
+    store_->EmplaceBack(2 * i, MakeRowBatch({10 * i, 10 * i + 1}, bools, strings).columns());
+  }
+  EXPECT_EQ(5, store_->Size());
+
+  store_->PopFrontN(3);
+  EXPECT_EQ(2, store_->Size());
+  EXPECT_EQ(6, store_->FirstRowID());
+  EXPECT_EQ(9, store_->LastRowID());
+  EXPECT_EQ(30, store_->MinTime());
+
+  auto optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(0);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(6, optional_row_id.value());
+
+  store_->PopFrontN(2);
+  EXPECT_EQ(0, store_->Size());
+  EXPECT_EQ(-1, store_->MinTime());
+}
+
+TEST_F(ColdStoreTest, TimeSegments) {
+  store_ = std::make_unique<StoreWithRowTimeAccounting<StoreType::Cold>>(*rel_, 0, 100);
+  std::vector<types::BoolValue> bools = {true, false};
+  std::vector<types::StringValue> strings = {"ab", "cd"};
+  // Batches of two rows each, spanning times [40 * i, 40 * i + 30]. Every batch but the last one
+  // in a segment ends in the next segment's window.
+  for (int64_t i = 0; i < 10; ++i) {
+    store_->EmplaceBack(2 * i, MakeRowBatch({40 * i, 40 * i + 30}, bools, strings).columns());
+  }
+  // Segments start at 0, 100, 200 and 300.
+  EXPECT_EQ(4, store_->NumSegments());
+
+  // Every lookup must agree with a linear scan over the rows.
+  auto expected_ge = [](Time time) -> std::optional<RowID> {
+    for (int64_t row = 0; row < 20; ++row) {
+      if (40 * (row / 2) + 30 * (row % 2) >= time) return row;
+    }
+    return std::nullopt;
+  };
+  auto expected_gt = [](Time time) -> std::optional<RowID> {
+    for (int64_t row = 0; row < 20; ++row) {
+      if (40 * (row / 2) + 30 * (row % 2) > time) return row;
+    }
+    return std::nullopt;
+  };
+  for (Time time = -10; time < 400; ++time) {
+    EXPECT_EQ(expected_ge(time), store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time)) << time;
+    EXPECT_EQ(expected_gt(time), store_->FindRowIDFromTimeFirstGreaterThan(time)) << time;
+  }
+
+  // Removing the first three batches (times 0 to 110) leaves the segments starting at 100 and
+  // later.
+  store_->PopFrontN(3);
+  EXPECT_EQ(3, store_->NumSegments());
+  auto optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(0);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(6, optional_row_id.value());
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThan(200);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(11, optional_row_id.value());
+
+  store_->PopFront();
+  EXPECT_EQ(3, store_->NumSegments());
+  store_->PopFront();
+  EXPECT_EQ(2, store_->NumSegments());
+  store_->PopFrontN(store_->Size());
+  EXPECT_EQ(0, store_->NumSegments());
+}
+
 TEST_P(HotStoreTest, PushRowBatchesCheckProperties) {
   std::vector<types::Time64NSValue> times = {1, 1, 10, 11};
   std::vector<types::BoolValue> bools = {true, false, true, false};
@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <iterator>
@@ -135,8 +136,8 @@ Table::Table(std::string_view table_name, const schema::Relation& relation, size
       rel_(relation),
       max_table_size_(max_table_size),
       compacted_batch_size_(compacted_batch_size),
-      // TODO(james): move mem_pool into constructor.
-      compactor_(rel_, arrow::default_memory_pool()) {
+      cold_pool_(internal::ArenaMemoryPool::Create()),
+      compactor_(rel_, cold_pool_.get()) {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   for (const auto& [i, col_name] : Enumerate(rel_.col_names())) {
@@ -148,7 +149,23 @@ Table::Table(std::string_view table_name, const schema::Relation& relation, size
   hot_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Hot>>(
       rel_, time_col_idx_);
   cold_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Cold>>(
-      rel_, time_col_idx_);
+      rel_, time_col_idx_, kColdSegmentWindowNs);
+}
+
+Status Table::EnableDiskTier(const std::filesystem::path& dir, int64_t max_disk_bytes) {
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    if (disk_store_ != nullptr || next_row_id_ != 0) {
+      return error::FailedPrecondition("The disk tier can only be enabled on a new table.");
+    }
+    PL_ASSIGN_OR_RETURN(disk_store_,
+                        internal::DiskStore::Open(rel_, time_col_idx_, dir, max_disk_bytes));
+    if (disk_store_->store().Size() > 0) {
+      next_row_id_ = disk_store_->store().LastRowID() + 1;
+    }
+  }
+  return UpdateTableMetricGauges();
 }
 
 Status Table::ToProto(table_store::schemapb::Table* table_proto) const {
@@ -175,9 +192,36 @@ StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetNextRowBatch(
     Cursor* cursor, const std::vector<int64_t>& cols) const {
   DCHECK(!cursor->Done()) << "Calling GetNextRowBatch on an exhausted Cursor";
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  PL_ASSIGN_OR_RETURN(auto rb,
-                      cold_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
-                                                   cursor->StopRowID(), cols));
+  std::unique_ptr<schema::RowBatch> rb;
+  if (disk_store_ != nullptr && disk_store_->store().Size() > 0) {
+    const auto& disk = disk_store_->store();
+    if (*cursor->LastReadRowID() + 1 < disk.FirstRowID()) {
+      // The rows after the cursor were dropped from the disk tier, so continue from the oldest row
+      // that is still on disk.
+      *cursor->LastReadRowID() = disk.FirstRowID() - 1;
+      if (cursor->Done()) {
+        return error::InvalidArgument("Data after Cursor is not in the table.");
+      }
+    }
+    PL_ASSIGN_OR_RETURN(rb, disk.GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
+                                                 cursor->StopRowID(), cols));
+    if (rb == nullptr && cursor->Done()) {
+      return error::InvalidArgument("Data after Cursor is not in the table.");
+    }
+  }
+  if (rb == nullptr && disk_store_ != nullptr && cold_store_->Size() > 0 &&
+      *cursor->LastReadRowID() + 1 < cold_store_->FirstRowID()) {
+    // The rows between the disk tier and the cold store expired without being spilled, so continue
+    // from the first cold row.
+    *cursor->LastReadRowID() = cold_store_->FirstRowID() - 1;
+    if (cursor->Done()) {
+      return error::InvalidArgument("Data after Cursor is not in the table.");
+    }
+  }
+  if (rb == nullptr) {
+    PL_ASSIGN_OR_RETURN(rb, cold_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
+                                                         cursor->StopRowID(), cols));
+  }
   if (rb == nullptr) {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     PL_ASSIGN_OR_RETURN(rb, hot_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
@@ -209,6 +253,33 @@ Status Table::ExpireRowBatches(int64_t row_batch_size) {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
   }
+  if (bytes + row_batch_size > max_table_size_) {
+    // Drop all the cold batches needed to make room in one go, instead of one batch at a time.
+    size_t num_expired;
+    {
+      absl::MutexLock expiry_lock(&cold_expiry_lock_);
+      size_t num_cold_batches;
+      {
+        absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+        absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+        int64_t bytes_to_expire = bytes + row_batch_size - max_table_size_;
+        if (disk_store_ != nullptr) {
+          bytes_to_expire =
+              std::max(bytes_to_expire, std::min(kDiskSpillBytes, max_table_size_ / 4));
+        }
+        num_cold_batches = batch_size_accountant_->ExpireColdBatches(bytes_to_expire);
+      }
+      num_expired = RemoveColdBatches(num_cold_batches);
+      absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+      bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
+    }
+    if (num_expired > 0) {
+      absl::base_internal::SpinLockHolder lock(&stats_lock_);
+      batches_expired_ += num_expired;
+      metrics_.batches_expired_counter.Increment(num_expired);
+    }
+  }
+  // Any remaining space has to come from the hot store.
   while (bytes + row_batch_size > max_table_size_) {
     PL_RETURN_IF_ERROR(ExpireBatch());
     {
@@ -285,6 +356,9 @@ Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
 
 Table::RowID Table::FirstRowID() const {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+  if (disk_store_ != nullptr && disk_store_->store().Size() > 0) {
+    return disk_store_->store().FirstRowID();
+  }
   if (cold_store_->Size() > 0) {
     return cold_store_->FirstRowID();
   }
@@ -304,12 +378,22 @@ Table::RowID Table::LastRowID() const {
   if (cold_store_->Size() > 0) {
     return cold_store_->LastRowID();
   }
+  if (disk_store_ != nullptr && disk_store_->store().Size() > 0) {
+    return disk_store_->store().LastRowID();
+  }
   return -1;
 }
 
 Table::RowID Table::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  auto optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
+  std::optional<RowID> optional_row_id;
+  if (disk_store_ != nullptr) {
+    optional_row_id = disk_store_->store().FindRowIDFromTimeFirstGreaterThanOrEqual(time);
+    if (optional_row_id.has_value()) {
+      return optional_row_id.value();
+    }
+  }
+  optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
   }
@@ -323,7 +407,14 @@ Table::RowID Table::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
 
 Table::RowID Table::FindRowIDFromTimeFirstGreaterThan(Time time) const {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  auto optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThan(time);
+  std::optional<RowID> optional_row_id;
+  if (disk_store_ != nullptr) {
+    optional_row_id = disk_store_->store().FindRowIDFromTimeFirstGreaterThan(time);
+    if (optional_row_id.has_value()) {
+      return optional_row_id.value();
+    }
+  }
+  optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThan(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
   }
@@ -343,9 +434,17 @@ TableStats Table::GetTableStats() const {
   int64_t num_batches = 0;
   int64_t hot_bytes = 0;
   int64_t cold_bytes = 0;
+  int64_t disk_bytes = 0;
   {
     absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-    min_time = cold_store_->MinTime();
+    if (disk_store_ != nullptr) {
+      min_time = disk_store_->store().MinTime();
+      num_batches += disk_store_->store().Size();
+      disk_bytes = disk_store_->Bytes();
+    }
+    if (min_time == -1) {
+      min_time = cold_store_->MinTime();
+    }
     num_batches += cold_store_->Size();
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     num_batches += hot_store_->Size();
@@ -364,6 +463,8 @@ TableStats Table::GetTableStats() const {
   info.bytes = hot_bytes + cold_bytes;
   info.hot_bytes = hot_bytes;
   info.cold_bytes = cold_bytes;
+  info.cold_arena_bytes = cold_pool_->arena_bytes();
+  info.disk_bytes = disk_bytes;
   info.compacted_batches = compacted_batches_;
   info.max_table_size = max_table_size_;
   info.min_time = min_time;
@@ -371,7 +472,7 @@ TableStats Table::GetTableStats() const {
   return info;
 }
 
-Status Table::CompactSingleBatchUnlocked(arrow::MemoryPool*) {
+Status Table::CompactSingleBatchUnlocked() {
   const auto& compaction_spec = batch_size_accountant_->GetNextCompactedBatchSpec();
 
   PL_RETURN_IF_ERROR(
@@ -406,37 +507,86 @@ Status Table::CompactSingleBatchUnlocked(arrow::MemoryPool*) {
   return Status::OK();
 }
 
-Status Table::CompactHotToCold(arrow::MemoryPool* mem_pool) {
-  bool next_ready = false;
-  {
-    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    next_ready = batch_size_accountant_->CompactedBatchReady();
-  }
-  while (next_ready) {
+Status Table::CompactHotToCold() {
+  auto start = std::chrono::steady_clock::now();
+  bool next_ready = CompactionPending();
+  int64_t backlog_bytes = 0;
+  for (int64_t i = 0; next_ready && i < kMaxBatchesPerCompactionCall; ++i) {
     absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     // We have to check CompactedBatchReady() again, in case hot batches were expired since the last
     // check.
     if (!batch_size_accountant_->CompactedBatchReady()) {
+      backlog_bytes = 0;
       break;
     }
-    PL_RETURN_IF_ERROR(CompactSingleBatchUnlocked(mem_pool));
+    PL_RETURN_IF_ERROR(CompactSingleBatchUnlocked());
     next_ready = batch_size_accountant_->CompactedBatchReady();
+    backlog_bytes = next_ready ? batch_size_accountant_->HotBytes() : 0;
   }
-  return Status::OK();
+
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  metrics_.compaction_time_counter.Increment(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  metrics_.compaction_backlog_bytes_gauge.Set(backlog_bytes);
+  return UpdateTableMetricGauges();
+}
+
+bool Table::CompactionPending() const {
+  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+  return batch_size_accountant_->CompactedBatchReady();
 }
 
 StatusOr<bool> Table::ExpireCold() {
-  absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  if (cold_store_->Size() == 0) {
-    return false;
+  absl::MutexLock expiry_lock(&cold_expiry_lock_);
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    if (cold_store_->Size() == 0) {
+      return false;
+    }
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    batch_size_accountant_->ExpireColdBatch();
   }
-  cold_store_->PopFront();
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-  batch_size_accountant_->ExpireColdBatch();
+  RemoveColdBatches(1);
   return true;
 }
 
+size_t Table::RemoveColdBatches(size_t num_batches) {
+  if (num_batches == 0) {
+    return 0;
+  }
+  // Only compaction touches the cold store concurrently, and it appends to the back, so the first
+  // num_batches batches stay the same until they are popped below.
+  internal::DiskStore* disk_store;
+  internal::RowID first_row_id;
+  std::vector<internal::ColdBatch> batches;
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    disk_store = disk_store_.get();
+    if (disk_store == nullptr) {
+      cold_store_->PopFrontN(num_batches);
+      return num_batches;
+    }
+    first_row_id = cold_store_->FirstRowID();
+    for (size_t i = 0; i < num_batches; ++i) {
+      batches.push_back(cold_store_->at(i));
+    }
+  }
+
+  // Writing and syncing the segment can take a while, so readers keep reading the batches from the
+  // cold store in the meantime.
+  auto segment_or_s = disk_store->WriteSegment(first_row_id, batches);
+
+  absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+  cold_store_->PopFrontN(num_batches);
+  if (!segment_or_s.ok()) {
+    // The batches are expired from memory either way, so that writes can make progress.
+    LOG(ERROR) << "Failed to spill cold batches to disk: " << segment_or_s.msg();
+    return num_batches;
+  }
+  return disk_store->AddSegment(segment_or_s.ConsumeValueOrDie());
+}
+
 Status Table::ExpireHot() {
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   if (hot_store_->Size() == 0) {
@@ -463,6 +613,8 @@ Status Table::UpdateTableMetricGauges() {
   // Set gauge values
   metrics_.cold_bytes_gauge.Set(stats.cold_bytes);
   metrics_.hot_bytes_gauge.Set(stats.hot_bytes);
+  metrics_.cold_arena_bytes_gauge.Set(stats.cold_arena_bytes);
+  metrics_.disk_bytes_gauge.Set(stats.disk_bytes);
   metrics_.num_batches_gauge.Set(stats.num_batches);
   metrics_.max_table_size_gauge.Set(stats.max_table_size);
   // Compute retention gauge
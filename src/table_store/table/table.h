@@ -23,6 +23,7 @@
 #include <arrow/record_batch.h>
 #include <algorithm>
 #include <deque>
+#include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
@@ -41,8 +42,10 @@
 #include "src/table_store/schema/row_batch.h"
 #include "src/table_store/schema/row_descriptor.h"
 #include "src/table_store/schemapb/schema.pb.h"
+#include "src/table_store/table/internal/arena_memory_pool.h"
 #include "src/table_store/table/internal/arrow_array_compactor.h"
 #include "src/table_store/table/internal/batch_size_accountant.h"
+#include "src/table_store/table/internal/disk_store.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
 #include "src/table_store/table/internal/store_with_row_accounting.h"
 #include "src/table_store/table/internal/types.h"
@@ -59,6 +62,11 @@ struct TableStats {
   int64_t bytes;
   int64_t hot_bytes;
   int64_t cold_bytes;
+  // Bytes mapped for the arenas holding the cold batches. Compare with cold_bytes to see how
+  // fragmented the cold store is.
+  int64_t cold_arena_bytes;
+  // Bytes of the table's segment files in the disk tier, if enabled.
+  int64_t disk_bytes;
   int64_t num_batches;
   int64_t batches_added;
   int64_t batches_expired;
@@ -80,6 +88,14 @@ struct TableStats {
  * Synchronization Scheme:
  * The hot and cold partitions are synchronized separately with spinlocks.
  *
+ * Disk Tier:
+ * Optionally (see EnableDiskTier), cold batches that are expired from memory are spilled to
+ * memory mapped segment files on local disk instead of being dropped. Reads go through the disk,
+ * cold and hot partitions in that order, and the disk tier is reloaded when the table is recreated
+ * on the same directory. The disk tier is synchronized by the cold partition's spinlock, except
+ * that segment files are written without holding it: the batches being spilled stay readable in the
+ * cold partition until their segment is mapped, and are then swapped for it under the spinlock.
+ *
  * Compaction Scheme:
  * Hot batches are compacted into batches of size roughly `compacted_batch_size_` +/- the size of a
  * single row.  The compaction routine should be called periodically but that is not the
@@ -112,6 +128,11 @@ class Table : public NotCopyable {
   using BatchID = internal::BatchID;
 
   static inline constexpr int64_t kDefaultColdBatchMinSize = 64 * 1024;
+  // Width of the time windows that the cold store is segmented into for time-based seeks.
+  static inline constexpr Time kColdSegmentWindowNs = 30LL * 1000 * 1000 * 1000;
+  // Cold batches are spilled to the disk tier in chunks of up to this many bytes (or a quarter of
+  // the table), so that each write produces a reasonably sized segment file.
+  static inline constexpr int64_t kDiskSpillBytes = 8 * 1024 * 1024;
 
  public:
   static inline constexpr int64_t kMaxBatchesPerCompactionCall = 256;
@@ -214,6 +235,15 @@ class Table : public NotCopyable {
   Table(std::string_view table_name, const schema::Relation& relation, size_t max_table_size,
         size_t compacted_batch_size_);
 
+  /**
+   * Enables the on-disk tier of the table in `dir`. Any segments left in `dir` by a previous table
+   * with the same relation are loaded, and new rows are appended after them. Must be called before
+   * any data is written to the table.
+   * @param dir the directory holding the table's segment files.
+   * @param max_disk_bytes the maximum number of bytes of segment files to keep on disk.
+   */
+  Status EnableDiskTier(const std::filesystem::path& dir, int64_t max_disk_bytes);
+
   /**
    * Get a RowBatch of data corresponding to the next data after the given cursor.
    * @param cursor the Table::Cursor to get the next row batch after.
@@ -281,10 +311,16 @@ class Table : public NotCopyable {
 
   /**
    * Compacts hot batches into compacted_batch_size_ sized cold batches. Each call to
-   * CompactHotToCold will create a maximum of kMaxBatchesPerCompactionCall cold batches.
-   * @param mem_pool arrow MemoryPool to be used for creating new cold batches.
+   * CompactHotToCold will create a maximum of kMaxBatchesPerCompactionCall cold batches, so a
+   * large backlog is worked through over several calls (see CompactionPending()). New cold batches
+   * are allocated from the table's own arena pool.
+   */
+  Status CompactHotToCold();
+
+  /**
+   * @return whether there is enough hot data to create at least one compacted batch.
    */
-  Status CompactHotToCold(arrow::MemoryPool* mem_pool);
+  bool CompactionPending() const;
 
  private:
   TableMetrics metrics_;
@@ -302,10 +338,13 @@ class Table : public NotCopyable {
   std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Hot>> hot_store_
       ABSL_GUARDED_BY(hot_lock_);
 
+  // Serializes expiring cold batches, which may write them to the disk tier without cold_lock_.
+  absl::Mutex cold_expiry_lock_ ABSL_ACQUIRED_BEFORE(cold_lock_);
   mutable absl::base_internal::SpinLock cold_lock_;
   std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Cold>> cold_store_
       ABSL_GUARDED_BY(cold_lock_);
   std::deque<int64_t> cold_batch_bytes_ ABSL_GUARDED_BY(cold_lock_);
+  std::unique_ptr<internal::DiskStore> disk_store_ ABSL_GUARDED_BY(cold_lock_);
 
   // Counter to assign a unique row ID to each row. Synchronized by hot_lock_ since its only
   // accessed on a hot write.
@@ -318,12 +357,19 @@ class Table : public NotCopyable {
   Status ExpireHot();
   StatusOr<bool> ExpireCold();
   Status ExpireRowBatches(int64_t row_batch_size);
-  Status CompactSingleBatchUnlocked(arrow::MemoryPool* mem_pool)
+  // Removes the first num_batches cold batches from the cold store, spilling them to the disk tier
+  // first if it is enabled. Returns the number of batches that left the table.
+  size_t RemoveColdBatches(size_t num_batches) ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_expiry_lock_)
+      ABSL_LOCKS_EXCLUDED(cold_lock_);
+  Status CompactSingleBatchUnlocked()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_lock_) ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
   Status UpdateTableMetricGauges();
 
   std::unique_ptr<internal::BatchSizeAccountant> batch_size_accountant_ ABSL_GUARDED_BY(hot_lock_);
 
+  // Cold batches are allocated from the table's own pool, so that they don't fragment the heap
+  // shared with query temporaries, and their memory is returned as whole arenas expire.
+  internal::ArenaMemoryPoolUPtr cold_pool_;
   internal::ArrowArrayCompactor compactor_;
 
   friend class Cursor;
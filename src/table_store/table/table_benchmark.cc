@@ -77,7 +77,7 @@ static inline int64_t FillTableCold(Table* table, int64_t table_size, int64_t ba
     auto batch = MakeHotBatch(batch_length, &time_counter);
     PL_CHECK_OK(table->TransferRecordBatch(std::move(batch)));
     // Run compaction every time to ensure that all batches get put into cold.
-    PL_CHECK_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+    PL_CHECK_OK(table->CompactHotToCold());
   }
   return time_counter;
 }
@@ -247,7 +247,7 @@ static void BM_TableCompaction(benchmark::State& state) {
   FillTableHot(table.get(), table_size, batch_length);
 
   for (auto _ : state) {
-    PL_CHECK_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+    PL_CHECK_OK(table->CompactHotToCold());
     state.PauseTiming();
     FillTableHot(table.get(), table_size, batch_length);
     state.ResumeTiming();
@@ -278,10 +278,10 @@ static void BM_TableThreaded(benchmark::State& state) {
 
   std::thread compaction_thread([table_ptr, done]() {
     while (!done->WaitForNotificationWithTimeout(absl::Milliseconds(50))) {
-      PL_CHECK_OK(table_ptr->CompactHotToCold(arrow::default_memory_pool()));
+      PL_CHECK_OK(table_ptr->CompactHotToCold());
     }
     // Do one last compaction after writer thread has finished writing.
-    PL_CHECK_OK(table_ptr->CompactHotToCold(arrow::default_memory_pool()));
+    PL_CHECK_OK(table_ptr->CompactHotToCold());
   });
 
   auto writer_work = [&]() {
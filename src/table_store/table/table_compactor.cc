@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/table_compactor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace px {
+namespace table_store {
+
+TableCompactor::TableCompactor(int num_threads, double cpu_budget)
+    : cpu_budget_(std::clamp(cpu_budget, 0.01, 1.0)) {
+  num_threads = std::max(num_threads, 1);
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&TableCompactor::RunWorker, this);
+  }
+}
+
+TableCompactor::~TableCompactor() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  idle_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void TableCompactor::Compact(const std::vector<std::shared_ptr<Table>>& tables) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& table : tables) {
+      if (scheduled_.insert(table.get()).second) {
+        queue_.push_back(table);
+      }
+    }
+  }
+  cv_.notify_all();
+}
+
+void TableCompactor::WaitForIdle() {
+  std::unique_lock<std::mutex> lock(mu_);
+  idle_cv_.wait(lock, [this] { return stop_ || (queue_.empty() && num_running_ == 0); });
+}
+
+size_t TableCompactor::QueueSize() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return queue_.size();
+}
+
+void TableCompactor::RunWorker() {
+  std::unique_lock<std::mutex> lock(mu_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (stop_) {
+      return;
+    }
+    std::shared_ptr<Table> table = std::move(queue_.front());
+    queue_.pop_front();
+    ++num_running_;
+    lock.unlock();
+
+    auto start = std::chrono::steady_clock::now();
+    auto status = table->CompactHotToCold();
+    LOG_IF(ERROR, !status.ok()) << status.msg();
+    bool pending = status.ok() && table->CompactionPending();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    lock.lock();
+    --num_running_;
+    if (pending) {
+      // Put the table at the back of the queue so that other tables make progress in between.
+      queue_.push_back(std::move(table));
+      cv_.notify_one();
+    } else {
+      scheduled_.erase(table.get());
+    }
+    if (queue_.empty() && num_running_ == 0) {
+      idle_cv_.notify_all();
+    }
+
+    // Idle long enough that compaction takes up at most cpu_budget_ of this thread's time.
+    auto idle = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        elapsed * (1.0 / cpu_budget_ - 1.0));
+    if (idle.count() > 0) {
+      cv_.wait_for(lock, idle, [this] { return stop_; });
+    }
+  }
+}
+
+}  // namespace table_store
+}  // namespace px
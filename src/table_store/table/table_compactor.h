@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+#include "src/common/base/base.h"
+#include "src/table_store/table/table.h"
+
+namespace px {
+namespace table_store {
+
+/**
+ * TableCompactor runs Table::CompactHotToCold on a pool of background threads, so that compaction
+ * doesn't block the thread that schedules it.
+ *
+ * A table is compacted by at most one thread at a time, but different tables are compacted
+ * concurrently. Each compaction call creates at most Table::kMaxBatchesPerCompactionCall cold
+ * batches; tables that still have a backlog afterwards are put at the back of the queue, so that
+ * one large table can't starve the others. After each call, a thread idles in proportion to the
+ * time it spent compacting, which keeps each thread's share of a CPU at roughly cpu_budget.
+ */
+class TableCompactor : public NotCopyable {
+ public:
+  /**
+   * @param num_threads the number of background compaction threads.
+   * @param cpu_budget fraction of a CPU, in (0, 1], that each thread may spend compacting.
+   */
+  TableCompactor(int num_threads, double cpu_budget);
+  ~TableCompactor();
+
+  /**
+   * Queues the given tables for compaction. Tables that are already queued or being compacted are
+   * skipped. Returns immediately.
+   */
+  void Compact(const std::vector<std::shared_ptr<Table>>& tables);
+
+  /**
+   * Blocks until all queued tables have been compacted.
+   */
+  void WaitForIdle();
+
+  /**
+   * @return the number of tables waiting for a compaction thread.
+   */
+  size_t QueueSize() const;
+
+ private:
+  void RunWorker();
+
+  const double cpu_budget_;
+
+  mutable std::mutex mu_;
+  // Signalled when tables are queued or the compactor is stopped.
+  std::condition_variable cv_;
+  // Signalled when the queue drains and no compaction is running.
+  std::condition_variable idle_cv_;
+  std::deque<std::shared_ptr<Table>> queue_;
+  // Tables that are queued or being compacted.
+  absl::flat_hash_set<const Table*> scheduled_;
+  int num_running_ = 0;
+  bool stop_ = false;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <arrow/memory_pool.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/table.h"
+#include "src/table_store/table/table_compactor.h"
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+constexpr int64_t kCompactedBatchSize = 4 * sizeof(int64_t);
+
+std::shared_ptr<Table> MakeHotTable(int64_t num_rows) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  auto table =
+      std::make_shared<Table>("test_table", rel, 128 * 1024 * 1024, kCompactedBatchSize);
+  for (int64_t i = 0; i < num_rows; i += 2) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    col_wrapper->AppendFromVector(std::vector<types::Time64NSValue>({i, i + 1}));
+    wrapper_batch->push_back(col_wrapper);
+    PL_CHECK_OK(table->TransferRecordBatch(std::move(wrapper_batch)));
+  }
+  return table;
+}
+
+}  // namespace
+
+TEST(TableCompactorTest, compacts_all_tables) {
+  std::vector<std::shared_ptr<Table>> tables;
+  for (int i = 0; i < 4; ++i) {
+    tables.push_back(MakeHotTable(64));
+  }
+
+  TableCompactor compactor(2, 1.0);
+  compactor.Compact(tables);
+  compactor.WaitForIdle();
+
+  for (const auto& table : tables) {
+    EXPECT_FALSE(table->CompactionPending());
+    auto stats = table->GetTableStats();
+    EXPECT_EQ(0, stats.hot_bytes);
+    EXPECT_EQ(64 * static_cast<int64_t>(sizeof(int64_t)), stats.cold_bytes);
+  }
+}
+
+TEST(TableCompactorTest, backlog_larger_than_one_call) {
+  // Enough rows for more than two calls worth of compacted batches.
+  int64_t num_rows = 4 * (2 * Table::kMaxBatchesPerCompactionCall + 1);
+  auto table = MakeHotTable(num_rows);
+
+  EXPECT_OK(table->CompactHotToCold());
+  EXPECT_TRUE(table->CompactionPending());
+  EXPECT_EQ(Table::kMaxBatchesPerCompactionCall * kCompactedBatchSize,
+            table->GetTableStats().cold_bytes);
+
+  TableCompactor compactor(1, 1.0);
+  compactor.Compact({table});
+  // Queueing the same table twice is a no-op.
+  compactor.Compact({table});
+  compactor.WaitForIdle();
+
+  EXPECT_FALSE(table->CompactionPending());
+  EXPECT_EQ(0, table->GetTableStats().hot_bytes);
+  EXPECT_EQ(num_rows * static_cast<int64_t>(sizeof(int64_t)), table->GetTableStats().cold_bytes);
+  EXPECT_EQ(0, compactor.QueueSize());
+}
+
+}  // namespace table_store
+}  // namespace px
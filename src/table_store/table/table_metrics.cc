@@ -36,6 +36,17 @@ TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_nam
                           .Help("Current hot data bytes in the table")
                           .Register(*registry)
                           .Add({{"name", table_name}})),
+      cold_arena_bytes_gauge(
+          prometheus::BuildGauge()
+              .Name("table_cold_arena_bytes")
+              .Help("Current bytes mapped for the arenas holding the table's cold data")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      disk_bytes_gauge(prometheus::BuildGauge()
+                           .Name("table_disk_bytes")
+                           .Help("Current bytes of the table's segment files on disk")
+                           .Register(*registry)
+                           .Add({{"name", table_name}})),
       num_batches_gauge(prometheus::BuildGauge()
                             .Name("table_num_batches")
                             .Help("Current number of row batches in the table")
@@ -58,6 +69,18 @@ TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_nam
               .Help("Total batches compacted in the table in the table's lifetime")
               .Register(*registry)
               .Add({{"name", table_name}})),
+      compaction_time_counter(
+          prometheus::BuildCounter()
+              .Name("table_compaction_time_us")
+              .Help("Total time spent compacting the table in the table's lifetime")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      compaction_backlog_bytes_gauge(
+          prometheus::BuildGauge()
+              .Name("table_compaction_backlog_bytes")
+              .Help("Hot bytes still ready for compaction when the last compaction call returned")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
       max_table_size_gauge(prometheus::BuildGauge()
                                .Name("table_max_table_size")
                                .Help("The cap on the table size")
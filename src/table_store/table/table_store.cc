@@ -158,9 +158,18 @@ std::vector<uint64_t> TableStore::GetTableIDs() const {
   return ids;
 }
 
-Status TableStore::RunCompaction(arrow::MemoryPool* mem_pool) {
+std::vector<std::shared_ptr<Table>> TableStore::GetTables() const {
+  std::vector<std::shared_ptr<Table>> tables;
+  tables.reserve(name_to_table_map_.size());
   for (const auto& it : name_to_table_map_) {
-    PL_RETURN_IF_ERROR(it.second->CompactHotToCold(mem_pool));
+    tables.push_back(it.second);
+  }
+  return tables;
+}
+
+Status TableStore::RunCompaction() {
+  for (const auto& it : name_to_table_map_) {
+    PL_RETURN_IF_ERROR(it.second->CompactHotToCold());
   }
   return Status::OK();
 }
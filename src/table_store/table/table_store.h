@@ -165,7 +165,12 @@ class TableStore {
     return "";
   }
 
-  Status RunCompaction(arrow::MemoryPool* mem_pool);
+  Status RunCompaction();
+
+  /**
+   * @return all the tables (including tablets) in the table store.
+   */
+  std::vector<std::shared_ptr<Table>> GetTables() const;
 
  private:
   void RegisterTableName(const std::string& table_name, const types::TabletID& tablet_id,
@@ -198,7 +198,7 @@ TEST(TableTest, bytes_test_w_compaction) {
 
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1)));
 
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
 
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size + rb3_size);
 }
@@ -358,7 +358,7 @@ TEST(TableTest, expiry_test_w_compaction) {
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size);
 
   EXPECT_OK(table.WriteRowBatch(rb2));
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size);
 
   EXPECT_OK(table.WriteRowBatch(rb3));
@@ -371,6 +371,192 @@ TEST(TableTest, expiry_test_w_compaction) {
   EXPECT_EQ(table.GetTableStats().bytes, rb5_size);
 }
 
+TEST(TableTest, expiry_drops_multiple_cold_batches_at_once) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t compaction_size = 4 * sizeof(int64_t);
+  Table table("test_table", rel, 10 * compaction_size, compaction_size);
+
+  auto make_batch = [](int64_t first_time, int64_t num_rows) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      col_wrapper->Append(first_time + i);
+    }
+    wrapper_batch->push_back(col_wrapper);
+    return wrapper_batch;
+  };
+
+  // Fill the table with 10 cold batches of 4 rows each.
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_OK(table.TransferRecordBatch(make_batch(4 * i, 4)));
+  }
+  EXPECT_OK(table.CompactHotToCold());
+  EXPECT_EQ(10, table.GetTableStats().num_batches);
+  EXPECT_EQ(0, table.GetTableStats().batches_expired);
+
+  // Making room for 12 more rows requires expiring the first 3 cold batches.
+  EXPECT_OK(table.TransferRecordBatch(make_batch(40, 12)));
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(3, stats.batches_expired);
+  EXPECT_EQ(8, stats.num_batches);
+  EXPECT_EQ(10 * compaction_size, stats.bytes);
+  EXPECT_EQ(12, table.FirstRowID());
+  EXPECT_EQ(12, table.FindRowIDFromTimeFirstGreaterThanOrEqual(0));
+  EXPECT_EQ(40, table.FindRowIDFromTimeFirstGreaterThan(39));
+}
+
+TEST(TableTest, disk_tier_keeps_expired_cold_batches) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t compaction_size = 4 * sizeof(int64_t);
+  testing::TempDir tmp_dir;
+
+  auto make_batch = [](int64_t first_time, int64_t num_rows) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      col_wrapper->Append(first_time + i);
+    }
+    wrapper_batch->push_back(col_wrapper);
+    return wrapper_batch;
+  };
+  auto read_times = [](const Table& table) {
+    std::vector<types::Time64NSValue> times;
+    Table::Cursor cursor(&table);
+    while (!cursor.Done()) {
+      auto rb_or_s = cursor.GetNextRowBatch({0});
+      EXPECT_OK(rb_or_s);
+      if (!rb_or_s.ok()) break;
+      auto col = std::static_pointer_cast<arrow::Int64Array>(rb_or_s.ValueOrDie()->ColumnAt(0));
+      for (int64_t i = 0; i < col->length(); ++i) {
+        times.push_back(col->Value(i));
+      }
+    }
+    return times;
+  };
+
+  {
+    Table table("test_table", rel, 10 * compaction_size, compaction_size);
+    ASSERT_OK(table.EnableDiskTier(tmp_dir.path(), 1024 * 1024));
+    for (int64_t i = 0; i < 10; ++i) {
+      EXPECT_OK(table.TransferRecordBatch(make_batch(4 * i, 4)));
+    }
+    EXPECT_OK(table.CompactHotToCold());
+    EXPECT_NOT_OK(table.EnableDiskTier(tmp_dir.path(), 1024 * 1024));
+
+    // Making room for 12 more rows moves the first 3 cold batches to disk instead of dropping them.
+    EXPECT_OK(table.TransferRecordBatch(make_batch(40, 12)));
+    auto stats = table.GetTableStats();
+    EXPECT_EQ(0, stats.batches_expired);
+    EXPECT_EQ(11, stats.num_batches);
+    EXPECT_EQ(10 * compaction_size, stats.bytes);
+    EXPECT_GT(stats.disk_bytes, 0);
+    EXPECT_EQ(0, stats.min_time);
+    EXPECT_EQ(0, table.FirstRowID());
+    EXPECT_EQ(51, table.LastRowID());
+    EXPECT_EQ(5, table.FindRowIDFromTimeFirstGreaterThanOrEqual(5));
+    EXPECT_EQ(40, table.FindRowIDFromTimeFirstGreaterThan(39));
+
+    // Cursors read transparently across the disk, cold and hot stores.
+    auto times = read_times(table);
+    ASSERT_EQ(52, times.size());
+    for (int64_t i = 0; i < 52; ++i) {
+      EXPECT_EQ(i, times[i]);
+    }
+  }
+
+  // A new table on the same directory picks up the batches on disk.
+  Table table("test_table", rel, 10 * compaction_size, compaction_size);
+  ASSERT_OK(table.EnableDiskTier(tmp_dir.path(), 1024 * 1024));
+  EXPECT_EQ(3, table.GetTableStats().num_batches);
+  EXPECT_EQ(0, table.FirstRowID());
+  EXPECT_EQ(11, table.LastRowID());
+  EXPECT_OK(table.TransferRecordBatch(make_batch(100, 2)));
+  EXPECT_EQ(13, table.LastRowID());
+  auto times = read_times(table);
+  ASSERT_EQ(14, times.size());
+  EXPECT_EQ(11, times[11]);
+  EXPECT_EQ(100, times[12]);
+}
+
+TEST(TableTest, disk_tier_keeps_segments_after_failed_spill) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t compaction_size = 4 * sizeof(int64_t);
+  testing::TempDir tmp_dir;
+  auto disk_dir = tmp_dir.path() / "disk";
+  auto moved_dir = tmp_dir.path() / "moved";
+
+  auto make_batch = [](int64_t first_time, int64_t num_rows) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      col_wrapper->Append(first_time + i);
+    }
+    wrapper_batch->push_back(col_wrapper);
+    return wrapper_batch;
+  };
+
+  Table table("test_table", rel, 10 * compaction_size, compaction_size);
+  ASSERT_OK(table.EnableDiskTier(disk_dir, 1024 * 1024));
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_OK(table.TransferRecordBatch(make_batch(4 * i, 4)));
+  }
+  EXPECT_OK(table.CompactHotToCold());
+  // Rows 0-11 are spilled.
+  EXPECT_OK(table.TransferRecordBatch(make_batch(40, 12)));
+  EXPECT_EQ(0, table.GetTableStats().batches_expired);
+
+  // Rows 12-23 can't be written to disk, so they are dropped.
+  std::filesystem::rename(disk_dir, moved_dir);
+  EXPECT_OK(table.TransferRecordBatch(make_batch(52, 12)));
+  EXPECT_EQ(3, table.GetTableStats().batches_expired);
+  std::filesystem::rename(moved_dir, disk_dir);
+
+  // Rows 24-35 are spilled after the gap, without dropping rows 0-11.
+  EXPECT_OK(table.TransferRecordBatch(make_batch(64, 12)));
+  EXPECT_EQ(3, table.GetTableStats().batches_expired);
+  EXPECT_EQ(0, table.FirstRowID());
+  EXPECT_EQ(24, table.FindRowIDFromTimeFirstGreaterThanOrEqual(15));
+
+  std::vector<types::Time64NSValue> times;
+  Table::Cursor cursor(&table);
+  while (!cursor.Done()) {
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({0}));
+    auto col = std::static_pointer_cast<arrow::Int64Array>(rb->ColumnAt(0));
+    for (int64_t i = 0; i < col->length(); ++i) {
+      times.push_back(col->Value(i));
+    }
+  }
+  std::vector<types::Time64NSValue> expected_times;
+  for (int64_t i = 0; i < 76; ++i) {
+    if (i < 12 || i >= 24) {
+      expected_times.push_back(i);
+    }
+  }
+  EXPECT_EQ(expected_times, times);
+}
+
+TEST(TableTest, cold_batches_use_table_arena) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t compaction_size = 4 * sizeof(int64_t);
+  Table table("test_table", rel, 128 * 1024, compaction_size);
+  EXPECT_EQ(0, table.GetTableStats().cold_arena_bytes);
+
+  auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+  col_wrapper->AppendFromVector(std::vector<types::Time64NSValue>({1, 2, 3, 4}));
+  wrapper_batch->push_back(col_wrapper);
+  EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
+  EXPECT_OK(table.CompactHotToCold());
+
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(compaction_size, stats.cold_bytes);
+  EXPECT_GE(stats.cold_arena_bytes, stats.cold_bytes);
+}
+
 TEST(TableTest, batch_size_too_big) {
   auto rd = schema::RowDescriptor({types::DataType::INT64, types::DataType::STRING});
   schema::Relation rel(rd.types(), {"col1", "col2"});
@@ -491,7 +677,7 @@ TEST(TableTest, hot_batches_w_compaction_test) {
   EXPECT_TRUE(rb1->ColumnAt(0)->Equals(types::ToArrow(col1_in1, arrow::default_memory_pool())));
   EXPECT_TRUE(rb1->ColumnAt(1)->Equals(types::ToArrow(col2_in1, arrow::default_memory_pool())));
 
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
 
   auto rb2 = cursor.GetNextRowBatch({0, 1}).ConsumeValueOrDie();
   EXPECT_TRUE(rb2->ColumnAt(0)->Equals(types::ToArrow(col1_in2, arrow::default_memory_pool())));
@@ -595,7 +781,7 @@ TEST(TableTest, find_rowid_from_time_first_greater_than_or_equal_with_compaction
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
 
   // Run Compaction.
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
   EXPECT_EQ(0, table.FindRowIDFromTimeFirstGreaterThanOrEqual(0));
   EXPECT_EQ(3, table.FindRowIDFromTimeFirstGreaterThanOrEqual(5));
 
@@ -614,7 +800,7 @@ TEST(TableTest, find_rowid_from_time_first_greater_than_or_equal_with_compaction
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
 
   // Run Compaction.
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
   EXPECT_EQ(3, table.FindRowIDFromTimeFirstGreaterThanOrEqual(6));
 
   EXPECT_EQ(4, table.FindRowIDFromTimeFirstGreaterThanOrEqual(8));
@@ -642,7 +828,7 @@ TEST(TableTest, find_rowid_from_time_first_greater_than_or_equal_with_compaction
   wrapper_batch->push_back(col_wrapper);
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
   // Run Compaction.
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
 
   EXPECT_EQ(10, table.FindRowIDFromTimeFirstGreaterThanOrEqual(13));
 
@@ -778,10 +964,10 @@ TEST(TableTest, threaded) {
 
   std::thread compaction_thread([table_ptr, done]() {
     while (!done->WaitForNotificationWithTimeout(absl::Milliseconds(50))) {
-      EXPECT_OK(table_ptr->CompactHotToCold(arrow::default_memory_pool()));
+      EXPECT_OK(table_ptr->CompactHotToCold());
     }
     // Do one last compaction after writer thread has finished writing.
-    EXPECT_OK(table_ptr->CompactHotToCold(arrow::default_memory_pool()));
+    EXPECT_OK(table_ptr->CompactHotToCold());
   });
 
   // Create the cursor before the write thread starts, to ensure that we get every row of the table.
@@ -882,7 +1068,7 @@ TEST(TableTest, NextBatch_generation_bug) {
   EXPECT_OK(rb1.AddColumn(col2_rb1_arrow));
 
   EXPECT_OK(table.WriteRowBatch(rb1));
-  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_OK(table.CompactHotToCold());
 
   Table::Cursor cursor(&table, Table::Cursor::StartSpec{}, Table::Cursor::StopSpec{});
   // Force cold expiration.
@@ -668,6 +668,10 @@ class GetDebugTableInfo final : public carnot::udf::UDTF<GetDebugTableInfo> {
                 "The size of this table in bytes"),
         ColInfo("cold_size", types::DataType::INT64, types::PatternType::GENERAL,
                 "The number of bytes in cold storage"),
+        ColInfo("cold_arena_size", types::DataType::INT64, types::PatternType::GENERAL,
+                "The number of bytes mapped for cold storage, including fragmentation"),
+        ColInfo("disk_size", types::DataType::INT64, types::PatternType::GENERAL,
+                "The number of bytes in the on-disk tier, 0 if it isn't enabled"),
         ColInfo("max_table_size", types::DataType::INT64, types::PatternType::GENERAL,
                 "The maximum size of this table"),
         ColInfo("min_time", types::DataType::TIME64NS, types::PatternType::GENERAL,
@@ -698,6 +702,8 @@ class GetDebugTableInfo final : public carnot::udf::UDTF<GetDebugTableInfo> {
     rw->Append<IndexOf("compacted_batches")>(info.compacted_batches);
     rw->Append<IndexOf("size")>(info.bytes);
     rw->Append<IndexOf("cold_size")>(info.cold_bytes);
+    rw->Append<IndexOf("cold_arena_size")>(info.cold_arena_bytes);
+    rw->Append<IndexOf("disk_size")>(info.disk_bytes);
     rw->Append<IndexOf("max_table_size")>(info.max_table_size);
     rw->Append<IndexOf("min_time")>(info.min_time);
 
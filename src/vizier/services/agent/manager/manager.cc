@@ -63,6 +63,14 @@ DEFINE_string(vizier_id, gflags::StringFromEnv("PL_VIZIER_ID", ""), "The ID of t
 DEFINE_string(vizier_name, gflags::StringFromEnv("PL_VIZIER_NAME", ""),
               "The name of the cluster according to vizier.");
 
+DEFINE_int32(table_store_compaction_threads,
+             gflags::Int32FromEnv("PL_TABLE_STORE_COMPACTION_THREADS", 2),
+             "The number of background threads used to compact the table store.");
+
+DEFINE_double(table_store_compaction_cpu_budget,
+              gflags::DoubleFromEnv("PL_TABLE_STORE_COMPACTION_CPU_BUDGET", 0.5),
+              "The fraction of a CPU, in (0, 1], that each table store compaction thread may use.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -318,12 +326,12 @@ Status Manager::PostRegisterHook(uint32_t asid) {
         std::bind(&Manager::NATSMessageHandler, this, std::placeholders::_1));
   }
 
+  table_compactor_ = std::make_unique<table_store::TableCompactor>(
+      FLAGS_table_store_compaction_threads, FLAGS_table_store_compaction_cpu_budget);
   tablestore_compaction_timer_ = dispatcher()->CreateTimer([this]() {
-    // TODO(james): when we change ExecState::exec_mem_pool to not return just the default pool, we
-    // will need to figure out how to use the correct memory pool here, but for now we can just use
-    // the default pool.
-    auto status = table_store()->RunCompaction(arrow::default_memory_pool());
-    LOG_IF(ERROR, !status.ok()) << status.msg();
+    // Only the list of tables is collected on the dispatcher thread, the compaction itself runs
+    // on the compactor's threads.
+    table_compactor_->Compact(table_store()->GetTables());
     if (tablestore_compaction_timer_) {
       tablestore_compaction_timer_->EnableTimer(kTableStoreCompactionPeriod);
     }
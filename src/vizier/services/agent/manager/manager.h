@@ -32,6 +32,7 @@
 #include "src/common/metrics/memory_metrics.h"
 #include "src/common/uuid/uuid.h"
 #include "src/shared/metadata/metadata.h"
+#include "src/table_store/table/table_compactor.h"
 #include "src/vizier/funcs/context/vizier_context.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/chan_cache.h"
@@ -231,7 +232,9 @@ class Manager : public px::NotCopyable {
   // Factory context for vizier functions.
   funcs::VizierFuncFactoryContext func_context_;
 
-  // Timer to manage table store compaction.
+  // Compacts the table store's tables off the dispatcher thread.
+  std::unique_ptr<table_store::TableCompactor> table_compactor_;
+  // Timer to schedule table store compaction.
   px::event::TimerUPtr tablestore_compaction_timer_;
 
   px::metrics::MemoryMetrics memory_metrics_;
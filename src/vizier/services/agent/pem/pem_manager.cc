@@ -18,6 +18,8 @@
 
 #include "src/vizier/services/agent/pem/pem_manager.h"
 
+#include <filesystem>
+
 #include "src/common/system/config.h"
 #include "src/vizier/services/agent/manager/exec.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -34,6 +36,15 @@ DEFINE_int32(table_store_http_events_percent,
              "The percent of the table store data limit that should be devoted to the http_events "
              "table. Defaults to 40%.");
 
+DEFINE_string(table_store_data_dir, gflags::StringFromEnv("PL_TABLE_STORE_DATA_DIR", ""),
+              "If set, cold data expired from the in-memory table store is kept in memory mapped "
+              "segment files under this directory, and reloaded when the agent restarts.");
+
+DEFINE_int32(table_store_disk_limit,
+             gflags::Int32FromEnv("PL_TABLE_STORE_DISK_LIMIT_MB", 16 * 1024),
+             "The maximum amount of data to keep in table_store_data_dir, split between tables in "
+             "the same ratio as table_store_data_limit. Defaults to 16GB.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -86,6 +97,8 @@ Status PEMManager::InitSchemas() {
   int64_t num_tables = relation_info_vec.size();
   int64_t http_table_size = (FLAGS_table_store_http_events_percent * memory_limit) / 100;
   int64_t other_table_size = (memory_limit - http_table_size) / (num_tables - 1);
+  double disk_to_memory_ratio =
+      static_cast<double>(FLAGS_table_store_disk_limit) / FLAGS_table_store_data_limit;
 
   for (const auto& relation_info : relation_info_vec) {
     std::shared_ptr<table_store::Table> table_ptr;
@@ -100,6 +113,17 @@ Status PEMManager::InitSchemas() {
                                                        other_table_size);
     }
 
+    if (!FLAGS_table_store_data_dir.empty()) {
+      auto disk_size = static_cast<int64_t>(
+          disk_to_memory_ratio *
+          (relation_info.name == "http_events" ? http_table_size : other_table_size));
+      auto s = table_ptr->EnableDiskTier(
+          std::filesystem::path(FLAGS_table_store_data_dir) / relation_info.name, disk_size);
+      // The table still works without its disk tier, so don't fail the agent over it.
+      LOG_IF(ERROR, !s.ok()) << absl::Substitute("Failed to enable the disk tier of table $0: $1",
+                                                 relation_info.name, s.msg());
+    }
+
     table_store()->AddTable(std::move(table_ptr), relation_info.name, relation_info.id);
     PL_RETURN_IF_ERROR(relation_info_manager()->AddRelationInfo(relation_info));
   }